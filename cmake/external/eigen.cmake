@@ -43,6 +43,8 @@ endif()
 
 set(EIGEN_INCLUDE_DIR ${EIGEN_SOURCE_DIR})
 include_directories(${EIGEN_INCLUDE_DIR})
+# Eigen::ThreadPoolDevice is used by the intra-op thread pool of CPUContext
+add_definitions(-DEIGEN_USE_THREADS)
 
 ExternalProject_Add(
   extern_eigen3
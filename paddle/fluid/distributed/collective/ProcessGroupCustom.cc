@@ -110,16 +110,14 @@ ProcessGroupCustom::ProcessGroupCustom(const std::shared_ptr<Store>& store,
 
 void ProcessGroupCustom::BroadcastUniqueCustomID(
     std::vector<phi::ccl::CCLRootId>& ccl_ids) {  // NOLINT
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < ccl_ids.size(); i++) {
+    keys.emplace_back("ProcessGroupCustom/ccl_ids/" + std::to_string(i));
+  }
   if (rank_ == 0) {
-    for (size_t i = 0; i < ccl_ids.size(); i++) {
-      auto key = "ProcessGroupCustom/ccl_ids/" + std::to_string(i);
-      store_->set(key, ccl_ids[i]);
-    }
+    store_->multi_set(keys, ccl_ids);
   } else {
-    for (size_t i = 0; i < ccl_ids.size(); i++) {
-      auto key = "ProcessGroupCustom/ccl_ids/" + std::to_string(i);
-      ccl_ids[i] = store_->get(key);
-    }
+    ccl_ids = store_->multi_get(keys);
   }
 }
 
@@ -33,6 +33,8 @@
 #include "paddle/fluid/framework/fleet/gloo_wrapper.h"
 #include "paddle/fluid/platform/enforce.h"
 
+DECLARE_int32(gloo_comm_threads);
+
 namespace paddle {
 namespace distributed {
 
@@ -176,6 +178,33 @@ ProcessGroupGloo::GlooTask::GlooTask(
     int rank, const std::vector<phi::DenseTensor>& inputs, CommType comm_type)
     : ProcessGroup::Task(rank, inputs, comm_type) {}
 
+bool ProcessGroupGloo::GlooTask::Wait(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (timeout == kWaitTimeout) {
+    cv_.wait(lock, [&] { return is_completed_; });
+  } else {
+    cv_.wait_for(lock, timeout, [&] { return is_completed_; });
+    PADDLE_ENFORCE_EQ(
+        is_completed_,
+        true,
+        platform::errors::ExecutionTimeout(
+            "The gloo task is not finished in %d ms.", timeout.count()));
+  }
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+  return true;
+}
+
+void ProcessGroupGloo::GlooTask::Finish(std::exception_ptr exception) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_completed_ = true;
+    exception_ = exception;
+  }
+  cv_.notify_all();
+}
+
 ProcessGroupGloo::ProcessGroupGloo(
     const std::shared_ptr<distributed::Store>& store,
     int rank,
@@ -186,10 +215,92 @@ ProcessGroupGloo::ProcessGroupGloo(
     : ProcessGroup(rank, world_size, place, gid),
       _tag(0),
       _store(new GlooStore(store)) {
-  _context = std::make_shared<gloo::rendezvous::Context>(rank, world_size);
-  auto prefix_store =
-      ::gloo::rendezvous::PrefixStore(std::to_string(gid), *_store);
-  _context->connectFullMesh(prefix_store, options->device);
+  PADDLE_ENFORCE_GT(FLAGS_gloo_comm_threads,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The number of communication threads of "
+                        "ProcessGroupGloo should be greater than 0, "
+                        "but got %d.",
+                        FLAGS_gloo_comm_threads));
+  for (int i = 0; i < FLAGS_gloo_comm_threads; ++i) {
+    auto context =
+        std::make_shared<gloo::rendezvous::Context>(rank, world_size);
+    // the first context keeps the prefix of the single context before
+    auto prefix = std::to_string(gid);
+    if (i > 0) {
+      prefix += "_" + std::to_string(i);
+    }
+    auto prefix_store = ::gloo::rendezvous::PrefixStore(prefix, *_store);
+    context->connectFullMesh(prefix_store, options->device);
+    _contexts.push_back(context);
+  }
+  _queues.resize(_contexts.size());
+  _running.resize(_contexts.size());
+  for (size_t i = 0; i < _contexts.size(); ++i) {
+    _workers.emplace_back(&ProcessGroupGloo::WorkLoop, this, i);
+  }
+}
+
+ProcessGroupGloo::~ProcessGroupGloo() {
+  std::unique_lock<std::mutex> lock(_queue_mutex);
+  _queue_consume.wait(lock, [&] {
+    for (auto& queue : _queues) {
+      if (!queue.empty()) {
+        return false;
+      }
+    }
+    return true;
+  });
+  _stop = true;
+  lock.unlock();
+  _queue_produce.notify_all();
+
+  for (auto& worker : _workers) {
+    worker.join();
+  }
+}
+
+void ProcessGroupGloo::WorkLoop(size_t worker_id) {
+  std::unique_lock<std::mutex> lock(_queue_mutex);
+
+  auto& queue = _queues[worker_id];
+
+  while (!_stop) {
+    if (queue.empty()) {
+      _queue_produce.wait(lock);
+      continue;
+    }
+
+    auto task = std::move(queue.front());
+    queue.pop_front();
+    _running[worker_id] = task;
+
+    lock.unlock();
+    _queue_consume.notify_all();
+
+    try {
+      task->Run();
+      task->Finish();
+    } catch (...) {
+      task->Finish(std::current_exception());
+    }
+
+    lock.lock();
+    _running[worker_id].reset();
+  }
+}
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Enqueue(
+    std::shared_ptr<GlooTask> task, uint32_t tag, bool sync_op) {
+  std::unique_lock<std::mutex> lock(_queue_mutex);
+  _queues[tag % _queues.size()].push_back(task);
+  lock.unlock();
+  // the workers share the condition variable, so wake the one of the tag up
+  _queue_produce.notify_all();
+  if (sync_op) {
+    task->Wait();
+  }
+  return task;
 }
 
 class BroadcastGlooTask : public ProcessGroupGloo::GlooTask {
@@ -237,7 +348,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Broadcast(
     bool sync_op) {
   std::vector<phi::DenseTensor> in_wrapper = {in_tensor};
   std::vector<phi::DenseTensor> out_wrapper = {*out_tensor};
-  return Broadcast(in_wrapper, out_wrapper, opts, true);
+  return Broadcast(in_wrapper, out_wrapper, opts, sync_op);
 }
 
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Broadcast(
@@ -253,13 +364,12 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Broadcast(
     const BroadcastOptions& opts,
     bool sync_op) {
   auto root = opts.source_rank;
-  std::unique_ptr<BroadcastGlooTask> task;
+  std::shared_ptr<BroadcastGlooTask> task;
   auto tag = next_tag();
-  auto context = get_context();
-  task = std::make_unique<BroadcastGlooTask>(
+  auto context = get_context(tag);
+  task = std::make_shared<BroadcastGlooTask>(
       context, inputs, outputs, rank_, root, tag);
-  task->Run();
-  return task;
+  return Enqueue(task, tag, sync_op);
 }
 
 class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
@@ -311,6 +421,17 @@ class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
   }
 };
 
+// Single-tensor AllReduce, runs on the vector overload.
+std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
+    phi::DenseTensor* out_tensor,
+    const phi::DenseTensor& in_tensor,
+    const AllreduceOptions& opts,
+    bool sync_op) {
+  std::vector<phi::DenseTensor> in_wrapper = {in_tensor};
+  std::vector<phi::DenseTensor> out_wrapper = {*out_tensor};
+  return AllReduce(in_wrapper, out_wrapper, opts, sync_op);
+}
+
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
     std::vector<phi::DenseTensor>& inputs,
     std::vector<phi::DenseTensor>& outputs,
@@ -325,38 +446,59 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
     bool sync_op) {
   auto tag = next_tag();
   std::shared_ptr<GlooTask> task;
-  auto context = get_context();
+  auto context = get_context(tag);
   task = std::make_shared<AllreduceGlooTask>(
       rank_, context, inputs, outputs, opts.reduce_op, tag);
-  task->Run();
-  return task;
+  return Enqueue(task, tag, sync_op);
 }
 
 class BarrierGlooTask : public ProcessGroupGloo::GlooTask {
  public:
-  BarrierGlooTask(int rank, const std::shared_ptr<gloo::Context>& context)
+  BarrierGlooTask(int rank,
+                  const std::shared_ptr<gloo::Context>& context,
+                  uint32_t tag)
       : ProcessGroupGloo::GlooTask(
             rank, std::vector<phi::DenseTensor>{}, CommType::BARRIER),
-        _context(context) {}
+        _context(context),
+        _tag(tag) {}
 
   void Run() override { _do_barrier(); }
 
  private:
   std::shared_ptr<gloo::Context> _context;
+  uint32_t _tag;
 
   void _do_barrier() {
     gloo::BarrierOptions opts(_context);
+    opts.setTag(_tag);
     gloo::barrier(opts);
   }
 };
 
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Barrier(
     const BarrierOptions& opts) {
+  // the barrier is passed after all the tasks enqueued before are finished
+  std::vector<std::shared_ptr<GlooTask>> pending_tasks;
+  {
+    std::lock_guard<std::mutex> lock(_queue_mutex);
+    for (auto& queue : _queues) {
+      pending_tasks.insert(pending_tasks.end(), queue.begin(), queue.end());
+    }
+    for (auto& running_task : _running) {
+      if (running_task) {
+        pending_tasks.push_back(running_task);
+      }
+    }
+  }
+  for (auto& pending_task : pending_tasks) {
+    pending_task->Wait();
+  }
+
   std::shared_ptr<BarrierGlooTask> task;
-  auto context = get_context();
-  task = std::make_shared<BarrierGlooTask>(rank_, context);
-  task->Run();
-  return task;
+  auto tag = next_tag();
+  auto context = get_context(tag);
+  task = std::make_shared<BarrierGlooTask>(rank_, context, tag);
+  return Enqueue(task, tag, true);
 }
 
 class AllgatherGlooTask : public ProcessGroupGloo::GlooTask {
@@ -397,7 +539,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllGather(
     bool sync_op) {
   std::vector<phi::DenseTensor> in_wrapper = {in_tensor};
   std::vector<phi::DenseTensor> out_wrapper = {*out_tensor};
-  return AllGather(in_wrapper, out_wrapper, true);
+  return AllGather(in_wrapper, out_wrapper, sync_op);
 }
 
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllGather(
@@ -412,11 +554,10 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllGather(
     bool sync_op) {
   std::shared_ptr<AllgatherGlooTask> task;
   auto tag = next_tag();
-  auto context = get_context();
+  auto context = get_context(tag);
   task = std::make_shared<AllgatherGlooTask>(
       rank_, context, in_tensors, out_tensors, tag);
-  task->Run();
-  return task;
+  return Enqueue(task, tag, sync_op);
 }
 
 class ReduceGlooTask : public ProcessGroupGloo::GlooTask {
@@ -487,11 +628,10 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Reduce(
     bool sync_op) {
   std::shared_ptr<ReduceGlooTask> task;
   auto tag = next_tag();
-  auto context = get_context();
+  auto context = get_context(tag);
   task = std::make_shared<ReduceGlooTask>(
       rank_, context, inputs, outputs, opts.reduce_op, opts.root_rank, tag);
-  task->Run();
-  return task;
+  return Enqueue(task, tag, sync_op);
 }
 
 class ScatterGlooTask : public ProcessGroupGloo::GlooTask {
@@ -550,11 +690,10 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Scatter(
     bool sync_op) {
   std::shared_ptr<ScatterGlooTask> task;
   auto tag = next_tag();
-  auto context = get_context();
+  auto context = get_context(tag);
   task = std::make_shared<ScatterGlooTask>(
       rank_, context, in_tensors, out_tensors, opts.root_rank, size_, tag);
-  task->Run();
-  return task;
+  return Enqueue(task, tag, sync_op);
 }
 
 std::shared_ptr<::gloo::transport::Device>
@@ -14,8 +14,12 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <future>
 #include <mutex>
+#include <thread>
 
 #include "paddle/fluid/distributed/collective/ProcessGroup.h"
 
@@ -41,12 +45,19 @@ class ProcessGroupGloo : public ProcessGroup {
     ~GlooTask() = default;
 
     virtual void Run() = 0;
-    bool Wait(std::chrono::milliseconds timeout) override { return true; }
-    bool IsCompleted() override { return true; }
-    void Synchronize() override {}
+    // Block until the task is run by a communication thread, and rethrow
+    // the exception raised by Run().
+    bool Wait(std::chrono::milliseconds timeout = kWaitTimeout) override;
+    void Synchronize() override { Wait(); }
 
    protected:
     friend class ProcessGroupGloo;
+
+   private:
+    void Finish(std::exception_ptr exception = nullptr);
+
+    std::condition_variable cv_;
+    std::exception_ptr exception_;
   };
 
   class GlooStore : public ::gloo::rendezvous::Store {
@@ -106,7 +117,7 @@ class ProcessGroupGloo : public ProcessGroup {
       int gid,
       std::shared_ptr<GlooOptions> options);
 
-  ~ProcessGroupGloo() = default;
+  ~ProcessGroupGloo();
 
   std::shared_ptr<ProcessGroup::Task> AllGather(
       phi::DenseTensor* out_tensor,
@@ -119,6 +130,12 @@ class ProcessGroupGloo : public ProcessGroup {
       const BroadcastOptions& opts,
       bool sync_op) override;
 
+  std::shared_ptr<ProcessGroup::Task> AllReduce(
+      phi::DenseTensor* out_tensor,
+      const phi::DenseTensor& in_tensor,
+      const AllreduceOptions& opts,
+      bool sync_op) override;
+
   // TODO(sunyilun): methods below will be removed later
   std::shared_ptr<ProcessGroup::Task> Broadcast(
       std::vector<phi::DenseTensor>& inputs,
@@ -176,7 +193,11 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<phi::DenseTensor>& out_tensors,
       const ScatterOptions&) override;
 
-  std::shared_ptr<::gloo::Context> get_context() { return _context; }
+  std::shared_ptr<::gloo::Context> get_context() { return _contexts[0]; }
+  // The collectives with the same tag run on the same context of all ranks.
+  std::shared_ptr<::gloo::Context> get_context(uint32_t tag) {
+    return _contexts[tag % _contexts.size()];
+  }
   uint64_t next_tag() { return _tag++; }
 
   std::string GetBackendName() const override { return "GLOO"; }
@@ -194,9 +215,30 @@ class ProcessGroupGloo : public ProcessGroup {
   static std::shared_ptr<::gloo::transport::Device> createDefaultDevice();
 
  protected:
+  // Run the task on the communication thread of the context of tag, and
+  // wait for it if sync_op is true. Each context is only driven by its own
+  // thread, which runs the tasks in the order they are enqueued, the same
+  // on all ranks.
+  std::shared_ptr<ProcessGroup::Task> Enqueue(std::shared_ptr<GlooTask> task,
+                                              uint32_t tag,
+                                              bool sync_op);
+
+  void WorkLoop(size_t worker_id);
+
   uint32_t _tag;
-  std::shared_ptr<gloo::rendezvous::Context> _context;
+  std::vector<std::shared_ptr<gloo::rendezvous::Context>> _contexts;
   std::shared_ptr<::gloo::rendezvous::Store> _store;
+
+ private:
+  bool _stop{false};
+  std::mutex _queue_mutex;
+  // The pending tasks of each context.
+  std::vector<std::deque<std::shared_ptr<GlooTask>>> _queues;
+  // The task run by each communication thread.
+  std::vector<std::shared_ptr<GlooTask>> _running;
+  std::vector<std::thread> _workers;
+  std::condition_variable _queue_produce;
+  std::condition_variable _queue_consume;
 };
 
 }  // namespace distributed
@@ -299,6 +299,16 @@ static void SplitTensorsWithType(const DeviceContext &context,
   }
 }
 
+// ProcessGroupGloo runs the all-reduce with sync_op=false on its
+// communication threads, so that the all-reduce of a group on CPU overlaps
+// with the rest of backward, and the group is split after the all-reduce is
+// finished in FinalizeBackward().
+static bool IsAsyncAllReduce(const platform::Place &place,
+                             const ProcessGroup &process_group) {
+  return platform::is_cpu_place(place) &&
+         process_group.GetBackendName() == "GLOO";
+}
+
 void EagerGroup::ConcatTensors(const platform::Place &place) {
   dense_contents_ =
       paddle::experimental::empty(IntArray({all_length_}), dtype_, place);
@@ -935,9 +945,13 @@ void EagerReducer::ProcessUnusedDenseVars() {
 void EagerReducer::FinalizeBackward() {
   groups_need_finalize_ = false;
   grad_need_hooks_ = false;
+  bool is_async_allreduce = IsAsyncAllReduce(inner_place_, *process_group_);
   for (auto &group : groups_) {
     if (!group.is_sparse_) {
       group.task->Synchronize();
+      if (is_async_allreduce) {
+        group.SplitTensorsDev(process_group_->GetDeviceContext(inner_place_));
+      }
     }
   }
 
@@ -978,6 +992,11 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
   for (auto &t : reduce_tensors) {
     in_out.push_back(*std::dynamic_pointer_cast<phi::DenseTensor>(t.impl()));
   }
+  if (IsAsyncAllReduce(inner_place_, *process_group_)) {
+    group->task = process_group_->AllReduce(in_out, in_out, opts, false);
+    // split in FinalizeBackward()
+    return;
+  }
   group->task = process_group_->AllReduce(in_out, in_out, opts);
 
   const auto &context = process_group_->GetDeviceContext(inner_place_);
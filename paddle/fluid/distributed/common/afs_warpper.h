@@ -66,6 +66,14 @@ class FsReadChannel {
     return 0;
   }
 
+  // read exactly size bytes, used by binary files
+  inline uint32_t read(char* data, uint32_t size) {
+    if (size != fread_unlocked(data, 1, size, _file.get())) {
+      return -1;
+    }
+    return 0;
+  }
+
  private:
   uint32_t _buffer_size;
   FsChannelConfig _config;
@@ -114,6 +122,14 @@ class FsWriteChannel {
     return write_line(data.c_str(), data.size());
   }
 
+  // write raw bytes without the line break, used by binary files
+  inline uint32_t write(const char* data, uint32_t size) {
+    if (size != fwrite_unlocked(data, 1, size, _file.get())) {
+      return -1;
+    }
+    return 0;
+  }
+
  private:
   uint32_t _buffer_size;
   FsChannelConfig _config;
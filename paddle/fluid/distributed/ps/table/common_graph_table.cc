@@ -608,13 +608,8 @@ int32_t GraphTable::make_complementary_graph(int idx, int64_t byte_size) {
     int64_t res = load_graph_to_memory_from_ssd(idx, buffer);
     byte_size -= res;
   }
-  std::string sample_type = "random";
-  for (auto &shard : edge_shards[idx]) {
-    auto bucket = shard->get_bucket();
-    for (size_t i = 0; i < bucket.size(); i++) {
-      bucket[i]->build_sampler(sample_type);
-    }
-  }
+  // the CSR sampler replaces the samplers of the nodes if it is enabled
+  build_sampler(idx, "random");
 
   return 0;
 }
@@ -983,6 +978,7 @@ void GraphShard::clear() {
   }
   bucket.clear();
   node_location.clear();
+  csr_sampler.reset();
 }
 
 GraphShard::~GraphShard() { clear(); }
@@ -998,8 +994,11 @@ void GraphShard::delete_node(uint64_t id) {
   }
   node_location.erase(id);
   bucket.pop_back();
+  csr_sampler.reset();
 }
 GraphNode *GraphShard::add_graph_node(uint64_t id) {
+  // the edges of the node may be changed by the caller
+  csr_sampler.reset();
   if (node_location.find(id) == node_location.end()) {
     node_location[id] = bucket.size();
     bucket.push_back(new GraphNode(id));
@@ -1009,6 +1008,7 @@ GraphNode *GraphShard::add_graph_node(uint64_t id) {
 
 GraphNode *GraphShard::add_graph_node(Node *node) {
   auto id = node->get_id();
+  csr_sampler.reset();
   if (node_location.find(id) == node_location.end()) {
     node_location[id] = bucket.size();
     bucket.push_back(node);
@@ -1030,9 +1030,23 @@ FeatureNode *GraphShard::add_feature_node(uint64_t id, bool is_overlap) {
 }
 
 void GraphShard::add_neighbor(uint64_t id, uint64_t dst_id, float weight) {
+  csr_sampler.reset();
   find_node(id)->add_edge(dst_id, weight);
 }
 
+void GraphShard::build_csr_sampler(const std::string &sample_type) {
+  csr_sample_type = sample_type;
+  csr_sampler.reset(new CSRNeighborSampler());
+  csr_sampler->build(bucket, sample_type == "weighted");
+}
+
+CSRNeighborSampler *GraphShard::get_csr_sampler() {
+  if (csr_sampler == nullptr && !csr_sample_type.empty()) {
+    build_csr_sampler(csr_sample_type);
+  }
+  return csr_sampler.get();
+}
+
 Node *GraphShard::find_node(uint64_t id) {
   auto iter = node_location.find(id);
   return iter == node_location.end() ? nullptr : bucket[iter->second];
@@ -1345,6 +1359,28 @@ int32_t GraphTable::load_nodes(const std::string &path, std::string node_type) {
 }
 
 int32_t GraphTable::build_sampler(int idx, std::string sample_type) {
+  if (use_csr_sampler) {
+    // build in the task threads of shards, which sample the shards later
+    std::vector<std::future<int>> tasks;
+    for (size_t i = 0; i < edge_shards[idx].size(); i++) {
+      tasks.push_back(
+          _shards_task_pool[get_thread_pool_index_by_shard_index(
+                                i + shard_start)]
+              ->enqueue([&, i]() -> int {
+                edge_shards[idx][i]->build_csr_sampler(sample_type);
+                return 0;
+              }));
+    }
+    size_t memory_size = 0;
+    for (size_t i = 0; i < tasks.size(); i++) {
+      tasks[i].get();
+      memory_size += edge_shards[idx][i]->get_csr_sampler()->get_memory_size();
+    }
+    VLOG(0) << "build csr sampler of edge_type[" << id_to_edge[idx]
+            << "], sample_type[" << sample_type << "], memory size "
+            << memory_size;
+    return 0;
+  }
   for (auto &shard : edge_shards[idx]) {
     auto bucket = shard->get_bucket();
     for (size_t i = 0; i < bucket.size(); i++) {
@@ -1477,14 +1513,8 @@ int32_t GraphTable::load_edges(const std::string &path,
     // this optimization is only performed in load_edges function.
     VLOG(0) << "run in gpugraph mode!";
   } else {
-    std::string sample_type = "random";
     VLOG(0) << "build sampler ... ";
-    for (auto &shard : edge_shards[idx]) {
-      auto bucket = shard->get_bucket();
-      for (size_t i = 0; i < bucket.size(); i++) {
-        bucket[i]->build_sampler(sample_type);
-      }
-    }
+    build_sampler(idx, "random");
   }
 
   return 0;
@@ -1523,6 +1553,18 @@ Node *GraphTable::find_node(int type_id, int idx, uint64_t id) {
   Node *node = search_shards[index]->find_node(id);
   return node;
 }
+int GraphTable::find_csr_row(int idx,
+                             uint64_t id,
+                             CSRNeighborSampler **csr_sampler) {
+  size_t shard_id = id % shard_num;
+  if (shard_id >= shard_end || shard_id < shard_start) {
+    return -1;
+  }
+  auto shard = edge_shards[idx][shard_id - shard_start];
+  *csr_sampler = shard->get_csr_sampler();
+  return *csr_sampler == nullptr ? -1 : shard->get_node_index(id);
+}
+
 uint32_t GraphTable::get_thread_pool_index(uint64_t node_id) {
   return node_id % shard_num % shard_num_per_server % task_pool_size_;
 }
@@ -1647,6 +1689,7 @@ int32_t GraphTable::random_sample_neighbors(
       std::vector<SampleResult> sample_res;
       std::vector<SampleKey> sample_keys;
       auto &rng = _shards_task_rng_pool[i];
+      std::vector<int> res;
       for (size_t k = 0; k < id_list[i].size(); k++) {
         if (index < r.size() &&
             r[index].first.node_key == id_list[i][k].node_key) {
@@ -1656,10 +1699,17 @@ int32_t GraphTable::random_sample_neighbors(
           index++;
         } else {
           node_id = id_list[i][k].node_key;
-          Node *node = find_node(0, idx, node_id);
+          Node *node = nullptr;
+          CSRNeighborSampler *csr_sampler = nullptr;
+          int row = -1;
+          if (use_csr_sampler) {
+            row = find_csr_row(idx, node_id, &csr_sampler);
+          } else {
+            node = find_node(0, idx, node_id);
+          }
           int idy = seq_id[i][k];
           int &actual_size = actual_sizes[idy];
-          if (node == nullptr) {
+          if (node == nullptr && row < 0) {
 #ifdef PADDLE_WITH_HETERPS
             if (search_level == 2) {
               VLOG(2) << "enter sample from ssd for node_id " << node_id;
@@ -1677,7 +1727,11 @@ int32_t GraphTable::random_sample_neighbors(
             continue;
           }
           std::shared_ptr<char> &buffer = buffers[idy];
-          std::vector<int> res = node->sample_k(sample_size, rng);
+          if (row >= 0) {
+            csr_sampler->sample_k(row, sample_size, rng.get(), &res);
+          } else {
+            res = node->sample_k(sample_size, rng);
+          }
           actual_size =
               res.size() * (need_weight ? (Node::id_size + Node::weight_size)
                                         : Node::id_size);
@@ -1693,11 +1747,13 @@ int32_t GraphTable::random_sample_neighbors(
             buffer.reset(buffer_addr, char_del);
           }
           for (int &x : res) {
-            id = node->get_neighbor_id(x);
+            id = row >= 0 ? csr_sampler->get_neighbor_id(row, x)
+                          : node->get_neighbor_id(x);
             memcpy(buffer_addr + offset, &id, Node::id_size);
             offset += Node::id_size;
             if (need_weight) {
-              weight = node->get_neighbor_weight(x);
+              weight = row >= 0 ? csr_sampler->get_neighbor_weight(row, x)
+                                : node->get_neighbor_weight(x);
               memcpy(buffer_addr + offset, &weight, Node::weight_size);
               offset += Node::weight_size;
             }
@@ -2122,6 +2178,7 @@ void GraphTable::load_node_weight(int type_id, int idx, std::string path) {
 int32_t GraphTable::Initialize(const GraphParameter &graph) {
   task_pool_size_ = graph.task_pool_size();
   build_sampler_on_cpu = graph.build_sampler_on_cpu();
+  use_csr_sampler = graph.use_csr_sampler();
 
 #ifdef PADDLE_WITH_HETERPS
   _db = NULL;
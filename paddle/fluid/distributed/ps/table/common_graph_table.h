@@ -41,6 +41,7 @@
 #include "paddle/fluid/distributed/ps/table/accessor.h"
 #include "paddle/fluid/distributed/ps/table/common_table.h"
 #include "paddle/fluid/distributed/ps/table/graph/class_macro.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr_sampler.h"
 #include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
 #include "paddle/fluid/string/string_helper.h"
 #include "paddle/phi/core/utils/rw_lock.h"
@@ -129,10 +130,21 @@ class GraphShard {
   std::unordered_map<uint64_t, int> &get_node_location() {
     return node_location;
   }
+  int get_node_index(uint64_t id) {
+    auto iter = node_location.find(id);
+    return iter == node_location.end() ? -1 : iter->second;
+  }
+  // Build the CSR neighbors of the bucket, used instead of the samplers of
+  // nodes. The CSR is dropped when the bucket changes, and rebuilt on the
+  // next get_csr_sampler.
+  void build_csr_sampler(const std::string &sample_type);
+  CSRNeighborSampler *get_csr_sampler();
 
  private:
   std::unordered_map<uint64_t, int> node_location;
   std::vector<Node *> bucket;
+  std::unique_ptr<CSRNeighborSampler> csr_sampler;
+  std::string csr_sample_type;
 };
 
 enum LRUResponse { ok = 0, blocked = 1, err = 2 };
@@ -691,6 +703,8 @@ class GraphTable : public Table {
 #endif
   virtual int32_t add_comm_edge(int idx, uint64_t src_id, uint64_t dst_id);
   virtual int32_t build_sampler(int idx, std::string sample_type = "random");
+  // Return the row of id in the CSR sampler of its shard, or -1.
+  int find_csr_row(int idx, uint64_t id, CSRNeighborSampler **csr_sampler);
   void set_feature_separator(const std::string &ch);
   std::vector<std::vector<GraphShard *>> edge_shards, feature_shards;
   size_t shard_start, shard_end, server_num, shard_num_per_server, shard_num;
@@ -720,6 +734,7 @@ class GraphTable : public Table {
   int cache_ttl;
   mutable std::mutex mutex_;
   bool build_sampler_on_cpu;
+  bool use_csr_sampler = false;
   std::shared_ptr<pthread_rwlock_t> rw_lock;
 #ifdef PADDLE_WITH_HETERPS
   // paddle::framework::GpuPsGraphTable gpu_graph_table;
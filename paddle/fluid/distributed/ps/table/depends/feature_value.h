@@ -15,6 +15,10 @@
 #pragma once
 
 #include <mct/hash-map.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 
 #include "gflags/gflags.h"
@@ -27,17 +31,190 @@ static const int CTR_SPARSE_SHARD_BUCKET_NUM_BITS = 6;
 static const size_t CTR_SPARSE_SHARD_BUCKET_NUM =
     static_cast<size_t>(1) << CTR_SPARSE_SHARD_BUCKET_NUM_BITS;
 
+// FixedFeatureValue keeps the values of a sparse key. The values are stored
+// inline, right after the header, when the FixedFeatureValue is allocated by
+// FixedFeatureValueSlab with an inline size, and are moved to the heap only
+// when resized beyond it (e.g., the extended mf values). The header is 16
+// bytes instead of the 24 bytes of std::vector<float>.
 class FixedFeatureValue {
  public:
-  FixedFeatureValue() {}
-  ~FixedFeatureValue() {}
-  float* data() { return _data.data(); }
-  size_t size() { return _data.size(); }
-  void resize(size_t size) { _data.resize(size); }
-  void shrink_to_fit() { _data.shrink_to_fit(); }
+  FixedFeatureValue() : _capacity(0), _on_heap(0) {}
+  explicit FixedFeatureValue(size_t inline_size)
+      : _data(inline_size > 0 ? inline_data() : nullptr),
+        _capacity(static_cast<uint32_t>(inline_size)),
+        _on_heap(0) {}
+  FixedFeatureValue(const FixedFeatureValue&) = delete;
+  ~FixedFeatureValue() {
+    if (_on_heap) {
+      free(_data);
+    }
+  }
+
+  // Copy the values only, the storage is unchanged.
+  FixedFeatureValue& operator=(const FixedFeatureValue& other) {
+    if (this != &other) {
+      resize(other._size);
+      if (_size > 0) {
+        memcpy(_data, other._data, _size * sizeof(float));
+      }
+    }
+    return *this;
+  }
+
+  float* data() { return _data; }
+  size_t size() { return _size; }
+  // Same as std::vector<float>::resize, the new values are zero.
+  void resize(size_t size) {
+    if (size > _capacity) {
+      reallocate(size);
+    }
+    if (size > _size) {
+      memset(_data + _size, 0, (size - _size) * sizeof(float));
+    }
+    _size = static_cast<uint32_t>(size);
+  }
+  void shrink_to_fit() {
+    if (_on_heap && _size < _capacity) {
+      reallocate(_size);
+    }
+  }
 
  private:
-  std::vector<float> _data;
+  float* inline_data() { return reinterpret_cast<float*>(this + 1); }
+
+  void reallocate(size_t capacity) {
+    float* data = nullptr;
+    if (capacity > 0) {
+      data = reinterpret_cast<float*>(malloc(capacity * sizeof(float)));
+      CHECK(data != nullptr) << "Failed to allocate " << capacity << " floats";
+      if (_size > 0) {
+        memcpy(
+            data, _data, std::min<size_t>(_size, capacity) * sizeof(float));
+      }
+    }
+    if (_on_heap) {
+      free(_data);
+    }
+    _data = data;
+    _capacity = static_cast<uint32_t>(capacity);
+    _on_heap = 1;
+  }
+
+  float* _data{nullptr};
+  uint32_t _size{0};
+  uint32_t _capacity : 31;
+  uint32_t _on_heap : 1;
+};
+
+static_assert(sizeof(FixedFeatureValue) == 16,
+              "The header of FixedFeatureValue should be 16 bytes");
+
+// FixedFeatureValueSlab allocates FixedFeatureValue together with its inline
+// values from large slabs owned by the shard, so that the fixed-width values
+// of the accessor do not need a heap allocation per key. The addresses of the
+// allocated values are stable until they are released. Not thread-safe, the
+// same as ChunkAllocator.
+class FixedFeatureValueSlab {
+ public:
+  explicit FixedFeatureValueSlab(size_t values_per_slab = 4096)
+      : _values_per_slab(values_per_slab) {
+    set_inline_size(0);
+  }
+  FixedFeatureValueSlab(const FixedFeatureValueSlab&) = delete;
+  ~FixedFeatureValueSlab() { release_slabs(); }
+
+  // Should be called before any value is acquired.
+  void set_inline_size(size_t inline_size) {
+    CHECK_EQ(_counter, 0UL)
+        << "Cannot change the inline size of a non-empty slab";
+    release_slabs();
+    _inline_size = inline_size;
+    _node_size = sizeof(FixedFeatureValue) + inline_size * sizeof(float);
+    _node_size = (_node_size + alignof(FixedFeatureValue) - 1) /
+                 alignof(FixedFeatureValue) * alignof(FixedFeatureValue);
+  }
+  size_t inline_size() const { return _inline_size; }
+
+  FixedFeatureValue* acquire() {
+    return new (allocate_node()) FixedFeatureValue(_inline_size);
+  }
+  FixedFeatureValue* acquire(const FixedFeatureValue& other) {
+    FixedFeatureValue* x = acquire();
+    *x = other;
+    return x;
+  }
+  void release(FixedFeatureValue* x) {
+    x->~FixedFeatureValue();
+    Node* node = reinterpret_cast<Node*>(x);
+    node->next = _free_nodes;
+    _free_nodes = node;
+    _counter--;
+  }
+  size_t size() const { return _counter; }
+  // Bytes of the slabs, used for memory statistics.
+  size_t capacity_bytes() const {
+    return _slabs.size() * _values_per_slab * _node_size;
+  }
+
+ private:
+  struct Node {
+    Node* next;
+  };
+
+  void* allocate_node() {
+    void* node = nullptr;
+    if (_free_nodes != nullptr) {
+      node = _free_nodes;
+      _free_nodes = _free_nodes->next;
+    } else {
+      if (_cursor == _end) {
+        char* slab = nullptr;
+        int ret = posix_memalign(reinterpret_cast<void**>(&slab),
+                                 64,
+                                 _values_per_slab * _node_size);
+        CHECK_EQ(ret, 0) << "Failed to allocate a slab of "
+                         << _values_per_slab << " values";
+        _slabs.push_back(slab);
+        _cursor = slab;
+        _end = slab + _values_per_slab * _node_size;
+      }
+      node = _cursor;
+      _cursor += _node_size;
+    }
+    _counter++;
+    return node;
+  }
+
+  void release_slabs() {
+    for (char* slab : _slabs) {
+      free(slab);
+    }
+    _slabs.clear();
+    _cursor = nullptr;
+    _end = nullptr;
+    _free_nodes = nullptr;
+  }
+
+  size_t _values_per_slab;
+  size_t _inline_size{0};
+  size_t _node_size{0};
+  std::vector<char*> _slabs;
+  // the unused part of the last slab
+  char* _cursor{nullptr};
+  char* _end{nullptr};
+  Node* _free_nodes{nullptr};
+  size_t _counter{0};  // how many values are acquired
+};
+
+// SparseTableShard allocates the values by ChunkAllocator by default.
+template <class VALUE>
+struct SparseValueAllocator {
+  typedef ChunkAllocator<VALUE> type;
+};
+
+template <>
+struct SparseValueAllocator<FixedFeatureValue> {
+  typedef FixedFeatureValueSlab type;
 };
 
 template <class KEY, class VALUE>
@@ -99,6 +276,9 @@ struct alignas(64) SparseTableShard {
       _buckets[bucket].max_load_factor(x);
     }
   }
+  // Only for the values supporting inline storage, i.e., FixedFeatureValue.
+  // Should be called when the shard is empty.
+  void set_value_inline_size(size_t size) { _alloc.set_inline_size(size); }
   size_t bucket_count() { return CTR_SPARSE_SHARD_BUCKET_NUM; }
   size_t bucket_size(size_t bucket) { return _buckets[bucket].size(); }
   void clear() {
@@ -194,7 +374,7 @@ struct alignas(64) SparseTableShard {
 
  private:
   map_type _buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
-  ChunkAllocator<VALUE> _alloc;
+  typename SparseValueAllocator<VALUE>::type _alloc;
   std::hash<KEY> _hasher;
 };
 
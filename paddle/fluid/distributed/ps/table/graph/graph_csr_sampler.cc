@@ -0,0 +1,216 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace paddle {
+namespace distributed {
+
+// Samples more than this are drawn with O(n) algorithms instead of
+// rejecting the duplicated neighbors.
+static constexpr int kMaxRejectionSampleSize = 64;
+
+static bool contains(const std::vector<int> &res, int idx) {
+  return std::find(res.begin(), res.end(), idx) != res.end();
+}
+
+void CSRNeighborSampler::build(const std::vector<Node *> &bucket,
+                               bool is_weighted) {
+  size_t edge_num = 0;
+  for (auto node : bucket) {
+    edge_num += node->get_neighbor_size();
+  }
+  offsets.clear();
+  offsets.reserve(bucket.size() + 1);
+  offsets.push_back(0);
+  neighbor_ids.clear();
+  neighbor_ids.reserve(edge_num);
+  weights.clear();
+  weights.reserve(edge_num);
+  bool all_one = true;
+  for (auto node : bucket) {
+    size_t neighbor_size = node->get_neighbor_size();
+    for (size_t j = 0; j < neighbor_size; j++) {
+      neighbor_ids.push_back(node->get_neighbor_id(j));
+      float weight = node->get_neighbor_weight(j);
+      all_one = all_one && weight == 1;
+      weights.push_back(weight);
+    }
+    offsets.push_back(neighbor_ids.size());
+  }
+  if (all_one) {
+    std::vector<float>().swap(weights);
+  }
+
+  std::vector<float>().swap(alias_prob);
+  std::vector<uint32_t>().swap(alias_idx);
+  if (!is_weighted || weights.empty()) {
+    return;
+  }
+
+  // Vose's alias method
+  alias_prob.resize(edge_num);
+  alias_idx.resize(edge_num);
+  std::vector<double> scaled;
+  std::vector<int> small, large;
+  for (size_t row = 0; row + 1 < offsets.size(); row++) {
+    uint64_t start = offsets[row];
+    int n = offsets[row + 1] - start;
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += std::max(weights[start + i], 0.f);
+    }
+    scaled.resize(n);
+    small.clear();
+    large.clear();
+    for (int i = 0; i < n; i++) {
+      scaled[i] =
+          sum > 0 ? std::max(weights[start + i], 0.f) * n / sum : 1.0;
+      if (scaled[i] < 1.0) {
+        small.push_back(i);
+      } else {
+        large.push_back(i);
+      }
+    }
+    while (!small.empty() && !large.empty()) {
+      int s = small.back();
+      int l = large.back();
+      small.pop_back();
+      alias_prob[start + s] = scaled[s];
+      alias_idx[start + s] = l;
+      scaled[l] -= 1.0 - scaled[s];
+      if (scaled[l] < 1.0) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // the rest are 1 except rounding errors
+    for (auto list : {&small, &large}) {
+      for (int i : *list) {
+        alias_prob[start + i] = 1.0;
+        alias_idx[start + i] = i;
+      }
+    }
+  }
+}
+
+int CSRNeighborSampler::sample_one(uint64_t start,
+                                   int n,
+                                   std::mt19937_64 *rng) const {
+  std::uniform_int_distribution<int> int_distrib(0, n - 1);
+  std::uniform_real_distribution<float> real_distrib(0, 1.0);
+  int idx = int_distrib(*rng);
+  return real_distrib(*rng) < alias_prob[start + idx] ? idx
+                                                       : alias_idx[start + idx];
+}
+
+// Weighted sampling without replacement by the keys u^(1/w) (Efraimidis and
+// Spirakis), the neighbors already in res are kept and excluded.
+void CSRNeighborSampler::sample_by_keys(uint64_t start,
+                                        int n,
+                                        int k,
+                                        std::mt19937_64 *rng,
+                                        std::vector<int> *res) const {
+  thread_local std::vector<std::pair<float, int>> keys;
+  std::uniform_real_distribution<float> distrib(0, 1.0);
+  keys.clear();
+  for (int i = 0; i < n; i++) {
+    if (contains(*res, i)) {
+      continue;
+    }
+    float weight = weights[start + i];
+    // log(u) / w, u in (0, 1]
+    float key = weight > 0 ? std::log(1.0f - distrib(*rng)) / weight
+                           : -std::numeric_limits<float>::infinity();
+    keys.emplace_back(key, i);
+  }
+  size_t left = k - res->size();
+  std::nth_element(keys.begin(),
+                   keys.begin() + left - 1,
+                   keys.end(),
+                   std::greater<std::pair<float, int>>());
+  for (size_t i = 0; i < left; i++) {
+    res->push_back(keys[i].second);
+  }
+}
+
+void CSRNeighborSampler::sample_k(int row,
+                                  int k,
+                                  std::mt19937_64 *rng,
+                                  std::vector<int> *res) const {
+  res->clear();
+  uint64_t start = offsets[row];
+  int n = offsets[row + 1] - start;
+  if (k >= n) {
+    for (int i = 0; i < n; i++) {
+      res->push_back(i);
+    }
+    return;
+  }
+
+  if (alias_prob.empty()) {
+    if (k <= kMaxRejectionSampleSize) {
+      // Floyd's algorithm
+      for (int j = n - k; j < n; j++) {
+        std::uniform_int_distribution<int> distrib(0, j);
+        int idx = distrib(*rng);
+        res->push_back(contains(*res, idx) ? j : idx);
+      }
+    } else {
+      thread_local std::vector<int> perm;
+      perm.resize(n);
+      std::iota(perm.begin(), perm.end(), 0);
+      for (int i = 0; i < k; i++) {
+        std::uniform_int_distribution<int> distrib(i, n - 1);
+        std::swap(perm[i], perm[distrib(*rng)]);
+      }
+      res->assign(perm.begin(), perm.begin() + k);
+    }
+    return;
+  }
+
+  if (k <= kMaxRejectionSampleSize && 2 * k <= n) {
+    // Drawing from the alias table and rejecting the sampled neighbors is
+    // the same as drawing from the neighbors left. Fall back to the keys if
+    // the neighbors left are too light to be drawn.
+    int max_tries = 4 * k + 16;
+    for (int tries = 0; tries < max_tries && static_cast<int>(res->size()) < k;
+         tries++) {
+      int idx = sample_one(start, n, rng);
+      if (!contains(*res, idx)) {
+        res->push_back(idx);
+      }
+    }
+    if (static_cast<int>(res->size()) == k) {
+      return;
+    }
+  }
+  sample_by_keys(start, n, k, rng, res);
+}
+
+size_t CSRNeighborSampler::get_memory_size() const {
+  return offsets.capacity() * sizeof(uint64_t) +
+         neighbor_ids.capacity() * sizeof(uint64_t) +
+         weights.capacity() * sizeof(float) +
+         alias_prob.capacity() * sizeof(float) +
+         alias_idx.capacity() * sizeof(uint32_t);
+}
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,69 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
+namespace paddle {
+namespace distributed {
+
+// CSRNeighborSampler stores the neighbors of all the nodes in a shard in
+// CSR arrays, the i-th row holds the neighbors of the i-th node of the
+// bucket. For the "weighted" sample type, a Walker alias table is built for
+// every row, so that a weighted neighbor is drawn in O(1).
+class CSRNeighborSampler {
+ public:
+  CSRNeighborSampler() {}
+  void build(const std::vector<Node *> &bucket, bool is_weighted);
+
+  size_t get_row_num() const { return offsets.size() - 1; }
+  size_t get_neighbor_size(int row) const {
+    return offsets[row + 1] - offsets[row];
+  }
+  uint64_t get_neighbor_id(int row, int idx) const {
+    return neighbor_ids[offsets[row] + idx];
+  }
+  float get_neighbor_weight(int row, int idx) const {
+    return weights.empty() ? 1. : weights[offsets[row] + idx];
+  }
+  // Sample k distinct neighbors of row, the indices of the neighbors in the
+  // row are put into res. All the neighbors are returned if k is not less
+  // than the neighbor size, like Sampler::sample_k.
+  void sample_k(int row,
+                int k,
+                std::mt19937_64 *rng,
+                std::vector<int> *res) const;
+  size_t get_memory_size() const;
+
+ private:
+  int sample_one(uint64_t start, int n, std::mt19937_64 *rng) const;
+  void sample_by_keys(uint64_t start,
+                      int n,
+                      int k,
+                      std::mt19937_64 *rng,
+                      std::vector<int> *res) const;
+
+  std::vector<uint64_t> offsets{0};
+  std::vector<uint64_t> neighbor_ids;
+  // empty if all the weights are 1
+  std::vector<float> weights;
+  // empty if not weighted
+  std::vector<float> alias_prob;
+  std::vector<uint32_t> alias_idx;
+};
+}  // namespace distributed
+}  // namespace paddle
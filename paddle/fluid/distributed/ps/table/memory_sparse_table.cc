@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <omp.h>
+
+#include <cstring>
 #include <sstream>
 
 #include "glog/logging.h"
@@ -53,6 +55,27 @@ int32_t MemorySparseTable::Initialize() {
   return 0;
 }
 
+MemorySparseTable::shard_type *MemorySparseTable::CreateShards(
+    size_t shard_num) {
+  const auto &info = _value_accesor->GetAccessorInfo();
+  size_t inline_size = (info.size - info.mf_size) / sizeof(float);
+  auto *shards = new shard_type[shard_num];
+  for (size_t i = 0; i < shard_num; ++i) {
+    shards[i].set_value_inline_size(inline_size);
+  }
+  return shards;
+}
+
+SparseShardFileHeader MemorySparseTable::ShardFileHeader() {
+  const auto &info = _value_accesor->GetAccessorInfo();
+  SparseShardFileHeader header;
+  header.value_dim = info.dim;
+  header.value_size = info.size;
+  header.mf_size = info.mf_size;
+  header.SetAccessorClass(_config.accessor().accessor_class());
+  return header;
+}
+
 int32_t MemorySparseTable::InitializeValue() {
   _sparse_table_shard_num = static_cast<int>(_config.shard_num());
   _avg_local_shard_num =
@@ -73,7 +96,7 @@ int32_t MemorySparseTable::InitializeValue() {
           << " _real_local_shard_num: " << _real_local_shard_num
           << " _task_pool_size:" << _task_pool_size;
 
-  _local_shards.reset(new shard_type[_real_local_shard_num]);
+  _local_shards.reset(CreateShards(_real_local_shard_num));
 
   if (_config.enable_revert()) {
     // calculate merged shard number based on config param;
@@ -97,7 +120,7 @@ int32_t MemorySparseTable::InitializeValue() {
     LOG(INFO) << "merged shard info: [" << _m_sparse_table_shard_num << "|"
               << _m_avg_local_shard_num << "|" << _m_real_local_shard_num
               << "]";
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);
+    _local_shards_new.reset(CreateShards(_real_local_shard_num));
   }
   return 0;
 }
@@ -145,6 +168,10 @@ int32_t MemorySparseTable::Load(const std::string &path,
     channel_config.path = file_list[file_start_idx + i];
     VLOG(1) << "MemorySparseTable::load begin load " << channel_config.path
             << " into local shard " << i;
+    if (IsSparseShardBinaryFile(channel_config.path)) {
+      LoadBinaryShard(channel_config.path, &_local_shards[i]);
+      continue;
+    }
     channel_config.converter = _value_accesor->Converter(load_param).converter;
     channel_config.deconverter =
         _value_accesor->Converter(load_param).deconverter;
@@ -200,6 +227,37 @@ int32_t MemorySparseTable::Load(const std::string &path,
   return 0;
 }
 
+int32_t MemorySparseTable::LoadBinaryShard(const std::string &path,
+                                           shard_type *shard) {
+  // the binary files are written without the converters of the accessor
+  FsChannelConfig channel_config;
+  channel_config.path = path;
+  auto file_header = ShardFileHeader();
+  auto handler = [shard](const uint64_t *keys,
+                         const float *values,
+                         uint32_t key_num,
+                         uint32_t dim) {
+    for (uint32_t k = 0; k < key_num; ++k) {
+      auto &value = (*shard)[keys[k]];
+      value.resize(dim);
+      memcpy(value.data(), values + k * dim, dim * sizeof(float));
+    }
+  };
+  int retry_num = 0;
+  while (ReadSparseShardFile(
+             &_afs_client, channel_config, file_header, handler) != 0) {
+    ++retry_num;
+    LOG(ERROR) << "MemorySparseTable load binary failed, retry it! path:"
+               << path << " , retry_num=" << retry_num;
+    if (retry_num > FLAGS_pserver_table_save_max_retry) {
+      LOG(ERROR) << "MemorySparseTable load failed reach max limit!";
+      exit(-1);
+    }
+  }
+  VLOG(1) << "MemorySparseTable load binary success, path:" << path;
+  return 0;
+}
+
 int32_t MemorySparseTable::LoadPatch(const std::vector<std::string> &file_list,
                                      int load_param) {
   if (!_config.enable_revert()) {
@@ -323,7 +381,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   // patch model
   if (save_param == 5) {
     _local_shards_patch_model.reset(_local_shards_new.release());
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);
+    _local_shards_new.reset(CreateShards(_real_local_shard_num));
     _save_patch_model_thread = std::thread(std::bind(
         &MemorySparseTable::SavePatch, this, std::string(dirname), save_param));
     return 0;
@@ -339,6 +397,10 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   std::atomic<uint32_t> feasign_size_all{0};
 
   size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  // only the checkpoints are saved in binary, xbox models are for tooling
+  bool is_binary =
+      _config.binary_in_save() && (save_param == 0 || save_param == 3);
+  auto file_header = ShardFileHeader();
 
 #ifdef PADDLE_WITH_GPU_GRAPH
   int thread_num = _real_local_shard_num;
@@ -349,21 +411,22 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
 #pragma omp parallel for schedule(dynamic)
   for (int i = 0; i < _real_local_shard_num; ++i) {
     FsChannelConfig channel_config;
+    std::string suffix = is_binary ? ".bin" : "";
     if (_config.compress_in_save() && (save_param == 0 || save_param == 3)) {
-      channel_config.path =
-          paddle::string::format_string("%s/part-%03d-%05d.gz",
-                                        table_path.c_str(),
-                                        _shard_idx,
-                                        file_start_idx + i);
-    } else {
-      channel_config.path = paddle::string::format_string("%s/part-%03d-%05d",
-                                                          table_path.c_str(),
-                                                          _shard_idx,
-                                                          file_start_idx + i);
+      suffix += ".gz";
+    }
+    channel_config.path =
+        paddle::string::format_string("%s/part-%03d-%05d%s",
+                                      table_path.c_str(),
+                                      _shard_idx,
+                                      file_start_idx + i,
+                                      suffix.c_str());
+    if (!is_binary) {
+      channel_config.converter =
+          _value_accesor->Converter(save_param).converter;
+      channel_config.deconverter =
+          _value_accesor->Converter(save_param).deconverter;
     }
-    channel_config.converter = _value_accesor->Converter(save_param).converter;
-    channel_config.deconverter =
-        _value_accesor->Converter(save_param).deconverter;
     bool is_write_failed = false;
     int feasign_size = 0;
     int retry_num = 0;
@@ -375,7 +438,15 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
       is_write_failed = false;
       auto write_channel =
           _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
-      for (auto it = shard.begin(); it != shard.end(); ++it) {
+      SparseShardFileWriter writer(write_channel.get(), file_header);
+      if (is_binary && writer.WriteHeader() != 0) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "MemorySparseTable save header failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
+      for (auto it = shard.begin(); !is_write_failed && it != shard.end();
+           ++it) {
         if (_config.enable_sparse_table_cache() &&
             (save_param == 1 || save_param == 2) &&
             _value_accesor->Save(it.value().data(), 4)) {
@@ -384,10 +455,16 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
         }
 
         if (_value_accesor->Save(it.value().data(), save_param)) {
-          std::string format_value = _value_accesor->ParseToString(
-              it.value().data(), it.value().size());
-          if (0 != write_channel->write_line(paddle::string::format_string(
-                       "%lu %s", it.key(), format_value.c_str()))) {
+          int ret = 0;
+          if (is_binary) {
+            ret = writer.Append(it.key(), it.value().data(), it.value().size());
+          } else {
+            std::string format_value = _value_accesor->ParseToString(
+                it.value().data(), it.value().size());
+            ret = write_channel->write_line(paddle::string::format_string(
+                "%lu %s", it.key(), format_value.c_str()));
+          }
+          if (0 != ret) {
             ++retry_num;
             is_write_failed = true;
             LOG(ERROR)
@@ -398,6 +475,12 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
           ++feasign_size;
         }
       }
+      if (is_binary && !is_write_failed && writer.Finish() != 0) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "MemorySparseTable save blocks failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
       write_channel->close();
       if (err_no == -1) {
         ++retry_num;
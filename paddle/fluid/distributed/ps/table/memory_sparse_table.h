@@ -29,6 +29,7 @@
 #include "paddle/fluid/distributed/ps/table/accessor.h"
 #include "paddle/fluid/distributed/ps/table/common_table.h"
 #include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
+#include "paddle/fluid/distributed/ps/table/sparse_shard_file.h"
 #include "paddle/fluid/string/string_helper.h"
 
 #define PSERVER_SAVE_SUFFIX ".shard"
@@ -111,6 +112,12 @@ class MemorySparseTable : public Table {
   virtual int32_t SavePatch(const std::string& path, int save_param);
   virtual int32_t LoadPatch(const std::vector<std::string>& file_list,
                             int save_param);
+  // Create shards whose values without mf are stored inline.
+  shard_type* CreateShards(size_t shard_num);
+  // Header of the binary shard files, recording the layout of the accessor.
+  SparseShardFileHeader ShardFileHeader();
+  // Load a binary shard file into shard, with retries.
+  int32_t LoadBinaryShard(const std::string& path, shard_type* shard);
 
   int _task_pool_size = 24;
   int _avg_local_shard_num;
@@ -0,0 +1,256 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/sparse_shard_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/io/fs.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+struct BlockHeader {
+  uint32_t key_num;
+  uint32_t dim;
+};
+
+bool EndWith(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// the values are padded to 8 bytes to align the keys of the next block
+size_t PaddedValueNum(uint32_t key_num, uint32_t dim) {
+  size_t value_num = static_cast<size_t>(key_num) * dim;
+  return (value_num + 1) / 2 * 2;
+}
+
+int32_t ReadMappedFile(const std::string& path,
+                       const SparseShardFileHeader& expected,
+                       const SparseShardBlockHandler& handler) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(ERROR) << "open sparse shard file failed, path:" << path;
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(SparseShardFileHeader)) {
+    LOG(ERROR) << "sparse shard file is truncated, path:" << path;
+    close(fd);
+    return -1;
+  }
+  size_t file_size = st.st_size;
+  void* addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    LOG(ERROR) << "mmap sparse shard file failed, path:" << path;
+    return -1;
+  }
+  madvise(addr, file_size, MADV_SEQUENTIAL);
+
+  const char* data = static_cast<const char*>(addr);
+  const auto* header = reinterpret_cast<const SparseShardFileHeader*>(data);
+  std::string reason = expected.CheckLayout(*header);
+  if (!reason.empty()) {
+    LOG(ERROR) << "sparse shard file " << path
+               << " mismatches the table: " << reason;
+    munmap(addr, file_size);
+    return -1;
+  }
+
+  int32_t ret = -1;
+  size_t offset = sizeof(SparseShardFileHeader);
+  while (offset + sizeof(BlockHeader) <= file_size) {
+    const auto* block = reinterpret_cast<const BlockHeader*>(data + offset);
+    offset += sizeof(BlockHeader);
+    if (block->key_num == 0) {
+      ret = 0;
+      break;
+    }
+    size_t keys_bytes = block->key_num * sizeof(uint64_t);
+    size_t values_bytes =
+        PaddedValueNum(block->key_num, block->dim) * sizeof(float);
+    if (offset + keys_bytes + values_bytes > file_size) {
+      break;
+    }
+    handler(reinterpret_cast<const uint64_t*>(data + offset),
+            reinterpret_cast<const float*>(data + offset + keys_bytes),
+            block->key_num,
+            block->dim);
+    offset += keys_bytes + values_bytes;
+  }
+  munmap(addr, file_size);
+  if (ret != 0) {
+    LOG(ERROR) << "sparse shard file is truncated, path:" << path;
+  }
+  return ret;
+}
+
+int32_t ReadStreamFile(AfsClient* afs_client,
+                       const FsChannelConfig& config,
+                       const SparseShardFileHeader& expected,
+                       const SparseShardBlockHandler& handler) {
+  int err_no = 0;
+  auto read_channel = afs_client->open_r(config, 0, &err_no);
+  SparseShardFileHeader header;
+  if (read_channel->read(reinterpret_cast<char*>(&header), sizeof(header)) !=
+      0) {
+    LOG(ERROR) << "read sparse shard file header failed, path:"
+               << config.path;
+    read_channel->close();
+    return -1;
+  }
+  std::string reason = expected.CheckLayout(header);
+  if (!reason.empty()) {
+    LOG(ERROR) << "sparse shard file " << config.path
+               << " mismatches the table: " << reason;
+    read_channel->close();
+    return -1;
+  }
+
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  int32_t ret = -1;
+  BlockHeader block;
+  while (read_channel->read(reinterpret_cast<char*>(&block), sizeof(block)) ==
+         0) {
+    if (block.key_num == 0) {
+      ret = 0;
+      break;
+    }
+    keys.resize(block.key_num);
+    values.resize(PaddedValueNum(block.key_num, block.dim));
+    if (read_channel->read(reinterpret_cast<char*>(keys.data()),
+                           keys.size() * sizeof(uint64_t)) != 0 ||
+        read_channel->read(reinterpret_cast<char*>(values.data()),
+                           values.size() * sizeof(float)) != 0) {
+      break;
+    }
+    handler(keys.data(), values.data(), block.key_num, block.dim);
+  }
+  read_channel->close();
+  if (ret != 0 || err_no == -1) {
+    LOG(ERROR) << "read sparse shard file failed, path:" << config.path;
+    return -1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+void SparseShardFileHeader::SetAccessorClass(const std::string& name) {
+  memset(accessor_class, 0, sizeof(accessor_class));
+  strncpy(accessor_class, name.c_str(), sizeof(accessor_class) - 1);
+}
+
+std::string SparseShardFileHeader::CheckLayout(
+    const SparseShardFileHeader& other) const {
+  if (other.magic != magic) {
+    return "bad magic number";
+  }
+  if (other.version != version) {
+    return "version " + std::to_string(other.version) + " vs " +
+           std::to_string(version);
+  }
+  if (other.value_dim != value_dim || other.value_size != value_size ||
+      other.mf_size != mf_size) {
+    return "value dim/size/mf_size " + std::to_string(other.value_dim) + "/" +
+           std::to_string(other.value_size) + "/" +
+           std::to_string(other.mf_size) + " vs " + std::to_string(value_dim) +
+           "/" + std::to_string(value_size) + "/" + std::to_string(mf_size);
+  }
+  if (strncmp(other.accessor_class,
+              accessor_class,
+              sizeof(accessor_class)) != 0) {
+    return std::string("accessor ") + other.accessor_class + " vs " +
+           accessor_class;
+  }
+  return "";
+}
+
+bool IsSparseShardBinaryFile(const std::string& path) {
+  return EndWith(path, ".bin") || EndWith(path, ".bin.gz");
+}
+
+int32_t SparseShardFileWriter::WriteHeader() {
+  return _channel->write(reinterpret_cast<const char*>(&_header),
+                         sizeof(_header));
+}
+
+int32_t SparseShardFileWriter::Append(uint64_t key,
+                                      const float* value,
+                                      uint32_t dim) {
+  auto& block = _blocks[dim];
+  block.keys.push_back(key);
+  block.values.insert(block.values.end(), value, value + dim);
+  if (block.keys.size() >= kSparseShardFileBlockKeyNum) {
+    return FlushBlock(dim, &block);
+  }
+  return 0;
+}
+
+int32_t SparseShardFileWriter::FlushBlock(uint32_t dim, Block* block) {
+  if (block->keys.empty()) {
+    return 0;
+  }
+  BlockHeader block_header{static_cast<uint32_t>(block->keys.size()), dim};
+  block->values.resize(PaddedValueNum(block_header.key_num, dim), 0.0f);
+  int32_t ret =
+      _channel->write(reinterpret_cast<const char*>(&block_header),
+                      sizeof(block_header)) ||
+      _channel->write(reinterpret_cast<const char*>(block->keys.data()),
+                      block->keys.size() * sizeof(uint64_t)) ||
+      _channel->write(reinterpret_cast<const char*>(block->values.data()),
+                      block->values.size() * sizeof(float));
+  block->keys.clear();
+  block->values.clear();
+  return ret == 0 ? 0 : -1;
+}
+
+int32_t SparseShardFileWriter::Finish() {
+  for (auto& item : _blocks) {
+    if (FlushBlock(item.first, &item.second) != 0) {
+      return -1;
+    }
+  }
+  BlockHeader end_block{0, 0};
+  return _channel->write(reinterpret_cast<const char*>(&end_block),
+                         sizeof(end_block)) == 0
+             ? 0
+             : -1;
+}
+
+int32_t ReadSparseShardFile(AfsClient* afs_client,
+                            const FsChannelConfig& config,
+                            const SparseShardFileHeader& expected,
+                            const SparseShardBlockHandler& handler) {
+  if (paddle::framework::fs_select_internal(config.path) == 0 &&
+      !EndWith(config.path, ".gz") && config.deconverter.empty()) {
+    return ReadMappedFile(config.path, expected, handler);
+  }
+  return ReadStreamFile(afs_client, config, expected, handler);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,104 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/distributed/common/afs_warpper.h"
+
+namespace paddle {
+namespace distributed {
+
+/*
+ * Binary format of a sparse table shard file:
+ *
+ *   SparseShardFileHeader
+ *   block 0: uint32 key_num | uint32 dim | uint64 keys[key_num] |
+ *            float values[key_num * dim] | padding to 8 bytes
+ *   block 1: ...
+ *   end block: key_num == 0
+ *
+ * All the values in a block have the same dim, so the values without mf and
+ * the values with mf go to different blocks. The keys and the values of a
+ * block are stored contiguously and 8-byte aligned, so that a mapped file
+ * can be used in place.
+ */
+static constexpr uint32_t kSparseShardFileMagic = 0x42535350;  // "PSSB"
+static constexpr uint32_t kSparseShardFileVersion = 1;
+static constexpr uint32_t kSparseShardFileBlockKeyNum = 8192;
+
+struct SparseShardFileHeader {
+  uint32_t magic{kSparseShardFileMagic};
+  uint32_t version{kSparseShardFileVersion};
+  // layout of the accessor, see AccessorInfo
+  uint32_t value_dim{0};
+  uint32_t value_size{0};
+  uint32_t mf_size{0};
+  uint32_t reserved{0};
+  char accessor_class[104] = {0};
+
+  void SetAccessorClass(const std::string& name);
+  // Return an empty string if the layout of other matches, or the reason.
+  std::string CheckLayout(const SparseShardFileHeader& other) const;
+};
+static_assert(sizeof(SparseShardFileHeader) == 128,
+              "the size of SparseShardFileHeader should be 128 bytes");
+
+// Return true if path is a binary shard file, e.g. part-000-00000.bin.gz
+bool IsSparseShardBinaryFile(const std::string& path);
+
+class SparseShardFileWriter {
+ public:
+  SparseShardFileWriter(FsWriteChannel* channel,
+                        const SparseShardFileHeader& header)
+      : _channel(channel), _header(header) {}
+
+  // Return 0 if success, the values are buffered until a block is full.
+  int32_t WriteHeader();
+  int32_t Append(uint64_t key, const float* value, uint32_t dim);
+  // Flush all the blocks and write the end block.
+  int32_t Finish();
+
+ private:
+  struct Block {
+    std::vector<uint64_t> keys;
+    std::vector<float> values;
+  };
+  int32_t FlushBlock(uint32_t dim, Block* block);
+
+  FsWriteChannel* _channel;
+  SparseShardFileHeader _header;
+  std::map<uint32_t, Block> _blocks;
+};
+
+// Called once per block with key_num keys and key_num * dim values.
+using SparseShardBlockHandler = std::function<void(
+    const uint64_t* keys, const float* values, uint32_t key_num, uint32_t dim)>;
+
+// Read a binary shard file written by SparseShardFileWriter. A plain local
+// file is mapped into memory and the blocks are passed to handler in place,
+// others (remote or compressed) are streamed through the read channel.
+// The layout in the file header must match expected. Return 0 if success,
+// -1 if the file is unreadable, truncated or of another layout.
+int32_t ReadSparseShardFile(AfsClient* afs_client,
+                            const FsChannelConfig& config,
+                            const SparseShardFileHeader& expected,
+                            const SparseShardBlockHandler& handler);
+
+}  // namespace distributed
+}  // namespace paddle
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/distributed/ps/table/ssd_sparse_table.h"
 
+#include <atomic>
+
 #include "paddle/fluid/distributed/common/cost_timer.h"
 #include "paddle/fluid/distributed/common/local_random.h"
 #include "paddle/fluid/distributed/common/topk_calculator.h"
@@ -23,6 +25,7 @@
 DECLARE_bool(pserver_print_missed_key_num_every_push);
 DECLARE_bool(pserver_create_value_when_push);
 DECLARE_bool(pserver_enable_create_feasign_randomly);
+DECLARE_int32(pserver_table_save_max_retry);
 DEFINE_bool(pserver_open_strict_check, false, "pserver_open_strict_check");
 DEFINE_string(rocksdb_path, "database", "path of sparse table rocksdb file");
 DEFINE_int32(pserver_load_batch_size, 5000, "load batch size for ssd");
@@ -546,6 +549,10 @@ int32_t SSDSparseTable::Save(const std::string& path,
   _cache_tk_size = LocalSize() * _config.sparse_table_cache_rate();
   TopkCalculator tk(_real_local_shard_num, _cache_tk_size);
   size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  // only the checkpoints are saved in binary, xbox models are for tooling
+  bool is_binary =
+      _config.binary_in_save() && (save_param == 0 || save_param == 3);
+  auto file_header = ShardFileHeader();
   std::string table_path = TableDir(path);
   _afs_client.remove(paddle::string::format_string(
       "%s/part-%03d-*", table_path.c_str(), _shard_idx));
@@ -559,21 +566,22 @@ int32_t SSDSparseTable::Save(const std::string& path,
 #pragma omp parallel for schedule(dynamic)
   for (int i = 0; i < _real_local_shard_num; ++i) {
     FsChannelConfig channel_config;
+    std::string suffix = is_binary ? ".bin" : "";
     if (_config.compress_in_save() && (save_param == 0 || save_param == 3)) {
-      channel_config.path =
-          paddle::string::format_string("%s/part-%03d-%05d.gz",
-                                        table_path.c_str(),
-                                        _shard_idx,
-                                        file_start_idx + i);
-    } else {
-      channel_config.path = paddle::string::format_string("%s/part-%03d-%05d",
-                                                          table_path.c_str(),
-                                                          _shard_idx,
-                                                          file_start_idx + i);
+      suffix += ".gz";
+    }
+    channel_config.path =
+        paddle::string::format_string("%s/part-%03d-%05d%s",
+                                      table_path.c_str(),
+                                      _shard_idx,
+                                      file_start_idx + i,
+                                      suffix.c_str());
+    if (!is_binary) {
+      channel_config.converter =
+          _value_accesor->Converter(save_param).converter;
+      channel_config.deconverter =
+          _value_accesor->Converter(save_param).deconverter;
     }
-    channel_config.converter = _value_accesor->Converter(save_param).converter;
-    channel_config.deconverter =
-        _value_accesor->Converter(save_param).deconverter;
     int err_no = 0;
     int retry_num = 0;
     bool is_write_failed = false;
@@ -585,7 +593,15 @@ int32_t SSDSparseTable::Save(const std::string& path,
       is_write_failed = false;
       auto write_channel =
           _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
-      for (auto it = shard.begin(); it != shard.end(); ++it) {
+      SparseShardFileWriter writer(write_channel.get(), file_header);
+      if (is_binary && writer.WriteHeader() != 0) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "SSDSparseTable save header failed, retry it! path:"
+                   << channel_config.path << ", retry_num=" << retry_num;
+      }
+      for (auto it = shard.begin(); !is_write_failed && it != shard.end();
+           ++it) {
         if (_config.enable_sparse_table_cache() &&
             (save_param == 1 || save_param == 2) &&
             _value_accesor->Save(it.value().data(), 4)) {
@@ -593,10 +609,16 @@ int32_t SSDSparseTable::Save(const std::string& path,
           tk.push(i, _value_accesor->GetField(it.value().data(), "show"));
         }
         if (_value_accesor->Save(it.value().data(), save_param)) {
-          std::string format_value = _value_accesor->ParseToString(
-              it.value().data(), it.value().size());
-          if (0 != write_channel->write_line(paddle::string::format_string(
-                       "%lu %s", it.key(), format_value.c_str()))) {
+          int ret = 0;
+          if (is_binary) {
+            ret = writer.Append(it.key(), it.value().data(), it.value().size());
+          } else {
+            std::string format_value = _value_accesor->ParseToString(
+                it.value().data(), it.value().size());
+            ret = write_channel->write_line(paddle::string::format_string(
+                "%lu %s", it.key(), format_value.c_str()));
+          }
+          if (0 != ret) {
             ++retry_num;
             is_write_failed = true;
             LOG(ERROR) << "SSDSparseTable save failed, retry it! path:"
@@ -628,13 +650,20 @@ int32_t SSDSparseTable::Save(const std::string& path,
           _value_accesor->UpdateStatAfterSave(
               paddle::string::str_to_float(it->value().data()), save_param);
           if (need_save) {
-            std::string format_value = _value_accesor->ParseToString(
-                paddle::string::str_to_float(it->value().data()),
-                it->value().size() / sizeof(float));
-            if (0 != write_channel->write_line(paddle::string::format_string(
-                         "%lu %s",
-                         *((uint64_t*)const_cast<char*>(it->key().data())),
-                         format_value.c_str()))) {
+            uint64_t key = *((uint64_t*)const_cast<char*>(it->key().data()));
+            const float* value =
+                paddle::string::str_to_float(it->value().data());
+            uint32_t dim = it->value().size() / sizeof(float);
+            int ret = 0;
+            if (is_binary) {
+              ret = writer.Append(key, value, dim);
+            } else {
+              std::string format_value =
+                  _value_accesor->ParseToString(value, dim);
+              ret = write_channel->write_line(paddle::string::format_string(
+                  "%lu %s", key, format_value.c_str()));
+            }
+            if (0 != ret) {
               ++retry_num;
               is_write_failed = true;
               LOG(ERROR) << "SSDSparseTable save failed, retry it! path:"
@@ -653,6 +682,12 @@ int32_t SSDSparseTable::Save(const std::string& path,
         }
         delete it;
       }
+      if (is_binary && !is_write_failed && writer.Finish() != 0) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "SSDSparseTable save blocks failed, retry it! path:"
+                   << channel_config.path << ", retry_num=" << retry_num;
+      }
 
       write_channel->close();
       if (err_no == -1) {
@@ -879,8 +914,15 @@ int32_t SSDSparseTable::Load(size_t start_idx,
                 : _sparse_table_shard_num;
   int thread_num = (end_idx - start_idx) < 20 ? (end_idx - start_idx) : 20;
   omp_set_num_threads(thread_num);
+  std::atomic<bool> binary_load_failed{false};
 #pragma omp parallel for schedule(dynamic)
   for (size_t i = start_idx; i < end_idx; ++i) {
+    if (IsSparseShardBinaryFile(file_list[i])) {
+      if (LoadBinaryShardToSSD(file_list[i], i % _avg_local_shard_num) != 0) {
+        binary_load_failed = true;
+      }
+      continue;
+    }
     FsChannelConfig channel_config;
     channel_config.path = file_list[i];
     channel_config.converter = _value_accesor->Converter(load_param).converter;
@@ -986,6 +1028,11 @@ int32_t SSDSparseTable::Load(size_t start_idx,
       }
     } while (is_read_failed);
   }
+  if (binary_load_failed) {
+    LOG(ERROR) << "SSDSparseTable load binary shard files failed, path from "
+               << file_list[start_idx] << " to " << file_list[end_idx - 1];
+    return -1;
+  }
   LOG(INFO) << "load num:" << LocalSize();
   LOG(INFO) << "SSDSparseTable load success, path from " << file_list[start_idx]
             << " to " << file_list[end_idx - 1];
@@ -994,5 +1041,62 @@ int32_t SSDSparseTable::Load(size_t start_idx,
   return 0;
 }
 
+int32_t SSDSparseTable::LoadBinaryShardToSSD(const std::string& path,
+                                             int local_shard_id) {
+  FsChannelConfig channel_config;
+  channel_config.path = path;
+  auto file_header = ShardFileHeader();
+  auto& shard = _local_shards[local_shard_id];
+  uint64_t mem_count = 0;
+  uint64_t ssd_count = 0;
+  std::vector<std::pair<char*, int>> ssd_keys;
+  std::vector<std::pair<char*, int>> ssd_values;
+  auto handler = [&](const uint64_t* keys,
+                     const float* values,
+                     uint32_t key_num,
+                     uint32_t dim) {
+    ssd_keys.clear();
+    ssd_values.clear();
+    for (uint32_t k = 0; k < key_num; ++k) {
+      float* value = const_cast<float*>(values + k * dim);
+      if (_value_accesor->SaveSSD(value)) {
+        ssd_keys.emplace_back(
+            reinterpret_cast<char*>(const_cast<uint64_t*>(&keys[k])),
+            sizeof(uint64_t));
+        ssd_values.emplace_back(reinterpret_cast<char*>(value),
+                                dim * sizeof(float));
+        ssd_count++;
+      } else {
+        auto& feature_value = shard[keys[k]];
+        feature_value.resize(dim);
+        memcpy(feature_value.data(), value, dim * sizeof(float));
+        mem_count++;
+      }
+    }
+    // keys and values only live during the call
+    if (ssd_keys.size() > 0) {
+      _db->put_batch(local_shard_id, ssd_keys, ssd_values, ssd_keys.size());
+    }
+  };
+  int retry_num = 0;
+  while (ReadSparseShardFile(
+             &_afs_client, channel_config, file_header, handler) != 0) {
+    ++retry_num;
+    mem_count = 0;
+    ssd_count = 0;
+    LOG(ERROR) << "SSDSparseTable load binary failed, retry it! path:" << path
+               << " , retry_num=" << retry_num;
+    if (retry_num > FLAGS_pserver_table_save_max_retry) {
+      LOG(ERROR) << "SSDSparseTable load binary failed reach max limit! path:"
+                 << path;
+      return -1;
+    }
+  }
+  _db->flush(local_shard_id);
+  LOG(INFO) << "Table>> load binary done. ALL[" << mem_count + ssd_count
+            << "] MEM[" << mem_count << "] SSD[" << ssd_count << "].";
+  return 0;
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -78,6 +78,9 @@ class SSDSparseTable : public MemorySparseTable {
   int64_t LocalSize();
 
  private:
+  // Load a binary shard file, the values matching SaveSSD go to rocksdb.
+  int32_t LoadBinaryShardToSSD(const std::string& path, int local_shard_id);
+
   RocksDBHandler* _db;
   int64_t _cache_tk_size;
   double _local_show_threshold{0.0};
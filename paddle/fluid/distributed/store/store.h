@@ -46,6 +46,52 @@ class Store {
         "Implement the add method in the subclass."));
   }
 
+  // The batched versions issue one request per key by default, the stores
+  // that have a cheaper way to serve a list of keys override them.
+  virtual std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) {
+    std::vector<std::vector<uint8_t>> values;
+    values.reserve(keys.size());
+    for (auto& key : keys) {
+      values.emplace_back(get(key));
+    }
+    return values;
+  }
+  virtual void multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values) {
+    PADDLE_ENFORCE_EQ(keys.size(),
+                      values.size(),
+                      platform::errors::InvalidArgument(
+                          "The number of keys (%d) and values (%d) of "
+                          "multi_set should be equal.",
+                          keys.size(),
+                          values.size()));
+    for (size_t i = 0; i < keys.size(); ++i) {
+      set(keys[i], values[i]);
+    }
+  }
+  virtual std::vector<int64_t> multi_add(const std::vector<std::string>& keys,
+                                         const std::vector<int64_t>& values) {
+    PADDLE_ENFORCE_EQ(keys.size(),
+                      values.size(),
+                      platform::errors::InvalidArgument(
+                          "The number of keys (%d) and values (%d) of "
+                          "multi_add should be equal.",
+                          keys.size(),
+                          values.size()));
+    std::vector<int64_t> results;
+    results.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      results.emplace_back(add(keys[i], values[i]));
+    }
+    return results;
+  }
+  virtual void multi_wait(const std::vector<std::string>& keys) {
+    for (auto& key : keys) {
+      wait(key);
+    }
+  }
+
   virtual int timeout() { return _timeout; }
 
  protected:
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/distributed/store/tcp_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -22,12 +23,23 @@
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/flags.h"
 
+DECLARE_int32(tcp_store_server_threads);
+
 namespace paddle {
 namespace distributed {
 
 namespace detail {
 
 constexpr int INFTIME = 10000;  // 10 seconds
+#ifdef _WIN32
+// There is no wakeup pipe on Windows, so the workers poll with a short
+// timeout to pick up the newly accepted sockets.
+constexpr int kWorkerPollTime = 100;
+#else
+constexpr int kWorkerPollTime = INFTIME;
+#endif
+
+constexpr size_t MasterDaemon::kNumShards;
 
 std::unique_ptr<MasterDaemon> MasterDaemon::start(SocketType socket,
                                                   int nranks,
@@ -39,6 +51,19 @@ std::unique_ptr<MasterDaemon> MasterDaemon::start(SocketType socket,
 MasterDaemon::MasterDaemon(SocketType socket, int nranks, int timeout)
     : _listen_socket(socket), _nranks(nranks), _timeout(timeout) {
   InitControlFd();
+  int num_threads = std::max(FLAGS_tcp_store_server_threads, 1);
+  for (int i = 0; i < num_threads; ++i) {
+    _workers.emplace_back(new Worker());
+#ifndef _WIN32
+    PADDLE_ENFORCE_NE(
+        pipe(_workers.back()->wakeup_fd.data()),
+        -1,
+        platform::errors::Fatal("failed to cread wakeup pipe errno:%d", errno));
+#endif
+  }
+  for (auto& worker : _workers) {
+    worker->thread = std::thread{&MasterDaemon::WorkerLoop, this, worker.get()};
+  }
   _background_thread = std::thread{&MasterDaemon::run, this};
 }
 
@@ -46,29 +71,123 @@ MasterDaemon::~MasterDaemon() {
   VLOG(4) << ("begin to destruct MasterDaemon");
   StopByControlFd();
   _background_thread.join();
+  _stop = true;
+  for (auto& worker : _workers) {
+    WakeUp(worker.get());
+  }
+  for (auto& worker : _workers) {
+    worker->thread.join();
+  }
   tcputils::close_socket(_listen_socket);
-  for (SocketType socket : _sockets) {
-    tcputils::close_socket(socket);
+  for (auto& worker : _workers) {
+    for (SocketType socket : worker->sockets) {
+      tcputils::close_socket(socket);
+    }
+    for (SocketType socket : worker->new_sockets) {
+      tcputils::close_socket(socket);
+    }
+#ifndef _WIN32
+    for (int fd : worker->wakeup_fd) {
+      ::close(fd);
+    }
+#endif
   }
   CloseControlFd();
 }
 
-void MasterDaemon::_do_add(SocketType socket) {
-  int64_t new_value{};
-  std::string key = tcputils::receive_string(socket);
-  new_value = tcputils::receive_value<int64_t>(socket);
-  std::vector<uint8_t> old_value;
-  auto it = _store.find(key);
-  if (it != _store.end()) {
-    old_value = it->second;
+MasterDaemon::StoreShard& MasterDaemon::GetShard(const std::string& key) {
+  return _shards[std::hash<std::string>()(key) % kNumShards];
+}
+
+int64_t MasterDaemon::AddValue(const std::string& key, int64_t value) {
+  auto& shard = GetShard(key);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  auto it = shard.values.find(key);
+  if (it != shard.values.end()) {
     char* buffer = reinterpret_cast<char*>(it->second.data());
-    size_t len = old_value.size();
-    new_value += std::stoll(std::string(buffer, len));
+    size_t len = it->second.size();
+    value += std::stoll(std::string(buffer, len));
+  }
+  std::string value_str = std::to_string(value);
+  shard.values[key] = std::vector<uint8_t>(value_str.begin(), value_str.end());
+  NotifyWaiters(&shard, key);
+  return value;
+}
+
+void MasterDaemon::SetValue(const std::string& key,
+                            std::vector<uint8_t> value) {
+  auto& shard = GetShard(key);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  shard.values[key] = std::move(value);
+  NotifyWaiters(&shard, key);
+}
+
+std::vector<uint8_t> MasterDaemon::GetValue(const std::string& key) {
+  auto& shard = GetShard(key);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  auto iter = shard.values.find(key);
+  PADDLE_ENFORCE_NE(
+      iter,
+      shard.values.end(),
+      platform::errors::InvalidArgument("Key %s not found in TCPStore.", key));
+  return iter->second;
+}
+
+// Must be called with shard->mutex held.
+void MasterDaemon::NotifyWaiters(StoreShard* shard, const std::string& key) {
+  auto iter = shard->waiters.find(key);
+  if (iter == shard->waiters.end()) {
+    return;
+  }
+  auto waiters = std::move(iter->second);
+  shard->waiters.erase(iter);
+  for (auto& waiter : waiters) {
+    if (--waiter->pending == 0) {
+      ReplyWaiter(waiter.get());
+    }
+  }
+}
+
+void MasterDaemon::ReplyWaiter(Waiter* waiter) {
+  // The owner worker closes the socket under the same lock, so the reply
+  // never goes to a socket that is closed or reused by a new connection.
+  std::lock_guard<std::mutex> guard(waiter->mutex);
+  if (waiter->closed) {
+    return;
+  }
+  try {
+    tcputils::send_value<ReplyType>(waiter->socket, ReplyType::STOP_WAIT);
+  } catch (const std::exception& ex) {
+    // The owner worker will see the broken socket and close it.
+    VLOG(3) << "Failed to reply a waiting client:" << ex.what();
   }
+}
+
+void MasterDaemon::ParkWaiter(Worker* worker,
+                              SocketType socket,
+                              const std::vector<std::string>& keys) {
+  // One extra count keeps the waiter from being answered before all of
+  // the keys are checked.
+  auto waiter = std::make_shared<Waiter>(socket, keys.size() + 1);
+  for (auto& key : keys) {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    if (shard.values.count(key) != 0) {
+      --waiter->pending;
+    } else {
+      shard.waiters[key].emplace_back(waiter);
+    }
+  }
+  worker->waiters[socket] = waiter;
+  if (--waiter->pending == 0) {
+    ReplyWaiter(waiter.get());
+  }
+}
 
-  std::string new_value_str = std::to_string(new_value);
-  _store[key] =
-      std::vector<uint8_t>(new_value_str.begin(), new_value_str.end());
+void MasterDaemon::_do_add(SocketType socket) {
+  std::string key = tcputils::receive_string(socket);
+  int64_t new_value = tcputils::receive_value<int64_t>(socket);
+  new_value = AddValue(key, new_value);
   VLOG(4) << "TCPStore: new value (" << new_value << ") for key (" << key
           << ") " << GetSockName(socket);
   tcputils::send_value<int64_t>(socket, new_value);
@@ -79,28 +198,67 @@ void MasterDaemon::_do_set(SocketType socket) {
   VLOG(4) << "MasterDaemon::_do_set key(" << key << ") " << GetSockName(socket);
 
   auto value = tcputils::receive_vector<uint8_t>(socket);
-  _store[key] = value;
+  SetValue(key, std::move(value));
 }
 
 void MasterDaemon::_do_get(SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(4) << "MasterDaemon::_do_get key(" << key << ") " << GetSockName(socket);
 
-  auto iter = _store.find(key);
-  PADDLE_ENFORCE_NE(
-      iter,
-      _store.end(),
-      platform::errors::InvalidArgument("Key %s not found in TCPStore.", key));
-  std::vector<uint8_t> value = iter->second;
+  std::vector<uint8_t> value = GetValue(key);
   tcputils::send_vector<uint8_t>(socket, value);
 }
 
+void MasterDaemon::_do_multi_add(SocketType socket) {
+  auto keys = tcputils::receive_strings(socket);
+  auto values = tcputils::receive_vector<int64_t>(socket);
+  PADDLE_ENFORCE_EQ(keys.size(),
+                    values.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of keys (%d) and values (%d) of "
+                        "MULTI_ADD should be equal.",
+                        keys.size(),
+                        values.size()));
+  VLOG(4) << "MasterDaemon::_do_multi_add " << keys.size() << " keys "
+          << GetSockName(socket);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values[i] = AddValue(keys[i], values[i]);
+  }
+  tcputils::send_vector<int64_t>(socket, values);
+}
+
+void MasterDaemon::_do_multi_set(SocketType socket) {
+  auto keys = tcputils::receive_strings(socket);
+  VLOG(4) << "MasterDaemon::_do_multi_set " << keys.size() << " keys "
+          << GetSockName(socket);
+  for (auto& key : keys) {
+    SetValue(key, tcputils::receive_vector<uint8_t>(socket));
+  }
+}
+
+void MasterDaemon::_do_multi_get(SocketType socket) {
+  auto keys = tcputils::receive_strings(socket);
+  VLOG(4) << "MasterDaemon::_do_multi_get " << keys.size() << " keys "
+          << GetSockName(socket);
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (auto& key : keys) {
+    values.emplace_back(GetValue(key));
+  }
+  for (auto& value : values) {
+    tcputils::send_vector<uint8_t>(socket, value);
+  }
+}
+
 void MasterDaemon::_do_stop(SocketType socket) {
   VLOG(4) << "MasterDaemon::_do_stop " << GetSockName(socket);
-  if (!_has_stop) {
-    _stop_time = std::chrono::system_clock::now();
+  {
+    std::lock_guard<std::mutex> guard(_stop_mutex);
+    if (!_has_stop) {
+      _stop_time = std::chrono::system_clock::now();
+    }
+    _has_stop = true;
   }
-  _has_stop = true;
   ReplyType value = ReplyType::STOP_WAIT;
   tcputils::send_value<ReplyType>(socket, value);
   if (--_nranks == 0) {
@@ -134,81 +292,156 @@ void MasterDaemon::StopByControlFd() {
     _control_fd[1] = -1;
   }
 }
+void MasterDaemon::WakeUp(Worker* worker) {
+  PADDLE_ENFORCE_NE(
+      ::write(worker->wakeup_fd[1], "\0", 1),
+      -1,
+      platform::errors::Fatal("failed to write wakeup pipe errno:%d", errno));
+}
 #else
 void MasterDaemon::InitControlFd() {}
 void MasterDaemon::CloseControlFd() {}
 void MasterDaemon::StopByControlFd() {}
+void MasterDaemon::WakeUp(Worker* worker) {}
 #endif
 
-void MasterDaemon::_do_wait(SocketType socket) {
+void MasterDaemon::_do_wait(Worker* worker, SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(4) << "MasterDaemon::_do_wait key(" << key << ") "
           << GetSockName(socket);
+  ParkWaiter(worker, socket, {key});
+}
+
+void MasterDaemon::_do_multi_wait(Worker* worker, SocketType socket) {
+  auto keys = tcputils::receive_strings(socket);
+  VLOG(4) << "MasterDaemon::_do_multi_wait " << keys.size() << " keys "
+          << GetSockName(socket);
+  ParkWaiter(worker, socket, keys);
+}
 
-  auto iter = _store.find(key);
-  auto reply = ReplyType::STOP_WAIT;
-  if (iter == _store.end()) {
-    reply = ReplyType::WAITING;
+bool MasterDaemon::ProcessCommand(Worker* worker, SocketType socket) {
+  try {
+    Command command = tcputils::receive_value<Command>(socket);
+    VLOG(3) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
+    // A client only sends a new command after its last wait was answered.
+    worker->waiters.erase(socket);
+
+    switch (command) {
+      case Command::ADD:
+        _do_add(socket);
+        break;
+      case Command::GET:
+        _do_get(socket);
+        break;
+      case Command::SET:
+        _do_set(socket);
+        break;
+      case Command::WAIT:
+        _do_wait(worker, socket);
+        break;
+      case Command::STOP:
+        _do_stop(socket);
+        break;
+      case Command::MULTI_GET:
+        _do_multi_get(socket);
+        break;
+      case Command::MULTI_SET:
+        _do_multi_set(socket);
+        break;
+      case Command::MULTI_ADD:
+        _do_multi_add(socket);
+        break;
+      case Command::MULTI_WAIT:
+        _do_multi_wait(worker, socket);
+        break;
+      default:
+        LOG(WARNING) << "Unknown command: " << static_cast<int>(command)
+                     << " from addr info:" << GetSockName(socket);
+    }
+  } catch (const std::exception& ex) {
+    VLOG(3) << "Meet some exceptions during run:" << ex.what();
+    return false;
+  }
+  return true;
+}
+
+void MasterDaemon::CloseSocket(Worker* worker, SocketType socket) {
+  auto iter = worker->waiters.find(socket);
+  if (iter == worker->waiters.end()) {
+    tcputils::close_socket(socket);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(iter->second->mutex);
+    iter->second->closed = true;
+    tcputils::close_socket(socket);
   }
-  VLOG(3) << "TCPStore: wait reply (" << static_cast<int>(reply)
-          << ") for key (" << key << ").";
-  tcputils::send_value<ReplyType>(socket, reply);
+  worker->waiters.erase(iter);
 }
 
-void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
-  std::vector<struct pollfd>& fds = *p_fds;
-  // FIXME(gongwb): Don't loop all fds of set just the fds who have event.
+void MasterDaemon::WorkerLoop(Worker* worker) {
+  std::vector<struct pollfd> fds;
+#ifndef _WIN32
+  fds.push_back(
+      {.fd = worker->wakeup_fd[0], .events = POLLIN | POLLHUP, .revents = 0});
+  // 0: wakeup pipe, so the sockets start from 1.
+  const size_t first = 1;
+#else
+  const size_t first = 0;
+#endif
+
+  while (!_stop) {
+    {
+      std::lock_guard<std::mutex> guard(worker->mutex);
+      for (SocketType socket : worker->new_sockets) {
+        worker->sockets.emplace_back(socket);
 #ifdef _WIN32
-  // 0: listen socket, so loop from 1.
-  for (size_t i = 1; i < fds.size(); i++) {
+        fds.push_back({socket, POLLIN});
 #else
-  // 0: listen socket, 1:controller pipe, so loop from 2.
-  for (size_t i = 2; i < fds.size(); i++) {
+        fds.push_back({.fd = socket, .events = POLLIN, .revents = 0});
 #endif
-    try {
-      if (fds[i].revents == 0) {
-        continue;
       }
+      worker->new_sockets.clear();
+    }
 
-      Command command = tcputils::receive_value<Command>(fds[i].fd);
-      VLOG(3) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
-
-      switch (command) {
-        case Command::ADD:
-          _do_add(fds[i].fd);
-          break;
-        case Command::GET:
-          _do_get(fds[i].fd);
-          break;
-        case Command::SET:
-          _do_set(fds[i].fd);
-          break;
-        case Command::WAIT:
-          _do_wait(fds[i].fd);
-          break;
-        case Command::STOP:
-          _do_stop(fds[i].fd);
-          break;
-        default:
-          LOG(WARNING) << "Unknown command: " << static_cast<int>(command)
-                       << " from addr info:" << GetSockName(fds[i].fd);
-      }
-    } catch (const std::exception& ex) {
-      tcputils::close_socket(fds[i].fd);
-      fds.erase(fds.begin() + i);
+    for (auto& fd : fds) {
+      fd.revents = 0;
+    }
 #ifdef _WIN32
-      _sockets.erase(_sockets.begin() + i - 1);
+    if (fds.empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kWorkerPollTime));
+      continue;
+    }
+    ::WSAPoll(fds.data(), fds.size(), kWorkerPollTime);
 #else
-      _sockets.erase(_sockets.begin() + i - 2);
+    ::poll(fds.data(), fds.size(), kWorkerPollTime);
+    if (fds[0].revents != 0) {
+      char buffer[64];
+      PADDLE_ENFORCE_NE(::read(fds[0].fd, buffer, sizeof(buffer)),
+                        -1,
+                        platform::errors::Fatal(
+                            "failed to read wakeup pipe errno:%d", errno));
+    }
 #endif
 
-      VLOG(3) << "Meet some exceptions during run:" << ex.what();
+    // fds[first + i] is worker->sockets[i].
+    size_t kept = first;
+    for (size_t i = first; i < fds.size(); ++i) {
+      if (fds[i].revents != 0 && !ProcessCommand(worker, fds[i].fd)) {
+        CloseSocket(worker, fds[i].fd);
+        continue;
+      }
+      fds[kept] = fds[i];
+      worker->sockets[kept - first] = worker->sockets[i - first];
+      ++kept;
     }
+    fds.resize(kept);
+    worker->sockets.resize(kept - first);
   }
 }
 
 void MasterDaemon::run() {
-  VLOG(4) << "begin to run run _stop:" << _stop << " _has_stop:" << _has_stop;
+  VLOG(4) << "begin to run run _stop:" << _stop;
   std::vector<struct pollfd> fds;
 #ifdef _WIN32
   fds.push_back({_listen_socket, POLLIN});
@@ -220,6 +453,7 @@ void MasterDaemon::run() {
 
   while (!_stop) {
     auto end_time = std::chrono::system_clock::now();
+    std::unique_lock<std::mutex> stop_lock(_stop_mutex);
     if (_has_stop) {
       std::chrono::duration<double> diff = end_time - _stop_time;
       int elapsed_seconds = static_cast<int>(diff.count());
@@ -234,6 +468,7 @@ void MasterDaemon::run() {
               " to change the timeout value in seconds. The default one is 900",
               elapsed_seconds));
     }
+    stop_lock.unlock();
 
     for (size_t i = 0; i < fds.size(); i++) {
       fds[i].revents = 0;
@@ -261,18 +496,16 @@ void MasterDaemon::run() {
     }
 #endif
 
-    // accept connect request.
+    // accept connect request and hand it over to the workers in turn.
     if (fds[0].revents != 0) {
       auto socket = tcputils::tcp_accept(_listen_socket);
-      _sockets.emplace_back(socket);
-#ifdef _WIN32
-      fds.push_back({socket, POLLIN});
-#else
-      fds.push_back({.fd = socket, .events = POLLIN, .revents = 0});
-#endif
+      auto& worker = _workers[_next_worker++ % _workers.size()];
+      {
+        std::lock_guard<std::mutex> guard(worker->mutex);
+        worker->new_sockets.emplace_back(socket);
+      }
+      WakeUp(worker.get());
     }
-
-    ProcessCommands(&fds);
   }
 }
 
@@ -322,6 +555,26 @@ std::vector<T> TCPClient::receive_vector() {
   return tcputils::receive_vector<T>(_socket);
 }
 
+void TCPClient::send_keys(const std::vector<std::string>& keys) {
+  tcputils::send_strings(_socket, keys);
+}
+
+bool TCPClient::wait_for_reply(std::chrono::seconds timeout) {
+  auto timeout_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count();
+#ifdef _WIN32
+  struct pollfd fd = {_socket, POLLIN};
+  return ::WSAPoll(&fd, 1, static_cast<int>(timeout_ms)) > 0;
+#else
+  struct pollfd fd = {.fd = _socket, .events = POLLIN, .revents = 0};
+  int ret = 0;
+  do {
+    ret = ::poll(&fd, 1, static_cast<int>(timeout_ms));
+  } while (ret == -1 && errno == EINTR);
+  return ret > 0;
+#endif
+}
+
 }  // namespace detail
 
 TCPStore::TCPStore(std::string host,
@@ -349,36 +602,25 @@ void TCPStore::waitWorkers() {
   if (_num_workers == 0) {
     return;
   }
-  add(_init_key, 1);
+  // The last worker to arrive releases the others, which are parked on the
+  // master until then instead of polling the counter.
+  auto completed = add(_init_key, 1);
+  VLOG(3) << completed << " worker ready, total " << _num_workers
+          << ", _timeout:" << _timeout;
+  if (completed >= _num_workers) {
+    set(_init_done_key, {1});
+  }
 
   VLOG(3) << paddle::string::Sprintf("_timeout:%d", _timeout);
-  auto begin = std::chrono::steady_clock::now();
-  do {
-    auto value = get(_init_key);
-    int completed = std::stoi(std::string(value.begin(), value.end()));
-    VLOG(3) << completed << " worker ready, total " << _num_workers
-            << ", _timeout:" << _timeout;
-    if (completed >= _num_workers) {
-      break;
-    }
-    const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-        std::chrono::steady_clock::now() - begin);
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    if (_timeout != 0 && elapsed.count() > _timeout) {
-      LOG(FATAL) << paddle::string::Sprintf(
-          "_timeout:%d elapsed:%d (elapsed > _timeout)=%d",
-          _timeout,
-          elapsed.count(),
-          elapsed.count() > _timeout);
-
-      PADDLE_ENFORCE_EQ(
-          completed,
-          _num_workers,
-          platform::errors::InvalidArgument(
-              "TCPStore timeouted and not all workers got ready."));
-    }
-  } while (true);
+  _client->send_command_for_key(Command::WAIT, _key_prefix + _init_done_key);
+  bool ready = _client->wait_for_reply(std::chrono::seconds(_timeout));
+  PADDLE_ENFORCE_EQ(
+      ready,
+      true,
+      platform::errors::InvalidArgument(
+          "TCPStore timeouted after %d seconds and not all workers got ready.",
+          _timeout));
+  _client->receive_value<ReplyType>();
   VLOG(3) << "TCPStore initialized.";
 }
 
@@ -403,16 +645,74 @@ std::vector<uint8_t> TCPStore::get(const std::string& key) {
 }
 
 void TCPStore::wait(const std::string& key) {
-  ReplyType reply;
   VLOG(3) << "TCPStore wait.";
+  // The master replies once the key is set.
   _client->send_command_for_key(Command::WAIT, _key_prefix + key);
-  reply = _client->receive_value<ReplyType>();
-  while (reply != ReplyType::STOP_WAIT) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  _client->receive_value<ReplyType>();
+}
 
-    _client->send_command_for_key(Command::WAIT, _key_prefix + key);
-    reply = _client->receive_value<ReplyType>();
+std::vector<std::string> TCPStore::WithPrefix(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> prefixed_keys;
+  prefixed_keys.reserve(keys.size());
+  for (auto& key : keys) {
+    prefixed_keys.emplace_back(_key_prefix + key);
   }
+  return prefixed_keys;
+}
+
+void TCPStore::multi_wait(const std::vector<std::string>& keys) {
+  VLOG(3) << "TCPStore multi_wait " << keys.size() << " keys.";
+  _client->send_command_for_key(Command::MULTI_WAIT, "");
+  _client->send_keys(WithPrefix(keys));
+  _client->receive_value<ReplyType>();
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multi_get(
+    const std::vector<std::string>& keys) {
+  multi_wait(keys);
+  VLOG(3) << "TCPStore multi_get " << keys.size() << " keys.";
+  _client->send_command_for_key(Command::MULTI_GET, "");
+  _client->send_keys(WithPrefix(keys));
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.emplace_back(_client->receive_vector<uint8_t>());
+  }
+  return values;
+}
+
+void TCPStore::multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values) {
+  PADDLE_ENFORCE_EQ(keys.size(),
+                    values.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of keys (%d) and values (%d) of "
+                        "multi_set should be equal.",
+                        keys.size(),
+                        values.size()));
+  VLOG(3) << "TCPStore multi_set " << keys.size() << " keys.";
+  _client->send_command_for_key(Command::MULTI_SET, "");
+  _client->send_keys(WithPrefix(keys));
+  for (auto& value : values) {
+    _client->send_vector<uint8_t>(value);
+  }
+}
+
+std::vector<int64_t> TCPStore::multi_add(const std::vector<std::string>& keys,
+                                         const std::vector<int64_t>& values) {
+  PADDLE_ENFORCE_EQ(keys.size(),
+                    values.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of keys (%d) and values (%d) of "
+                        "multi_add should be equal.",
+                        keys.size(),
+                        values.size()));
+  VLOG(3) << "TCPStore multi_add " << keys.size() << " keys.";
+  _client->send_command_for_key(Command::MULTI_ADD, "");
+  _client->send_keys(WithPrefix(keys));
+  _client->send_vector<int64_t>(values);
+  return _client->receive_vector<int64_t>();
 }
 
 TCPStore::~TCPStore() { VLOG(3) << "TCPStore destructure"; }
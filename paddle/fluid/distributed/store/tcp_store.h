@@ -24,11 +24,14 @@
 #endif
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/fluid/distributed/store/socket.h"
 #include "paddle/fluid/distributed/store/store.h"
@@ -38,10 +41,27 @@ namespace paddle {
 namespace distributed {
 
 enum class ReplyType { WAITING, STOP_WAIT };
-enum class Command { ADD, GET, SET, WAIT, STOP };
+enum class Command {
+  ADD,
+  GET,
+  SET,
+  WAIT,
+  STOP,
+  // The batched commands serve a list of keys in one round trip.
+  MULTI_GET,
+  MULTI_SET,
+  MULTI_ADD,
+  MULTI_WAIT
+};
 
 namespace detail {
 
+// The MasterDaemon accepts the connections on its background thread and
+// hands them over to FLAGS_tcp_store_server_threads workers, each of which
+// polls its own sockets. The keys are spread over the shards of the store,
+// so the workers only contend when they touch the same shard. A WAIT is
+// parked on the master and answered when the last missing key is set,
+// instead of being polled by the client.
 class MasterDaemon {
  public:
   static std::unique_ptr<MasterDaemon> start(SocketType listen_socket,
@@ -54,22 +74,77 @@ class MasterDaemon {
   ~MasterDaemon();
 
  private:
+  // A client blocked in WAIT or MULTI_WAIT, it is answered once by the
+  // thread that decreases pending to zero.
+  struct Waiter {
+    Waiter(SocketType socket, size_t pending)
+        : socket(socket), pending(pending) {}
+    SocketType socket;
+    std::atomic<size_t> pending;
+    std::mutex mutex;
+    bool closed = false;  // guarded by mutex
+  };
+
+  struct StoreShard {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::vector<uint8_t>> values;
+    std::unordered_map<std::string, std::vector<std::shared_ptr<Waiter>>>
+        waiters;
+  };
+
+  struct Worker {
+    std::thread thread;
+    std::mutex mutex;
+    std::vector<SocketType> new_sockets;  // guarded by mutex
+    // Only used by the worker thread, and by the destructor after the
+    // thread is joined.
+    std::vector<SocketType> sockets;
+    std::unordered_map<SocketType, std::shared_ptr<Waiter>> waiters;
+#ifndef _WIN32
+    std::array<int, 2> wakeup_fd{{-1, -1}};
+#endif
+  };
+
+  static constexpr size_t kNumShards = 64;
+
   void run();
-  void ProcessCommands(std::vector<struct pollfd>* p_fds);
+  void WorkerLoop(Worker* worker);
+  void WakeUp(Worker* worker);
+  // Returns false if the socket is broken and should be closed.
+  bool ProcessCommand(Worker* worker, SocketType socket);
+  void CloseSocket(Worker* worker, SocketType socket);
+
+  StoreShard& GetShard(const std::string& key);
+  int64_t AddValue(const std::string& key, int64_t value);
+  void SetValue(const std::string& key, std::vector<uint8_t> value);
+  std::vector<uint8_t> GetValue(const std::string& key);
+  void NotifyWaiters(StoreShard* shard, const std::string& key);
+  void ParkWaiter(Worker* worker,
+                  SocketType socket,
+                  const std::vector<std::string>& keys);
+  void ReplyWaiter(Waiter* waiter);
+
   void _do_add(SocketType socket);
-  void _do_wait(SocketType socket);
+  void _do_wait(Worker* worker, SocketType socket);
   void _do_get(SocketType socket);
   void _do_set(SocketType socket);
   void _do_stop(SocketType socket);
+  void _do_multi_add(SocketType socket);
+  void _do_multi_get(SocketType socket);
+  void _do_multi_set(SocketType socket);
+  void _do_multi_wait(Worker* worker, SocketType socket);
   SocketType _listen_socket;
-  std::vector<SocketType> _sockets;
-  std::unordered_map<std::string, std::vector<uint8_t>> _store;
+  std::array<StoreShard, kNumShards> _shards;
+  std::vector<std::unique_ptr<Worker>> _workers;
+  size_t _next_worker = 0;
   std::thread _background_thread{};
-  int _nranks = -1;
+  std::atomic<int> _nranks{-1};
   int _timeout = 0;
-  bool _stop = false;  // all workers stopped
+  std::atomic<bool> _stop{false};  // all workers stopped
+  std::mutex _stop_mutex;
   std::chrono::time_point<std::chrono::system_clock> _stop_time;
-  bool _has_stop = false;  // at least one worker stopped
+  bool _has_stop = false;  // at least one worker stopped, guarded by
+                           // _stop_mutex
 
   void InitControlFd();
   void CloseControlFd();
@@ -110,6 +185,10 @@ class TCPClient {
   template <typename T>
   T receive_value();
 
+  void send_keys(const std::vector<std::string>& keys);
+  // Returns false if nothing arrived on the socket within the timeout.
+  bool wait_for_reply(std::chrono::seconds timeout);
+
  private:
   SocketType _socket;
 };
@@ -133,12 +212,22 @@ class TCPStore : public Store {
   void wait(const std::string& key) override;
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
 
+  std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) override;
+  void multi_set(const std::vector<std::string>& keys,
+                 const std::vector<std::vector<uint8_t>>& values) override;
+  std::vector<int64_t> multi_add(const std::vector<std::string>& keys,
+                                 const std::vector<int64_t>& values) override;
+  void multi_wait(const std::vector<std::string>& keys) override;
+
  private:
   void waitWorkers();
+  std::vector<std::string> WithPrefix(const std::vector<std::string>& keys);
   std::unique_ptr<detail::TCPServer> _server;
   std::unique_ptr<detail::TCPClient> _client;
 
   const std::string _init_key = "init/";
+  const std::string _init_done_key = "init/done";
   const std::string _key_prefix = "/";
 
   bool _is_master;
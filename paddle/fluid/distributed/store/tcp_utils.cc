@@ -127,6 +127,18 @@ SocketType tcp_connect(const std::string host,
                     0,
                     platform::errors::InvalidArgument(
                         "Network %s:%s cannot be connected.", host, port));
+  // The requests are written in several pieces, don't let Nagle's algorithm
+  // hold the tail of a request back until the head is acknowledged.
+  auto value = 1;
+#ifdef _WIN32
+  ::setsockopt(sockfd,
+               IPPROTO_TCP,
+               TCP_NODELAY,
+               reinterpret_cast<const char*>(&value),
+               sizeof(value));
+#else
+  ::setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+#endif
   VLOG(0) << "Successfully connected to " << host << ":" << port;
 
   return sockfd;
@@ -223,6 +235,34 @@ std::string receive_string(SocketType socket) {
   return std::string(v.data(), v.size());
 }
 
+void send_strings(SocketType socket, const std::vector<std::string>& v) {
+  // Pack the list into one buffer so that a batch of keys costs one send.
+  std::vector<char> buffer;
+  auto append = [&buffer](const void* data, size_t len) {
+    auto ptr = reinterpret_cast<const char*>(data);
+    buffer.insert(buffer.end(), ptr, ptr + len);
+  };
+  size_t count = v.size();
+  append(&count, sizeof(count));
+  for (auto& s : v) {
+    std::string::size_type size = s.size();
+    append(&size, sizeof(size));
+    append(s.data(), size);
+  }
+  send_bytes<char>(socket, buffer.data(), buffer.size());
+}
+
+std::vector<std::string> receive_strings(SocketType socket) {
+  size_t count;
+  receive_bytes<size_t>(socket, &count, 1);
+  std::vector<std::string> res;
+  res.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    res.emplace_back(receive_string(socket));
+  }
+  return res;
+}
+
 }  // namespace tcputils
 }  // namespace distributed
 }  // namespace paddle
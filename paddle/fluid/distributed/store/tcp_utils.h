@@ -28,6 +28,7 @@
 #endif
 #include <chrono>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "paddle/fluid/platform/enforce.h"
@@ -67,6 +68,8 @@ SocketType tcp_accept(SocketType socket);
 
 void send_string(SocketType socket, const std::string& s);
 std::string receive_string(SocketType socket);
+void send_strings(SocketType socket, const std::vector<std::string>& v);
+std::vector<std::string> receive_strings(SocketType socket);
 
 template <typename T>
 void send_bytes(SocketType socket, const T* buffer, size_t len) {
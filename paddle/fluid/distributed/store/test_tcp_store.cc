@@ -12,6 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/store/tcp_store.h"
 #include "paddle/fluid/distributed/store/tcp_utils.h"
@@ -37,6 +42,81 @@ TEST(MasterDaemon, init) {
   d.reset();
 }
 
+#ifndef _WIN32
+static uint16_t GetListenPort(SocketType socket) {
+  ::sockaddr_in addr{};
+  ::socklen_t len = sizeof(addr);
+  ::getsockname(socket, reinterpret_cast<::sockaddr*>(&addr), &len);
+  return ntohs(addr.sin_port);
+}
+
+static std::vector<uint8_t> ToBytes(const std::string& s) {
+  return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+TEST(TCPStore, multi_keys) {
+  int socket = tcputils::tcp_listen("", std::to_string(0), AF_INET);
+  uint16_t port = GetListenPort(socket);
+  auto d = detail::MasterDaemon::start(socket, 1, 100);
+  {
+    TCPStore store("127.0.0.1", port, false, 1);
+    store.multi_set({"a", "b"}, {ToBytes("1"), ToBytes("22")});
+    auto values = store.multi_get({"b", "a"});
+    ASSERT_EQ(values.size(), 2UL);
+    EXPECT_EQ(values[0], ToBytes("22"));
+    EXPECT_EQ(values[1], ToBytes("1"));
+
+    auto sums = store.multi_add({"c", "d", "c"}, {1, 2, 3});
+    EXPECT_EQ(sums, std::vector<int64_t>({1, 2, 4}));
+    EXPECT_EQ(store.add("d", 5), 7);
+    EXPECT_EQ(store.get("c"), ToBytes("4"));
+  }
+  d.reset();
+}
+
+// Simulates the bootstrap of a job on one machine: every rank registers,
+// publishes its address and reads the ones of its neighbours. Each rank
+// holds two sockets in this process, so a larger kNumRanks needs a larger
+// `ulimit -n`.
+TEST(TCPStore, bootstrap) {
+  constexpr int kNumRanks = 256;
+  int socket = tcputils::tcp_listen("", std::to_string(0), AF_INET);
+  uint16_t port = GetListenPort(socket);
+  auto d = detail::MasterDaemon::start(socket, kNumRanks, 100);
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<std::thread> ranks;
+  std::vector<int> ok(kNumRanks, 0);
+  for (int rank = 0; rank < kNumRanks; ++rank) {
+    ranks.emplace_back([rank, port, &ok]() {
+      TCPStore store("127.0.0.1", port, false, kNumRanks, 60);
+      store.set("addr/" + std::to_string(rank), ToBytes(std::to_string(rank)));
+      int prev = (rank + kNumRanks - 1) % kNumRanks;
+      int next = (rank + 1) % kNumRanks;
+      auto values = store.multi_get(
+          {"addr/" + std::to_string(prev), "addr/" + std::to_string(next)});
+      auto rounds = store.multi_add({"round/0", "round/1"}, {1, 1});
+      ok[rank] = values[0] == ToBytes(std::to_string(prev)) &&
+                 values[1] == ToBytes(std::to_string(next)) &&
+                 rounds[0] >= 1 && rounds[0] <= kNumRanks &&
+                 rounds[1] >= 1 && rounds[1] <= kNumRanks;
+    });
+  }
+  for (auto& rank : ranks) {
+    rank.join();
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - begin);
+  printf("bootstrap of %d ranks took %lld ms\n",
+         kNumRanks,
+         static_cast<long long>(elapsed.count()));
+  for (int rank = 0; rank < kNumRanks; ++rank) {
+    EXPECT_EQ(ok[rank], 1) << "rank " << rank;
+  }
+  d.reset();
+}
+#endif
+
 /* now for only c compile test
 TEST(TCPStore, init) {
   TCPStore store("127.0.0.1", 6170, true, 1);
@@ -46,5 +46,47 @@ TEST(BENCHMARK, LargeScaleKV) {
   ASSERT_FLOAT_EQ(value_data[3], 0.3);
 }
 
+TEST(FixedFeatureValueSlab, InlineAndExtend) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  shard_type shard;
+  shard.set_value_inline_size(4);
+
+  std::vector<FixedFeatureValue*> ptrs;
+  for (uint64_t key = 0; key < 10000; ++key) {
+    auto& feature_value = shard[key];
+    feature_value.resize(4);
+    feature_value.data()[3] = static_cast<float>(key);
+    // stored inline, right after the header
+    ASSERT_EQ(feature_value.data(),
+              reinterpret_cast<float*>(&feature_value + 1));
+    ptrs.push_back(&feature_value);
+  }
+
+  // extend part of the values, e.g., the mf values, to the heap
+  for (uint64_t key = 0; key < 10000; key += 3) {
+    auto& feature_value = shard[key];
+    feature_value.resize(12);
+    ASSERT_FLOAT_EQ(feature_value.data()[3], static_cast<float>(key));
+    ASSERT_FLOAT_EQ(feature_value.data()[11], 0.0);
+  }
+
+  // the address of values are stable
+  for (uint64_t key = 0; key < 10000; ++key) {
+    auto itr = shard.find(key);
+    ASSERT_TRUE(itr != shard.end());
+    ASSERT_EQ(itr.value_ptr(), ptrs[key]);
+    ASSERT_EQ(itr.value().size(), key % 3 == 0 ? 12UL : 4UL);
+  }
+
+  for (uint64_t key = 0; key < 10000; key += 2) {
+    ASSERT_EQ(shard.erase(key), 1UL);
+  }
+  ASSERT_EQ(shard.size(), 5000UL);
+  // the released values are reused
+  auto& feature_value = shard[0];
+  ASSERT_EQ(feature_value.size(), 0UL);
+  ASSERT_EQ(&feature_value, ptrs[9998]);
+}
+
 }  // namespace distributed
 }  // namespace paddle
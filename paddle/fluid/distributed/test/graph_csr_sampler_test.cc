@@ -0,0 +1,110 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr_sampler.h"
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+// node i has (i + 1) * 10 neighbors, whose ids are 1000 * i + j, and the
+// weight of the first neighbor is 10 times of the others
+static std::vector<Node *> BuildBucket(int node_num) {
+  std::vector<Node *> bucket;
+  for (int i = 0; i < node_num; i++) {
+    auto node = new GraphNode(i);
+    node->build_edges(true);
+    for (int j = 0; j < (i + 1) * 10; j++) {
+      node->add_edge(1000 * i + j, j == 0 ? 10.0 : 1.0);
+    }
+    bucket.push_back(node);
+  }
+  return bucket;
+}
+
+TEST(CSRNeighborSampler, Layout) {
+  auto bucket = BuildBucket(3);
+  CSRNeighborSampler sampler;
+  sampler.build(bucket, true);
+  ASSERT_EQ(sampler.get_row_num(), 3UL);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(sampler.get_neighbor_size(i), bucket[i]->get_neighbor_size());
+    for (size_t j = 0; j < sampler.get_neighbor_size(i); j++) {
+      ASSERT_EQ(sampler.get_neighbor_id(i, j), bucket[i]->get_neighbor_id(j));
+      ASSERT_EQ(sampler.get_neighbor_weight(i, j),
+                bucket[i]->get_neighbor_weight(j));
+    }
+  }
+
+  // all the neighbors are returned if k is not less than the size
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::vector<int> res;
+  sampler.sample_k(0, 20, rng.get(), &res);
+  ASSERT_EQ(res.size(), 10UL);
+  for (auto node : bucket) {
+    delete node;
+  }
+}
+
+TEST(CSRNeighborSampler, SampleDistinct) {
+  auto bucket = BuildBucket(10);
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::vector<int> res;
+  for (bool is_weighted : {false, true}) {
+    CSRNeighborSampler sampler;
+    sampler.build(bucket, is_weighted);
+    // both the rejection and the O(n) algorithms are covered
+    for (int k : {1, 5, 40, 70, 95}) {
+      sampler.sample_k(9, k, rng.get(), &res);
+      ASSERT_EQ(res.size(), static_cast<size_t>(k));
+      std::set<int> distinct(res.begin(), res.end());
+      ASSERT_EQ(distinct.size(), static_cast<size_t>(k));
+      ASSERT_LT(*distinct.rbegin(), 100);
+      ASSERT_GE(*distinct.begin(), 0);
+    }
+  }
+  for (auto node : bucket) {
+    delete node;
+  }
+}
+
+TEST(CSRNeighborSampler, Weighted) {
+  auto bucket = BuildBucket(1);
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::vector<int> res;
+  CSRNeighborSampler uniform_sampler, weighted_sampler;
+  uniform_sampler.build(bucket, false);
+  weighted_sampler.build(bucket, true);
+
+  // the probability of the first neighbor is 10 / 19 if weighted
+  int uniform_hits = 0, weighted_hits = 0;
+  int times = 10000;
+  for (int i = 0; i < times; i++) {
+    uniform_sampler.sample_k(0, 1, rng.get(), &res);
+    uniform_hits += res[0] == 0;
+    weighted_sampler.sample_k(0, 1, rng.get(), &res);
+    weighted_hits += res[0] == 0;
+  }
+  ASSERT_NEAR(static_cast<double>(uniform_hits) / times, 0.1, 0.02);
+  ASSERT_NEAR(static_cast<double>(weighted_hits) / times, 10.0 / 19, 0.02);
+  delete bucket[0];
+}
+
+}  // namespace distributed
+}  // namespace paddle
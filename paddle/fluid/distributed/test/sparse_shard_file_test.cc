@@ -0,0 +1,102 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/sparse_shard_file.h"
+
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+static SparseShardFileHeader MakeHeader() {
+  SparseShardFileHeader header;
+  header.value_dim = 17;
+  header.value_size = 17 * sizeof(float);
+  header.mf_size = 9 * sizeof(float);
+  header.SetAccessorClass("CtrCommonAccessor");
+  return header;
+}
+
+static void CheckRoundTrip(const std::string& path) {
+  AfsClient afs_client;
+  auto header = MakeHeader();
+
+  // keys without mf have 8 values, and odd keys have 17 values
+  std::map<uint64_t, std::vector<float>> expected;
+  FsChannelConfig config;
+  config.path = path;
+  int err_no = 0;
+  auto write_channel = afs_client.open_w(config, 0, &err_no);
+  SparseShardFileWriter writer(write_channel.get(), header);
+  ASSERT_EQ(writer.WriteHeader(), 0);
+  for (uint64_t key = 0; key < 3 * kSparseShardFileBlockKeyNum; ++key) {
+    uint32_t dim = key % 2 == 0 ? 8 : 17;
+    std::vector<float> value(dim);
+    for (uint32_t i = 0; i < dim; ++i) {
+      value[i] = key * 0.5 + i;
+    }
+    ASSERT_EQ(writer.Append(key, value.data(), dim), 0);
+    expected[key] = std::move(value);
+  }
+  ASSERT_EQ(writer.Finish(), 0);
+  write_channel->close();
+
+  std::map<uint64_t, std::vector<float>> loaded;
+  auto handler = [&loaded](const uint64_t* keys,
+                           const float* values,
+                           uint32_t key_num,
+                           uint32_t dim) {
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(keys) % sizeof(uint64_t), 0UL);
+    for (uint32_t k = 0; k < key_num; ++k) {
+      loaded[keys[k]].assign(values + k * dim, values + (k + 1) * dim);
+    }
+  };
+  ASSERT_EQ(ReadSparseShardFile(&afs_client, config, header, handler), 0);
+  ASSERT_EQ(loaded, expected);
+  afs_client.remove(path);
+}
+
+TEST(SparseShardFile, MappedRoundTrip) {
+  ASSERT_TRUE(IsSparseShardBinaryFile("part-000-00000.bin"));
+  CheckRoundTrip("./sparse_shard_file_test_" + std::to_string(getpid()) +
+                 ".bin");
+}
+
+TEST(SparseShardFile, CompressedRoundTrip) {
+  ASSERT_TRUE(IsSparseShardBinaryFile("part-000-00000.bin.gz"));
+  CheckRoundTrip("./sparse_shard_file_test_" + std::to_string(getpid()) +
+                 ".bin.gz");
+}
+
+TEST(SparseShardFile, CheckLayout) {
+  ASSERT_FALSE(IsSparseShardBinaryFile("part-000-00000.gz"));
+  auto header = MakeHeader();
+  ASSERT_TRUE(header.CheckLayout(MakeHeader()).empty());
+
+  auto other = MakeHeader();
+  other.mf_size = 0;
+  ASSERT_FALSE(header.CheckLayout(other).empty());
+  other = MakeHeader();
+  other.SetAccessorClass("CtrDymfAccessor");
+  ASSERT_FALSE(header.CheckLayout(other).empty());
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -14,9 +14,23 @@
 
 #include "paddle/fluid/eager/backward.h"
 
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <string>
+
 #include "paddle/fluid/eager/general_grad.h"
+#include "paddle/fluid/framework/threadpool.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
 
+PADDLE_DEFINE_EXPORTED_int32(
+    eager_backward_num_threads,
+    0,
+    "The number of threads used to run the eager backward graph on CPU, "
+    "including the calling thread. Values below 2 keep the serial engine. "
+    "paddle.grad and create_graph=True always run serially.");
+
 namespace egr {
 
 std::unordered_map<GradNodeBase*, int> getInDegreeMap(
@@ -102,6 +116,246 @@ void DuplicateCheck(const std::vector<paddle::experimental::Tensor>& inputs,
 
 GeneralGrad* GeneralGrad::general_grad_ = new GeneralGrad();
 
+namespace {
+
+// State of one grad node in the parallel engine. The map holding these is
+// built before any node runs and never rehashed afterwards, so only the
+// members need locking.
+struct ParallelNodeState {
+  std::mutex mutex;
+  int in_degree = 0;
+  std::unique_ptr<GradTensorHolder> buffer;
+};
+
+using ParallelNodeStateMap =
+    std::unordered_map<GradNodeBase*, ParallelNodeState>;
+
+// Helper threads of the parallel engine, sized by the flag at first use.
+paddle::framework::ThreadPool* BackwardThreadPool() {
+  static paddle::framework::ThreadPool pool(
+      FLAGS_eager_backward_num_threads - 1);
+  return &pool;
+}
+
+bool UseParallelBackward(bool is_general_grad, bool create_graph) {
+  return FLAGS_eager_backward_num_threads > 1 && !is_general_grad &&
+         !create_graph &&
+         paddle::platform::is_cpu_place(
+             egr::Controller::Instance().GetExpectedPlace());
+}
+
+// Run one ready node and hand its outputs to the nodes it feeds. Every node
+// whose in-degree drops to zero is passed to push_ready.
+void RunGradNodeInParallel(
+    GradNodeBase* node,
+    ParallelNodeStateMap* states,
+    bool retain_graph,
+    const std::function<void(GradNodeBase*)>& push_ready) {
+  // Accumulation nodes write leaf grads and run the reducer hooks, which are
+  // not safe to run concurrently, so keep them in order of arrival.
+  static std::mutex accumulation_mutex;
+
+  VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
+  paddle::platform::RecordEvent node_record_event(
+      std::string((*node).name()),
+      paddle::platform::TracerEventType::Operator,
+      1);
+
+  std::unique_ptr<GradTensorHolder> node_input_buffer;
+  {
+    auto& state = states->at(node);
+    std::lock_guard<std::mutex> guard(state.mutex);
+    node_input_buffer = std::move(state.buffer);
+  }
+  PADDLE_ENFORCE_NOT_NULL(
+      node_input_buffer,
+      paddle::platform::errors::Fatal(
+          "Unable to find next node in the GradTensorHolder \n"
+          "Trying to run Node without configuring its GradTensorHolder."));
+
+  EnforceGradNodeHasInput(node);
+
+  paddle::small_vector<std::vector<paddle::experimental::Tensor>,
+                       kSlotSmallVectorSize>
+      grad_output_tensors;
+  if (dynamic_cast<egr::GradNodeAccumulation*>(node)) {
+    std::lock_guard<std::mutex> guard(accumulation_mutex);
+    grad_output_tensors = (*node)(node_input_buffer->Buffers(), false, false);
+  } else {
+    grad_output_tensors = (*node)(node_input_buffer->Buffers(), false, false);
+  }
+
+  if (!retain_graph) {
+    node->ClearTensorWrappers();
+  }
+  node_input_buffer.reset();
+
+  const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+      metas = node->OutputMeta();
+  PADDLE_ENFORCE(metas.size() == grad_output_tensors.size() || metas.empty(),
+                 paddle::platform::errors::Fatal(
+                     "Number of edges should be either empty ( for leaf node "
+                     ") or the same as number of output grad tensors, but we "
+                     "got edges size is: %d, grad_output size is: %d",
+                     metas.size(),
+                     grad_output_tensors.size()));
+
+  for (size_t i = 0; i < metas.size(); i++) {
+    for (size_t j = 0; j < metas[i].size(); j++) {
+      const Edge& edge = metas[i][j].GetEdge();
+      if (!edge.IsInitialized()) {
+        continue;
+      }
+      auto edge_rank = edge.GetEdgeRankInfo();
+      auto* next_node = edge.GetMutableGradNode().get();
+      if (!next_node || grad_output_tensors[i].empty()) {
+        continue;
+      }
+      PADDLE_ENFORCE_LT(
+          j,
+          grad_output_tensors[i].size(),
+          paddle::platform::errors::Fatal(
+              "Rank of grad_output_tensors should be less than "
+              "grad_output_tensors[i].size(), which is: %d. This error may "
+              "indicate autoprune or autograd api error. ",
+              grad_output_tensors.size()));
+
+      bool is_ready = false;
+      {
+        auto& next_state = states->at(next_node);
+        std::lock_guard<std::mutex> guard(next_state.mutex);
+        if (!next_state.buffer) {
+          next_state.buffer =
+              std::make_unique<GradTensorHolder>(next_node->InputMeta());
+        }
+        next_state.buffer->add(edge_rank.first,
+                               edge_rank.second,
+                               grad_output_tensors[i][j],
+                               /*create_graph=*/false);
+        PADDLE_ENFORCE(
+            --next_state.in_degree >= 0,
+            paddle::platform::errors::Fatal(
+                "Detected in-degree value smaller than zero. For Node: %s"
+                "Node's in-degree cannot be negative.",
+                next_node->name()));
+        is_ready = next_state.in_degree == 0;
+      }
+      if (is_ready) {
+        push_ready(next_node);
+      }
+    }
+  }
+}
+
+// Ready queue shared by the threads of one parallel backward. Helpers hold
+// it by shared_ptr: a helper the pool starts after the run has finished
+// only touches this struct and leaves.
+struct ParallelReadyQueue {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<GradNodeBase*> nodes;
+  size_t running = 0;
+  size_t active_helpers = 0;
+  bool finished = false;
+  std::exception_ptr error;
+};
+
+// Run the backward graph with FLAGS_eager_backward_num_threads threads.
+// The calling thread works on the queue too and never waits for a helper
+// that has not started, so a nested backward issued from a grad node
+// running on the pool always makes progress.
+// Consumes queue and node_input_buffers_dict.
+void RunBackwardInParallel(
+    std::deque<GradNodeBase*>* queue,
+    const std::unordered_map<GradNodeBase*, int>& node_in_degree_map,
+    std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+        node_input_buffers_dict,
+    bool retain_graph) {
+  ParallelNodeStateMap states;
+  for (auto& kv : node_in_degree_map) {
+    states[kv.first].in_degree = kv.second;
+  }
+  for (auto& kv : *node_input_buffers_dict) {
+    states[kv.first].buffer = std::move(kv.second);
+  }
+  node_input_buffers_dict->clear();
+
+  auto ready = std::make_shared<ParallelReadyQueue>();
+  std::unordered_set<GradNodeBase*> started;
+  for (auto* node : *queue) {
+    // Start nodes fed by other start nodes are released by their in-degree
+    if (states[node].in_degree == 0 && started.insert(node).second) {
+      ready->nodes.push_back(node);
+    }
+  }
+  queue->clear();
+
+  auto push_ready = [&ready](GradNodeBase* node) {
+    {
+      std::lock_guard<std::mutex> guard(ready->mutex);
+      if (dynamic_cast<egr::GradNodeAccumulation*>(node)) {
+        ready->nodes.push_front(node);
+      } else {
+        ready->nodes.push_back(node);
+      }
+    }
+    ready->cv.notify_one();
+  };
+
+  // Called with ready->mutex held by lock
+  auto work = [&](std::unique_lock<std::mutex>* lock) {
+    auto& q = *ready;
+    while (true) {
+      q.cv.wait(*lock, [&] {
+        return q.error || !q.nodes.empty() || q.running == 0;
+      });
+      // Nothing queued and nothing running means the graph is done
+      if (q.error || q.nodes.empty()) break;
+      GradNodeBase* node = q.nodes.front();
+      q.nodes.pop_front();
+      ++q.running;
+      lock->unlock();
+      std::exception_ptr node_error;
+      try {
+        RunGradNodeInParallel(node, &states, retain_graph, push_ready);
+      } catch (...) {
+        node_error = std::current_exception();
+      }
+      lock->lock();
+      --q.running;
+      if (node_error && !q.error) q.error = node_error;
+      if (q.error || (q.running == 0 && q.nodes.empty())) q.cv.notify_all();
+    }
+  };
+
+  // Grad nodes read the tracer state of the thread they run on
+  bool has_grad = egr::Controller::Instance().HasGrad();
+  auto amp_level = egr::Controller::Instance().GetAMPLevel();
+  std::string amp_dtype =
+      egr::Controller::Instance().GetCurrentTracer()->GetAmpDtype();
+  for (int i = 1; i < FLAGS_eager_backward_num_threads; ++i) {
+    BackwardThreadPool()->Run([ready, &work, has_grad, amp_level, amp_dtype] {
+      std::unique_lock<std::mutex> lock(ready->mutex);
+      if (ready->finished) return;
+      ++ready->active_helpers;
+      egr::Controller::Instance().SetHasGrad(has_grad);
+      egr::Controller::Instance().SetAMPLevel(amp_level);
+      egr::Controller::Instance().GetCurrentTracer()->SetAmpDtype(amp_dtype);
+      work(&lock);
+      --ready->active_helpers;
+      ready->cv.notify_all();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(ready->mutex);
+  work(&lock);
+  ready->finished = true;
+  ready->cv.wait(lock, [&] { return ready->active_helpers == 0; });
+  if (ready->error) std::rethrow_exception(ready->error);
+}
+
+}  // namespace
+
 std::vector<paddle::experimental::Tensor> RunBackward(
     const std::vector<paddle::experimental::Tensor>& tensors,  // output
     const std::vector<paddle::experimental::Tensor>& grad_tensors,
@@ -216,6 +470,13 @@ std::vector<paddle::experimental::Tensor> RunBackward(
 
   VLOG(5) << "Startup_ops's size is " << queue.size();
 
+  if (UseParallelBackward(is_general_grad, create_graph)) {
+    VLOG(3) << "Run Backward with " << FLAGS_eager_backward_num_threads
+            << " threads";
+    RunBackwardInParallel(
+        &queue, node_in_degree_map, &node_input_buffers_dict, retain_graph);
+  }
+
   /* --- Topological Visit --- */
   // 1. Pop queue
   // 2. Run node
@@ -41,6 +41,8 @@ PD_DECLARE_KERNEL(add_grad, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(sum, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(sum_grad, CPU, ALL_LAYOUT);
 
+DECLARE_int32(eager_backward_num_threads);
+
 using namespace egr;            // NOLINT
 using namespace egr_utils_api;  // NOLINT
 
@@ -254,6 +256,79 @@ TEST(Benchmark, EagerIntermediateMLPCPU) {
   }
 }
 
+TEST(Benchmark, EagerWideMLPCPU) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(paddle::platform::CPUPlace());
+
+  auto tracer = std::make_shared<paddle::imperative::Tracer>();
+  paddle::imperative::SetCurrentTracer(tracer);
+
+  int num_threads = FLAGS_eager_backward_num_threads;
+  // Serial engine first, then the parallel one on the same graph
+  for (int backward_threads : {0, 4}) {
+    FLAGS_eager_backward_num_threads = backward_threads;
+    for (const std::string& mode : {"Accuracy", "Performance"}) {
+      paddle::framework::DDim ddimX =
+          phi::make_ddim({WIDE_MLP_M, WIDE_MLP_N});
+      paddle::experimental::Tensor X =
+          CreateTensorWithValue(ddimX,
+                                paddle::platform::CPUPlace(),
+                                phi::DataType::FLOAT32,
+                                phi::DataLayout::NCHW,
+                                WIDE_MLP_X_VAL,
+                                true);
+      RetainGradForTensor(X);
+
+      std::vector<paddle::experimental::Tensor> Ws;
+      std::vector<paddle::experimental::Tensor> Bs;
+      for (size_t i = 0; i < WIDE_MLP_NUM_TOWERS * WIDE_MLP_DEPTH; i++) {
+        paddle::framework::DDim ddimW =
+            phi::make_ddim({WIDE_MLP_N, WIDE_MLP_N});
+        paddle::experimental::Tensor W =
+            CreateTensorWithValue(ddimW,
+                                  paddle::platform::CPUPlace(),
+                                  phi::DataType::FLOAT32,
+                                  phi::DataLayout::NCHW,
+                                  WIDE_MLP_W_VAL,
+                                  true);
+        RetainGradForTensor(W);
+
+        paddle::framework::DDim ddimB = phi::make_ddim({WIDE_MLP_N});
+        paddle::experimental::Tensor B =
+            CreateTensorWithValue(ddimB,
+                                  paddle::platform::CPUPlace(),
+                                  phi::DataType::FLOAT32,
+                                  phi::DataLayout::NCHW,
+                                  WIDE_MLP_B_VAL,
+                                  true);
+        RetainGradForTensor(B);
+
+        Ws.emplace_back(std::move(W));
+        Bs.emplace_back(std::move(B));
+      }
+
+      if (mode == "Accuracy") {
+        benchmark_eager_wide_mlp(X, Ws, Bs, true /* accuracy_check */);
+
+      } else if (mode == "Performance") {
+        auto t_start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < 10; i++) {
+          benchmark_eager_wide_mlp(X, Ws, Bs);
+        }
+        auto t_end = std::chrono::high_resolution_clock::now();
+        double elapsed_time_ms =
+            std::chrono::duration<double, std::milli>(t_end - t_start).count();
+        std::cout << "Backward threads: " << backward_threads
+                  << ", Duration: " << elapsed_time_ms << " ms" << std::endl;
+
+      } else {
+        PADDLE_THROW(paddle::platform::errors::Fatal("Unknown benchmark mode"));
+      }
+    }
+  }
+  FLAGS_eager_backward_num_threads = num_threads;
+}
+
 USE_OP_ITSELF(scale);
 USE_OP_ITSELF(elementwise_add);
 USE_OP_ITSELF(matmul_v2);
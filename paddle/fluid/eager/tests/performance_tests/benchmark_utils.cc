@@ -154,6 +154,41 @@ void benchmark_eager_intermediate_mlp(
   }
 }
 
+void benchmark_eager_wide_mlp(
+    const paddle::experimental::Tensor& X,
+    const std::vector<paddle::experimental::Tensor>& Ws,
+    const std::vector<paddle::experimental::Tensor>& Bs,
+    bool accuracy_check) {
+  paddle::experimental::Tensor Out;
+  for (size_t t = 0; t < WIDE_MLP_NUM_TOWERS; t++) {
+    paddle::experimental::Tensor input0 = X;
+    for (size_t i = 0; i < WIDE_MLP_DEPTH; i++) {
+      size_t idx = t * WIDE_MLP_DEPTH + i;
+      paddle::experimental::Tensor Y = matmul_v2_dygraph_function(
+          input0, Ws[idx], {{"trans_x", false}, {"trans_y", false}});
+
+      input0 = elementwise_add_dygraph_function(Y, Bs[idx], {});
+    }
+
+    paddle::experimental::Tensor tower_out =
+        reduce_sum_dygraph_function(input0, {{"reduce_all", true}});
+    Out = t == 0 ? tower_out
+                 : elementwise_add_dygraph_function(Out, tower_out, {});
+  }
+
+  std::vector<paddle::experimental::Tensor> target_tensors = {Out};
+  Backward(target_tensors, {});
+
+  if (accuracy_check) {
+    std::unordered_map<std::string, float> result =
+        compute_wide_mlp_expected_results();
+
+    eager_test::CompareTensorWithValue<float>(Out, result["Out"]);
+    eager_test::CompareGradTensorWithValue<float>(X, result["GradX"]);
+    eager_test::CompareGradTensorWithValue<float>(Ws[0], result["GradW"]);
+  }
+}
+
 }  // namespace egr
 
 namespace paddle {
@@ -32,6 +32,18 @@
 #define MLP_B_VAL 3.0
 #define MLP_NUM_LINEAR 1000
 
+/* Wide MLP Configurations */
+// Tower_t = MLP of WIDE_MLP_DEPTH linears on X[M, N], as above
+// Out     = Sum_t ReduceSum(Tower_t), t < WIDE_MLP_NUM_TOWERS
+// The towers share no grad node, so their backward can run concurrently.
+#define WIDE_MLP_M 64
+#define WIDE_MLP_N 256
+#define WIDE_MLP_X_VAL 1.0
+#define WIDE_MLP_W_VAL 0.25
+#define WIDE_MLP_B_VAL 0.0
+#define WIDE_MLP_DEPTH 3
+#define WIDE_MLP_NUM_TOWERS 16
+
 namespace egr {
 
 inline std::unordered_map<std::string, float> compute_mlp_expected_results() {
@@ -47,6 +59,21 @@ inline std::unordered_map<std::string, float> compute_mlp_expected_results() {
   return {{"Out", Out}, {"GradX", GradX}, {"GradW", GradW0}};
 }
 
+inline std::unordered_map<std::string, float>
+compute_wide_mlp_expected_results() {
+  float Out = WIDE_MLP_X_VAL;
+  for (size_t i = 0; i < WIDE_MLP_DEPTH; i++) {
+    Out = Out * WIDE_MLP_W_VAL * WIDE_MLP_N + WIDE_MLP_B_VAL;
+  }
+  Out = Out * WIDE_MLP_M * WIDE_MLP_N * WIDE_MLP_NUM_TOWERS;
+
+  float GradX = WIDE_MLP_NUM_TOWERS *
+                pow((WIDE_MLP_W_VAL * WIDE_MLP_N), WIDE_MLP_DEPTH);
+  float GradW0 = pow((WIDE_MLP_W_VAL * WIDE_MLP_N), (WIDE_MLP_DEPTH - 1)) *
+                 WIDE_MLP_X_VAL * WIDE_MLP_M;
+  return {{"Out", Out}, {"GradX", GradX}, {"GradW", GradW0}};
+}
+
 /* ---- Eager Scale ---- */
 void benchmark_eager_scale(const paddle::experimental::Tensor& tensor,
                            bool accuracy_check = false);
@@ -66,6 +93,13 @@ void benchmark_eager_intermediate_mlp(
     const std::vector<paddle::experimental::Tensor>& Bs,
     bool accuracy_check = false);
 
+// Ws and Bs hold WIDE_MLP_DEPTH parameters per tower, tower after tower
+void benchmark_eager_wide_mlp(
+    const paddle::experimental::Tensor& X,
+    const std::vector<paddle::experimental::Tensor>& Ws,
+    const std::vector<paddle::experimental::Tensor>& Bs,
+    bool accuracy_check = false);
+
 }  // namespace egr
 
 namespace paddle {
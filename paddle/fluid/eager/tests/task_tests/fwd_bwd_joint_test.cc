@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <sstream>
 
 #include "glog/logging.h"
@@ -35,6 +36,8 @@ PD_DECLARE_KERNEL(full, GPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, KPS, ALL_LAYOUT);
 #endif
 
+DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
 paddle::experimental::Tensor hook_function(
@@ -355,6 +358,95 @@ TEST(FwdBwdJoint, CrossBatchAccumulation) {
   eager_test::CompareGradTensorWithValue<float>(tensor, 60.0);
 }
 
+static float GradValue(const paddle::experimental::Tensor& tensor) {
+  return std::dynamic_pointer_cast<phi::DenseTensor>(
+             EagerUtils::unsafe_autograd_meta(tensor)->Grad().impl())
+      ->data<float>()[0];
+}
+
+// Run the backward of a wide graph twice with retain_graph, and return the
+// grads of all the tensors. The hooks count their calls and the calls on a
+// thread without the AMP dtype of the caller.
+static std::vector<float> RunWideGraphBackward(int num_threads,
+                                               int* num_reduce_hooks,
+                                               int* num_grad_hooks,
+                                               int* num_amp_mismatches) {
+  FLAGS_eager_backward_num_threads = num_threads;
+  auto tracer = egr::Controller::Instance().GetCurrentTracer();
+  tracer->SetAmpDtype("bfloat16");
+
+  paddle::framework::DDim ddim = phi::make_ddim({4, 16});
+  paddle::experimental::Tensor tensor =
+      egr_utils_api::CreateTensorWithValue(ddim,
+                                           paddle::platform::CPUPlace(),
+                                           phi::DataType::FLOAT32,
+                                           phi::DataLayout::NCHW,
+                                           5.0 /*value*/,
+                                           true /*is_leaf*/);
+  egr_utils_api::RetainGradForTensor(tensor);
+  std::atomic<int> reduce_hooks{0}, grad_hooks{0}, amp_mismatches{0};
+  egr_utils_api::RegisterReduceHookForTensor(tensor,
+                                             [&] { ++reduce_hooks; });
+  auto hook = [&](const paddle::experimental::Tensor& t) {
+    ++grad_hooks;
+    if (egr::Controller::Instance().GetCurrentTracer()->GetAmpDtype() !=
+        "bfloat16") {
+      ++amp_mismatches;
+    }
+    return hook_function(t);
+  };
+
+  paddle::experimental::Tensor out0 = egr::scale(
+      tensor, 2.0, 3.0, true /*bias_after_scale*/, true /*trace_backward*/);
+  egr_utils_api::RetainGradForTensor(out0);
+  egr_utils_api::RegisterGradientHookForTensor(out0, hook);
+  std::vector<paddle::experimental::Tensor> outs;
+  for (int i = 0; i < 8; ++i) {
+    outs.emplace_back(egr::scale(out0,
+                                 i + 1.0,
+                                 i,
+                                 true /*bias_after_scale*/,
+                                 true /*trace_backward*/));
+    egr_utils_api::RetainGradForTensor(outs.back());
+    egr_utils_api::RegisterGradientHookForTensor(outs.back(), hook);
+  }
+
+  Backward(outs, {}, true /*retain_graph*/);
+  Backward(outs, {}, true /*retain_graph*/);
+
+  std::vector<float> grads = {GradValue(tensor), GradValue(out0)};
+  for (auto& out : outs) {
+    grads.push_back(GradValue(out));
+  }
+  *num_reduce_hooks = reduce_hooks;
+  *num_grad_hooks = grad_hooks;
+  *num_amp_mismatches = amp_mismatches;
+  tracer->SetAmpDtype("float32");
+  FLAGS_eager_backward_num_threads = 0;
+  return grads;
+}
+
+TEST(FwdBwdJoint, ParallelBackward) {
+  eager_test::InitEnv(paddle::platform::CPUPlace());
+
+  int serial_reduce_hooks, serial_grad_hooks, serial_amp_mismatches;
+  std::vector<float> serial_grads = RunWideGraphBackward(
+      1, &serial_reduce_hooks, &serial_grad_hooks, &serial_amp_mismatches);
+  int reduce_hooks, grad_hooks, amp_mismatches;
+  std::vector<float> grads =
+      RunWideGraphBackward(4, &reduce_hooks, &grad_hooks, &amp_mismatches);
+
+  // the leaf grad is accumulated over the branches and the two runs
+  ASSERT_EQ(grads, serial_grads);
+  ASSERT_EQ(reduce_hooks, serial_reduce_hooks);
+  ASSERT_EQ(reduce_hooks, 2);
+  ASSERT_EQ(grad_hooks, serial_grad_hooks);
+  ASSERT_EQ(grad_hooks, 18);
+  // the helper threads run the hooks with the AMP dtype of the caller
+  ASSERT_EQ(serial_amp_mismatches, 0);
+  ASSERT_EQ(amp_mismatches, 0);
+}
+
 /* ---------------------------------------------------- */
 /* ---------------------- CUDA Tests ------------------ */
 /* ---------------------------------------------------- */
@@ -22,14 +22,17 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>  // NOLINT
 #include <deque>
 #include <limits>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
+#include "paddle/fluid/framework/mpmc_ring_buffer.h"
 #include "paddle/phi/core/expect.h"
 
 namespace paddle {
@@ -45,13 +48,37 @@ class ChannelObject {
     capacity_ = (std::min)(MaxCapacity(), capacity);
   }
 
-  const std::deque<T>& GetData() const { return data_; }
+  // If lock_free, the data is stored in a bounded lock-free ring buffer
+  // instead of the deque, whose size is capacity rounded up to a power of
+  // two, and SetCapacity can not raise the capacity above the ring size.
+  // Since writers do not wait for readers in the ring, a capacity of zero
+  // works as one.
+  ChannelObject(size_t capacity, bool lock_free) : ChannelObject(capacity) {
+    if (lock_free) {
+      CHECK(capacity < MaxCapacity()) << "lock-free channel must be bounded";
+      ring_.reset(new MPMCRingBuffer<T>((std::max)(capacity, size_t(1))));
+    }
+  }
+
+  const std::deque<T>& GetData() const {
+    CHECK(ring_ == nullptr) << "GetData is not supported by lock-free channel";
+    return data_;
+  }
   void Clear() {
+    if (ring_ != nullptr) {
+      T val;
+      while (ring_->TryRead(1, &val) != 0) {
+      }
+      NotifyRing();
+      return;
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     data_.clear();
     data_.shrink_to_fit();
   }
 
+  bool LockFree() const { return ring_ != nullptr; }
+
   size_t Capacity() {
     return capacity_;  // atomic
   }
@@ -60,6 +87,7 @@ class ChannelObject {
     std::lock_guard<std::mutex> lock(mutex_);
     capacity_ = std::min(MaxCapacity(), x);
     Notify();
+    NotifyRingLocked();
   }
 
   size_t BlockSize() {
@@ -88,6 +116,7 @@ class ChannelObject {
     std::lock_guard<std::mutex> lock(mutex_);
     closed_ = false;
     Notify();
+    NotifyRingLocked();
   }
 
   // close channel, then no more data can be write() to channel
@@ -95,14 +124,21 @@ class ChannelObject {
     std::lock_guard<std::mutex> lock(mutex_);
     closed_ = true;
     Notify();
+    NotifyRingLocked();
   }
 
   size_t Size() {
+    if (ring_ != nullptr) {
+      return ring_->Size();
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     return data_.size();
   }
 
   bool Empty() {
+    if (ring_ != nullptr) {
+      return ring_->Size() == 0;
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     return EmptyUnlocked();
   }
@@ -116,6 +152,9 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_ != nullptr) {
+      return RingRead(n, p, false);
+    }
 
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = Read(n, p, lock);
@@ -135,6 +174,11 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_ != nullptr) {
+      return RingWrite(n, [this, p](size_t finished, size_t m) {
+        return ring_->TryWrite(m, p + finished, RingCapacity());
+      });
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = Write(n, p, lock);
     Notify();
@@ -146,6 +190,11 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_ != nullptr) {
+      return RingWrite(n, [this, p](size_t finished, size_t m) {
+        return ring_->TryWriteMove(m, p + finished, RingCapacity());
+      });
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = WriteMove(n, p, lock);
     Notify();
@@ -164,6 +213,12 @@ class ChannelObject {
     if (size == 0) {
       return 0;
     }
+    if (ring_ != nullptr) {
+      p.resize(size);
+      size_t finished = RingRead(size, &p[0], true);
+      p.resize(finished);
+      return finished;
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     p.resize(size);
     size_t finished = Read(size, &p[0], lock, true);
@@ -194,9 +249,9 @@ class ChannelObject {
   size_t Write(std::vector<T>&& p) { return WriteMove(p.size(), &p[0]); }
 
  private:
-  size_t capacity_ = MaxCapacity();
-  size_t block_size_ = 1024;
-  bool closed_ = false;
+  std::atomic<size_t> capacity_{MaxCapacity()};
+  std::atomic<size_t> block_size_{1024};
+  std::atomic<bool> closed_{false};
   std::mutex mutex_;
   // use deque to store data
   std::deque<T> data_;
@@ -205,6 +260,11 @@ class ChannelObject {
   int full_waiters_ = 0;
   std::condition_variable empty_cond_;
   std::condition_variable full_cond_;
+  // only used by the lock-free channel, the mutex and ring_cond_ are only
+  // touched when there are waiters
+  std::unique_ptr<MPMCRingBuffer<T>> ring_;
+  std::atomic<int> ring_waiters_{0};
+  std::condition_variable ring_cond_;
 
   static constexpr size_t MaxCapacity() {
     return (std::numeric_limits<size_t>::max)() / 2;
@@ -221,6 +281,84 @@ class ChannelObject {
 
   bool EmptyUnlocked() { return data_.empty(); }
 
+  size_t RingCapacity() {
+    return (std::max)((std::min)(capacity_.load(), ring_->RingSize()),
+                      size_t(1));
+  }
+
+  void NotifyRing() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring_waiters_.load() != 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ring_cond_.notify_all();
+    }
+  }
+
+  void NotifyRingLocked() {
+    if (ring_ != nullptr && ring_waiters_.load() != 0) {
+      ring_cond_.notify_all();
+    }
+  }
+
+  // Spin a while and then sleep until ready() is true. Since a notifier
+  // updates the ring before it checks ring_waiters_, and a waiter checks
+  // ready() after it registers in ring_waiters_, no wakeup is missed.
+  template <class Ready>
+  void RingWait(Ready&& ready) {
+    for (int spin = 0; spin < 64; ++spin) {
+      if (ready()) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+    ring_waiters_++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ring_cond_.wait(lock, ready);
+    }
+    ring_waiters_--;
+  }
+
+  size_t RingRead(size_t n, T* p, bool once) {
+    size_t finished = 0;
+    while (finished < n) {
+      size_t m = ring_->TryRead(n - finished, p + finished);
+      if (m > 0) {
+        finished += m;
+        NotifyRing();
+        if (once) {
+          break;
+        }
+        continue;
+      }
+      if (closed_ && ring_->Size() == 0) {
+        break;
+      }
+      RingWait([this] { return ring_->Size() != 0 || closed_; });
+    }
+    return finished;
+  }
+
+  // try_write(finished, m) writes at most m items after the first finished
+  // ones, and returns the number of items written
+  template <class TryWrite>
+  size_t RingWrite(size_t n, TryWrite&& try_write) {
+    size_t finished = 0;
+    while (finished < n && !closed_) {
+      size_t m = try_write(finished, n - finished);
+      if (m > 0) {
+        finished += m;
+        NotifyRing();
+        continue;
+      }
+      RingWait([this] {
+        return ring_->Size() < RingCapacity() || closed_;
+      });
+    }
+    return finished;
+  }
+
   bool FullUnlocked() { return data_.size() >= capacity_ + reading_count_; }
 
   bool WaitForRead(std::unique_lock<std::mutex>& lock) {  // NOLINT
@@ -314,6 +452,12 @@ Channel<T> MakeChannel(size_t capacity = (std::numeric_limits<size_t>::max)()) {
   return std::make_shared<ChannelObject<T>>(capacity);
 }
 
+// The channel is backed by a bounded lock-free ring buffer, see ChannelObject
+template <class T>
+Channel<T> MakeLockFreeChannel(size_t capacity) {
+  return std::make_shared<ChannelObject<T>>(capacity, true);
+}
+
 template <class T, class U>
 Channel<T> MakeChannel(const Channel<U>& other) {
   CHECK(other != nullptr) << "channel can not be NULL";
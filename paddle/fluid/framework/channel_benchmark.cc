@@ -0,0 +1,93 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compare the throughput of the deque channel and the lock-free channel,
+// e.g. ./channel_benchmark --producers=48 --consumers=48 --block_size=1024
+
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+#include "paddle/fluid/framework/channel.h"
+
+DEFINE_int32(producers, 16, "The number of writer threads.");
+DEFINE_int32(consumers, 16, "The number of reader threads.");
+DEFINE_int64(items, 1000000, "The number of items written by each writer.");
+DEFINE_int32(block_size, 1024, "The block size of the channels.");
+DEFINE_int64(capacity, 65536, "The capacity of the channels.");
+
+namespace paddle {
+namespace framework {
+
+static double RunBenchmark(Channel<uint64_t> channel) {
+  channel->SetBlockSize(FLAGS_block_size);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers;
+  for (int i = 0; i < FLAGS_producers; ++i) {
+    producers.emplace_back([channel] {
+      ChannelWriter<uint64_t> writer(channel.get());
+      for (uint64_t j = 0; j < static_cast<uint64_t>(FLAGS_items); ++j) {
+        writer << j;
+      }
+      writer.Flush();
+    });
+  }
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < FLAGS_consumers; ++i) {
+    consumers.emplace_back([channel] {
+      std::vector<uint64_t> block;
+      uint64_t sum = 0;
+      while (channel->Read(block) != 0) {
+        for (auto x : block) {
+          sum += x;
+        }
+      }
+      VLOG(3) << "sum " << sum;
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  channel->Close();
+  for (auto& t : consumers) {
+    t.join();
+  }
+  std::chrono::duration<double> cost =
+      std::chrono::steady_clock::now() - start;
+  return FLAGS_producers * FLAGS_items / cost.count();
+}
+
+}  // namespace framework
+}  // namespace paddle
+
+int main(int argc, char* argv[]) {
+  ::GFLAGS_NAMESPACE::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+  using paddle::framework::MakeChannel;
+  using paddle::framework::MakeLockFreeChannel;
+  LOG(INFO) << FLAGS_producers << " writers, " << FLAGS_consumers
+            << " readers, block size " << FLAGS_block_size << ", capacity "
+            << FLAGS_capacity;
+  LOG(INFO) << "deque channel: "
+            << paddle::framework::RunBenchmark(
+                   MakeChannel<uint64_t>(FLAGS_capacity))
+            << " items/s";
+  LOG(INFO) << "lock-free channel: "
+            << paddle::framework::RunBenchmark(
+                   MakeLockFreeChannel<uint64_t>(FLAGS_capacity))
+            << " items/s";
+  return 0;
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/channel.h"
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+// Every producer writes 1 to kItemNum in blocks, and the consumers read
+// blocks until the channel is closed and drained.
+static void CheckMPMC(Channel<int64_t> channel,
+                      int producer_num,
+                      int consumer_num) {
+  constexpr int64_t kItemNum = 20000;
+  channel->SetBlockSize(64);
+  std::vector<std::thread> producers;
+  for (int i = 0; i < producer_num; ++i) {
+    producers.emplace_back([channel] {
+      ChannelWriter<int64_t> writer(channel.get());
+      for (int64_t j = 1; j <= kItemNum; ++j) {
+        writer << j;
+      }
+      writer.Flush();
+      ASSERT_TRUE(static_cast<bool>(writer));
+    });
+  }
+  std::vector<int64_t> sums(consumer_num, 0);
+  std::vector<int64_t> counts(consumer_num, 0);
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < consumer_num; ++i) {
+    consumers.emplace_back([channel, i, &sums, &counts] {
+      std::vector<int64_t> block;
+      while (channel->Read(block) != 0) {
+        ASSERT_LE(block.size(), channel->BlockSize());
+        for (auto x : block) {
+          sums[i] += x;
+        }
+        counts[i] += block.size();
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  channel->Close();
+  for (auto& t : consumers) {
+    t.join();
+  }
+  int64_t sum = 0, count = 0;
+  for (int i = 0; i < consumer_num; ++i) {
+    sum += sums[i];
+    count += counts[i];
+  }
+  ASSERT_EQ(count, producer_num * kItemNum);
+  ASSERT_EQ(sum, producer_num * kItemNum * (kItemNum + 1) / 2);
+  ASSERT_TRUE(channel->Empty());
+}
+
+TEST(Channel, MPMC) {
+  CheckMPMC(MakeChannel<int64_t>(100), 4, 4);
+  CheckMPMC(MakeLockFreeChannel<int64_t>(100), 4, 4);
+  CheckMPMC(MakeLockFreeChannel<int64_t>(1), 3, 5);
+  // the capacity can be lowered below the ring size
+  auto channel = MakeLockFreeChannel<int64_t>(1000);
+  channel->SetCapacity(7);
+  CheckMPMC(channel, 5, 3);
+}
+
+TEST(Channel, LockFreeCapacity) {
+  auto channel = MakeLockFreeChannel<int>(5);
+  ASSERT_TRUE(channel->LockFree());
+  std::vector<int> data{1, 2, 3, 4, 5};
+  ASSERT_EQ(channel->Write(data), 5UL);
+  ASSERT_EQ(channel->Size(), 5UL);
+
+  // the writer is blocked until the channel is not full
+  std::thread writer([channel] { ASSERT_TRUE(channel->Put(6)); });
+  std::vector<int> res;
+  ASSERT_EQ(channel->ReadOnce(res, 2), 2UL);
+  ASSERT_EQ(res, std::vector<int>({1, 2}));
+  writer.join();
+  ASSERT_EQ(channel->Size(), 4UL);
+
+  channel->Clear();
+  ASSERT_TRUE(channel->Empty());
+  // a capacity of zero works as one
+  channel->SetCapacity(0);
+  ASSERT_TRUE(channel->Put(7));
+  int val = 0;
+  ASSERT_TRUE(channel->Get(val));
+  ASSERT_EQ(val, 7);
+}
+
+TEST(Channel, LockFreeClose) {
+  auto channel = MakeLockFreeChannel<int>(2);
+  std::vector<int> res;
+  // the reader is blocked until the channel is closed
+  std::thread reader([channel, &res] { channel->ReadAll(res); });
+  ASSERT_TRUE(channel->Put(1));
+  ASSERT_TRUE(channel->Put(2));
+  channel->Close();
+  reader.join();
+  ASSERT_EQ(res, std::vector<int>({1, 2}));
+  // no data can be written to a closed channel, and the blocked writers
+  // are waked up
+  ASSERT_FALSE(channel->Put(3));
+  channel->Open();
+  ASSERT_TRUE(channel->Put(3));
+  ASSERT_TRUE(channel->Put(4));
+  std::thread writer([channel] { ASSERT_FALSE(channel->Put(5)); });
+  channel->Close();
+  writer.join();
+  ASSERT_EQ(channel->ReadAll(res), 2UL);
+  ASSERT_EQ(res, std::vector<int>({3, 4}));
+}
+
+}  // namespace framework
+}  // namespace paddle
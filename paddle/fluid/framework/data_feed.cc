@@ -19,6 +19,9 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/data_feed.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "paddle/fluid/framework/fleet/ps_gpu_wrapper.h"
 #ifdef _LINUX
 #include <stdio_ext.h>
@@ -26,11 +29,15 @@ limitations under the License. */
 #include <sys/stat.h>
 #endif
 #include "io/fs.h"
+#include "paddle/fluid/framework/io/local_line_reader.h"
+#include "paddle/fluid/framework/threadpool.h"
 #include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/timer.h"
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 DECLARE_bool(enable_ins_parser_file);
+DECLARE_bool(enable_lock_free_channel);
+DECLARE_int32(native_file_reader_thread_num);
 namespace paddle {
 namespace framework {
 
@@ -39,6 +46,54 @@ DLManager& global_dlmanager_pool() {
   return manager;
 }
 
+// The threads shared by the native file readers of all the reader threads,
+// so that at most FLAGS_native_file_reader_thread_num helper threads read
+// the files in process.
+static ThreadPool* NativeFileReaderPool() {
+  static ThreadPool pool(std::max(FLAGS_native_file_reader_thread_num, 1));
+  return &pool;
+}
+
+// Read a local file by LocalLineReader, the file is split into at most
+// FLAGS_native_file_reader_thread_num chunks, and chunk_func is called with
+// every chunk. The chunks are taken by the calling thread and the threads of
+// NativeFileReaderPool, so a busy pool does not stall the calling thread.
+// The first exception thrown by chunk_func is rethrown after all the chunks
+// are done.
+static void RunNativeFileReader(
+    const std::string& filename,
+    const std::function<void(const LocalLineReader::Chunk&)>& chunk_func) {
+  // not worth a thread for a chunk less than 1MB
+  constexpr size_t kMinChunkSize = 1 << 20;
+  LocalLineReader reader(filename);
+  auto chunks =
+      reader.Split(FLAGS_native_file_reader_thread_num, kMinChunkSize);
+  std::vector<std::exception_ptr> errors(chunks.size());
+  std::atomic<size_t> next_chunk{0};
+  auto run_chunks = [&chunks, &errors, &chunk_func, &next_chunk]() {
+    for (size_t i = next_chunk++; i < chunks.size(); i = next_chunk++) {
+      try {
+        chunk_func(chunks[i]);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    futures.emplace_back(NativeFileReaderPool()->Run(run_chunks));
+  }
+  run_chunks();
+  for (auto& f : futures) {
+    f.wait();
+  }
+  for (auto& error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
 class BufferedLineFileReader {
   typedef std::function<bool()> SampleFunc;
   static const int MAX_FILE_BUFF_SIZE = 4 * 1024 * 1024;
@@ -287,7 +342,9 @@ void PrivateQueueDataFeed<T>::SetQueueSize(int queue_size) {
       platform::errors::InvalidArgument(
           "Queue size %d is illegal in PrivateQueueDataFeed.", queue_size));
   queue_size_ = queue_size;
-  queue_ = paddle::framework::MakeChannel<T>();
+  queue_ = FLAGS_enable_lock_free_channel
+               ? paddle::framework::MakeLockFreeChannel<T>(queue_size)
+               : paddle::framework::MakeChannel<T>();
   queue_->SetCapacity(queue_size);
 }
 
@@ -519,6 +576,52 @@ void InMemoryDataFeed<T>::SetParseUid(bool parse_uid) {
   parse_uid_ = parse_uid;
 }
 
+template <typename T>
+bool InMemoryDataFeed<T>::UseNativeReader(const std::string& filename) {
+#ifdef _LINUX
+  return FLAGS_native_file_reader_thread_num > 0 && SupportNativeReader() &&
+         LocalLineReader::CanRead(filename, this->pipe_command_);
+#else
+  return false;
+#endif
+}
+
+template <typename T>
+void InMemoryDataFeed<T>::LoadIntoMemoryByNativeReader(
+    const std::string& filename) {
+  platform::Timer timeline;
+  timeline.Start();
+  std::atomic<uint64_t> fea_num(0);
+  std::atomic<size_t> lines(0);
+  RunNativeFileReader(
+      filename,
+      [this, &fea_num, &lines](const LocalLineReader::Chunk& chunk) {
+        paddle::framework::ChannelWriter<T> writer(input_channel_);
+        uint64_t chunk_fea_num = 0;
+        lines += LocalLineReader::ReadLines(
+            chunk, [this, &writer, &chunk_fea_num](const std::string& line) {
+              T instance;
+              if (!ParseOneInstanceFromLine(line, &instance, &chunk_fea_num)) {
+                return false;
+              }
+              writer << std::move(instance);
+              return true;
+            });
+        writer.Flush();
+        fea_num += chunk_fea_num;
+      });
+  STAT_ADD(STAT_total_feasign_num_in_mem, fea_num.load());
+  {
+    std::lock_guard<std::mutex> flock(*mutex_for_fea_num_);
+    *total_fea_num_ += fea_num.load();
+  }
+  timeline.Pause();
+  VLOG(3) << "LoadIntoMemoryByNativeReader() read all lines, file="
+          << filename << ", lines=" << lines
+          << ", cost time=" << timeline.ElapsedSec()
+          << " seconds, thread_id=" << thread_id_;
+}
+
 template <typename T>
 void InMemoryDataFeed<T>::LoadIntoMemory() {
 #ifdef _LINUX
@@ -531,6 +634,10 @@ void InMemoryDataFeed<T>::LoadIntoMemory() {
   while (this->PickOneFile(&filename)) {
     VLOG(3) << "PickOneFile, filename=" << filename
             << ", thread_id=" << thread_id_;
+    if (UseNativeReader(filename)) {
+      LoadIntoMemoryByNativeReader(filename);
+      continue;
+    }
 #ifdef PADDLE_WITH_BOX_PS
     if (BoxWrapper::GetInstance()->UseAfsApi()) {
       this->fp_ = BoxWrapper::GetInstance()->afs_manager->GetFile(
@@ -1131,129 +1238,138 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
   if (!reader.getline(&*(fp_.get()))) {
     return false;
   } else {
-    const char* str = reader.get();
-    std::string line = std::string(str);
-    // VLOG(3) << line;
-    char* endptr = const_cast<char*>(str);
-    int pos = 0;
-    if (parse_ins_id_) {
-      int num = strtol(&str[pos], &endptr, 10);
-      CHECK(num == 1);  // NOLINT
-      pos = endptr - str + 1;
-      size_t len = 0;
-      while (str[pos + len] != ' ') {
-        ++len;
-      }
-      instance->ins_id_ = std::string(str + pos, len);
-      pos += len + 1;
-      VLOG(3) << "ins_id " << instance->ins_id_;
+    return ParseOneInstanceFromLine(
+        std::string(reader.get()), instance, &fea_num_);
+  }
+#else
+  return false;
+#endif
+}
+
+bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromLine(
+    const std::string& line, Record* instance, uint64_t* fea_num) {
+#ifdef _LINUX
+  const char* str = line.c_str();
+  // VLOG(3) << line;
+  char* endptr = const_cast<char*>(str);
+  int pos = 0;
+  if (parse_ins_id_) {
+    int num = strtol(&str[pos], &endptr, 10);
+    CHECK(num == 1);  // NOLINT
+    pos = endptr - str + 1;
+    size_t len = 0;
+    while (str[pos + len] != ' ') {
+      ++len;
     }
-    if (parse_content_) {
-      int num = strtol(&str[pos], &endptr, 10);
-      CHECK(num == 1);  // NOLINT
-      pos = endptr - str + 1;
-      size_t len = 0;
-      while (str[pos + len] != ' ') {
-        ++len;
-      }
-      instance->content_ = std::string(str + pos, len);
-      pos += len + 1;
-      VLOG(3) << "content " << instance->content_;
+    instance->ins_id_ = std::string(str + pos, len);
+    pos += len + 1;
+    VLOG(3) << "ins_id " << instance->ins_id_;
+  }
+  if (parse_content_) {
+    int num = strtol(&str[pos], &endptr, 10);
+    CHECK(num == 1);  // NOLINT
+    pos = endptr - str + 1;
+    size_t len = 0;
+    while (str[pos + len] != ' ') {
+      ++len;
     }
-    if (parse_logkey_) {
-      int num = strtol(&str[pos], &endptr, 10);
-      CHECK(num == 1);  // NOLINT
-      pos = endptr - str + 1;
-      size_t len = 0;
-      while (str[pos + len] != ' ') {
-        ++len;
-      }
-      // parse_logkey
-      std::string log_key = std::string(str + pos, len);
-      uint64_t search_id;
-      uint32_t cmatch;
-      uint32_t rank;
-      GetMsgFromLogKey(log_key, &search_id, &cmatch, &rank);
-
-      instance->ins_id_ = log_key;
-      instance->search_id = search_id;
-      instance->cmatch = cmatch;
-      instance->rank = rank;
-      pos += len + 1;
+    instance->content_ = std::string(str + pos, len);
+    pos += len + 1;
+    VLOG(3) << "content " << instance->content_;
+  }
+  if (parse_logkey_) {
+    int num = strtol(&str[pos], &endptr, 10);
+    CHECK(num == 1);  // NOLINT
+    pos = endptr - str + 1;
+    size_t len = 0;
+    while (str[pos + len] != ' ') {
+      ++len;
     }
-    for (size_t i = 0; i < use_slots_index_.size(); ++i) {
-      int idx = use_slots_index_[i];
-      int num = strtol(&str[pos], &endptr, 10);
-      PADDLE_ENFORCE_NE(
-          num,
-          0,
-          platform::errors::InvalidArgument(
-              "The number of ids can not be zero, you need padding "
-              "it in data generator; or if there is something wrong with "
-              "the data, please check if the data contains unresolvable "
-              "characters.\nplease check this error line: %s, \n Specifically, "
-              "something wrong happened(the length of this slot's feasign is 0)"
-              "when we parse the %d th slots."
-              "Maybe something wrong around this slot"
-              "\nWe detect the feasign number of this slot is %d, "
-              "which is illegal.",
-              str,
-              i,
-              num));
+    // parse_logkey
+    std::string log_key = std::string(str + pos, len);
+    uint64_t search_id;
+    uint32_t cmatch;
+    uint32_t rank;
+    GetMsgFromLogKey(log_key, &search_id, &cmatch, &rank);
+
+    instance->ins_id_ = log_key;
+    instance->search_id = search_id;
+    instance->cmatch = cmatch;
+    instance->rank = rank;
+    pos += len + 1;
+  }
+  for (size_t i = 0; i < use_slots_index_.size(); ++i) {
+    int idx = use_slots_index_[i];
+    int num = strtol(&str[pos], &endptr, 10);
+    PADDLE_ENFORCE_NE(
+        num,
+        0,
+        platform::errors::InvalidArgument(
+            "The number of ids can not be zero, you need padding "
+            "it in data generator; or if there is something wrong with "
+            "the data, please check if the data contains unresolvable "
+            "characters.\nplease check this error line: %s, \n Specifically, "
+            "something wrong happened(the length of this slot's feasign is 0)"
+            "when we parse the %d th slots."
+            "Maybe something wrong around this slot"
+            "\nWe detect the feasign number of this slot is %d, "
+            "which is illegal.",
+            str,
+            i,
+            num));
 #ifdef PADDLE_WITH_PSLIB
-      if (parse_uid_ && all_slots_[i] == uid_slot_) {
-        PADDLE_ENFORCE(num == 1 && all_slots_type_[i][0] == 'u',
-                       platform::errors::PreconditionNotMet(
-                           "The uid has to be uint64 and single.\n"
-                           "please check this error line: %s",
-                           str));
+    if (parse_uid_ && all_slots_[i] == uid_slot_) {
+      PADDLE_ENFORCE(num == 1 && all_slots_type_[i][0] == 'u',
+                     platform::errors::PreconditionNotMet(
+                         "The uid has to be uint64 and single.\n"
+                         "please check this error line: %s",
+                         str));
 
-        char* uidptr = endptr;
-        uint64_t feasign = (uint64_t)strtoull(uidptr, &uidptr, 10);
-        instance->uid_ = feasign;
-      }
+      char* uidptr = endptr;
+      uint64_t feasign = (uint64_t)strtoull(uidptr, &uidptr, 10);
+      instance->uid_ = feasign;
+    }
 #endif
-      if (idx != -1) {
-        if (all_slots_type_[i][0] == 'f') {  // float
-          for (int j = 0; j < num; ++j) {
-            float feasign = strtof(endptr, &endptr);
-            // if float feasign is equal to zero, ignore it
-            // except when slot is dense
-            if (fabs(feasign) < 1e-6 && !use_slots_is_dense_[i]) {
-              continue;
-            }
-            FeatureFeasign f;
-            f.float_feasign_ = feasign;
-            instance->float_feasigns_.push_back(FeatureItem(f, idx));
-          }
-        } else if (all_slots_type_[i][0] == 'u') {  // uint64
-          for (int j = 0; j < num; ++j) {
-            uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
-            // if uint64 feasign is equal to zero, ignore it
-            // except when slot is dense
-            if (feasign == 0 && !use_slots_is_dense_[i]) {
-              continue;
-            }
-            FeatureFeasign f;
-            f.uint64_feasign_ = feasign;
-            instance->uint64_feasigns_.push_back(FeatureItem(f, idx));
+    if (idx != -1) {
+      if (all_slots_type_[i][0] == 'f') {  // float
+        for (int j = 0; j < num; ++j) {
+          float feasign = strtof(endptr, &endptr);
+          // if float feasign is equal to zero, ignore it
+          // except when slot is dense
+          if (fabs(feasign) < 1e-6 && !use_slots_is_dense_[i]) {
+            continue;
           }
+          FeatureFeasign f;
+          f.float_feasign_ = feasign;
+          instance->float_feasigns_.push_back(FeatureItem(f, idx));
         }
-        pos = endptr - str;
-      } else {
-        for (int j = 0; j <= num; ++j) {
-          // pos = line.find_first_of(' ', pos + 1);
-          while (line[pos + 1] != ' ') {
-            pos++;
+      } else if (all_slots_type_[i][0] == 'u') {  // uint64
+        for (int j = 0; j < num; ++j) {
+          uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
+          // if uint64 feasign is equal to zero, ignore it
+          // except when slot is dense
+          if (feasign == 0 && !use_slots_is_dense_[i]) {
+            continue;
           }
+          FeatureFeasign f;
+          f.uint64_feasign_ = feasign;
+          instance->uint64_feasigns_.push_back(FeatureItem(f, idx));
+        }
+      }
+      pos = endptr - str;
+    } else {
+      for (int j = 0; j <= num; ++j) {
+        // pos = line.find_first_of(' ', pos + 1);
+        while (line[pos + 1] != ' ') {
+          pos++;
         }
       }
     }
-    instance->float_feasigns_.shrink_to_fit();
-    instance->uint64_feasigns_.shrink_to_fit();
-    fea_num_ += instance->uint64_feasigns_.size();
-    return true;
   }
+  instance->float_feasigns_.shrink_to_fit();
+  instance->uint64_feasigns_.shrink_to_fit();
+  *fea_num += instance->uint64_feasigns_.size();
+  return true;
 #else
   return false;
 #endif
@@ -2002,6 +2118,96 @@ void PaddleBoxDataFeed::PutToFeedVec(const std::vector<Record*>& ins_vec) {
 }
 
 template class InMemoryDataFeed<SlotRecord>;
+
+void SlotRecordColumns::Build(const std::vector<UsedSlotInfo>& used_slots,
+                              const SlotRecord* records,
+                              size_t record_num,
+                              int thread_num) {
+  platform::Timer timeline;
+  timeline.Start();
+  record_num_ = record_num;
+  size_t slot_num = used_slots.size();
+  values_.clear();
+  values_.resize(slot_num);
+  offsets_.clear();
+  offsets_.resize(slot_num);
+
+  std::atomic<size_t> next_slot{0};
+  auto build_func = [&]() {
+    for (size_t j = next_slot++; j < slot_num; j = next_slot++) {
+      BuildSlot(used_slots[j], records, &values_[j], &offsets_[j]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < thread_num && static_cast<size_t>(i) < slot_num; ++i) {
+    threads.emplace_back(build_func);
+  }
+  build_func();
+  for (auto& t : threads) {
+    t.join();
+  }
+  timeline.Pause();
+  VLOG(3) << "build columns of " << slot_num << " slots and " << record_num
+          << " records, memory size=" << MemorySize()
+          << ", span=" << timeline.ElapsedSec();
+}
+
+void SlotRecordColumns::BuildSlot(const UsedSlotInfo& info,
+                                  const SlotRecord* records,
+                                  phi::DenseTensor* values,
+                                  std::vector<size_t>* offsets) {
+  bool is_float = info.type[0] == 'f';
+  offsets->resize(record_num_ + 1);
+  (*offsets)[0] = 0;
+  for (size_t i = 0; i < record_num_; ++i) {
+    size_t fea_num = 0;
+    if (is_float) {
+      records[i]->slot_float_feasigns_.get_values(info.slot_value_idx,
+                                                  &fea_num);
+    } else {
+      records[i]->slot_uint64_feasigns_.get_values(info.slot_value_idx,
+                                                   &fea_num);
+      fea_num = std::max<size_t>(fea_num, 1);
+    }
+    (*offsets)[i + 1] = (*offsets)[i] + fea_num;
+  }
+
+  int64_t total = static_cast<int64_t>(offsets->back());
+  if (is_float) {
+    float* dst = values->mutable_data<float>({total, 1}, platform::CPUPlace());
+    for (size_t i = 0; i < record_num_; ++i) {
+      size_t fea_num = 0;
+      float* src = records[i]->slot_float_feasigns_.get_values(
+          info.slot_value_idx, &fea_num);
+      if (fea_num > 0) {
+        memcpy(dst + (*offsets)[i], src, sizeof(float) * fea_num);
+      }
+    }
+  } else {
+    // no uint64_t type in paddlepaddle
+    int64_t* dst =
+        values->mutable_data<int64_t>({total, 1}, platform::CPUPlace());
+    for (size_t i = 0; i < record_num_; ++i) {
+      size_t fea_num = 0;
+      uint64_t* src = records[i]->slot_uint64_feasigns_.get_values(
+          info.slot_value_idx, &fea_num);
+      if (fea_num > 0) {
+        memcpy(dst + (*offsets)[i], src, sizeof(uint64_t) * fea_num);
+      } else {
+        dst[(*offsets)[i]] = 0;
+      }
+    }
+  }
+}
+
+size_t SlotRecordColumns::MemorySize() const {
+  size_t size = 0;
+  for (size_t j = 0; j < values_.size(); ++j) {
+    size += values_[j].memory_size() + offsets_[j].size() * sizeof(size_t);
+  }
+  return size;
+}
+
 void SlotRecordInMemoryDataFeed::Init(const DataFeedDesc& data_feed_desc) {
   finish_init_ = false;
   finish_set_filelist_ = false;
@@ -2309,6 +2515,10 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand(void) {
   while (this->PickOneFile(&filename)) {
     VLOG(3) << "PickOneFile, filename=" << filename
             << ", thread_id=" << thread_id_;
+    if (UseNativeReader(filename)) {
+      LoadIntoMemoryByNativeReader(filename);
+      continue;
+    }
     int lines = 0;
     std::vector<SlotRecord> record_vec;
     platform::Timer timeline;
@@ -2365,6 +2575,51 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand(void) {
 #endif
 }
 
+void SlotRecordInMemoryDataFeed::LoadIntoMemoryByNativeReader(
+    const std::string& filename) {
+  platform::Timer timeline;
+  timeline.Start();
+  std::atomic<size_t> lines(0);
+  RunNativeFileReader(
+      filename,
+      [this, &filename, &lines](const LocalLineReader::Chunk& chunk) {
+        std::vector<SlotRecord> record_vec;
+        SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+        int offset = 0;
+        lines += LocalLineReader::ReadLines(
+            chunk,
+            [this, &record_vec, &offset, &filename](const std::string& line) {
+              if (!ParseOneInstance(line, &record_vec[offset])) {
+                LOG(WARNING) << "read file:[" << filename
+                             << "] item error, line:[" << line << "]";
+                return false;
+              }
+              if (++offset >= OBJPOOL_BLOCK_SIZE) {
+                input_channel_->Write(std::move(record_vec));
+                record_vec.clear();
+                SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+                offset = 0;
+              }
+              return true;
+            },
+            sample_rate_);
+        if (offset > 0) {
+          input_channel_->WriteMove(offset, &record_vec[0]);
+          if (offset < OBJPOOL_BLOCK_SIZE) {
+            SlotRecordPool().put(&record_vec[offset],
+                                 (OBJPOOL_BLOCK_SIZE - offset));
+          }
+        } else {
+          SlotRecordPool().put(&record_vec);
+        }
+      });
+  timeline.Pause();
+  VLOG(3) << "LoadIntoMemoryByNativeReader() read all lines, file="
+          << filename << ", lines=" << lines
+          << ", cost time=" << timeline.ElapsedSec()
+          << " seconds, thread_id=" << thread_id_;
+}
+
 static void parser_log_key(const std::string& log_key,
                            uint64_t* search_id,
                            uint32_t* cmatch,
@@ -2570,6 +2825,55 @@ void SlotRecordInMemoryDataFeed::PutToFeedVec(const SlotRecord* ins_vec,
 #endif
 }
 
+void SlotRecordInMemoryDataFeed::PutToFeedVecFromColumns(int begin, int num) {
+  for (int j = 0; j < use_slot_size_; ++j) {
+    auto& feed = feed_vec_[j];
+    if (feed == nullptr) {
+      continue;
+    }
+
+    const auto& column_offsets = columns_->Offsets(j);
+    size_t value_begin = column_offsets[begin];
+    size_t value_end = column_offsets[begin + num];
+    int64_t total_instance = static_cast<int64_t>(value_end - value_begin);
+
+    auto& slot_offset = offset_[j];
+    slot_offset.resize(num + 1);
+    for (int i = 0; i <= num; ++i) {
+      slot_offset[i] = column_offsets[begin + i] - value_begin;
+    }
+
+    auto& info = used_slots_info_[j];
+    const auto& column = columns_->Values(j);
+    if (platform::is_cpu_place(this->place_) && total_instance > 0) {
+      feed->ShareDataWith(column.Slice(value_begin, value_end));
+    } else if (info.type[0] == 'f') {  // float
+      float* tensor_ptr =
+          feed->mutable_data<float>({total_instance, 1}, this->place_);
+      CopyToFeedTensor(tensor_ptr,
+                       column.data<float>() + value_begin,
+                       total_instance * sizeof(float));
+    } else if (info.type[0] == 'u') {  // uint64
+      int64_t* tensor_ptr =
+          feed->mutable_data<int64_t>({total_instance, 1}, this->place_);
+      CopyToFeedTensor(tensor_ptr,
+                       column.data<int64_t>() + value_begin,
+                       total_instance * sizeof(int64_t));
+    }
+
+    if (info.dense) {
+      if (info.inductive_shape_index != -1) {
+        info.local_shape[info.inductive_shape_index] =
+            total_instance / info.total_dims_without_inductive;
+      }
+      feed->Resize(phi::make_ddim(info.local_shape));
+    } else {
+      LoD data_lod{slot_offset};
+      feed_vec_[j]->set_lod(data_lod);
+    }
+  }
+}
+
 void SlotRecordInMemoryDataFeed::ExpandSlotRecord(SlotRecord* rec) {
   SlotRecord& ins = (*rec);
   if (ins->slot_float_feasigns_.slot_offsets.empty()) {
@@ -2670,7 +2974,9 @@ int SlotRecordInMemoryDataFeed::Next() {
     this->batch_size_ = batch.second;
     VLOG(3) << "batch_size_=" << this->batch_size_
             << ", thread_id=" << thread_id_;
-    if (this->batch_size_ != 0) {
+    if (this->batch_size_ != 0 && columns_ != nullptr) {
+      PutToFeedVecFromColumns(batch.first, this->batch_size_);
+    } else if (this->batch_size_ != 0) {
       PutToFeedVec(&records_[batch.first], this->batch_size_);
     } else {
       VLOG(3) << "finish reading for heterps, batch size zero, thread_id="
@@ -375,6 +375,42 @@ inline SlotObjPool& SlotRecordPool() {
   static SlotObjPool pool;
   return pool;
 }
+
+// SlotRecordColumns keeps the values of the used slots of the records in
+// columns: the values of a slot of all the records are contiguous in one
+// tensor, and the values of the i-th record are in [offsets[i], offsets[i+1])
+// of the column. A minibatch of consecutive records is fed by slicing the
+// columns, so the feed tensors share the memory of the columns instead of
+// copying the values record by record. As PutToFeedVec, an empty uint64 slot
+// of a record is filled with one value 0.
+class SlotRecordColumns {
+ public:
+  // Build the columns of the records, the slots are built by thread_num
+  // threads in parallel.
+  void Build(const std::vector<UsedSlotInfo>& used_slots,
+             const SlotRecord* records,
+             size_t record_num,
+             int thread_num);
+
+  size_t RecordNum() const { return record_num_; }
+  // The memory size of the values and offsets in bytes.
+  size_t MemorySize() const;
+
+  const phi::DenseTensor& Values(int slot) const { return values_[slot]; }
+  const std::vector<size_t>& Offsets(int slot) const {
+    return offsets_[slot];
+  }
+
+ private:
+  void BuildSlot(const UsedSlotInfo& info,
+                 const SlotRecord* records,
+                 phi::DenseTensor* values,
+                 std::vector<size_t>* offsets);
+
+  size_t record_num_ = 0;
+  std::vector<phi::DenseTensor> values_;
+  std::vector<std::vector<size_t>> offsets_;
+};
 struct PvInstanceObject {
   std::vector<Record*> ads;
   void merge_instance(Record* ins) { ads.push_back(ins); }
@@ -1201,6 +1237,7 @@ class InMemoryDataFeed : public DataFeed {
   virtual void SetCurrentPhase(int current_phase);
   virtual void LoadIntoMemory();
   virtual void LoadIntoMemoryFromSo();
+  virtual void LoadIntoMemoryByNativeReader(const std::string& filename);
   virtual void SetRecord(T* records) { records_ = records; }
   int GetDefaultBatchSize() { return default_batch_size_; }
   void AddBatchOffset(const std::pair<int, int>& offset) {
@@ -1210,6 +1247,17 @@ class InMemoryDataFeed : public DataFeed {
  protected:
   virtual bool ParseOneInstance(T* instance) = 0;
   virtual bool ParseOneInstanceFromPipe(T* instance) = 0;
+  // Parse an instance from one line of a local file read in process, the
+  // number of feasigns is added to fea_num. It is called by several threads
+  // at the same time, and is only used if SupportNativeReader is true.
+  virtual bool ParseOneInstanceFromLine(const std::string& line,
+                                        T* instance,
+                                        uint64_t* fea_num) {
+    return false;
+  }
+  virtual bool SupportNativeReader() { return false; }
+  // Whether the file is read by LocalLineReader instead of the pipe command
+  bool UseNativeReader(const std::string& filename);
   virtual void ParseOneInstanceFromSo(const char* str,
                                       T* instance,
                                       CustomParser* parser) {}
@@ -1597,6 +1645,10 @@ class MultiSlotInMemoryDataFeed : public InMemoryDataFeed<Record> {
  protected:
   virtual bool ParseOneInstance(Record* instance);
   virtual bool ParseOneInstanceFromPipe(Record* instance);
+  virtual bool ParseOneInstanceFromLine(const std::string& line,
+                                        Record* instance,
+                                        uint64_t* fea_num);
+  virtual bool SupportNativeReader() { return true; }
   virtual void ParseOneInstanceFromSo(const char* str,
                                       Record* instance,
                                       CustomParser* parser) {}
@@ -1625,6 +1677,14 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   virtual void Init(const DataFeedDesc& data_feed_desc);
   virtual void LoadIntoMemory();
   void ExpandSlotRecord(SlotRecord* ins);
+  const std::vector<UsedSlotInfo>& GetUsedSlotsInfo() const {
+    return used_slots_info_;
+  }
+  // Feed the minibatches from the columns of the records set by SetRecord
+  // instead of the records.
+  void SetColumns(const std::shared_ptr<SlotRecordColumns>& columns) {
+    columns_ = columns;
+  }
 
  protected:
   virtual bool Start();
@@ -1638,12 +1698,16 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   virtual void LoadIntoMemoryByCommand(void);
   virtual void LoadIntoMemoryByLib(void);
   virtual void LoadIntoMemoryByLine(void);
+  virtual void LoadIntoMemoryByNativeReader(const std::string& filename);
+  virtual bool SupportNativeReader() { return true; }
   virtual void LoadIntoMemoryByFile(void);
   virtual void SetInputChannel(void* channel) {
     input_channel_ = static_cast<ChannelObject<SlotRecord>*>(channel);
   }
   bool ParseOneInstance(const std::string& line, SlotRecord* rec);
   virtual void PutToFeedVec(const SlotRecord* ins_vec, int num);
+  // Feed the records in [begin, begin + num) by slicing the columns.
+  void PutToFeedVecFromColumns(int begin, int num);
   virtual void AssignFeedVar(const Scope& scope);
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
   void BuildSlotBatchGPU(const int ins_num);
@@ -1677,6 +1741,7 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   std::vector<UsedSlotInfo> used_slots_info_;
   size_t float_total_dims_size_ = 0;
   std::vector<int> float_total_dims_without_inductives_;
+  std::shared_ptr<SlotRecordColumns> columns_ = nullptr;
 
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
   MiniBatchGpuPack* pack_ = nullptr;
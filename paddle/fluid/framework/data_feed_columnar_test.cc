@@ -0,0 +1,140 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/channel.h"
+#include "paddle/fluid/framework/data_feed.h"
+#include "paddle/fluid/framework/data_feed_factory.h"
+#include "paddle/fluid/framework/scope.h"
+
+namespace paddle {
+namespace framework {
+
+#if defined(_LINUX) && \
+    !(defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS))
+struct FeedResult {
+  std::vector<int64_t> ids;
+  std::vector<float> values;
+  LoD id_lod;
+  LoD value_lod;
+};
+
+static DataFeedDesc MakeDataFeedDesc(int batch_size) {
+  DataFeedDesc desc;
+  desc.set_name("SlotRecordInMemoryDataFeed");
+  desc.set_batch_size(batch_size);
+  auto* multi_slot_desc = desc.mutable_multi_slot_desc();
+  auto* ids = multi_slot_desc->add_slots();
+  ids->set_name("ids");
+  ids->set_type("uint64");
+  ids->set_is_dense(false);
+  ids->set_is_used(true);
+  auto* values = multi_slot_desc->add_slots();
+  values->set_name("values");
+  values->set_type("float");
+  values->set_is_dense(false);
+  values->set_is_used(true);
+  return desc;
+}
+
+// Feed all the minibatches of the records, from the columns of the records
+// if columnar is true.
+static std::vector<FeedResult> FeedRecords(std::vector<SlotRecord>* records,
+                                           int batch_size,
+                                           bool columnar) {
+  auto data_feed =
+      DataFeedFactory::CreateDataFeed("SlotRecordInMemoryDataFeed");
+  auto* slot_feed =
+      reinterpret_cast<SlotRecordInMemoryDataFeed*>(data_feed.get());
+  data_feed->Init(MakeDataFeedDesc(batch_size));
+  data_feed->SetPlace(platform::CPUPlace());
+  data_feed->SetFileList({});
+  auto channel = MakeChannel<SlotRecord>();
+  data_feed->SetInputChannel(channel.get());
+
+  Scope scope;
+  scope.Var("ids")->GetMutable<phi::DenseTensor>();
+  scope.Var("values")->GetMutable<phi::DenseTensor>();
+  data_feed->AssignFeedVar(scope);
+
+  slot_feed->SetRecord(records->data());
+  if (columnar) {
+    auto columns = std::make_shared<SlotRecordColumns>();
+    columns->Build(
+        slot_feed->GetUsedSlotsInfo(), records->data(), records->size(), 2);
+    slot_feed->SetColumns(columns);
+  }
+  int record_num = static_cast<int>(records->size());
+  for (int begin = 0; begin < record_num; begin += batch_size) {
+    slot_feed->AddBatchOffset(
+        std::make_pair(begin, std::min(batch_size, record_num - begin)));
+  }
+
+  std::vector<FeedResult> results;
+  data_feed->Start();
+  while (data_feed->Next() > 0) {
+    FeedResult result;
+    auto& ids = scope.FindVar("ids")->Get<phi::DenseTensor>();
+    auto& values = scope.FindVar("values")->Get<phi::DenseTensor>();
+    result.ids.assign(ids.data<int64_t>(), ids.data<int64_t>() + ids.numel());
+    result.values.assign(values.data<float>(),
+                         values.data<float>() + values.numel());
+    result.id_lod = ids.lod();
+    result.value_lod = values.lod();
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+TEST(DataFeed, SlotRecordColumnarFeed) {
+  const int record_num = 7;
+  const int batch_size = 3;
+  std::vector<SlotRecord> records;
+  SlotRecordPool().get(&records, record_num);
+  for (int i = 0; i < record_num; ++i) {
+    records[i]->slot_uint64_feasigns_.clear(false);
+    records[i]->slot_float_feasigns_.clear(false);
+    // Every third record has an empty id slot, which is fed as one 0.
+    std::vector<uint64_t> ids;
+    for (int j = 0; j < i % 3; ++j) {
+      ids.push_back(i * 10 + j + 1);
+    }
+    records[i]->slot_uint64_feasigns_.add_values(ids.data(), ids.size());
+    std::vector<float> values(i % 2 + 1, i + 0.5f);
+    records[i]->slot_float_feasigns_.add_values(values.data(),
+                                                values.size());
+  }
+
+  auto rows = FeedRecords(&records, batch_size, false);
+  auto columns = FeedRecords(&records, batch_size, true);
+  ASSERT_EQ(rows.size(), 3UL);
+  ASSERT_EQ(columns.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    EXPECT_EQ(columns[i].ids, rows[i].ids);
+    EXPECT_EQ(columns[i].values, rows[i].values);
+    EXPECT_EQ(columns[i].id_lod, rows[i].id_lod);
+    EXPECT_EQ(columns[i].value_lod, rows[i].value_lod);
+  }
+  SlotRecordPool().put(&records);
+}
+#endif
+
+}  // namespace framework
+}  // namespace paddle
@@ -37,6 +37,7 @@
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 DECLARE_bool(graph_get_neighbor_id);
+DECLARE_bool(enable_slotrecord_columnar_feed);
 
 namespace paddle {
 namespace framework {
@@ -414,6 +415,7 @@ void MultiSlotDataset::PrepareTrain() {
     if (input_records_.size() == 0 && input_channel_ != nullptr &&
         input_channel_->Size() != 0) {
       input_channel_->ReadAll(input_records_);
+      columns_ = nullptr;
       VLOG(3) << "read from channel to records with records size: "
               << input_records_.size();
     }
@@ -1790,6 +1792,16 @@ void SlotRecordDataset::CreateReaders() {
   VLOG(3) << "readers size: " << readers_.size();
 }
 
+void SlotRecordDataset::LoadIntoMemory() {
+  columns_ = nullptr;
+  DatasetImpl<SlotRecord>::LoadIntoMemory();
+}
+
+void SlotRecordDataset::PreLoadIntoMemory() {
+  columns_ = nullptr;
+  DatasetImpl<SlotRecord>::PreLoadIntoMemory();
+}
+
 void SlotRecordDataset::ReleaseMemory() {
   VLOG(3) << "SlotRecordDataset::ReleaseMemory() begin";
   platform::Timer timeline;
@@ -1804,6 +1816,7 @@ void SlotRecordDataset::ReleaseMemory() {
     SlotRecordPool().put(&input_records_);
     input_records_.clear();
     input_records_.shrink_to_fit();
+    columns_ = nullptr;
     VLOG(3) << "release heterps input records records size: "
             << input_records_.size();
   }
@@ -1850,6 +1863,7 @@ void SlotRecordDataset::PrepareTrain() {
     if (input_records_.size() == 0 && input_channel_ != nullptr &&
         input_channel_->Size() != 0) {
       input_channel_->ReadAll(input_records_);
+      columns_ = nullptr;
       VLOG(3) << "read from channel to records with records size: "
               << input_records_.size();
     }
@@ -1869,6 +1883,29 @@ void SlotRecordDataset::PrepareTrain() {
       reinterpret_cast<SlotRecordInMemoryDataFeed*>(readers_[i].get())
           ->SetRecord(&input_records_[0]);
     }
+#if !(defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS))
+    if (FLAGS_enable_slotrecord_columnar_feed && !gpu_graph_mode_ &&
+        total_ins_num > 0) {
+      // The records are in the order of training here, so the minibatches
+      // are consecutive records, which are fed by slicing the columns. The
+      // records keep their values, since the readers, shuffles and the
+      // pool still use them. The columns are dropped when data is loaded
+      // again or the memory is released.
+      if (columns_ == nullptr) {
+        auto* reader =
+            reinterpret_cast<SlotRecordInMemoryDataFeed*>(readers_[0].get());
+        columns_ = std::make_shared<SlotRecordColumns>();
+        columns_->Build(reader->GetUsedSlotsInfo(),
+                        input_records_.data(),
+                        input_records_.size(),
+                        thread_num_);
+      }
+      for (int i = 0; i < thread_num_; i++) {
+        reinterpret_cast<SlotRecordInMemoryDataFeed*>(readers_[i].get())
+            ->SetColumns(columns_);
+      }
+    }
+#endif
     for (size_t i = 0; i < offset.size(); i++) {
       reinterpret_cast<SlotRecordInMemoryDataFeed*>(
           readers_[i % thread_num_].get())
@@ -398,6 +398,9 @@ class SlotRecordDataset : public DatasetImpl<SlotRecord> {
   virtual void CreateChannel();
   // create readers
   virtual void CreateReaders();
+  // load data into memory, the columns of the old records are dropped
+  virtual void LoadIntoMemory();
+  virtual void PreLoadIntoMemory();
   // release memory
   virtual void ReleaseMemory();
   virtual void GlobalShuffle(int thread_num = -1);
@@ -408,6 +411,9 @@ class SlotRecordDataset : public DatasetImpl<SlotRecord> {
 
  protected:
   bool enable_heterps_ = true;
+  // the columns of input_records_ fed by the readers if
+  // FLAGS_enable_slotrecord_columnar_feed is true
+  std::shared_ptr<SlotRecordColumns> columns_ = nullptr;
 };
 
 }  // end namespace framework
@@ -0,0 +1,153 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/local_line_reader.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+
+bool LocalLineReader::CanRead(const std::string& path,
+                              const std::string& converter) {
+#ifdef _WIN32
+  return false;
+#else
+  if (fs_select_internal(path) != 0) {
+    return false;
+  }
+  if (path.length() >= 3 && path.compare(path.length() - 3, 3, ".gz") == 0) {
+    return false;
+  }
+  std::string command = string::trim_spaces(converter);
+  if (!command.empty() && command != "cat") {
+    return false;
+  }
+  struct stat buf;
+  return stat(path.c_str(), &buf) == 0 && S_ISREG(buf.st_mode);
+#endif
+}
+
+LocalLineReader::LocalLineReader(const std::string& path) {
+#ifdef _WIN32
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "LocalLineReader is not supported on Windows."));
+#else
+  fd_ = open(path.c_str(), O_RDONLY);
+  PADDLE_ENFORCE_GE(fd_,
+                    0,
+                    platform::errors::Unavailable(
+                        "Failed to open file, path[%s], errno[%d].",
+                        path,
+                        errno));
+  struct stat buf;
+  PADDLE_ENFORCE_EQ(fstat(fd_, &buf),
+                    0,
+                    platform::errors::External(
+                        "Failed to get file status of %s.", path));
+  size_ = buf.st_size;
+  if (size_ == 0) {
+    return;
+  }
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (data == MAP_FAILED) {
+    close(fd_);
+    PADDLE_THROW(platform::errors::ResourceExhausted(
+        "Failed to mmap file, path[%s], size[%d], errno[%d].",
+        path,
+        size_,
+        errno));
+  }
+  data_ = reinterpret_cast<char*>(data);
+  madvise(data_, size_, MADV_SEQUENTIAL);
+#endif
+}
+
+LocalLineReader::~LocalLineReader() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+#endif
+}
+
+std::vector<LocalLineReader::Chunk> LocalLineReader::Split(
+    int chunk_num, size_t min_chunk_size) const {
+  std::vector<Chunk> chunks;
+  chunk_num = std::max(chunk_num, 1);
+  size_t chunk_size =
+      std::max((size_ + chunk_num - 1) / chunk_num, min_chunk_size);
+  const char* end = data_ + size_;
+  const char* begin = data_;
+  while (begin < end) {
+    const char* chunk_end = begin + std::min(chunk_size, size_t(end - begin));
+    if (chunk_end < end) {
+      // move the end to the next line
+      const char* eol = reinterpret_cast<const char*>(
+          memchr(chunk_end - 1, '\n', end - chunk_end + 1));
+      chunk_end = eol == nullptr ? end : eol + 1;
+    }
+    chunks.emplace_back(begin, chunk_end);
+    begin = chunk_end;
+  }
+  return chunks;
+}
+
+size_t LocalLineReader::ReadLines(const Chunk& chunk,
+                                  const LineFunc& func,
+                                  float sample_rate,
+                                  size_t* error_lines) {
+  // the parsers expect NUL terminated lines, so every line is copied
+  thread_local std::string line;
+  thread_local std::default_random_engine engine(std::random_device{}());
+  std::uniform_real_distribution<float> distrib(0.0f, 1.0f);
+  bool sample = std::abs(sample_rate - 1.0f) >= 1e-5f;
+  size_t lines = 0;
+  const char* ptr = chunk.first;
+  const char* end = chunk.second;
+  while (ptr < end) {
+    const char* eol =
+        reinterpret_cast<const char*>(memchr(ptr, '\n', end - ptr));
+    const char* line_end = eol == nullptr ? end : eol;
+    ++lines;
+    if (!sample || distrib(engine) < sample_rate) {
+      line.assign(ptr, line_end);
+      if (!func(line) && error_lines != nullptr) {
+        ++*error_lines;
+      }
+    }
+    ptr = line_end + 1;
+  }
+  return lines;
+}
+
+}  // namespace framework
+}  // namespace paddle
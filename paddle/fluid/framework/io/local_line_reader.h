@@ -0,0 +1,68 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+// LocalLineReader reads a local text file in process instead of forking a
+// "cat" pipe per file: the file is mapped into memory and split into chunks
+// at line boundaries, so that the chunks can be parsed by several threads.
+class LocalLineReader {
+ public:
+  // The first argument is the line without '\n', the function returns false
+  // if the line can not be parsed.
+  typedef std::function<bool(const std::string&)> LineFunc;
+  typedef std::pair<const char*, const char*> Chunk;
+
+  // Whether the file can be read by LocalLineReader, which is a local and
+  // uncompressed file, and is read without a converter or with "cat".
+  static bool CanRead(const std::string& path, const std::string& converter);
+
+  explicit LocalLineReader(const std::string& path);
+  ~LocalLineReader();
+
+  LocalLineReader(const LocalLineReader&) = delete;
+  LocalLineReader& operator=(const LocalLineReader&) = delete;
+
+  size_t size() const { return size_; }
+
+  // Split the file into at most chunk_num chunks of whole lines, every chunk
+  // is at least min_chunk_size bytes except the last one.
+  std::vector<Chunk> Split(int chunk_num, size_t min_chunk_size = 1) const;
+
+  // Call func with every line of the chunk, and keep a line with probability
+  // sample_rate. Return the number of lines read, and the number of lines
+  // which func failed to parse is added to *error_lines.
+  static size_t ReadLines(const Chunk& chunk,
+                          const LineFunc& func,
+                          float sample_rate = 1.0f,
+                          size_t* error_lines = nullptr);
+
+ private:
+  int fd_ = -1;
+  char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace framework
+}  // namespace paddle
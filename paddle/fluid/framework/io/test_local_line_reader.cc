@@ -0,0 +1,96 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/io/local_line_reader.h"
+
+#if defined _WIN32 || defined __APPLE__
+#else
+#define _LINUX
+#endif
+
+#ifdef _LINUX
+static std::vector<std::string> ReadAllLines(
+    const paddle::framework::LocalLineReader& reader, int chunk_num) {
+  std::vector<std::string> lines;
+  auto chunks = reader.Split(chunk_num);
+  EXPECT_LE(chunks.size(), static_cast<size_t>(chunk_num));
+  for (auto& chunk : chunks) {
+    // every chunk ends at a line boundary
+    EXPECT_TRUE(chunk.second == chunks.back().second ||
+                *(chunk.second - 1) == '\n');
+    paddle::framework::LocalLineReader::ReadLines(
+        chunk, [&lines](const std::string& line) {
+          lines.push_back(line);
+          return true;
+        });
+  }
+  return lines;
+}
+#endif
+
+TEST(LocalLineReader, Split) {
+#ifdef _LINUX
+  std::vector<std::string> expected;
+  std::ofstream out("local_line_reader_test.txt");
+  for (int i = 0; i < 100; ++i) {
+    expected.push_back(std::string(i % 7, 'a' + i % 26) + std::to_string(i));
+    out << expected.back();
+    // the last line has no '\n'
+    if (i != 99) {
+      out << "\n";
+    }
+  }
+  out.close();
+
+  ASSERT_TRUE(paddle::framework::LocalLineReader::CanRead(
+      "local_line_reader_test.txt", "cat"));
+  ASSERT_FALSE(paddle::framework::LocalLineReader::CanRead(
+      "local_line_reader_test.txt", "grep a"));
+  ASSERT_FALSE(
+      paddle::framework::LocalLineReader::CanRead("local_line_reader.gz", ""));
+  ASSERT_FALSE(paddle::framework::LocalLineReader::CanRead(
+      "afs:/local_line_reader_test.txt", ""));
+
+  paddle::framework::LocalLineReader reader("local_line_reader_test.txt");
+  for (int chunk_num : {1, 3, 7, 64, 1000}) {
+    ASSERT_EQ(ReadAllLines(reader, chunk_num), expected);
+  }
+
+  // no line is kept if the sample rate is 0
+  size_t error_lines = 0;
+  auto chunks = reader.Split(1);
+  ASSERT_EQ(paddle::framework::LocalLineReader::ReadLines(
+                chunks[0],
+                [](const std::string& line) { return false; },
+                0.0f,
+                &error_lines),
+            expected.size());
+  ASSERT_EQ(error_lines, 0UL);
+  remove("local_line_reader_test.txt");
+
+  // an empty file has no chunk
+  std::ofstream("local_line_reader_empty.txt").close();
+  paddle::framework::LocalLineReader empty_reader(
+      "local_line_reader_empty.txt");
+  ASSERT_TRUE(empty_reader.Split(4).empty());
+  remove("local_line_reader_empty.txt");
+#endif
+}
@@ -16,6 +16,9 @@ limitations under the License. */
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/version.h"
 #include "paddle/phi/core/serialization.h"
@@ -206,8 +209,9 @@ LoDAndOffset GetSubLoDAndAbsoluteOffset(const LoD &lod,
 
 void SerializeToStream(std::ostream &os,
                        const phi::DenseTensor &tensor,
-                       const platform::DeviceContext &dev_ctx) {
-  phi::SerializeToStream(os, tensor, dev_ctx);
+                       const platform::DeviceContext &dev_ctx,
+                       size_t data_alignment) {
+  phi::SerializeToStream(os, tensor, dev_ctx, data_alignment);
 }
 
 void SerializeToStream(std::ostream &os, const phi::DenseTensor &tensor) {
@@ -239,6 +243,66 @@ void DeserializeFromStream(std::istream &is,
   phi::DeserializeFromStream(is, tensor, dev_ctx);
 }
 
+void DeserializeFromMappedFile(const std::shared_ptr<phi::Allocation> &file,
+                               size_t *offset,
+                               phi::DenseTensor *tensor,
+                               const platform::DeviceContext &dev_ctx) {
+  const char *base = static_cast<const char *>(file->ptr());
+  auto read = [&](void *dst, size_t size) {
+    PADDLE_ENFORCE_LE(
+        size,
+        file->size() - std::min(*offset, file->size()),
+        platform::errors::InvalidArgument(
+            "The mapped file ends at %d bytes, which cannot hold the %d "
+            "bytes of LoD at offset %d. Please check whether the model "
+            "file is complete or damaged.",
+            file->size(),
+            size,
+            *offset));
+    std::memcpy(dst, base + *offset, size);
+    *offset += size;
+  };
+  {
+    // the 1st field, unit32_t version for DenseTensor
+    uint32_t version;
+    read(&version, sizeof(version));
+    PADDLE_ENFORCE_EQ(IsTensorVersionSupported(version),
+                      true,
+                      platform::errors::InvalidArgument(
+                          "Tensor version %u is not supported.", version));
+    PADDLE_ENFORCE_EQ(
+        version,
+        0U,
+        platform::errors::InvalidArgument(
+            "Deserialize to tensor failed, maybe the loaded file is "
+            "not a paddle model(expected file format: 0, but %u found).",
+            version));
+  }
+  {
+    // the 2st field, LoD information
+    uint64_t lod_level;
+    read(&lod_level, sizeof(lod_level));
+    auto &lod = *tensor->mutable_lod();
+    lod.resize(lod_level);
+    for (uint64_t i = 0; i < lod_level; ++i) {
+      uint64_t size;
+      read(&size, sizeof(size));
+      PADDLE_ENFORCE_EQ(size % sizeof(size_t),
+                        0,
+                        platform::errors::InvalidArgument(
+                            "The LoD of level %d takes %d bytes, which is "
+                            "not a multiple of sizeof(size_t).",
+                            i,
+                            size));
+      std::vector<size_t> tmp(size / sizeof(size_t));
+      read(tmp.data(), size);
+      lod[i] = tmp;
+    }
+  }
+  // the 3st filed, Tensor
+  TensorFromMappedFile(file, offset, tensor, dev_ctx);
+}
+
 LoD ConvertToOffsetBasedLoD(const LoD &length_lod) {
   LoD offset_lod;
   offset_lod.reserve(length_lod.size());
@@ -172,7 +172,8 @@ std::pair<LoD, std::pair<size_t, size_t>> GetSubLoDAndAbsoluteOffset(
  */
 void SerializeToStream(std::ostream& os,
                        const phi::DenseTensor& tensor,
-                       const platform::DeviceContext& dev_ctx);
+                       const platform::DeviceContext& dev_ctx,
+                       size_t data_alignment = 0);
 void DeserializeFromStream(std::istream& is,
                            phi::DenseTensor* tensor,
                            const platform::DeviceContext& dev_ctx);
@@ -182,6 +183,16 @@ void DeserializeFromStream(std::istream& is,
                            const size_t& seek,
                            const std::vector<int64_t>& shape);
 
+/*
+ * Desiralize the phi::DenseTensor serialized at *offset of a memory mapped
+ * file, and move *offset past it. The data of a CPU tensor is used in place
+ * when it is aligned in the file, see data_alignment of SerializeToStream.
+ */
+void DeserializeFromMappedFile(const std::shared_ptr<phi::Allocation>& file,
+                               size_t* offset,
+                               phi::DenseTensor* tensor,
+                               const platform::DeviceContext& dev_ctx);
+
 LoD ConvertToOffsetBasedLoD(const LoD& length_lod);
 
 void SerializeToStream(std::ostream& os, const phi::DenseTensor& tensor);
@@ -0,0 +1,358 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/memory_arena_planner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+#include "paddle/fluid/framework/feed_fetch_type.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+// At most this many input shapes get a plan, later ones run unplanned.
+constexpr size_t kMaxArenaPlans = 16;
+constexpr size_t kArenaAlignment = 64;
+
+size_t AlignUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+// A view of [offset, offset + size) of the arena. It keeps the arena alive,
+// so a tensor still holding it after the arena grew never dangles.
+class ArenaView : public phi::Allocation {
+ public:
+  ArenaView(const std::shared_ptr<phi::Allocation>& arena,
+            size_t offset,
+            size_t size)
+      : phi::Allocation(static_cast<uint8_t*>(arena->ptr()) + offset,
+                        size,
+                        arena->place()),
+        arena_(arena) {}
+
+ private:
+  std::shared_ptr<phi::Allocation> arena_;
+};
+
+}  // namespace
+
+size_t PlanArenaOffsets(std::vector<ArenaBlock>* blocks, size_t alignment) {
+  std::vector<size_t> order(blocks->size());
+  std::iota(order.begin(), order.end(), 0);
+  for (auto& block : *blocks) {
+    block.size = AlignUp(block.size, alignment);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return (*blocks)[a].size > (*blocks)[b].size;
+  });
+
+  // Placed blocks, kept sorted by offset
+  std::vector<size_t> placed;
+  size_t arena_size = 0;
+  for (size_t i : order) {
+    auto& block = (*blocks)[i];
+    size_t best_offset = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t prev_end = 0;
+    for (size_t j : placed) {
+      const auto& other = (*blocks)[j];
+      if (other.last_op < block.first_op || block.last_op < other.first_op) {
+        continue;
+      }
+      if (other.offset >= prev_end) {
+        size_t gap = other.offset - prev_end;
+        if (gap >= block.size && gap < best_gap) {
+          best_offset = prev_end;
+          best_gap = gap;
+        }
+      }
+      prev_end = std::max(prev_end, other.offset + other.size);
+    }
+    block.offset =
+        best_offset == std::numeric_limits<size_t>::max() ? prev_end
+                                                           : best_offset;
+    arena_size = std::max(arena_size, block.offset + block.size);
+    auto pos = std::upper_bound(
+        placed.begin(), placed.end(), i, [&](size_t a, size_t b) {
+          return (*blocks)[a].offset < (*blocks)[b].offset;
+        });
+    placed.insert(pos, i);
+  }
+  return arena_size;
+}
+
+MemoryArenaPlanner::MemoryArenaPlanner(
+    const platform::Place& place,
+    const std::vector<std::unique_ptr<OperatorBase>>& ops,
+    Scope* scope,
+    const std::unordered_set<std::string>& pinned_vars)
+    : place_(place), ops_(ops), scope_(scope), pinned_vars_(pinned_vars) {
+  PADDLE_ENFORCE_EQ(platform::is_cpu_place(place_),
+                    true,
+                    platform::errors::Unimplemented(
+                        "The memory arena only supports CPUPlace now."));
+  PADDLE_ENFORCE_NOT_NULL(
+      scope_,
+      platform::errors::PreconditionNotMet(
+          "Need to init scope in NaiveExecutor before the memory arena."));
+}
+
+void MemoryArenaPlanner::Init() {
+  initialized_ = true;
+  for (auto& op : ops_) {
+    if (op->HasAttr("sub_block") || op->HasAttr("sub_blocks")) {
+      VLOG(3) << "Disable the memory arena for the control flow operator "
+              << op->Type();
+      disabled_ = true;
+      return;
+    }
+  }
+
+  std::unordered_map<std::string, int> var_idx;
+  auto get_var = [&](const std::string& name) -> int {
+    auto it = var_idx.find(name);
+    if (it != var_idx.end()) return it->second;
+    int idx = -1;
+    auto* var = name == kEmptyVarName ? nullptr : scope_->FindVar(name);
+    if (var && var->IsType<phi::DenseTensor>()) {
+      idx = vars_.size();
+      VarInfo info;
+      info.name = name;
+      info.tensor = var->GetMutable<phi::DenseTensor>();
+      // Persistable variables live in the ancestors of the executor scope
+      info.plannable =
+          scope_->FindLocalVar(name) != nullptr && !pinned_vars_.count(name);
+      vars_.emplace_back(std::move(info));
+    }
+    var_idx.emplace(name, idx);
+    return idx;
+  };
+
+  std::vector<bool> written;
+  op_inputs_.resize(ops_.size());
+  op_outputs_.resize(ops_.size());
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    if (ops_[i]->Type() == "feed") {
+      auto* feed_list = scope_->FindVar(ops_[i]->Input("X"));
+      if (feed_list && std::find(feed_lists_.begin(),
+                                 feed_lists_.end(),
+                                 feed_list) == feed_lists_.end()) {
+        feed_lists_.push_back(feed_list);
+      }
+    }
+    for (auto& arg : ops_[i]->Inputs()) {
+      for (auto& name : arg.second) {
+        int idx = get_var(name);
+        if (idx >= 0) op_inputs_[i].push_back(idx);
+      }
+    }
+    for (auto& arg : ops_[i]->Outputs()) {
+      for (auto& name : arg.second) {
+        int idx = get_var(name);
+        if (idx < 0) continue;
+        op_outputs_[i].push_back(idx);
+        written.resize(vars_.size(), false);
+        written[idx] = true;
+        // The feed operator shares the holder of the fed tensor
+        if (ops_[i]->Type() == "feed") vars_[idx].plannable = false;
+      }
+    }
+  }
+  written.resize(vars_.size(), false);
+  for (size_t idx = 0; idx < vars_.size(); ++idx) {
+    if (!written[idx]) {
+      // Fed by the user, or a parameter
+      if (vars_[idx].plannable) feed_vars_.push_back(idx);
+      vars_[idx].plannable = false;
+    }
+  }
+}
+
+std::string MemoryArenaPlanner::ShapeKey() const {
+  std::string key;
+  for (int idx : feed_vars_) {
+    const auto* tensor = vars_[idx].tensor;
+    key += tensor->dims().to_str();
+    key += ':';
+    key += std::to_string(static_cast<int>(tensor->dtype()));
+    key += ';';
+  }
+  for (const auto* feed_list : feed_lists_) {
+    if (!feed_list->IsType<FeedList>()) continue;
+    for (const auto& item : feed_list->Get<FeedList>()) {
+      if (item.type() != typeid(phi::DenseTensor)) continue;
+      const auto& tensor = PADDLE_GET_CONST(phi::DenseTensor, item);
+      key += tensor.dims().to_str();
+      key += ':';
+      key += std::to_string(static_cast<int>(tensor.dtype()));
+      key += ';';
+    }
+  }
+  return key;
+}
+
+bool MemoryArenaPlanner::BeforeRun() {
+  if (!initialized_) Init();
+  if (disabled_) return false;
+
+  std::string key = ShapeKey();
+  auto it = plans_.find(key);
+  Plan* plan = it == plans_.end() ? nullptr : &it->second;
+  // A tensor bound for other shapes must not keep writing into the arena
+  if (bound_plan_ && bound_plan_ != plan) {
+    for (auto* tensor : bound_plan_->tensors) tensor->clear();
+  }
+  bound_plan_ = plan;
+  if (plan) {
+    Bind(plan);
+    return false;
+  }
+  if (plans_.size() >= kMaxArenaPlans) return false;
+
+  profiling_key_ = std::move(key);
+  holder_owner_.clear();
+  for (auto& var : vars_) {
+    var.first_op = -1;
+    var.last_op = -1;
+    var.size = 0;
+    var.alias_of = -1;
+  }
+  return true;
+}
+
+void MemoryArenaPlanner::Bind(Plan* plan) {
+  if (!arena_ && required_arena_size_ > 0) {
+    arena_ = memory::AllocShared(place_, required_arena_size_);
+    ++arena_generation_;
+  }
+  if (plan->arena_generation != arena_generation_) {
+    plan->views.clear();
+    for (auto& block : plan->blocks) {
+      plan->views.emplace_back(
+          std::make_shared<ArenaView>(arena_, block.offset, block.size));
+    }
+    plan->arena_generation = arena_generation_;
+  }
+  for (size_t i = 0; i < plan->tensors.size(); ++i) {
+    auto* tensor = plan->tensors[i];
+    if (tensor->Holder() != plan->views[i]) {
+      tensor->clear();
+      tensor->ResetHolder(plan->views[i]);
+    }
+  }
+}
+
+void MemoryArenaPlanner::Touch(int var_idx, int op_idx) {
+  auto& var = vars_[var_idx];
+  if (var.first_op < 0) var.first_op = op_idx;
+  var.last_op = op_idx;
+}
+
+void MemoryArenaPlanner::OnOpFinished(size_t op_idx) {
+  // Register the inputs first, so an output sharing the holder of an input
+  // is seen as its alias.
+  for (int idx : op_inputs_[op_idx]) {
+    Touch(idx, op_idx);
+    const auto* tensor = vars_[idx].tensor;
+    if (tensor->initialized()) {
+      holder_owner_.emplace(tensor->Holder().get(), idx);
+    }
+  }
+  for (int idx : op_outputs_[op_idx]) {
+    Touch(idx, op_idx);
+    auto& var = vars_[idx];
+    const auto* tensor = var.tensor;
+    if (!tensor->initialized()) continue;
+    var.size = std::max(var.size,
+                        tensor->numel() * phi::SizeOf(tensor->dtype()) +
+                            tensor->offset());
+    auto owner = holder_owner_.emplace(tensor->Holder().get(), idx).first;
+    if (owner->second != idx && var.alias_of < 0) {
+      var.alias_of = owner->second;
+    }
+  }
+}
+
+void MemoryArenaPlanner::AfterRun() {
+  const int last_op = static_cast<int>(ops_.size());
+  std::vector<int> block_of(vars_.size(), -1);
+  Plan plan;
+  for (size_t idx = 0; idx < vars_.size(); ++idx) {
+    const auto& var = vars_[idx];
+    if (!var.plannable || var.alias_of >= 0 || var.size == 0 ||
+        var.first_op < 0) {
+      continue;
+    }
+    block_of[idx] = plan.blocks.size();
+    plan.tensors.push_back(var.tensor);
+    ArenaBlock block;
+    block.size = var.size;
+    block.first_op = var.first_op;
+    block.last_op = var.last_op;
+    plan.blocks.push_back(block);
+  }
+  // An alias keeps the buffer of its owner alive for its own lifetime
+  for (size_t idx = 0; idx < vars_.size(); ++idx) {
+    const auto& var = vars_[idx];
+    if (var.alias_of < 0) continue;
+    int root = var.alias_of;
+    for (size_t step = 0; step < vars_.size() && vars_[root].alias_of >= 0;
+         ++step) {
+      root = vars_[root].alias_of;
+    }
+    if (block_of[root] < 0) continue;
+    auto& block = plan.blocks[block_of[root]];
+    bool pinned = pinned_vars_.count(var.name) > 0;
+    block.first_op = std::min(block.first_op, var.first_op);
+    block.last_op = std::max(block.last_op, pinned ? last_op : var.last_op);
+  }
+
+  size_t arena_size = PlanArenaOffsets(&plan.blocks, kArenaAlignment);
+  if (arena_size > required_arena_size_) {
+    required_arena_size_ = arena_size;
+    // Drop the views of the old arena first so that it is freed
+    for (auto& kv : plans_) kv.second.views.clear();
+    arena_.reset();
+    arena_ = memory::AllocShared(place_, arena_size);
+    ++arena_generation_;
+  }
+  VLOG(3) << "Memory arena plans " << plan.tensors.size() << " tensors into "
+          << arena_size << " bytes for input shapes " << profiling_key_;
+  plans_.emplace(std::move(profiling_key_), std::move(plan));
+}
+
+void MemoryArenaPlanner::Release() {
+  // The tensors bound to the views hold the arena too
+  for (auto& kv : plans_) {
+    for (auto* tensor : kv.second.tensors) {
+      if (dynamic_cast<const ArenaView*>(tensor->Holder().get()) != nullptr) {
+        tensor->clear();
+      }
+    }
+    kv.second.views.clear();
+  }
+  bound_plan_ = nullptr;
+  arena_.reset();
+  ++arena_generation_;
+}
+
+}  // namespace framework
+}  // namespace paddle
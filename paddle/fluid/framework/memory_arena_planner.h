@@ -0,0 +1,137 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace framework {
+
+// A buffer to place in the arena, alive from the operator first_op to the
+// operator last_op, both included.
+struct ArenaBlock {
+  size_t size{0};
+  int first_op{0};
+  int last_op{0};
+  size_t offset{0};
+};
+
+// Assign an offset to every block so that two blocks alive at the same time
+// never overlap, and return the arena size they need. Blocks are placed from
+// the largest down, each into the smallest gap left between the placed
+// blocks it overlaps in time, or above all of them (greedy by size, best
+// fit). Offsets and sizes are rounded up to alignment.
+size_t PlanArenaOffsets(std::vector<ArenaBlock>* blocks, size_t alignment);
+
+/*
+ * Binds the intermediate tensors of a NaiveExecutor into one preallocated
+ * arena.
+ *
+ * The first run with a given set of input shapes is profiled: the lifetime
+ * of every tensor in operator order, the bytes it needs and which tensors
+ * share a holder. The plan made from it binds each tensor to a view of the
+ * arena before the later runs with those shapes, so the kernels find their
+ * outputs already allocated. A tensor that outgrows its view falls back to
+ * the allocator, so a stale plan costs memory but never correctness.
+ *
+ * Tensors in pinned_vars, such as the fetch targets, keep their own
+ * allocations. Programs with control flow operators are left alone, since
+ * their sub blocks read variables the plan does not see.
+ */
+class MemoryArenaPlanner {
+ public:
+  MemoryArenaPlanner(const platform::Place& place,
+                     const std::vector<std::unique_ptr<OperatorBase>>& ops,
+                     Scope* scope,
+                     const std::unordered_set<std::string>& pinned_vars);
+
+  // Called before the operators run. Binds the plan of the current input
+  // shapes, or returns true if this run has to be profiled.
+  bool BeforeRun();
+
+  // Called after the op_idx-th operator of a profiled run.
+  void OnOpFinished(size_t op_idx);
+
+  // Called after all the operators of a profiled run.
+  void AfterRun();
+
+  // Free the arena and the views of the plans. The plans are kept, and the
+  // arena is allocated again by the next run bound to a plan.
+  void Release();
+
+  size_t arena_size() const { return arena_ ? arena_->size() : 0; }
+
+  size_t num_plans() const { return plans_.size(); }
+
+ private:
+  struct VarInfo {
+    std::string name;
+    phi::DenseTensor* tensor{nullptr};
+    bool plannable{false};
+    // Filled by a profiled run
+    int first_op{-1};
+    int last_op{-1};
+    size_t size{0};
+    int alias_of{-1};
+  };
+
+  struct Plan {
+    std::vector<phi::DenseTensor*> tensors;
+    std::vector<ArenaBlock> blocks;
+    std::vector<std::shared_ptr<phi::Allocation>> views;
+    size_t arena_generation{0};
+  };
+
+  void Init();
+  std::string ShapeKey() const;
+  void Bind(Plan* plan);
+  void Touch(int var_idx, int op_idx);
+
+  const platform::Place place_;
+  const std::vector<std::unique_ptr<OperatorBase>>& ops_;
+  Scope* scope_;
+  std::unordered_set<std::string> pinned_vars_;
+
+  bool initialized_{false};
+  bool disabled_{false};
+  std::vector<VarInfo> vars_;
+  std::vector<std::vector<int>> op_inputs_;
+  std::vector<std::vector<int>> op_outputs_;
+  // Non persistable inputs of the program and the feed lists of the feed
+  // operators, whose shapes key the plans
+  std::vector<int> feed_vars_;
+  std::vector<const Variable*> feed_lists_;
+
+  std::unordered_map<std::string, Plan> plans_;
+  std::string profiling_key_;
+  std::unordered_map<const phi::Allocation*, int> holder_owner_;
+  Plan* bound_plan_{nullptr};
+
+  std::shared_ptr<phi::Allocation> arena_;
+  size_t arena_generation_{0};
+  // The arena size needed by the largest plan
+  size_t required_arena_size_{0};
+};
+
+}  // namespace framework
+}  // namespace paddle
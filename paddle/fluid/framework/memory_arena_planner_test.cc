@@ -0,0 +1,148 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/memory_arena_planner.h"
+
+#include <gtest/gtest.h>
+
+#include "paddle/fluid/framework/naive_executor.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+USE_OP_ITSELF(scale);
+
+PD_DECLARE_KERNEL(scale, CPU, ALL_LAYOUT);
+
+namespace paddle {
+namespace framework {
+
+TEST(PlanArenaOffsets, ReuseDisjointLifetimes) {
+  // a [0, 1], b [1, 2], c [2, 3]: a and c can share
+  std::vector<ArenaBlock> blocks(3);
+  blocks[0].size = 100;
+  blocks[0].first_op = 0;
+  blocks[0].last_op = 1;
+  blocks[1].size = 64;
+  blocks[1].first_op = 1;
+  blocks[1].last_op = 2;
+  blocks[2].size = 128;
+  blocks[2].first_op = 2;
+  blocks[2].last_op = 3;
+
+  size_t arena_size = PlanArenaOffsets(&blocks, 64);
+  EXPECT_EQ(arena_size, 192UL);
+  EXPECT_EQ(blocks[0].size, 128UL);
+  EXPECT_EQ(blocks[0].offset, blocks[2].offset);
+  EXPECT_NE(blocks[1].offset, blocks[2].offset);
+}
+
+TEST(PlanArenaOffsets, BestFitGap) {
+  // The small block fits into the gap left by the freed middle block
+  std::vector<ArenaBlock> blocks(4);
+  blocks[0] = {256, 0, 4, 0};
+  blocks[1] = {256, 0, 1, 0};
+  blocks[2] = {192, 0, 4, 0};
+  blocks[3] = {128, 2, 3, 0};
+
+  size_t arena_size = PlanArenaOffsets(&blocks, 64);
+  EXPECT_EQ(arena_size, 704UL);
+  EXPECT_EQ(blocks[3].offset, blocks[1].offset);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    for (size_t j = i + 1; j < blocks.size(); ++j) {
+      bool live = blocks[i].first_op <= blocks[j].last_op &&
+                  blocks[j].first_op <= blocks[i].last_op;
+      bool overlap = blocks[i].offset < blocks[j].offset + blocks[j].size &&
+                     blocks[j].offset < blocks[i].offset + blocks[i].size;
+      EXPECT_FALSE(live && overlap);
+    }
+  }
+}
+
+static void AppendScale(BlockDesc* block,
+                        const std::string& x,
+                        const std::string& out,
+                        float scale) {
+  auto* var = block->Var(out);
+  var->SetType(proto::VarType::LOD_TENSOR);
+  auto* op = block->AppendOp();
+  op->SetType("scale");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {out});
+  op->SetAttr("scale", scale);
+  op->SetAttr("bias", 0.0f);
+  op->SetAttr("bias_after_scale", true);
+}
+
+TEST(NaiveExecutor, MemoryArena) {
+  ProgramDesc program;
+  auto* block = program.MutableBlock(0);
+  block->Var("x")->SetType(proto::VarType::LOD_TENSOR);
+  AppendScale(block, "x", "t0", 2.0f);
+  AppendScale(block, "t0", "t1", 3.0f);
+  AppendScale(block, "t1", "t2", 5.0f);
+  AppendScale(block, "t2", "out", 7.0f);
+
+  auto place = platform::CPUPlace();
+  Scope scope;
+  auto* sub_scope = &scope.NewScope();
+  NaiveExecutor exe(place);
+  exe.CreateVariables(program, 0, false, sub_scope);
+  exe.Prepare(sub_scope, program, 0, false);
+  exe.EnableMemoryArena({"out"});
+
+  for (int64_t rows : {4, 4, 16, 4, 16}) {
+    auto* x = exe.FindTensor("x");
+    x->Resize({rows, 16});
+    float* x_data = x->mutable_data<float>(place);
+    for (int64_t i = 0; i < x->numel(); ++i) x_data[i] = i;
+
+    exe.Run();
+
+    auto* out = exe.FindTensor("out");
+    ASSERT_EQ(out->numel(), rows * 16);
+    for (int64_t i = 0; i < out->numel(); ++i) {
+      EXPECT_FLOAT_EQ(out->data<float>()[i], 210.0f * i);
+    }
+  }
+  ASSERT_NE(exe.memory_arena(), nullptr);
+  EXPECT_EQ(exe.memory_arena()->num_plans(), 2UL);
+  // t0 and t2 share a buffer, the biggest plan needs two of them
+  EXPECT_EQ(exe.memory_arena()->arena_size(), 2UL * 16 * 16 * sizeof(float));
+
+  // Bound tensors live in the arena, the pinned output does not
+  auto* t0 = exe.FindTensor("t0");
+  auto* t2 = exe.FindTensor("t2");
+  EXPECT_EQ(t0->data<float>(), t2->data<float>());
+  EXPECT_NE(exe.FindTensor("out")->data<float>(), t0->data<float>());
+
+  // The released arena is allocated again by the next run with a plan
+  exe.ReleaseMemoryArena();
+  EXPECT_EQ(exe.memory_arena()->arena_size(), 0UL);
+  EXPECT_FALSE(t0->initialized());
+  auto* x = exe.FindTensor("x");
+  x->Resize({4, 16});
+  float* x_data = x->mutable_data<float>(place);
+  for (int64_t i = 0; i < x->numel(); ++i) x_data[i] = i;
+  exe.Run();
+  auto* out = exe.FindTensor("out");
+  for (int64_t i = 0; i < out->numel(); ++i) {
+    EXPECT_FLOAT_EQ(out->data<float>()[i], 210.0f * i);
+  }
+  EXPECT_EQ(exe.memory_arena()->num_plans(), 2UL);
+  EXPECT_EQ(exe.memory_arena()->arena_size(), 2UL * 16 * 16 * sizeof(float));
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,150 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+
+namespace paddle {
+namespace framework {
+
+// MPMCRingBuffer is a bounded lock-free multi-producer multi-consumer queue,
+// based on the per-slot sequence numbers of Dmitry Vyukov's bounded queue.
+// A producer (consumer) claims a range of slots with one CAS on the tail
+// (head), so that a block of items is transferred with one atomic operation,
+// then it waits for every claimed slot to be released by the consumer
+// (producer) of the previous round, which has already claimed the slot and
+// never blocks.
+//
+// All the operations are non-blocking and return the number of items
+// transferred, see ChannelObject for the blocking wrappers.
+template <class T>
+class MPMCRingBuffer {
+ public:
+  // the ring size is rounded up to a power of two
+  explicit MPMCRingBuffer(size_t size) {
+    size_ = 2;
+    while (size_ < size) {
+      size_ <<= 1;
+    }
+    mask_ = size_ - 1;
+    slots_.reset(new Slot[size_]);
+    for (size_t i = 0; i < size_; ++i) {
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPMCRingBuffer(const MPMCRingBuffer&) = delete;
+  MPMCRingBuffer& operator=(const MPMCRingBuffer&) = delete;
+
+  size_t RingSize() const { return size_; }
+
+  // The number of items claimed by producers and not claimed by consumers.
+  size_t Size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  // Move at most n items from p into the ring, keeping at most capacity
+  // items in the ring.
+  size_t TryWriteMove(size_t n, T* p, size_t capacity) {
+    return TryWrite(n, capacity, [p](size_t i, T* slot) {
+      *slot = std::move(p[i]);
+    });
+  }
+
+  size_t TryWrite(size_t n, const T* p, size_t capacity) {
+    return TryWrite(n, capacity, [p](size_t i, T* slot) { *slot = p[i]; });
+  }
+
+  // Move at most n items from the ring into p.
+  size_t TryRead(size_t n, T* p) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t m = 0;
+    do {
+      size_t tail = tail_.load(std::memory_order_acquire);
+      if (tail <= head) {
+        return 0;
+      }
+      m = std::min(n, tail - head);
+    } while (!head_.compare_exchange_weak(
+        head, head + m, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    for (size_t i = 0; i < m; ++i) {
+      size_t pos = head + i;
+      Slot& slot = slots_[pos & mask_];
+      WaitForSeq(slot, pos + 1);
+      p[i] = std::move(slot.value);
+      slot.seq.store(pos + size_, std::memory_order_release);
+    }
+    return m;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> seq;
+    T value;
+  };
+
+  template <class Assign>
+  size_t TryWrite(size_t n, size_t capacity, Assign&& assign) {
+    capacity = std::min(capacity, size_);
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t m = 0;
+    do {
+      size_t head = head_.load(std::memory_order_acquire);
+      // head may have passed the stale tail
+      size_t used = tail > head ? tail - head : 0;
+      if (used >= capacity) {
+        return 0;
+      }
+      m = std::min(n, capacity - used);
+    } while (!tail_.compare_exchange_weak(
+        tail, tail + m, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    for (size_t i = 0; i < m; ++i) {
+      size_t pos = tail + i;
+      Slot& slot = slots_[pos & mask_];
+      WaitForSeq(slot, pos);
+      assign(i, &slot.value);
+      slot.seq.store(pos + 1, std::memory_order_release);
+    }
+    return m;
+  }
+
+  // The slot is held by a thread which has claimed it, and is transferring
+  // one item, so the wait is short.
+  static void WaitForSeq(const Slot& slot, size_t seq) {
+    for (int spin = 0; slot.seq.load(std::memory_order_acquire) != seq;
+         ++spin) {
+      if (spin > 64) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  size_t size_;
+  size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace framework
+}  // namespace paddle
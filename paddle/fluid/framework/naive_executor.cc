@@ -54,7 +54,9 @@ void NaiveExecutor::Run() {
 #ifdef PADDLE_WITH_INFERENCE_NVTX
   platform::CudaNvtxRangePush("model", platform::NvtxRangeColor::Yellow);
 #endif
-  for (auto &op : ops_) {
+  bool profile_memory_arena = memory_arena_ && memory_arena_->BeforeRun();
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    auto &op = ops_[i];
     VLOG(4) << std::this_thread::get_id() << " run "
             << op->DebugStringEx(scope_) << " on scope " << scope_;
     op->SetIsCalledByExecutor(false);
@@ -65,10 +67,16 @@ void NaiveExecutor::Run() {
 #ifdef PADDLE_WITH_INFERENCE_NVTX
     platform::CudaNvtxRangePop();
 #endif
+    if (profile_memory_arena) {
+      memory_arena_->OnOpFinished(i);
+    }
     if (hookfunc_) {
       hookfunc_(op.get());
     }
   }
+  if (profile_memory_arena) {
+    memory_arena_->AfterRun();
+  }
 #ifdef PADDLE_WITH_INFERENCE_NVTX
   platform::CudaNvtxRangePop();
 #endif
@@ -149,6 +157,18 @@ void NaiveExecutor::RegisterOutputHook(const HookFunc &hookfunc) {
   hookfunc_ = hookfunc;
 }
 
+void NaiveExecutor::EnableMemoryArena(
+    const std::unordered_set<std::string> &pinned_vars) {
+  memory_arena_ = std::make_unique<MemoryArenaPlanner>(
+      place_, ops_, scope_, pinned_vars);
+}
+
+void NaiveExecutor::ReleaseMemoryArena() {
+  if (memory_arena_) {
+    memory_arena_->Release();
+  }
+}
+
 NaiveExecutor::~NaiveExecutor() {
 #ifdef PADDLE_WITH_MKLDNN
   // Clear mkl-dnn cache,
@@ -17,8 +17,10 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+#include "paddle/fluid/framework/memory_arena_planner.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/program_desc.h"
 #include "paddle/fluid/framework/scope.h"
@@ -71,6 +73,18 @@ class NaiveExecutor {
 
   void RegisterOutputHook(const HookFunc& hookfunc);
 
+  // Bind the intermediate tensors into one arena planned per input shapes,
+  // see MemoryArenaPlanner. Call it after Prepare. The tensors in
+  // pinned_vars, usually the fetch targets, are never placed in the arena.
+  void EnableMemoryArena(const std::unordered_set<std::string>& pinned_vars);
+
+  const MemoryArenaPlanner* memory_arena() const {
+    return memory_arena_.get();
+  }
+
+  // Free the arena of EnableMemoryArena, the next run allocates it again.
+  void ReleaseMemoryArena();
+
  private:
   void CreateOps(const ProgramDesc& desc,
                  int block_id,
@@ -83,6 +97,8 @@ class NaiveExecutor {
   Scope* scope_{nullptr};
 
   HookFunc hookfunc_{nullptr};
+
+  std::unique_ptr<MemoryArenaPlanner> memory_arena_;
 };
 
 }  // namespace framework
@@ -26,6 +26,7 @@
 #include "paddle/fluid/operators/controlflow/recurrent_op_helper.h"
 #include "paddle/fluid/operators/controlflow/while_op_helper.h"
 #include "paddle/fluid/operators/ops_extra_info.h"
+#include "paddle/fluid/platform/numa_info.h"
 #include "paddle/phi/core/kernel_context.h"
 #include "paddle/phi/core/kernel_factory.h"
 
@@ -103,6 +104,12 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  // inherit the NUMA binding of the thread which creates the queues, e.g.,
+  // the predictor bound by AnalysisConfig::EnableNumaBinding
+  int numa_node = platform::GetCurrentThreadNumaNode();
+  for (auto& options : group_options) {
+    options.numa_node = numa_node;
+  }
   return group_options;
 }
 
@@ -60,6 +60,10 @@ class AsyncWorkQueue {
     return queue_group_->QueueNumThreads(idx);
   }
 
+  size_t QueueNumIdleThreads(size_t idx) {
+    return queue_group_->QueueNumIdleThreads(idx);
+  }
+
  private:
   size_t host_num_thread_;
   std::unique_ptr<WorkQueueGroup> queue_group_;
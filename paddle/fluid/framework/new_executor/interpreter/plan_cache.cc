@@ -0,0 +1,260 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/plan_cache.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/os_info.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+static constexpr uint32_t kPlanMagic = 0x504c414e;  // "PLAN"
+static constexpr uint32_t kPlanVersion = 1;
+
+namespace {
+
+uint64_t FNV1aHash(const std::string& data, uint64_t hash) {
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+template <typename T>
+void WritePOD(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPOD(std::istream& is, T* value) {
+  is.read(reinterpret_cast<char*>(value), sizeof(T));
+  return static_cast<bool>(is);
+}
+
+void WriteString(std::ostream& os, const std::string& str) {
+  WritePOD<uint64_t>(os, str.size());
+  os.write(str.data(), str.size());
+}
+
+// The sizes read from a corrupted file may be arbitrarily large, so they
+// are checked against the bytes left before allocating anything.
+uint64_t RemainingBytes(std::istream& is) {
+  auto pos = is.tellg();
+  is.seekg(0, std::ios::end);
+  auto end = is.tellg();
+  is.seekg(pos);
+  if (pos < 0 || end < pos) {
+    return 0;
+  }
+  return static_cast<uint64_t>(end - pos);
+}
+
+bool ReadString(std::istream& is, std::string* str) {
+  uint64_t size = 0;
+  if (!ReadPOD(is, &size) || size > RemainingBytes(is)) {
+    return false;
+  }
+  str->resize(size);
+  is.read(&(*str)[0], size);
+  return static_cast<bool>(is);
+}
+
+template <typename T>
+void WriteSet(std::ostream& os, const std::set<T>& values) {
+  WritePOD<uint64_t>(os, values.size());
+  for (const T& value : values) {
+    WritePOD<T>(os, value);
+  }
+}
+
+template <typename T>
+bool ReadSet(std::istream& is, std::set<T>* values) {
+  uint64_t size = 0;
+  if (!ReadPOD(is, &size)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < size; ++i) {
+    T value;
+    if (!ReadPOD(is, &value)) {
+      return false;
+    }
+    values->insert(value);
+  }
+  return true;
+}
+
+bool ReadPlanBody(std::istream& is, InterpreterPlan* plan) {
+  uint64_t size = 0;
+
+  // each key takes at least the bytes of its size
+  if (!ReadPOD(is, &size) || size > RemainingBytes(is) / sizeof(uint64_t)) {
+    return false;
+  }
+  plan->instruction_keys.resize(size);
+  for (auto& key : plan->instruction_keys) {
+    if (!ReadString(is, &key)) {
+      return false;
+    }
+  }
+
+  if (!ReadPOD(is, &size)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < size; ++i) {
+    int op_idx = 0;
+    if (!ReadPOD(is, &op_idx) ||
+        !ReadSet(is, &plan->op_downstream_map[op_idx])) {
+      return false;
+    }
+  }
+
+  if (!ReadPOD(is, &size)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < size; ++i) {
+    std::string var_name;
+    if (!ReadString(is, &var_name) ||
+        !ReadSet(is, &plan->last_live_ops[var_name])) {
+      return false;
+    }
+  }
+
+  // each pair takes at least the bytes of its instr_id and two name sizes
+  if (!ReadPOD(is, &size) ||
+      size > RemainingBytes(is) / (3 * sizeof(uint64_t))) {
+    return false;
+  }
+  plan->inplace_pairs.resize(size);
+  for (auto& pair : plan->inplace_pairs) {
+    uint64_t instr_id = 0;
+    if (!ReadPOD(is, &instr_id) || !ReadString(is, &pair.in_var_name) ||
+        !ReadString(is, &pair.out_var_name)) {
+      return false;
+    }
+    pair.instr_id = instr_id;
+  }
+  return true;
+}
+
+}  // namespace
+
+uint64_t HashProgramForPlan(ProgramDesc* program,
+                            const platform::Place& place,
+                            const std::string& options) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = FNV1aHash(program->Proto()->SerializeAsString(), hash);
+  hash = FNV1aHash(place.DebugString(), hash);
+  hash = FNV1aHash(options, hash);
+  return hash;
+}
+
+void SaveInterpreterPlan(const InterpreterPlan& plan, const std::string& path) {
+  // Write to a temporary file and rename it, so that a process loading the
+  // plan never sees a partially written one.
+  std::string tmp_path =
+      path + ".tmp" + std::to_string(platform::GetProcessId());
+  std::ofstream fout(tmp_path, std::ios::binary);
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fout),
+      true,
+      platform::errors::Unavailable(
+          "Cannot open %s to save the InterpreterCore plan.", tmp_path));
+
+  WritePOD<uint32_t>(fout, kPlanMagic);
+  WritePOD<uint32_t>(fout, kPlanVersion);
+  WritePOD<uint64_t>(fout, plan.program_hash);
+
+  WritePOD<uint64_t>(fout, plan.instruction_keys.size());
+  for (const auto& key : plan.instruction_keys) {
+    WriteString(fout, key);
+  }
+
+  WritePOD<uint64_t>(fout, plan.op_downstream_map.size());
+  for (const auto& item : plan.op_downstream_map) {
+    WritePOD<int>(fout, item.first);
+    WriteSet(fout, item.second);
+  }
+
+  WritePOD<uint64_t>(fout, plan.last_live_ops.size());
+  for (const auto& item : plan.last_live_ops) {
+    WriteString(fout, item.first);
+    WriteSet(fout, item.second);
+  }
+
+  WritePOD<uint64_t>(fout, plan.inplace_pairs.size());
+  for (const auto& pair : plan.inplace_pairs) {
+    WritePOD<uint64_t>(fout, pair.instr_id);
+    WriteString(fout, pair.in_var_name);
+    WriteString(fout, pair.out_var_name);
+  }
+
+  fout.close();
+  bool saved =
+      !fout.fail() && std::rename(tmp_path.c_str(), path.c_str()) == 0;
+  if (!saved) {
+    std::remove(tmp_path.c_str());
+  }
+  PADDLE_ENFORCE_EQ(
+      saved,
+      true,
+      platform::errors::Unavailable(
+          "Failed to write the InterpreterCore plan to %s.", path));
+  VLOG(3) << "Save InterpreterCore plan to " << path;
+}
+
+bool LoadInterpreterPlan(const std::string& path,
+                         uint64_t program_hash,
+                         InterpreterPlan* plan) {
+  std::ifstream fin(path, std::ios::binary);
+  if (!fin) {
+    VLOG(3) << "InterpreterCore plan " << path << " does not exist";
+    return false;
+  }
+
+  uint32_t magic = 0, version = 0;
+  uint64_t hash = 0;
+  if (!ReadPOD(fin, &magic) || magic != kPlanMagic ||
+      !ReadPOD(fin, &version) || version != kPlanVersion) {
+    LOG(WARNING) << path << " is not a valid InterpreterCore plan of version "
+                 << kPlanVersion << ", ignore it.";
+    return false;
+  }
+  if (!ReadPOD(fin, &hash) || hash != program_hash) {
+    VLOG(3) << "The program hash of InterpreterCore plan " << path
+            << " mismatches, ignore it.";
+    return false;
+  }
+
+  InterpreterPlan loaded_plan;
+  loaded_plan.program_hash = hash;
+  if (!ReadPlanBody(fin, &loaded_plan)) {
+    LOG(WARNING) << "InterpreterCore plan " << path
+                 << " is truncated or corrupted, ignore it.";
+    return false;
+  }
+  *plan = std::move(loaded_plan);
+  VLOG(3) << "Load InterpreterCore plan from " << path;
+  return true;
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,67 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+struct InplacePair {
+  size_t instr_id;
+  std::string in_var_name;
+  std::string out_var_name;
+};
+
+// InterpreterPlan records the analysis results of InterpreterCore::Convert,
+// which can be saved next to the model and reloaded by a new process to skip
+// the dependency, gc and inplace analysis. The plan is only valid for the
+// program (and place) whose hash equals to program_hash.
+struct InterpreterPlan {
+  uint64_t program_hash{0};
+  // "op_type:kernel_key" of each instruction, used to check that the
+  // instruction list built by the new process matches the plan
+  std::vector<std::string> instruction_keys;
+  // mapping from op to its downstream-op set, see DependencyBuilder
+  std::map<int, std::set<int>> op_downstream_map;
+  // mapping from var name to the ops that last access it
+  std::map<std::string, std::set<size_t>> last_live_ops;
+  std::vector<InplacePair> inplace_pairs;
+};
+
+// Stable (FNV-1a) hash of the serialized program, the place and the options
+// (i.e., flags) which affect the analysis.
+uint64_t HashProgramForPlan(ProgramDesc* program,
+                            const platform::Place& place,
+                            const std::string& options);
+
+void SaveInterpreterPlan(const InterpreterPlan& plan, const std::string& path);
+
+// Return false if the file does not exist, or its version or program hash
+// does not match.
+bool LoadInterpreterPlan(const std::string& path,
+                         uint64_t program_hash,
+                         InterpreterPlan* plan);
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
 
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <thread>
 #include <unordered_set>
 
 #include "gflags/gflags.h"
@@ -52,9 +56,27 @@ PADDLE_DEFINE_EXPORTED_bool(new_executor_use_local_scope,
 PADDLE_DEFINE_EXPORTED_bool(control_flow_use_new_executor,
                             false,
                             "Use new executor in control flow op");
+PADDLE_DEFINE_EXPORTED_bool(
+    new_executor_use_work_stealing,
+    false,
+    "Keep ready host OPs in the local queue of the thread which produced "
+    "their inputs, and only hand them over to other threads when there are "
+    "idle workers.");
+PADDLE_DEFINE_EXPORTED_bool(
+    new_executor_use_critical_path_priority,
+    false,
+    "Profile the host time of each OP in the first steps, and then always "
+    "dispatch the ready OP with the longest remaining path to the end of the "
+    "program first.");
+PADDLE_DEFINE_EXPORTED_int32(
+    new_executor_critical_path_warmup_steps,
+    3,
+    "Number of profiled steps before building the critical path, only used "
+    "when FLAGS_new_executor_use_critical_path_priority is set.");
 
 DECLARE_bool(check_nan_inf);
 DECLARE_bool(benchmark);
+DECLARE_bool(enable_latency_histogram);
 
 constexpr const char* kExceptionCaught = "ExceptionCaught";
 constexpr const char* kTaskCompletion = "TaskCompletion";
@@ -176,6 +198,13 @@ interpreter::CostInfo InterpreterCore::DryRun(
     platform::DeviceContextPool::Instance().Get(place_)->Wait();
   }
 
+  if (num_profiled_steps_ > 0) {
+    cost_info.instruction_time.reserve(instruction_time_.size());
+    for (double time : instruction_time_) {
+      cost_info.instruction_time.push_back(time / num_profiled_steps_);
+    }
+  }
+
   if (HasLocalScope()) {
     ClearLoDTensorArrayInLocalScope();
   }
@@ -311,6 +340,12 @@ void InterpreterCore::SetSkipGcVars(const std::set<std::string>& skip_gc_vars) {
   execution_config_.skip_gc_vars = skip_gc_vars;
 }
 
+void InterpreterCore::SetPlanCache(const std::string& plan_cache_path,
+                                   uint64_t program_hash) {
+  plan_cache_path_ = plan_cache_path;
+  program_hash_ = program_hash;
+}
+
 const VariableScope* InterpreterCore::GetVariableScope() const {
   return &var_scope_;
 }
@@ -429,6 +464,19 @@ void InterpreterCore::BuildInplace() {
 
   Scope* local_scope = HasLocalScope() ? var_scope_.GetMutableLocalScope()
                                        : var_scope_.GetMutableScope();
+  if (is_plan_cached_) {
+    for (const interpreter::InplacePair& pair : plan_->inplace_pairs) {
+      auto invar = local_scope->FindVar(pair.in_var_name);
+      auto outvar = local_scope->FindVar(pair.out_var_name);
+      if (invar && outvar) {
+        vec_instruction_.at(pair.instr_id).AddInplace(invar, outvar);
+        VLOG(3) << "inplace from plan " << pair.in_var_name << " -> "
+                << pair.out_var_name;
+      }
+    }
+    return;
+  }
+
   std::vector<std::vector<size_t>> input_var2op(var_scope_.VarSize());
   for (Instruction& instr : vec_instruction_) {
     for (auto& item : instr.Inputs()) {
@@ -479,6 +527,9 @@ void InterpreterCore::BuildInplace() {
               instr.AddInplace(invar, outvar);
               VLOG(3) << "inplace " << op_base->Type() << " " << invar_name
                       << " -> " << outvar_name;
+              if (plan_) {
+                plan_->inplace_pairs.push_back({i, invar_name, outvar_name});
+              }
             }
           }
         }
@@ -492,9 +543,17 @@ void InterpreterCore::BuildOperatorDependences() {
   // Schedule
   auto op_nums = vec_instruction_.size();
   dependecy_count_.resize(op_nums);
-  auto op2downstream = dependency_builder_.Build(
-      vec_instruction_,
-      /*is_sequential_run=*/FLAGS_new_executor_sequential_run);
+  std::map<int, std::set<int>> op2downstream;
+  if (is_plan_cached_) {
+    op2downstream = plan_->op_downstream_map;
+  } else {
+    op2downstream = dependency_builder_.Build(
+        vec_instruction_,
+        /*is_sequential_run=*/FLAGS_new_executor_sequential_run);
+    if (plan_) {
+      plan_->op_downstream_map = op2downstream;
+    }
+  }
   for (size_t op = 0; op < vec_instruction_.size(); ++op) {
     auto op_list = op2downstream[op];
     std::vector<size_t> downsteam_vector(op_list.begin(), op_list.end());
@@ -536,10 +595,29 @@ void InterpreterCore::Convert(
         op_idx, std::move(op_func_node), *dev_ctx_, priority);
   }
 
+  LoadOrCreatePlan();
+
   BuildOperatorDependences();
 
+  if (is_plan_cached_) {
+    for (auto& item : plan_->last_live_ops) {
+      int var_id = var_scope_.GetIdByName(item.first);
+      PADDLE_ENFORCE_NE(
+          var_id,
+          -1,
+          platform::errors::NotFound(
+              "Variable %s of the InterpreterCore plan is not found.",
+              item.first));
+      for (size_t op_idx : item.second) {
+        vec_instruction_.at(op_idx).AddGCCheckVar(var_id);
+      }
+      last_live_ops_[var_id] = item.second;
+      vec_meta_info[var_id].var_ref_count_ = item.second.size();
+    }
+  }
+
   // calculate last_live_ops_
-  for (size_t op_idx = 0; op_idx < op_nums; ++op_idx) {
+  for (size_t op_idx = 0; op_idx < op_nums && !is_plan_cached_; ++op_idx) {
     Instruction& instr = vec_instruction_[op_idx];
     OpInOutInfo info;
     info.Build(instr.OpBase());
@@ -589,6 +667,9 @@ void InterpreterCore::Convert(
 
   // clear the last_live_ops list for all vars in skip_gc_vars
   for (const std::string& skip_gc_var : execution_config_.skip_gc_vars) {
+    if (is_plan_cached_) {
+      break;
+    }
     int var_id = var_scope_.GetIdByName(skip_gc_var);
     if (var_id != -1) {
       last_live_ops_[var_id].clear();
@@ -603,7 +684,7 @@ void InterpreterCore::Convert(
   // c = op2(a, b)
   // in this case, a is the input of op1 and op2, we only need to check
   // a after op2, because op2 always uses a after op1.
-  for (size_t i = 0; i < last_live_ops_.size(); ++i) {
+  for (size_t i = 0; i < last_live_ops_.size() && !is_plan_cached_; ++i) {
     std::set<size_t> minumum_last_live_ops;
     for (size_t item : last_live_ops_[i]) {
       bool not_before_any = true;
@@ -626,6 +707,9 @@ void InterpreterCore::Convert(
     }
     last_live_ops_[i] = minumum_last_live_ops;
     vec_meta_info[i].var_ref_count_ = last_live_ops_[i].size();
+    if (plan_ && !minumum_last_live_ops.empty()) {
+      plan_->last_live_ops[var_scope_.GetNameById(i)] = minumum_last_live_ops;
+    }
   }
 
   for (size_t i = 0; i < vec_instruction_.size(); ++i) {
@@ -654,6 +738,66 @@ void InterpreterCore::Convert(
     refs_.emplace_back(std::make_shared<interpreter::VarRefInfo>(
         vec_meta_info[i].var_ref_count_, var_scope_.VarRef(i)));
   }
+
+  SavePlan();
+}
+
+static std::string InstructionKey(const Instruction& instr) {
+  std::ostringstream oss;
+  oss << instr.OpBase()->Type();
+  auto* op_with_kernel =
+      dynamic_cast<const framework::OperatorWithKernel*>(instr.OpBase());
+  if (op_with_kernel != nullptr && op_with_kernel->kernel_type() != nullptr) {
+    oss << ":" << *(op_with_kernel->kernel_type());
+  }
+  return oss.str();
+}
+
+void InterpreterCore::LoadOrCreatePlan() {
+  is_plan_cached_ = false;
+  plan_cache_hit_ = false;
+  plan_.reset();
+  if (plan_cache_path_.empty()) {
+    return;
+  }
+
+  std::vector<std::string> instruction_keys;
+  instruction_keys.reserve(vec_instruction_.size());
+  for (const Instruction& instr : vec_instruction_) {
+    instruction_keys.emplace_back(InstructionKey(instr));
+  }
+
+  plan_.reset(new interpreter::InterpreterPlan());
+  if (interpreter::LoadInterpreterPlan(
+          plan_cache_path_, program_hash_, plan_.get())) {
+    // NOTE: the instruction list contains the data transfer ops and the
+    // kernels selected by BuildOpFuncList, which depend on the runtime
+    // environment, so the plan is only reused if they are the same.
+    if (plan_->instruction_keys == instruction_keys) {
+      is_plan_cached_ = true;
+      plan_cache_hit_ = true;
+      VLOG(3) << "Use InterpreterCore plan " << plan_cache_path_;
+      return;
+    }
+    LOG(WARNING) << "The instructions of InterpreterCore plan "
+                 << plan_cache_path_
+                 << " mismatch the built ones, rebuild the plan.";
+    plan_.reset(new interpreter::InterpreterPlan());
+  }
+  plan_->program_hash = program_hash_;
+  plan_->instruction_keys = std::move(instruction_keys);
+}
+
+void InterpreterCore::SavePlan() {
+  if (plan_ && !is_plan_cached_) {
+    try {
+      interpreter::SaveInterpreterPlan(*plan_, plan_cache_path_);
+    } catch (platform::EnforceNotMet& ex) {
+      LOG(WARNING) << "Failed to save InterpreterCore plan: " << ex.what();
+    }
+  }
+  plan_.reset();
+  is_plan_cached_ = false;
 }
 
 void InterpreterCore::BuildSkipShareLoDInfo() {
@@ -809,17 +953,41 @@ void InterpreterCore::ExecuteInstructionList(
   }
 
   exception_holder_.Clear();
+  num_local_hits_ = 0;
+  num_steals_ = 0;
+  num_queue_hops_ = 0;
+
+  profile_instructions_ =
+      FLAGS_new_executor_use_critical_path_priority && !critical_path_built_;
+  if (profile_instructions_ && instruction_time_.size() != vec_instr.size()) {
+    instruction_time_.assign(vec_instr.size(), 0.);
+  }
+  record_latency_ = FLAGS_enable_latency_histogram;
+  if (record_latency_ && instruction_latency_.size() != vec_instr.size()) {
+    instruction_latency_.clear();
+    for (auto& instr : vec_instr) {
+      instruction_latency_.push_back(
+          platform::MetricRegistry::Instance().GetHistogram(
+              "paddle_op_latency_seconds",
+              "The latency of the operators run by the new executor.",
+              platform::PrometheusLabel("op_type", instr.OpBase()->Type())));
+    }
+  }
 
   for (size_t i = 0; i < dependecy_count_.size(); ++i) {
     if (dependecy_count_[i] == 0) {
-      async_work_queue_->AddTask(vec_instr.at(i).KernelType(),
-                                 [this, i] { RunInstructionAsync(i); });
+      AddInstructionTask(i);
     }
   }
 
   auto event_name = main_thread_blocker_.WaitEvent();
   VLOG(1) << "main_thread_blocker_(" << &main_thread_blocker_
           << ") got event_name: " << event_name;
+  if (FLAGS_new_executor_use_work_stealing) {
+    VLOG(4) << "Scheduling stats: local_hits=" << num_local_hits_
+            << ", steals=" << num_steals_
+            << ", queue_hops=" << num_queue_hops_;
+  }
 
   if (UNLIKELY(exception_holder_.IsCaught())) {
     VLOG(1) << "Exception caught " << exception_holder_.Type();
@@ -837,6 +1005,12 @@ void InterpreterCore::ExecuteInstructionList(
     VLOG(4) << "clear ok";
     exception_holder_.ReThrow();
   }
+
+  if (profile_instructions_ &&
+      ++num_profiled_steps_ >=
+          static_cast<size_t>(FLAGS_new_executor_critical_path_warmup_steps)) {
+    BuildCriticalPath();
+  }
 }
 
 void InterpreterCore::RunNextInstructions(
@@ -855,37 +1029,25 @@ void InterpreterCore::RunNextInstructions(
     // move all sync_ops into other threads
     for (size_t next_id : next_instr.SyncRunIds()) {
       if (IsReady(next_id)) {
-        async_work_queue_->AddTask(
-            vec_instruction_[next_id].KernelType(),
-            [this, next_id]() { RunInstructionAsync(next_id); });
+        AddInstructionTask(next_id);
       }
     }
     // keep all async_ops running in current thread
     for (size_t next_id : next_instr.DirectRunIds()) {
       if (IsReady(next_id)) {
-        if (vec_instruction_[next_id].GetPriority() == Priority::kLowest) {
-          reserved_next_ops->push_back(next_id);
-        } else {
-          reserved_next_ops->push_front(next_id);
-        }
+        ReserveInstruction(next_id, reserved_next_ops);
       }
     }
     for (size_t next_id : next_instr.EventRunIds()) {
       if (IsReady(next_id)) {
-        if (vec_instruction_[next_id].GetPriority() == Priority::kLowest) {
-          reserved_next_ops->push_back(next_id);
-        } else {
-          reserved_next_ops->push_front(next_id);
-        }
+        ReserveInstruction(next_id, reserved_next_ops);
       }
     }
   } else {
     // move async_ops into async_thread
     for (auto next_id : next_instr.EventRunIds()) {
       if (IsReady(next_id)) {
-        async_work_queue_->AddTask(
-            vec_instruction_[next_id].KernelType(),
-            [this, next_id] { RunInstructionAsync(next_id); });
+        AddInstructionTask(next_id);
       }
     }
 
@@ -894,19 +1056,42 @@ void InterpreterCore::RunNextInstructions(
                           next_instr.DirectRunIds().begin(),
                           next_instr.DirectRunIds().end());
 
+    if (FLAGS_new_executor_use_work_stealing) {
+      // keep all ready sync ops in the current thread (LIFO), so that the
+      // consumers run on the thread which produced their inputs. They are
+      // handed over to idle workers in SpillReadyInstructions.
+      for (auto next_id : direct_run_ops) {
+        if (IsReady(next_id)) {
+          if (vec_instruction_[next_id].KernelType() ==
+              OpFuncType::kQueueSync) {
+            ReserveInstruction(next_id, reserved_next_ops);
+          } else {
+            AddInstructionTask(next_id);
+          }
+        }
+      }
+      return;
+    }
+
+    // only keep one sync op running in current thread, which is the first
+    // one, or the one scheduled first once the critical path is built
     int64_t first_op = -1;
     for (auto next_id : direct_run_ops) {
       if (IsReady(next_id)) {
-        // only keep one sync op running in current thread
-        if (first_op == -1 &&
-            vec_instruction_[next_id].KernelType() == OpFuncType::kQueueSync) {
-          first_op = next_id;
-          continue;
+        if (vec_instruction_[next_id].KernelType() == OpFuncType::kQueueSync) {
+          if (first_op == -1) {
+            first_op = next_id;
+            continue;
+          }
+          if (critical_path_built_ &&
+              ScheduleBefore(next_id, static_cast<size_t>(first_op))) {
+            AddInstructionTask(first_op);
+            first_op = next_id;
+            continue;
+          }
         }
         // move rest ops into other threads
-        async_work_queue_->AddTask(
-            vec_instruction_[next_id].KernelType(),
-            [this, next_id] { RunInstructionAsync(next_id); });
+        AddInstructionTask(next_id);
       }
     }
     if (first_op != -1) {
@@ -915,67 +1100,260 @@ void InterpreterCore::RunNextInstructions(
   }
 }
 
+void InterpreterCore::ReserveInstruction(
+    size_t instr_id, std::deque<size_t>* reserved_next_ops) const {
+  if (critical_path_built_) {
+    reserved_next_ops->insert(
+        std::upper_bound(reserved_next_ops->begin(),
+                         reserved_next_ops->end(),
+                         instr_id,
+                         [this](size_t lhs, size_t rhs) {
+                           return ScheduleBefore(lhs, rhs);
+                         }),
+        instr_id);
+  } else if (vec_instruction_[instr_id].GetPriority() == Priority::kLowest) {
+    reserved_next_ops->push_back(instr_id);
+  } else {
+    reserved_next_ops->push_front(instr_id);
+  }
+}
+
+void InterpreterCore::AddInstructionTask(size_t instr_id) {
+  const OpFuncType& kernel_type = vec_instruction_[instr_id].KernelType();
+  if (FLAGS_new_executor_use_work_stealing) {
+    num_queue_hops_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (critical_path_built_) {
+    // NOTE: the task does not run instr_id itself, but the ready instruction
+    // of the same kernel type with the largest critical path cost. As each
+    // ready instruction adds exactly one task, all of them will be run.
+    auto* ready_queue = &ready_queues_.at(static_cast<size_t>(kernel_type));
+    ready_queue->Push(instr_id, vec_instruction_[instr_id].CriticalPathCost());
+    async_work_queue_->AddTask(kernel_type, [this, ready_queue] {
+      RunInstructionAsync(ready_queue->Pop());
+    });
+    return;
+  }
+
+  async_work_queue_->AddTask(
+      kernel_type, [this, instr_id] { RunInstructionAsync(instr_id); });
+}
+
+void InterpreterCore::SpillReadyInstructions(
+    const std::shared_ptr<interpreter::LocalReadyQueue>& local_queue) {
+  size_t num_idle_threads = async_work_queue_->QueueNumIdleThreads(
+      static_cast<size_t>(OpFuncType::kQueueSync));
+  // One steal task per idle worker, while the owner keeps at least one
+  // instruction which is not claimed by a pending steal task.
+  auto& pending_steals = local_queue->PendingSteals();
+  while (num_idle_threads > 0 &&
+         local_queue->Size() > pending_steals.load() + 1) {
+    pending_steals.fetch_add(1);
+    async_work_queue_->AddTask(OpFuncType::kQueueSync, [this, local_queue] {
+      local_queue->PendingSteals().fetch_sub(1);
+      size_t instr_id = 0;
+      // NOTE: the owner may have run all of the instructions, and the task
+      // must not touch this InterpreterCore then, as its run may be over.
+      if (!local_queue->PopBack(&instr_id)) {
+        return;
+      }
+      if (vec_instruction_[instr_id].KernelType() != OpFuncType::kQueueSync) {
+        AddInstructionTask(instr_id);
+        return;
+      }
+      num_steals_.fetch_add(1, std::memory_order_relaxed);
+      RunInstructionAsync(instr_id);
+    });
+    --num_idle_threads;
+  }
+}
+
+bool InterpreterCore::ScheduleBefore(size_t lhs, size_t rhs) const {
+  const Instruction& lhs_instr = vec_instruction_[lhs];
+  const Instruction& rhs_instr = vec_instruction_[rhs];
+  if (lhs_instr.GetPriority() != rhs_instr.GetPriority()) {
+    return rhs_instr.GetPriority() == Priority::kLowest;
+  }
+  return lhs_instr.CriticalPathCost() > rhs_instr.CriticalPathCost();
+}
+
+void InterpreterCore::BuildCriticalPath() {
+  auto ForEachNextInstruction = [this](size_t instr_id, auto&& fn) {
+    const NextInstructionList& next_instr =
+        vec_instruction_[instr_id].NextInstructions();
+    for (size_t next_id : next_instr.DirectRunIds()) {
+      fn(next_id);
+    }
+    for (size_t next_id : next_instr.EventRunIds()) {
+      fn(next_id);
+    }
+    for (size_t next_id : next_instr.SyncRunIds()) {
+      fn(next_id);
+    }
+  };
+
+  // topological order of the instructions
+  std::vector<size_t> dependecy_count = dependecy_count_;
+  std::vector<size_t> topo_order;
+  topo_order.reserve(vec_instruction_.size());
+  for (size_t i = 0; i < dependecy_count.size(); ++i) {
+    if (dependecy_count[i] == 0) {
+      topo_order.push_back(i);
+    }
+  }
+  for (size_t i = 0; i < topo_order.size(); ++i) {
+    ForEachNextInstruction(topo_order[i], [&](size_t next_id) {
+      if (--dependecy_count[next_id] == 0) {
+        topo_order.push_back(next_id);
+      }
+    });
+  }
+
+  // longest remaining path, computed in the reverse topological order
+  for (auto iter = topo_order.rbegin(); iter != topo_order.rend(); ++iter) {
+    size_t instr_id = *iter;
+    double max_next_cost = 0.;
+    ForEachNextInstruction(instr_id, [&](size_t next_id) {
+      max_next_cost = std::max(max_next_cost,
+                               vec_instruction_[next_id].CriticalPathCost());
+    });
+    double cost = instruction_time_[instr_id] / num_profiled_steps_;
+    vec_instruction_[instr_id].SetCriticalPathCost(cost + max_next_cost);
+    VLOG(8) << "Critical path cost of " << instr_id << " "
+            << vec_instruction_[instr_id].OpBase()->Type() << ": "
+            << vec_instruction_[instr_id].CriticalPathCost() << " ms";
+  }
+
+  critical_path_built_ = true;
+  VLOG(4) << "Build critical path after " << num_profiled_steps_
+          << " profiled steps";
+}
+
+interpreter::SchedulingStats InterpreterCore::GetSchedulingStats() const {
+  interpreter::SchedulingStats stats;
+  stats.local_hits = num_local_hits_.load(std::memory_order_relaxed);
+  stats.steals = num_steals_.load(std::memory_order_relaxed);
+  stats.queue_hops = num_queue_hops_.load(std::memory_order_relaxed);
+  return stats;
+}
+
 void InterpreterCore::RunInstructionAsync(size_t instr_id) {
+  if (FLAGS_new_executor_use_work_stealing) {
+    // The first instruction is counted as a queue hop or a steal by its
+    // task, the following ones are local hits.
+    auto local_queue = std::make_shared<interpreter::LocalReadyQueue>();
+    std::deque<size_t> ready_ops;
+    bool is_first_op = true;
+    do {
+      if (!is_first_op) {
+        num_local_hits_.fetch_add(1, std::memory_order_relaxed);
+      }
+      is_first_op = false;
+      ready_ops.clear();
+      if (!RunReadyInstruction(instr_id, &ready_ops)) {
+        return;
+      }
+      if (!ready_ops.empty()) {
+        if (critical_path_built_) {
+          for (size_t ready_op : ready_ops) {
+            local_queue->Insert(ready_op, [this](size_t lhs, size_t rhs) {
+              return ScheduleBefore(lhs, rhs);
+            });
+          }
+        } else {
+          local_queue->PushFront(ready_ops);
+        }
+        SpillReadyInstructions(local_queue);
+      }
+    } while (local_queue->PopFront(&instr_id));
+    return;
+  }
+
   std::deque<size_t> ready_ops;
   ready_ops.push_back(instr_id);
+  // NOTE: ready_ops is kept ordered by ReserveInstruction, the front one is
+  // always the next to run.
   while (!ready_ops.empty()) {
     instr_id = ready_ops.front();
     ready_ops.pop_front();
-    auto& instr_node = vec_instruction_.at(instr_id);
-    VLOG(5) << __func__ << " OP id:" << instr_node.Id()
-            << " name:" << instr_node.OpBase()->Type() << " type:"
-            << (instr_node.KernelType() == OpFuncType::kQueueSync
-                    ? "kQueueSync"
-                    : "kQueueAsync")
-            << " runs on " << platform::GetCurrentThreadName();
-
-    auto* op = instr_node.OpBase();
-    platform::RecordEvent instruction_event(
-        op->Type(), platform::TracerEventType::Operator, 1);
+    if (!RunReadyInstruction(instr_id, &ready_ops)) {
+      return;
+    }
+  }
+}
 
-    try {
-      interpreter::WaitEvent(instr_node, place_);
+bool InterpreterCore::RunReadyInstruction(
+    size_t instr_id, std::deque<size_t>* reserved_next_ops) {
+  auto& instr_node = vec_instruction_.at(instr_id);
+  VLOG(5) << __func__ << " OP id:" << instr_node.Id()
+          << " name:" << instr_node.OpBase()->Type() << " type:"
+          << (instr_node.KernelType() == OpFuncType::kQueueSync
+                  ? "kQueueSync"
+                  : "kQueueAsync")
+          << " runs on " << platform::GetCurrentThreadName();
 
-      if (!instr_node.IsArtificial()) {
-        RunInstruction(instr_node);
-        CheckGC(instr_node);
-        interpreter::LogDeviceMemoryStats(place_);
-      }
+  auto* op = instr_node.OpBase();
+  platform::RecordEvent instruction_event(
+      op->Type(), platform::TracerEventType::Operator, 1);
 
-      interpreter::RecordEvent(instr_node, place_);
-    } catch (platform::EnforceNotMet& ex) {
-      framework::InsertCallStackInfo(op->Type(), op->Attrs(), &ex);
-      exception_holder_.Catch(std::make_exception_ptr(std::move(ex)));
-    } catch (platform::EOFException&) {
-      exception_holder_.Catch(std::current_exception());
-    } catch (std::exception& ex) {
-      LOG(WARNING) << op->Type() << " raises an exception "
-                   << platform::demangle(typeid(ex).name()) << ", "
-                   << ex.what();
-      exception_holder_.Catch(std::current_exception());
-    } catch (...) {
-      LOG(WARNING) << op->Type() << " raises an unknown exception";
-      exception_holder_.Catch(std::current_exception());
-    }
+  try {
+    interpreter::WaitEvent(instr_node, place_);
 
-    if (UNLIKELY(exception_holder_.IsCaught())) {
-      VLOG(4) << "Exception caught";
-      if (exception_notifier_ != nullptr) {
-        exception_notifier_->NotifyEvent();
+    if (!instr_node.IsArtificial()) {
+      if (UNLIKELY(profile_instructions_ || record_latency_)) {
+        auto start = std::chrono::steady_clock::now();
+        RunInstruction(instr_node);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        if (profile_instructions_) {
+          instruction_time_[instr_id] +=
+              std::chrono::duration<double, std::milli>(elapsed).count();
+        }
+        if (record_latency_) {
+          instruction_latency_[instr_id]->Record(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                  .count());
+        }
+      } else {
+        RunInstruction(instr_node);
       }
-      return;
+      CheckGC(instr_node);
+      interpreter::LogDeviceMemoryStats(place_);
     }
 
-    VLOG(4) << "unfinished_op_number_: " << unfinished_op_number_;
-    if (UNLIKELY(unfinished_op_number_.fetch_sub(
-                     1, std::memory_order_relaxed) == 1)) {
-      if (completion_notifier_ != nullptr) {
-        completion_notifier_->NotifyEvent();
-      }
+    interpreter::RecordEvent(instr_node, place_);
+  } catch (platform::EnforceNotMet& ex) {
+    framework::InsertCallStackInfo(op->Type(), op->Attrs(), &ex);
+    exception_holder_.Catch(std::make_exception_ptr(std::move(ex)));
+  } catch (platform::EOFException&) {
+    exception_holder_.Catch(std::current_exception());
+  } catch (std::exception& ex) {
+    LOG(WARNING) << op->Type() << " raises an exception "
+                 << platform::demangle(typeid(ex).name()) << ", "
+                 << ex.what();
+    exception_holder_.Catch(std::current_exception());
+  } catch (...) {
+    LOG(WARNING) << op->Type() << " raises an unknown exception";
+    exception_holder_.Catch(std::current_exception());
+  }
+
+  if (UNLIKELY(exception_holder_.IsCaught())) {
+    VLOG(4) << "Exception caught";
+    if (exception_notifier_ != nullptr) {
+      exception_notifier_->NotifyEvent();
     }
+    return false;
+  }
 
-    RunNextInstructions(instr_node, &ready_ops);
+  VLOG(4) << "unfinished_op_number_: " << unfinished_op_number_;
+  if (UNLIKELY(unfinished_op_number_.fetch_sub(
+                   1, std::memory_order_relaxed) == 1)) {
+    if (completion_notifier_ != nullptr) {
+      completion_notifier_->NotifyEvent();
+    }
   }
+
+  RunNextInstructions(instr_node, reserved_next_ops);
+  return true;
 }
 
 void InterpreterCore::RecordStreamForGC(const Instruction& instr) {
@@ -1165,7 +1543,8 @@ std::shared_ptr<InterpreterCore> CreateInterpreterCore(
     const ProgramDesc& prog,
     Scope* scope,
     const std::vector<std::string>& fetch_names,
-    const std::set<std::string>& skip_gc_vars) {
+    const std::set<std::string>& skip_gc_vars,
+    const std::string& plan_cache_path) {
   std::shared_ptr<InterpreterCore> core = nullptr;
   // NOTE(Aurelius84): `AddFetch` will modify BlockDesc, so we should copy
   // a new program.
@@ -1175,6 +1554,18 @@ std::shared_ptr<InterpreterCore> CreateInterpreterCore(
 
   core = std::make_shared<InterpreterCore>(place, *block, skip_gc_vars, scope);
   core->SetCopyProgram(new_prog);
+  if (!plan_cache_path.empty()) {
+    std::ostringstream options;
+    options << "sequential_run:" << FLAGS_new_executor_sequential_run
+            << ",use_inplace:" << FLAGS_new_executor_use_inplace
+            << ",skip_gc_vars:";
+    for (auto& var_name : skip_gc_vars) {
+      options << var_name << ",";
+    }
+    core->SetPlanCache(
+        plan_cache_path,
+        interpreter::HashProgramForPlan(new_prog.get(), place, options.str()));
+  }
   return core;
 }
 
@@ -13,6 +13,7 @@
 // limitations under the License.
 #pragma once
 
+#include <array>
 #include <map>
 #include <queue>
 #include <string>
@@ -25,6 +26,7 @@
 #include "paddle/fluid/framework/new_executor/interpreter/event_manager.h"
 #include "paddle/fluid/framework/new_executor/interpreter/execution_config.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
+#include "paddle/fluid/framework/new_executor/interpreter/plan_cache.h"
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
 #include "paddle/fluid/framework/new_executor/profiler.h"
 #include "paddle/fluid/framework/new_executor/stream_analyzer.h"
@@ -33,9 +35,12 @@
 #include "paddle/fluid/framework/variable.h"
 #include "paddle/fluid/memory/allocation/spin_lock.h"
 #include "paddle/fluid/platform/device_event.h"
+#include "paddle/fluid/platform/monitor.h"
 
 DECLARE_bool(new_executor_use_local_scope);
 DECLARE_bool(control_flow_use_new_executor);
+DECLARE_bool(new_executor_use_work_stealing);
+DECLARE_bool(new_executor_use_critical_path_priority);
 
 namespace paddle {
 namespace framework {
@@ -68,18 +73,32 @@ class InterpreterCore {
 
   void SetSkipGcVars(const std::set<std::string>& skip_gc_vars);
 
+  // Load the analysis results of Convert from plan_cache_path if its program
+  // hash equals to program_hash, otherwise build them from scratch and save
+  // them to plan_cache_path.
+  void SetPlanCache(const std::string& plan_cache_path, uint64_t program_hash);
+
+  // Whether the analysis of the last Convert was loaded from the plan cache.
+  bool PlanCacheHit() const { return plan_cache_hit_; }
+
   const VariableScope* GetVariableScope() const;
 
   void reset_scope(Scope* new_scope);
 
   const platform::Place& GetPlace() const { return place_; }
 
+  // Scheduling counters of the last run, see
+  // FLAGS_new_executor_use_work_stealing.
+  interpreter::SchedulingStats GetSchedulingStats() const;
+
  private:
   // build graph
   void Convert(std::vector<paddle::framework::OpFuncNode>* op_func_nodes);
   void BuildOperatorDependences();
   void BuildAndCacheInstructionCtx(Instruction* instr_node);
   void BuildSkipShareLoDInfo();
+  void LoadOrCreatePlan();
+  void SavePlan();
 
   // inplace
   void BuildInplace();
@@ -90,9 +109,27 @@ class InterpreterCore {
   // execution
   void ExecuteInstructionList(const std::vector<Instruction>& vec_instr);
   void RunInstructionAsync(size_t instr_id);
+  // Run instr_id and collect its ready next instructions to be run in the
+  // current thread. Returns false if an exception is caught.
+  bool RunReadyInstruction(size_t instr_id,
+                           std::deque<size_t>* reserved_next_ops);
   void RunInstruction(const Instruction& instr_node);
   void RunNextInstructions(const Instruction& instr_id,
                            std::deque<size_t>* reserved_next_ops);
+  // Add instr_id to the instructions to be run in the current thread, which
+  // are ordered by ScheduleBefore once the critical path is built.
+  void ReserveInstruction(size_t instr_id,
+                          std::deque<size_t>* reserved_next_ops) const;
+  void AddInstructionTask(size_t instr_id);
+  // Add steal tasks for the idle workers to run the instructions at the back
+  // of local_queue, see FLAGS_new_executor_use_work_stealing.
+  void SpillReadyInstructions(
+      const std::shared_ptr<interpreter::LocalReadyQueue>& local_queue);
+  // returns true if the instruction lhs should be scheduled before rhs
+  bool ScheduleBefore(size_t lhs, size_t rhs) const;
+
+  // critical path
+  void BuildCriticalPath();
   // only used when program contains no feed op
   void Prepare(const std::vector<std::string>& feed_names,
                const std::vector<phi::DenseTensor>& feed_tensors,
@@ -124,6 +161,14 @@ class InterpreterCore {
   // new program is deleted.
   std::shared_ptr<ProgramDesc> copy_program_{nullptr};
 
+  // plan cache, see SetPlanCache. plan_ is only alive during Convert, and
+  // is_plan_cached_ means that it is loaded from plan_cache_path_.
+  std::string plan_cache_path_;
+  uint64_t program_hash_{0};
+  std::unique_ptr<interpreter::InterpreterPlan> plan_;
+  bool is_plan_cached_{false};
+  bool plan_cache_hit_{false};
+
   // from variable scope
   std::vector<Variable*> var_list_;
   std::map<std::string, int> name2id_;
@@ -132,6 +177,22 @@ class InterpreterCore {
   std::vector<Instruction> vec_instruction_;  // deconstruct before OpFuncNode
 
   std::atomic<size_t> unfinished_op_number_{0};
+
+  // scheduling counters, see SchedulingStats
+  std::atomic<uint64_t> num_local_hits_{0};
+  std::atomic<uint64_t> num_steals_{0};
+  std::atomic<uint64_t> num_queue_hops_{0};
+
+  // per-instruction profiling and critical path scheduling, see
+  // FLAGS_new_executor_use_critical_path_priority
+  bool profile_instructions_{false};
+  bool critical_path_built_{false};
+  size_t num_profiled_steps_{0};
+  std::vector<double> instruction_time_;  // ms, accumulated over the steps
+  // the histogram of every instruction, see FLAGS_enable_latency_histogram
+  bool record_latency_{false};
+  std::vector<platform::LatencyHistogram*> instruction_latency_;
+  std::array<interpreter::CriticalPathReadyQueue, 2> ready_queues_;
   VariableScope var_scope_;
   Scope* local_scope_{nullptr};  // not owned
 
@@ -162,7 +223,8 @@ std::shared_ptr<InterpreterCore> CreateInterpreterCore(
     const ProgramDesc& prog,
     Scope* global_scope,
     const std::vector<std::string>& fetch_names = {},
-    const std::set<std::string>& skip_gc_vars = {});
+    const std::set<std::string>& skip_gc_vars = {},
+    const std::string& plan_cache_path = "");
 
 }  // namespace framework
 }  // namespace paddle
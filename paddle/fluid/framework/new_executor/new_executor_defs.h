@@ -13,13 +13,18 @@
 // limitations under the License.
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/variable_helper.h"
+#include "paddle/fluid/memory/allocation/spin_lock.h"
 #include "paddle/fluid/platform/device_event_base.h"
 #include "paddle/fluid/platform/event.h"
 #include "paddle/phi/core/utils/rw_lock.h"
@@ -371,6 +376,12 @@ class Instruction {
 
   Priority GetPriority() const { return priority_; }
 
+  // The longest remaining path (in ms) from this instruction to the end of
+  // the program, see FLAGS_new_executor_use_critical_path_priority.
+  double CriticalPathCost() const { return critical_path_cost_; }
+
+  void SetCriticalPathCost(double cost) { critical_path_cost_ = cost; }
+
  private:
   bool is_artificial_;  // Instruction is artificial means that it is only used
                         // to assist scheduling and no need to be executed.
@@ -379,6 +390,7 @@ class Instruction {
   OpFuncNode op_func_node_;
   const platform::DeviceContext& dev_ctx_;  // not owned
   const Priority priority_;
+  double critical_path_cost_{0.};
 
   std::shared_ptr<RuntimeContext> runtime_ctx_;
   std::shared_ptr<InterpretercoreInferShapeContext> infershape_ctx_;
@@ -480,6 +492,103 @@ class ResetAtomicGuard {
   std::vector<std::shared_ptr<VarRefInfo>>* refs_;
 };
 
+// The ready instructions waiting for a thread of the AsyncWorkQueue, popped in
+// descending order of their critical path cost.
+class CriticalPathReadyQueue {
+ public:
+  void Push(size_t instr_id, double critical_path_cost) {
+    std::lock_guard<memory::SpinLock> guard(lock_);
+    heap_.emplace_back(critical_path_cost, instr_id);
+    std::push_heap(heap_.begin(), heap_.end());
+  }
+
+  size_t Pop() {
+    std::lock_guard<memory::SpinLock> guard(lock_);
+    PADDLE_ENFORCE_EQ(heap_.empty(),
+                      false,
+                      platform::errors::PreconditionNotMet(
+                          "Pop from an empty CriticalPathReadyQueue."));
+    std::pop_heap(heap_.begin(), heap_.end());
+    size_t instr_id = heap_.back().second;
+    heap_.pop_back();
+    return instr_id;
+  }
+
+ private:
+  memory::SpinLock lock_;
+  std::vector<std::pair<double, size_t>> heap_;
+};
+
+// The ready instructions kept by the worker thread which made them ready,
+// when FLAGS_new_executor_use_work_stealing is set. The owner pushes and pops
+// at the front (LIFO), and the idle workers steal from the back. Once the
+// critical path is built, the queue is ordered by the scheduling priority
+// instead.
+class LocalReadyQueue {
+ public:
+  // Push instr_ids to the front, keeping their order.
+  void PushFront(const std::deque<size_t>& instr_ids) {
+    std::lock_guard<memory::SpinLock> guard(lock_);
+    queue_.insert(queue_.begin(), instr_ids.begin(), instr_ids.end());
+  }
+
+  // Insert instr_id after the instructions which are not scheduled after
+  // it, the queue is kept ordered if all of them are inserted by Insert.
+  template <typename ScheduleBefore>
+  void Insert(size_t instr_id, ScheduleBefore schedule_before) {
+    std::lock_guard<memory::SpinLock> guard(lock_);
+    queue_.insert(std::upper_bound(
+                      queue_.begin(), queue_.end(), instr_id, schedule_before),
+                  instr_id);
+  }
+
+  bool PopFront(size_t* instr_id) {
+    std::lock_guard<memory::SpinLock> guard(lock_);
+    if (queue_.empty()) {
+      return false;
+    }
+    *instr_id = queue_.front();
+    queue_.pop_front();
+    return true;
+  }
+
+  bool PopBack(size_t* instr_id) {
+    std::lock_guard<memory::SpinLock> guard(lock_);
+    if (queue_.empty()) {
+      return false;
+    }
+    *instr_id = queue_.back();
+    queue_.pop_back();
+    return true;
+  }
+
+  size_t Size() {
+    std::lock_guard<memory::SpinLock> guard(lock_);
+    return queue_.size();
+  }
+
+  // the steal tasks which are added to the AsyncWorkQueue but not run yet
+  std::atomic<size_t>& PendingSteals() { return pending_steals_; }
+
+ private:
+  memory::SpinLock lock_;
+  std::deque<size_t> queue_;
+  std::atomic<size_t> pending_steals_{0};
+};
+
+// Scheduling counters of one InterpreterCore run, collected when
+// FLAGS_new_executor_use_work_stealing is set. Every dispatched instruction
+// is counted exactly once.
+//   local_hits: instructions popped from the local queue of the worker which
+//               made them ready.
+//   steals: instructions stolen from the local queue of another worker.
+//   queue_hops: instructions dispatched through the AsyncWorkQueue.
+struct SchedulingStats {
+  uint64_t local_hits{0};
+  uint64_t steals{0};
+  uint64_t queue_hops{0};
+};
+
 }  // namespace interpreter
 
 }  // namespace framework
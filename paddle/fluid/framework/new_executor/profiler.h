@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <vector>
+
 #include "paddle/fluid/framework/tensor.h"
 #include "paddle/fluid/framework/variable.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
@@ -24,6 +26,9 @@ namespace interpreter {
 struct CostInfo {
   double total_time{0.};          // ms
   size_t device_memory_bytes{0};  // total allocated memory size
+  // host time (ms) of each instruction, indexed by instruction id, only
+  // filled when FLAGS_new_executor_use_critical_path_priority is set
+  std::vector<double> instruction_time;
 };
 
 class ProfilerGuard {
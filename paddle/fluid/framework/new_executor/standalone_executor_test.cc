@@ -16,7 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <string>
 
@@ -276,5 +279,240 @@ TEST(InterpreterCore, workqueue_multiplexing) {
       program, {"a", "b"}, {tensor_a, tensor_b}, {"c"}, {0.0, 1.1, 2.2, 3.3});
 }
 
+TEST(InterpreterCore, work_stealing_stats) {
+  // four independent adds, each of them is fetched
+  ProgramDesc program;
+  BlockDesc* main_block = program.MutableBlock(0);
+  main_block->Var("a")->SetType(proto::VarType::LOD_TENSOR);
+  main_block->Var("b")->SetType(proto::VarType::LOD_TENSOR);
+  std::vector<std::string> fetch_names;
+  for (int i = 0; i < 4; ++i) {
+    std::string out = "c" + std::to_string(i);
+    main_block->Var(out)->SetType(proto::VarType::LOD_TENSOR);
+    OpDesc* add = main_block->AppendOp();
+    add->SetType("elementwise_add");
+    add->SetInput("X", {"a"});
+    add->SetInput("Y", {"b"});
+    add->SetOutput("Out", {out});
+    fetch_names.push_back(out);
+  }
+
+  phi::DDim dims = phi::make_ddim({2, 2});
+  const platform::CPUPlace place = platform::CPUPlace();
+  phi::DenseTensor tensor_a = phi::DenseTensor();
+  phi::DenseTensor tensor_b = phi::DenseTensor();
+  std::fill_n(tensor_a.mutable_data<float>(dims, place), 4, 1.0f);
+  std::fill_n(tensor_b.mutable_data<float>(dims, place), 4, 2.0f);
+
+  FLAGS_new_executor_use_work_stealing = true;
+  Scope scope;
+  auto core = CreateInterpreterCore(place, program, &scope, fetch_names);
+  // the first run builds the instructions
+  for (int step = 0; step < 3; ++step) {
+    FetchList fetch_list = core->Run({"a", "b"}, {tensor_a, tensor_b});
+    ASSERT_EQ(fetch_list.size(), fetch_names.size());
+    for (auto& fetch : fetch_list) {
+      const phi::DenseTensor& fetch_tensor =
+          PADDLE_GET_CONST(phi::DenseTensor, fetch);
+      for (int64_t i = 0; i < fetch_tensor.numel(); ++i) {
+        ASSERT_FLOAT_EQ(fetch_tensor.data<float>()[i], 3.0f);
+      }
+    }
+    if (step == 0) {
+      continue;
+    }
+    // each of the 4 adds and 4 fetches is counted exactly once, and the
+    // adds ready at the beginning are dispatched through the queue
+    interpreter::SchedulingStats stats = core->GetSchedulingStats();
+    EXPECT_EQ(stats.local_hits + stats.steals + stats.queue_hops, 8UL);
+    EXPECT_GE(stats.queue_hops, 4UL);
+  }
+  FLAGS_new_executor_use_work_stealing = false;
+}
+
+TEST(InterpreterCore, critical_path_ready_queues) {
+  std::vector<double> costs = {1.0, 5.0, 3.0, 4.0, 2.0};
+  auto schedule_before = [&costs](size_t lhs, size_t rhs) {
+    return costs[lhs] > costs[rhs];
+  };
+
+  // the queue shared by the workers pops the largest cost first
+  interpreter::CriticalPathReadyQueue ready_queue;
+  for (size_t i = 0; i < costs.size(); ++i) {
+    ready_queue.Push(i, costs[i]);
+  }
+  std::vector<size_t> popped;
+  for (size_t i = 0; i < costs.size(); ++i) {
+    popped.push_back(ready_queue.Pop());
+  }
+  EXPECT_EQ(popped, std::vector<size_t>({1, 3, 2, 4, 0}));
+
+  // the local queue of a worker pops the largest cost from the front, and
+  // the smallest one is stolen from the back
+  interpreter::LocalReadyQueue local_queue;
+  for (size_t i = 0; i < costs.size(); ++i) {
+    local_queue.Insert(i, schedule_before);
+  }
+  size_t instr_id = 0;
+  ASSERT_TRUE(local_queue.PopBack(&instr_id));
+  EXPECT_EQ(instr_id, 0UL);
+  popped.clear();
+  while (local_queue.PopFront(&instr_id)) {
+    popped.push_back(instr_id);
+  }
+  EXPECT_EQ(popped, std::vector<size_t>({1, 3, 2, 4}));
+}
+
+TEST(InterpreterCore, critical_path_with_work_stealing) {
+  // a chain of three adds next to a single add, the chain is on the
+  // critical path
+  ProgramDesc program;
+  BlockDesc* main_block = program.MutableBlock(0);
+  for (auto name : {"a", "b", "c", "d", "e", "f"}) {
+    main_block->Var(name)->SetType(proto::VarType::LOD_TENSOR);
+  }
+  auto append_add = [main_block](
+                        const char* x, const char* y, const char* out) {
+    OpDesc* add = main_block->AppendOp();
+    add->SetType("elementwise_add");
+    add->SetInput("X", {x});
+    add->SetInput("Y", {y});
+    add->SetOutput("Out", {out});
+  };
+  append_add("a", "b", "c");
+  append_add("c", "b", "d");
+  append_add("d", "b", "e");
+  append_add("a", "a", "f");
+
+  phi::DDim dims = phi::make_ddim({2, 2});
+  const platform::CPUPlace place = platform::CPUPlace();
+  phi::DenseTensor tensor_a = phi::DenseTensor();
+  phi::DenseTensor tensor_b = phi::DenseTensor();
+  std::fill_n(tensor_a.mutable_data<float>(dims, place), 4, 1.0f);
+  std::fill_n(tensor_b.mutable_data<float>(dims, place), 4, 2.0f);
+
+  FLAGS_new_executor_use_critical_path_priority = true;
+  FLAGS_new_executor_use_work_stealing = true;
+  Scope scope;
+  auto core = CreateInterpreterCore(place, program, &scope, {"e", "f"});
+  // the critical path is built after the warmup steps, and the scheduling
+  // keeps the results and dispatches every instruction exactly once
+  for (int step = 0; step < 6; ++step) {
+    FetchList fetch_list = core->Run({"a", "b"}, {tensor_a, tensor_b});
+    ASSERT_EQ(fetch_list.size(), 2UL);
+    const phi::DenseTensor& e =
+        PADDLE_GET_CONST(phi::DenseTensor, fetch_list[0]);
+    const phi::DenseTensor& f =
+        PADDLE_GET_CONST(phi::DenseTensor, fetch_list[1]);
+    for (int64_t i = 0; i < e.numel(); ++i) {
+      ASSERT_FLOAT_EQ(e.data<float>()[i], 7.0f);
+      ASSERT_FLOAT_EQ(f.data<float>()[i], 2.0f);
+    }
+    if (step > 0) {
+      interpreter::SchedulingStats stats = core->GetSchedulingStats();
+      EXPECT_EQ(stats.local_hits + stats.steals + stats.queue_hops, 6UL);
+    }
+  }
+  FLAGS_new_executor_use_work_stealing = false;
+  FLAGS_new_executor_use_critical_path_priority = false;
+}
+
+TEST(InterpreterCore, plan_cache) {
+  ProgramDesc program;
+  BlockDesc* main_block = program.MutableBlock(0);
+  VarDesc* var_a = main_block->Var("a");
+  VarDesc* var_b = main_block->Var("b");
+  VarDesc* var_c = main_block->Var("c");
+  var_a->SetType(proto::VarType::LOD_TENSOR);
+  var_b->SetType(proto::VarType::LOD_TENSOR);
+  var_c->SetType(proto::VarType::LOD_TENSOR);
+
+  OpDesc* add = main_block->AppendOp();
+  add->SetType("elementwise_add");
+  add->SetInput("X", {"a"});
+  add->SetInput("Y", {"b"});
+  add->SetOutput("Out", {"c"});
+
+  float data_a[] = {0, 1, 2, 3};
+  float data_b[] = {0.0, 0.1, 0.2, 0.3};
+  std::vector<float> fetch_results = {0.0, 1.1, 2.2, 3.3};
+
+  phi::DDim dims = phi::make_ddim({2, 2});
+  const platform::CPUPlace place = platform::CPUPlace();
+
+  phi::DenseTensor tensor_a = phi::DenseTensor();
+  phi::DenseTensor tensor_b = phi::DenseTensor();
+
+  std::copy_n(data_a, 4, tensor_a.mutable_data<float>(dims, place));
+  std::copy_n(data_b, 4, tensor_b.mutable_data<float>(dims, place));
+
+  const std::string plan_path = "interpretercore_plan_cache_test.plan";
+  std::remove(plan_path.c_str());
+
+  auto run_and_check = [&](std::shared_ptr<InterpreterCore> core) {
+    for (int step = 0; step < 2; ++step) {
+      FetchList fetch_list = core->Run({"a", "b"}, {tensor_a, tensor_b});
+      ASSERT_EQ(fetch_list.size(), 1UL);
+      const phi::DenseTensor& fetch_tensor =
+          PADDLE_GET_CONST(phi::DenseTensor, fetch_list[0]);
+      for (int64_t i = 0; i < fetch_tensor.numel(); ++i) {
+        ASSERT_FLOAT_EQ(fetch_tensor.data<float>()[i], fetch_results.at(i));
+      }
+    }
+  };
+
+  // the first core builds the plan from scratch and saves it
+  Scope scope1;
+  auto core1 =
+      CreateInterpreterCore(place, program, &scope1, {"c"}, {}, plan_path);
+  run_and_check(core1);
+  ASSERT_FALSE(core1->PlanCacheHit());
+  ASSERT_TRUE(std::ifstream(plan_path).good());
+  // a plan is never used for another program
+  interpreter::InterpreterPlan plan;
+  ASSERT_FALSE(interpreter::LoadInterpreterPlan(
+      plan_path, /*program_hash=*/0, &plan));
+
+  // the second core reuses the saved plan
+  Scope scope2;
+  auto core2 =
+      CreateInterpreterCore(place, program, &scope2, {"c"}, {}, plan_path);
+  run_and_check(core2);
+  ASSERT_TRUE(core2->PlanCacheHit());
+
+  std::remove(plan_path.c_str());
+}
+
+TEST(InterpreterCore, plan_cache_corrupted) {
+  const std::string plan_path = "interpretercore_plan_cache_corrupted.plan";
+  interpreter::InterpreterPlan plan;
+  plan.program_hash = 1;
+  plan.instruction_keys = {"elementwise_add:cpu"};
+  plan.inplace_pairs.push_back({0, "a", "c"});
+
+  // overwrite the uint64 at offset with a huge size
+  auto corrupt = [&](std::streamoff offset) {
+    interpreter::SaveInterpreterPlan(plan, plan_path);
+    std::fstream fs(plan_path, std::ios::in | std::ios::out | std::ios::binary);
+    fs.seekp(offset);
+    uint64_t size = static_cast<uint64_t>(1) << 62;
+    fs.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  };
+
+  interpreter::InterpreterPlan loaded_plan;
+  interpreter::SaveInterpreterPlan(plan, plan_path);
+  ASSERT_TRUE(interpreter::LoadInterpreterPlan(plan_path, 1, &loaded_plan));
+  ASSERT_EQ(loaded_plan.instruction_keys, plan.instruction_keys);
+
+  // the header (magic, version and hash) takes 16 bytes, followed by the
+  // number of instruction keys and the size of the first key
+  corrupt(16);
+  ASSERT_FALSE(interpreter::LoadInterpreterPlan(plan_path, 1, &loaded_plan));
+  corrupt(24);
+  ASSERT_FALSE(interpreter::LoadInterpreterPlan(plan_path, 1, &loaded_plan));
+
+  std::remove(plan_path.c_str());
+}
+
 }  // namespace framework
 }  // namespace paddle
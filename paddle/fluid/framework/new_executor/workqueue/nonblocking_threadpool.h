@@ -17,6 +17,7 @@
 #include "paddle/fluid/framework/new_executor/workqueue/event_count.h"
 #include "paddle/fluid/framework/new_executor/workqueue/run_queue.h"
 #include "paddle/fluid/framework/new_executor/workqueue/thread_environment.h"
+#include "paddle/fluid/platform/numa_info.h"
 #include "paddle/fluid/platform/os_info.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 
@@ -33,6 +34,7 @@ class ThreadPoolTempl {
                   int num_threads,
                   bool allow_spinning,
                   bool always_spinning,
+                  int numa_node = -1,
                   Environment env = Environment())
       : env_(env),
         allow_spinning_(allow_spinning),
@@ -45,7 +47,8 @@ class ThreadPoolTempl {
         ec_(num_threads),
         num_threads_(num_threads),
         thread_data_(num_threads),
-        name_(name) {
+        name_(name),
+        numa_node_(numa_node) {
     // Calculate coprimes of all numbers [1, num_threads].
     // Coprimes are used for random walks over all threads in Steal
     // and NonEmptyQueueIndex. Iteration is based on the fact that if we take
@@ -162,6 +165,24 @@ class ThreadPoolTempl {
 
   size_t NumThreads() const { return num_threads_; }
 
+  // Number of worker threads blocked in WaitForWork, it is only a hint since
+  // the value may change as soon as it is returned.
+  size_t NumBlockedThreads() const {
+    return blocked_.load(std::memory_order_relaxed);
+  }
+
+  // Number of tasks waiting in the queues of the workers, it is only a hint
+  // as well.
+  size_t NumPendingTasks() const {
+    size_t num_pending = 0;
+    for (size_t i = 0; i < thread_data_.size(); ++i) {
+      num_pending += thread_data_[i].queue.Size();
+    }
+    return num_pending;
+  }
+
+  const std::string& Name() const { return name_; }
+
   int CurrentThreadId() const {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
     if (pt->pool == this) {
@@ -251,12 +272,16 @@ class ThreadPoolTempl {
   const int num_threads_;
   std::vector<ThreadData> thread_data_;
   std::string name_;
+  const int numa_node_;
 
   // Main worker thread loop.
   void WorkerLoop(int thread_id) {
     std::string thr_name = name_ + "_thread_" + std::to_string(thread_id);
     VLOG(1) << thr_name << " started ";
     platform::SetCurrentThreadName(thr_name);
+    if (numa_node_ >= 0) {
+      platform::BindCurrentThreadToNumaNode(numa_node_);
+    }
     PerThread* pt = GetPerThread();
     pt->pool = this;
     pt->rand = GlobalThreadIdHash();
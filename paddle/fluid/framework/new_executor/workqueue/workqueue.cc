@@ -6,9 +6,13 @@
 
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
 
+#include <map>
+#include <unordered_set>
+
 #include "paddle/fluid/framework/new_executor/workqueue/nonblocking_threadpool.h"
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 
 namespace paddle {
@@ -35,6 +39,52 @@ namespace {
 
 using TaskTracker = TaskTracker<EventsWaiter::EventNotifier>;
 
+// The live thread pools, exported as the paddle_workqueue_pending_tasks gauge
+struct LivePools {
+  std::mutex mutex;
+  std::unordered_set<const NonblockingThreadPool*> pools;
+};
+
+LivePools& GetLivePools() {
+  // Never destructed, since a static work queue may outlive it
+  static LivePools* live_pools = new LivePools();
+  return *live_pools;
+}
+
+void CollectPendingTasks(platform::MetricRegistry::GaugeSamples* samples) {
+  std::map<std::string, size_t> num_pending;
+  auto& live_pools = GetLivePools();
+  {
+    std::lock_guard<std::mutex> guard(live_pools.mutex);
+    for (auto* pool : live_pools.pools) {
+      num_pending[pool->Name()] += pool->NumPendingTasks();
+    }
+  }
+  for (const auto& kv : num_pending) {
+    samples->emplace_back(platform::PrometheusLabel("queue", kv.first),
+                          static_cast<double>(kv.second));
+  }
+}
+
+void RegisterLivePool(const NonblockingThreadPool* pool) {
+  static std::once_flag register_gauge;
+  std::call_once(register_gauge, [] {
+    platform::MetricRegistry::Instance().RegisterGauge(
+        "paddle_workqueue_pending_tasks",
+        "The number of tasks waiting in the work queues of each name.",
+        CollectPendingTasks);
+  });
+  auto& live_pools = GetLivePools();
+  std::lock_guard<std::mutex> guard(live_pools.mutex);
+  live_pools.pools.insert(pool);
+}
+
+void UnregisterLivePool(const NonblockingThreadPool* pool) {
+  auto& live_pools = GetLivePools();
+  std::lock_guard<std::mutex> guard(live_pools.mutex);
+  live_pools.pools.erase(pool);
+}
+
 class WorkQueueImpl : public WorkQueue {
  public:
   explicit WorkQueueImpl(const WorkQueueOptions& options) : WorkQueue(options) {
@@ -50,10 +100,13 @@ class WorkQueueImpl : public WorkQueue {
     queue_ = new NonblockingThreadPool(options_.name,
                                        options_.num_threads,
                                        options_.allow_spinning,
-                                       options_.always_spinning);
+                                       options_.always_spinning,
+                                       options_.numa_node);
+    RegisterLivePool(queue_);
   }
 
   virtual ~WorkQueueImpl() {
+    UnregisterLivePool(queue_);
     delete queue_;
     if (tracker_ != nullptr) {
       tracker_->~TaskTracker();
@@ -82,6 +135,10 @@ class WorkQueueImpl : public WorkQueue {
 
   size_t NumThreads() const override { return queue_->NumThreads(); }
 
+  size_t NumIdleThreads() const override {
+    return queue_->NumBlockedThreads();
+  }
+
  private:
   NonblockingThreadPool* queue_{nullptr};
   TaskTracker* tracker_{nullptr};
@@ -102,6 +159,8 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
 
   size_t QueueGroupNumThreads() const override;
 
+  size_t QueueNumIdleThreads(size_t queue_idx) const override;
+
   void Cancel() override;
 
  private:
@@ -143,13 +202,16 @@ WorkQueueGroupImpl::WorkQueueGroupImpl(
         NonblockingThreadPool(options.name,
                               options.num_threads,
                               options.allow_spinning,
-                              options.always_spinning);
+                              options.always_spinning,
+                              options.numa_node);
+    RegisterLivePool(queues_[idx]);
   }
 }
 
 WorkQueueGroupImpl::~WorkQueueGroupImpl() {
   for (auto queue : queues_) {
     if (queue) {
+      UnregisterLivePool(queue);
       queue->~NonblockingThreadPool();
     }
   }
@@ -195,6 +257,14 @@ size_t WorkQueueGroupImpl::QueueGroupNumThreads() const {
   return total_num;
 }
 
+size_t WorkQueueGroupImpl::QueueNumIdleThreads(size_t queue_idx) const {
+  assert(queue_idx < queues_.size());
+  if (!queues_.at(queue_idx)) {
+    return 0;
+  }
+  return queues_.at(queue_idx)->NumBlockedThreads();
+}
+
 void WorkQueueGroupImpl::Cancel() {
   for (auto queue : queues_) {
     if (queue) {
@@ -102,6 +102,8 @@ struct WorkQueueOptions {
   // false and set events_waiter.
   bool detached{true};
   EventsWaiter* events_waiter{nullptr};  // not owned
+  // Worker threads will be bound to the NUMA node if it is not negative.
+  int numa_node{-1};
 };
 
 class WorkQueue {
@@ -136,6 +138,9 @@ class WorkQueue {
 
   virtual size_t NumThreads() const = 0;
 
+  // Hint of the number of idle worker threads
+  virtual size_t NumIdleThreads() const = 0;
+
   virtual void Cancel() = 0;
 
  protected:
@@ -178,6 +183,9 @@ class WorkQueueGroup {
 
   virtual size_t QueueGroupNumThreads() const = 0;
 
+  // Hint of the number of idle worker threads in the queue_idx-th queue
+  virtual size_t QueueNumIdleThreads(size_t queue_idx) const = 0;
+
   virtual void Cancel() = 0;
 
  protected:
@@ -107,6 +107,7 @@ TEST(WorkQueue, TestMultiThreadedWorkQueue) {
   auto work_queue = CreateMultiThreadedWorkQueue(options);
   // NumThreads
   EXPECT_EQ(work_queue->NumThreads(), 10u);
+  EXPECT_LE(work_queue->NumIdleThreads(), 10u);
   // AddTask
   EXPECT_EQ(finished.load(), false);
   EXPECT_EQ(counter.load(), 0u);
@@ -172,6 +173,9 @@ TEST(WorkQueue, TestWorkQueueGroup) {
   EXPECT_EQ(queue_group->QueueNumThreads(0), 1u);
   EXPECT_EQ(queue_group->QueueNumThreads(1), 10u);
   EXPECT_EQ(queue_group->QueueGroupNumThreads(), 11u);
+  // NumIdleThreads
+  EXPECT_LE(queue_group->QueueNumIdleThreads(0), 1u);
+  EXPECT_LE(queue_group->QueueNumIdleThreads(1), 10u);
   // AddTask
   EXPECT_EQ(counter.load(), 0u);
   for (unsigned i = 0; i < kExternalLoopNum; ++i) {
@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/tensor_util.h"
 
 #include <algorithm>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <string>
@@ -657,9 +658,56 @@ void TensorCopySync(const phi::DenseTensor& src,
 #endif
 }
 
+namespace {
+
+// The protobuf field that pads a TensorDesc to align the data after it. A
+// length delimited field unknown to TensorDesc, so readers skip it.
+constexpr uint32_t kTensorDescPaddingField = 1000;
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+// Append the padding field to the serialized desc, so that the data written
+// after the desc starts at a multiple of alignment. data_pos is the stream
+// position of the data if the desc was not padded.
+void PadTensorDesc(size_t data_pos, size_t alignment, std::string* desc) {
+  std::string tag;
+  AppendVarint((kTensorDescPaddingField << 3) | 2, &tag);
+  // The tag and a one byte length
+  size_t min_size = tag.size() + 1;
+  size_t padding =
+      (alignment - (data_pos + min_size) % alignment) % alignment;
+  desc->append(tag);
+  AppendVarint(padding, desc);
+  desc->append(padding, '\0');
+}
+
+// A view of [offset, offset + size) of a mapped file, keeping it mapped.
+class MappedTensorAllocation : public phi::Allocation {
+ public:
+  MappedTensorAllocation(const std::shared_ptr<phi::Allocation>& file,
+                         size_t offset,
+                         size_t size)
+      : phi::Allocation(static_cast<char*>(file->ptr()) + offset,
+                        size,
+                        platform::CPUPlace()),
+        file_(file) {}
+
+ private:
+  std::shared_ptr<phi::Allocation> file_;
+};
+
+}  // namespace
+
 void TensorToStream(std::ostream& os,
                     const phi::DenseTensor& tensor,
-                    const platform::DeviceContext& dev_ctx) {
+                    const platform::DeviceContext& dev_ctx,
+                    size_t data_alignment) {
   {  // the 1st field, uint32_t version
     constexpr uint32_t version = 0;
     os.write(reinterpret_cast<const char*>(&version), sizeof(version));
@@ -673,9 +721,24 @@ void TensorToStream(std::ostream& os,
     auto* pb_dims = desc.mutable_dims();
     pb_dims->Resize(static_cast<int>(dims.size()), 0);
     std::copy(dims.begin(), dims.end(), pb_dims->begin());
-    int32_t size = desc.ByteSize();
-    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
     auto out = desc.SerializeAsString();
+    if (data_alignment > 1) {
+      PADDLE_ENFORCE_LE(data_alignment,
+                        128UL,
+                        platform::errors::InvalidArgument(
+                            "The data alignment of a tensor should be at "
+                            "most 128, but received %d.",
+                            data_alignment));
+      auto pos = os.tellp();
+      if (pos >= 0) {
+        PadTensorDesc(
+            static_cast<size_t>(pos) + sizeof(int32_t) + out.size(),
+            data_alignment,
+            &out);
+      }
+    }
+    int32_t size = out.size();
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
     os.write(out.data(), size);
   }
   {  // the 3rd field, tensor data
@@ -998,6 +1061,84 @@ void TensorFromStream(std::istream& is,
   }
 }
 
+void TensorFromMappedFile(const std::shared_ptr<phi::Allocation>& file,
+                          size_t* offset,
+                          phi::DenseTensor* tensor,
+                          const platform::DeviceContext& dev_ctx) {
+  const char* base = static_cast<const char*>(file->ptr());
+  auto check_remaining = [&](size_t size) {
+    PADDLE_ENFORCE_LE(
+        size,
+        file->size() - std::min(*offset, file->size()),
+        platform::errors::InvalidArgument(
+            "The mapped file ends at %d bytes, which cannot hold the %d "
+            "bytes of tensor at offset %d. Please check whether the model "
+            "file is complete or damaged.",
+            file->size(),
+            size,
+            *offset));
+  };
+
+  uint32_t version;
+  check_remaining(sizeof(version));
+  std::memcpy(&version, base + *offset, sizeof(version));
+  *offset += sizeof(version);
+  PADDLE_ENFORCE_EQ(
+      version,
+      0U,
+      platform::errors::InvalidArgument(
+          "tensor version %u is not supported, Only version 0 is supported",
+          version));
+  proto::VarType::TensorDesc desc;
+  {  // int32_t size
+     // proto buffer
+    int32_t size = -1;
+    check_remaining(sizeof(size));
+    std::memcpy(&size, base + *offset, sizeof(size));
+    *offset += sizeof(size);
+    PADDLE_ENFORCE_GE(size,
+                      0,
+                      platform::errors::InvalidArgument(
+                          "phi::DenseTensor desc size should >= 0"));
+    check_remaining(size);
+    PADDLE_ENFORCE_EQ(
+        desc.ParseFromArray(base + *offset, size),
+        true,
+        platform::errors::InvalidArgument("Cannot parse tensor desc"));
+    *offset += size;
+  }
+  {  // map tensor
+    std::vector<int64_t> dims;
+    dims.reserve(static_cast<size_t>(desc.dims().size()));
+    std::copy(desc.dims().begin(), desc.dims().end(), std::back_inserter(dims));
+    auto dtype = framework::TransToPhiDataType(desc.data_type());
+    size_t element_size = phi::SizeOf(dtype);
+    size_t size = phi::product(phi::make_ddim(dims)) * element_size;
+    check_remaining(size);
+    const char* data = base + *offset;
+    bool aligned = element_size > 0 &&
+                   reinterpret_cast<uintptr_t>(data) % element_size == 0;
+
+    phi::DenseTensor cpu_tensor;
+    auto* dst = platform::is_cpu_place(dev_ctx.GetPlace()) ? tensor
+                                                            : &cpu_tensor;
+    dst->clear();
+    dst->Resize(phi::make_ddim(dims));
+    if (aligned) {
+      dst->ResetHolderWithType(
+          std::make_shared<MappedTensorAllocation>(file, *offset, size),
+          dtype);
+    } else {
+      std::memcpy(dst->mutable_data(platform::CPUPlace(), dtype), data, size);
+    }
+    if (dst != tensor) {
+      framework::TensorCopy(cpu_tensor, dev_ctx.GetPlace(), dev_ctx, tensor);
+      dev_ctx.Wait();
+    }
+    *offset += size;
+  }
+}
+
 // get tensor data point by DLDataType
 void* GetDstPtrByDLDataType(DLDataType type,
                             phi::DenseTensor* dst,
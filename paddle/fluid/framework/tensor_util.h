@@ -16,6 +16,7 @@ limitations under the License. */
 #include <algorithm>
 #include <codecvt>
 #include <locale>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -59,9 +60,13 @@ class PrintOptions {
   PrintOptions() {}
 };
 
+// If data_alignment is not 0, the tensor desc is padded so that the data
+// starts at a multiple of data_alignment (at most 128) from the beginning of
+// os. TensorFromMappedFile can then use the data in place.
 void TensorToStream(std::ostream& os,
                     const phi::DenseTensor& tensor,
-                    const platform::DeviceContext& dev_ctx);
+                    const platform::DeviceContext& dev_ctx,
+                    size_t data_alignment = 0);
 void TensorFromStream(std::istream& is,
                       phi::DenseTensor* tensor,
                       const platform::DeviceContext& dev_ctx);
@@ -71,6 +76,14 @@ void TensorFromStream(std::istream& is,
                       const size_t& seek,
                       const std::vector<int64_t>& shape);
 
+// Read the tensor written by TensorToStream at *offset of a memory mapped
+// file, and move *offset past it. On CPU, a tensor whose data is aligned to
+// its element size holds a view of the mapping instead of a copy.
+void TensorFromMappedFile(const std::shared_ptr<phi::Allocation>& file,
+                          size_t* offset,
+                          phi::DenseTensor* tensor,
+                          const platform::DeviceContext& dev_ctx);
+
 // NOTE(zcd): Because TensorCopy is an async operation, when the src_place
 // and dst_place are two different GPU, to ensure that the operation can
 // be carried out correctly, there is a src_ctx wait operation in TensorCopy.
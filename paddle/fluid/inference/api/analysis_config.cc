@@ -380,6 +380,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(mixed_black_list_);
 
   CP_MEMBER(enable_memory_optim_);
+  CP_MEMBER(enable_memory_arena_);
   // TensorRT related.
   CP_MEMBER(use_tensorrt_);
   CP_MEMBER(tensorrt_workspace_size_);
@@ -464,6 +465,10 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(specify_input_name_);
 
   CP_MEMBER(cpu_math_library_num_threads_);
+  CP_MEMBER(use_numa_binding_);
+  CP_MEMBER(numa_node_);
+  CP_MEMBER(use_gemm_weight_packing_);
+  CP_MEMBER(use_optimized_model_cache_);
 
   CP_MEMBER(serialized_info_cache_);
 
@@ -1007,6 +1012,7 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << trt_dla_core_;
 
   ss << enable_memory_optim_;
+  ss << enable_memory_arena_;
   ss << trt_engine_memory_sharing_;
 
   ss << use_mkldnn_;
@@ -1033,6 +1039,10 @@ std::string AnalysisConfig::SerializeInfoCache() {
 
   ss << specify_input_name_;
   ss << cpu_math_library_num_threads_;
+  ss << use_numa_binding_;
+  ss << numa_node_;
+  ss << use_gemm_weight_packing_;
+  ss << use_optimized_model_cache_;
 
   ss << use_lite_;
   ss << use_xpu_;
@@ -1075,6 +1085,31 @@ void AnalysisConfig::SetCpuMathLibraryNumThreads(
   Update();
 }
 
+void AnalysisConfig::EnableNumaBinding(int numa_node) {
+  PADDLE_ENFORCE_GE(numa_node,
+                    -1,
+                    platform::errors::InvalidArgument(
+                        "The NUMA node should be -1 (round-robin) or a valid "
+                        "node id, but got %d.",
+                        numa_node));
+  use_numa_binding_ = true;
+  numa_node_ = numa_node;
+
+  Update();
+}
+
+void AnalysisConfig::EnableGemmWeightPacking() {
+  use_gemm_weight_packing_ = true;
+
+  Update();
+}
+
+void AnalysisConfig::EnableOptimizedModelCache() {
+  use_optimized_model_cache_ = true;
+
+  Update();
+}
+
 float AnalysisConfig::fraction_of_gpu_memory_for_pool() const {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // Get the GPU memory details and calculate the fraction of memory for the
@@ -1104,6 +1139,8 @@ bool AnalysisConfig::enable_memory_optim() const {
   return enable_memory_optim_;
 }
 
+void AnalysisConfig::EnableMemoryArena(bool x) { enable_memory_arena_ = x; }
+
 bool AnalysisConfig::trt_engine_memory_sharing() const {
   return trt_engine_memory_sharing_;
 }
@@ -1186,6 +1223,13 @@ std::string AnalysisConfig::Summary() {
   // cpu info
   os.InsertRow(
       {"cpu_math_thread", std::to_string(cpu_math_library_num_threads_)});
+  if (use_numa_binding_) {
+    os.InsertRow({"numa_node", std::to_string(numa_node_)});
+  }
+  os.InsertRow({"gemm_weight_packing",
+                use_gemm_weight_packing_ ? "true" : "false"});
+  os.InsertRow({"optimized_model_cache",
+                use_optimized_model_cache_ ? "true" : "false"});
   os.InsertRow({"enable_mkldnn", use_mkldnn_ ? "true" : "false"});
   os.InsertRow(
       {"mkldnn_cache_capacity", std::to_string(mkldnn_cache_capacity_)});
@@ -1286,6 +1330,7 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow({"ir_optim", enable_ir_optim_ ? "true" : "false"});
   os.InsertRow({"ir_debug", ir_debug_ ? "true" : "false"});
   os.InsertRow({"memory_optim", enable_memory_optim_ ? "true" : "false"});
+  os.InsertRow({"memory_arena", enable_memory_arena_ ? "true" : "false"});
   os.InsertRow({"enable_profile", with_profile_ ? "true" : "false"});
   os.InsertRow({"enable_log", with_glog_info_ ? "true" : "false"});
   os.InsertRow({"collect_shape_range_info",
@@ -17,10 +17,16 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <random>
 #include <set>
+#include <sstream>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -53,13 +59,17 @@
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/numa_info.h"
 #include "paddle/fluid/platform/place.h"
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/phi/api/ext/op_meta_info.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/autotune/cache.h"
+#include "paddle/phi/kernels/funcs/packed_gemm.h"
 #include "paddle/utils/string/split.h"
 
 #if defined(PADDLE_WITH_DISTRIBUTE) && defined(PADDLE_WITH_PSCORE)
@@ -90,6 +100,9 @@
 #include "paddle/fluid/platform/device/ipu/paddle_ipu_handler.h"
 #endif
 
+DECLARE_string(autotune_cache_file);
+DECLARE_bool(enable_latency_histogram);
+
 namespace paddle {
 
 using inference::Singleton;
@@ -264,6 +277,19 @@ bool AnalysisPredictor::Init(
 
   // no matter with or without MKLDNN
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  phi::CPUContext::SetIntraOpNumThreads(
+      config_.cpu_math_library_num_threads());
+
+  // The cloned predictors have been assigned a node in Clone().
+  if (config_.numa_binding_enabled() && numa_node_ < 0) {
+    numa_node_ = config_.numa_node() >= 0 ? config_.numa_node()
+                                          : platform::GetNextNumaNode();
+    VLOG(3) << "Bind predictor to NUMA node " << numa_node_;
+  }
+  // Load the parameters on the node, and bind the threads of cpu math library.
+  platform::NumaBindingGuard numa_guard(numa_node_);
+  paddle::platform::MathLibraryNumaBindingGuard math_numa_guard(
+      config_.cpu_math_library_num_threads(), numa_node_);
 
   if (!PrepareScope(parent_scope)) {
     return false;
@@ -286,6 +312,20 @@ bool AnalysisPredictor::Init(
     return true;
   }
 
+  if (config_.gemm_weight_packing_enabled() && platform::is_cpu_place(place_)) {
+    RegisterPackedWeights();
+  }
+
+  // Start with the kernels tuned by another process, such as the CPU
+  // kernels tuned on the same machine before.
+  if (!FLAGS_autotune_cache_file.empty()) {
+    static std::once_flag load_autotune_cache;
+    std::call_once(load_autotune_cache, [] {
+      phi::autotune::AutoTuneCache::Instance().Load(
+          FLAGS_autotune_cache_file);
+    });
+  }
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // TODO(inference): Now only gpu with external stream support private
   // device_context.
@@ -524,21 +564,33 @@ bool AnalysisPredictor::PrepareProgram(
     const std::shared_ptr<framework::ProgramDesc> &program) {
   if (!program) {
     if (!LoadProgramDesc()) return false;
-    // If not cloned, the parameters should be loaded.
-    // If config_.ir_optim() is True, parameters is loaded in
-    // OptimizeInferenceProgram(), but other persistable variables
-    // (like RAW type var) are not created in scope.
-    // If config_.ir_optim() is False, parameters is loaded in LoadParameters(),
-    // still need to create other persistable variables.
-    // So in both case, create persistable variables at first.
-    executor_->CreateVariables(*inference_program_, 0, true, sub_scope_);
-
-    // if enable_ir_optim_ is false,
-    // the analysis pass(op fuse, graph analysis, trt subgraph, mkldnn etc) will
-    // not be executed.
     model_precision_ =
         paddle::inference::GetModelPrecision(*inference_program_);
-    OptimizeInferenceProgram();
+
+    // The cache key depends on the original program, so get it before the
+    // program is optimized or replaced by the cached one.
+    std::string cache_dir = GetOptimizedModelCacheDir();
+    optimized_model_cache_dir_ = cache_dir;
+    optimized_model_cache_hit_ =
+        !cache_dir.empty() && LoadOptimizedModelCache(cache_dir);
+    if (!optimized_model_cache_hit_) {
+      // If not cloned, the parameters should be loaded.
+      // If config_.ir_optim() is True, parameters is loaded in
+      // OptimizeInferenceProgram(), but other persistable variables
+      // (like RAW type var) are not created in scope.
+      // If config_.ir_optim() is False, parameters is loaded in
+      // LoadParameters(), still need to create other persistable variables.
+      // So in both case, create persistable variables at first.
+      executor_->CreateVariables(*inference_program_, 0, true, sub_scope_);
+
+      // if enable_ir_optim_ is false,
+      // the analysis pass(op fuse, graph analysis, trt subgraph, mkldnn etc)
+      // will not be executed.
+      OptimizeInferenceProgram();
+      if (!cache_dir.empty()) {
+        SaveOptimizedModelCache(cache_dir);
+      }
+    }
   } else {
     // If the program is passed from external, no need to optimize it, this
     // logic is used in the clone scenario.
@@ -615,9 +667,53 @@ bool AnalysisPredictor::PrepareExecutor() {
                           platform::errors::PreconditionNotMet(
                               "The sub_scope should not be nullptr."));
 
+  if (UseMemoryArena()) {
+    std::unordered_set<std::string> fetch_names;
+    for (auto &fetch : idx2fetches_) {
+      fetch_names.insert(fetch.second);
+    }
+    executor_->EnableMemoryArena(fetch_names);
+  }
+
   return true;
 }
 
+void AnalysisPredictor::RegisterPackedWeights() {
+  // the input of the weight for every op
+  const std::map<std::string, std::string> weight_inputs = {
+      {"fc", "W"}, {"mul", "Y"}, {"matmul_v2", "Y"}};
+  std::set<const void *> weights;
+  for (size_t i = 0; i < inference_program_->Size(); ++i) {
+    auto &block = inference_program_->Block(i);
+    for (auto *op : block.AllOps()) {
+      auto it = weight_inputs.find(op->Type());
+      if (it == weight_inputs.end() || op->Input(it->second).size() != 1) {
+        continue;
+      }
+      const std::string &name = op->Input(it->second)[0];
+      auto *var_desc = block.FindVarRecursive(name);
+      if (var_desc == nullptr || !var_desc->Persistable()) {
+        continue;
+      }
+      auto *var = sub_scope_->FindVar(name);
+      if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+        continue;
+      }
+      auto &tensor = var->Get<phi::DenseTensor>();
+      if (!tensor.IsInitialized() || !platform::is_cpu_place(tensor.place())) {
+        continue;
+      }
+      weights.insert(tensor.data());
+    }
+  }
+  for (auto *weight : weights) {
+    phi::funcs::PackedWeightCache::Instance().Register(weight);
+    packed_weights_.push_back(weight);
+  }
+  VLOG(3) << "Register " << packed_weights_.size()
+          << " weights to be packed for GEMM.";
+}
+
 #if defined(PADDLE_WITH_DISTRIBUTE) && defined(PADDLE_WITH_PSCORE)
 bool AnalysisPredictor::PrepareFleetExecutor() {
   VLOG(3) << "AnalysisPredictor::PrepareFleetExecutor()";
@@ -912,7 +1008,14 @@ void AnalysisPredictor::MkldnnPostReset() {
 bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
                             std::vector<PaddleTensor> *output_data,
                             int batch_size) {
+  platform::RecordEvent run_event(
+      "AnalysisPredictor::Run", platform::TracerEventType::UserDefined, 1);
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  phi::CPUContext::SetIntraOpNumThreads(
+      config_.cpu_math_library_num_threads());
+  platform::NumaBindingGuard numa_guard(numa_node_);
+  paddle::platform::MathLibraryNumaBindingGuard math_numa_guard(
+      config_.cpu_math_library_num_threads(), numa_node_);
 #ifdef PADDLE_WITH_MKLDNN
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
 #endif
@@ -963,6 +1066,7 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
   // recover the cpu_math_library_num_threads to 1, in order to avoid thread
   // conflict when integrating it into deployment service.
   paddle::platform::SetNumThreads(1);
+  phi::CPUContext::SetIntraOpNumThreads(1);
 #ifdef PADDLE_WITH_MKLDNN
   if (config_.use_mkldnn_) MkldnnPostReset();
 #endif
@@ -1072,7 +1176,8 @@ void AnalysisPredictor::PrepareArgument() {
   argument_.SetUseFcPadding(config_.use_fc_padding());
   argument_.SetGPUDeviceId(config_.gpu_device_id());
   argument_.SetEnableAnalysisOptim(config_.enable_ir_optim_);
-  argument_.SetEnableMemoryOptim(config_.enable_memory_optim());
+  argument_.SetEnableMemoryOptim(config_.enable_memory_optim() &&
+                                 !UseMemoryArena());
   argument_.SetModelFromMemory(config_.model_from_memory_);
   // Analyze inference_program
   argument_.SetPredictorID(predictor_id_);
@@ -1662,6 +1767,22 @@ std::unique_ptr<ZeroCopyTensor> AnalysisPredictor::GetOutputTensor(
 }
 
 bool AnalysisPredictor::ZeroCopyRun() {
+  // Also the default FLAGS_flight_recorder_slo_event
+  platform::RecordEvent run_event("AnalysisPredictor::ZeroCopyRun",
+                                  platform::TracerEventType::UserDefined,
+                                  1);
+  if (FLAGS_enable_latency_histogram && run_latency_ == nullptr) {
+    std::string model = config_.model_dir();
+    if (model.empty()) model = config_.prog_file();
+    // The program itself is in prog_file then
+    if (config_.model_from_memory()) model = "memory";
+    run_latency_ = platform::MetricRegistry::Instance().GetHistogram(
+        "paddle_predictor_run_latency_seconds",
+        "The latency of AnalysisPredictor::ZeroCopyRun.",
+        platform::PrometheusLabel("model", model));
+  }
+  platform::ScopedLatencyRecorder run_latency(
+      FLAGS_enable_latency_histogram ? run_latency_ : nullptr);
   inference::DisplayMemoryInfo(place_, "before run");
 #if defined(PADDLE_WITH_DISTRIBUTE) && defined(PADDLE_WITH_PSCORE)
   if (config_.dist_config().use_dist_model()) {
@@ -1678,6 +1799,11 @@ bool AnalysisPredictor::ZeroCopyRun() {
     paddle::platform::DeviceContextPool::SetDeviceContexts(&device_contexts_);
   }
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  phi::CPUContext::SetIntraOpNumThreads(
+      config_.cpu_math_library_num_threads());
+  platform::NumaBindingGuard numa_guard(numa_node_);
+  paddle::platform::MathLibraryNumaBindingGuard math_numa_guard(
+      config_.cpu_math_library_num_threads(), numa_node_);
 #ifdef PADDLE_WITH_MKLDNN
   if (config_.use_mkldnn_) {
     std::vector<std::vector<int>> shape_vector;
@@ -1713,6 +1839,7 @@ bool AnalysisPredictor::ZeroCopyRun() {
   // recover the cpu_math_library_num_threads to 1, in order to avoid thread
   // conflict when integrating it into deployment service.
   paddle::platform::SetNumThreads(1);
+  phi::CPUContext::SetIntraOpNumThreads(1);
   if (private_context_) {
     paddle::platform::DeviceContextPool::SetDeviceContexts(nullptr);
   }
@@ -1985,8 +2112,167 @@ bool AnalysisPredictor::LoadParameters() {
   return true;
 }
 
+bool AnalysisPredictor::UseMemoryArena() const {
+  return config_.memory_arena_enabled() && platform::is_cpu_place(place_) &&
+         !config_.mkldnn_enabled() && !config_.dist_config().use_dist_model();
+}
+
+std::string AnalysisPredictor::GetOptimizedModelCacheDir() {
+  if (!config_.optimized_model_cache_enabled()) {
+    return "";
+  }
+  // The passes of the subgraph engines build engines that live out of the
+  // program, and the parameters synchronized to the devices are not saved.
+  if (!config_.ir_optim() || !platform::is_cpu_place(place_) ||
+      config_.tensorrt_engine_enabled() || config_.lite_engine_enabled() ||
+      config_.dlnne_enabled() || config_.mkldnn_quantizer_enabled() ||
+      config_.dist_config().use_dist_model()) {
+    LOG(WARNING) << "The optimized model cache only works on CPU with "
+                    "ir_optim and without subgraph engines, it is disabled.";
+    return "";
+  }
+  std::string cache_root = config_.opt_cache_dir_;
+  if (cache_root.empty() && config_.model_from_memory()) {
+    LOG(WARNING) << "The optimized model cache of a model loaded from "
+                    "memory needs SetOptimCacheDir, it is disabled.";
+    return "";
+  }
+
+  // The key changes with the paddle version, the model and the config. The
+  // parameter files are identified by their sizes and modification times,
+  // the ones loaded from memory are part of the serialized config.
+  std::stringstream ss;
+  ss << paddle::get_version();
+  ss << inference_program_->Proto()->SerializeAsString();
+  ss << config_.SerializeInfoCache();
+  for (auto &pass : config_.pass_builder()->AllPasses()) {
+    ss << pass << ";";
+  }
+  if (!config_.model_from_memory()) {
+    std::vector<std::string> param_files;
+    if (!config_.params_file().empty()) {
+      param_files.push_back(config_.params_file());
+    } else {
+      for (auto *var : inference_program_->Block(0).AllVars()) {
+        if (IsPersistable(var)) {
+          param_files.push_back(config_.model_dir() + "/" + var->Name());
+        }
+      }
+    }
+    for (auto &file : param_files) {
+      struct stat file_stat;
+      if (stat(file.c_str(), &file_stat) == 0) {
+        ss << file << ":" << file_stat.st_size << ":" << file_stat.st_mtime
+           << ";";
+      }
+    }
+  }
+  // A cache that cannot be created is skipped, the model is optimized as
+  // usual.
+  try {
+    if (cache_root.empty()) {
+      cache_root = analysis::GetOrCreateModelOptCacheDir(
+          config_.model_dir().empty()
+              ? analysis::GetDirRoot(config_.prog_file())
+              : config_.model_dir());
+    } else {
+      analysis::MakeDirIfNotExists(cache_root);
+    }
+    std::string cache_dir =
+        cache_root + "/optimized_model_" +
+        std::to_string(std::hash<std::string>()(ss.str()));
+    analysis::MakeDirIfNotExists(cache_dir);
+    return cache_dir;
+  } catch (const std::exception &ex) {
+    LOG(WARNING) << "Failed to create the optimized model cache in "
+                 << cache_root << ", it is disabled. " << ex.what();
+    return "";
+  }
+}
+
+bool AnalysisPredictor::LoadOptimizedModelCache(const std::string &cache_dir) {
+  // The model file is renamed into place after the params file, so the
+  // params are complete once the model exists.
+  std::string model_file = cache_dir + "/model";
+  std::string params_file = cache_dir + "/params";
+  if (!analysis::FileExists(model_file) ||
+      !analysis::FileExists(params_file)) {
+    VLOG(3) << "The optimized model cache " << cache_dir << " is missed.";
+    return false;
+  }
+
+  auto origin_program = inference_program_;
+  try {
+    inference_program_.reset(
+        new framework::ProgramDesc(analysis::LoadProgramDesc(model_file)));
+    executor_->CreateVariables(*inference_program_, 0, true, sub_scope_);
+
+    framework::ProgramDesc load_program;
+    auto *load_block = load_program.MutableBlock(0);
+    std::vector<std::string> params;
+    for (auto *var : inference_program_->Block(0).AllVars()) {
+      if (IsPersistable(var)) {
+        auto *new_var = load_block->Var(var->Name());
+        new_var->SetShape(var->GetShape());
+        new_var->SetDataType(var->GetDataType());
+        new_var->SetType(var->GetType());
+        new_var->SetLoDLevel(var->GetLoDLevel());
+        new_var->SetPersistable(true);
+        params.push_back(new_var->Name());
+      }
+    }
+    // Keep the same order as SaveOptimModel.
+    std::sort(params.begin(), params.end());
+    auto *op = load_block->AppendOp();
+    op->SetType("load_combine");
+    op->SetOutput("Out", params);
+    op->SetAttr("file_path", {params_file});
+    op->CheckAttrs();
+
+    framework::NaiveExecutor e(place_);
+    e.Prepare(scope_.get(), load_program, 0, false);
+    e.Run();
+  } catch (const std::exception &ex) {
+    LOG(WARNING) << "Failed to load the optimized model cache " << cache_dir
+                 << ", the model will be optimized again. " << ex.what();
+    inference_program_ = origin_program;
+    return false;
+  }
+
+  config_.PartiallyRelease();
+  LOG(INFO) << "Load the optimized model from " << cache_dir
+            << ", the IR passes are skipped.";
+  return true;
+}
+
+void AnalysisPredictor::SaveOptimizedModelCache(const std::string &cache_dir) {
+  // Write to temporary files and rename them, so that the predictors
+  // started at the same time never see a partially written cache.
+  std::string suffix = ".tmp" + std::to_string(std::random_device()());
+  std::string model_file = cache_dir + "/model";
+  std::string params_file = cache_dir + "/params";
+  bool saved = true;
+  try {
+    SaveOptimModel(model_file + suffix, params_file + suffix);
+  } catch (const std::exception &ex) {
+    LOG(WARNING) << ex.what();
+    saved = false;
+  }
+  if (!saved ||
+      std::rename((params_file + suffix).c_str(), params_file.c_str()) != 0 ||
+      std::rename((model_file + suffix).c_str(), model_file.c_str()) != 0) {
+    LOG(WARNING) << "Failed to save the optimized model cache " << cache_dir;
+    std::remove((params_file + suffix).c_str());
+    std::remove((model_file + suffix).c_str());
+    return;
+  }
+  LOG(INFO) << "Save the optimized model to " << cache_dir;
+}
+
 uint64_t AnalysisPredictor::TryShrinkMemory() {
   ClearIntermediateTensor();
+  // The tensors are cleared, but the planned arena is still allocated
+  executor_->ReleaseMemoryArena();
   return paddle::memory::Release(place_);
 }
 
@@ -2076,6 +2362,9 @@ AnalysisPredictor::~AnalysisPredictor() {
     platform::DisableProfiler(platform::EventSortingKey::kTotal,
                               "./profile.log");
   }
+  for (auto *weight : packed_weights_) {
+    phi::funcs::PackedWeightCache::Instance().Unregister(weight);
+  }
   if (sub_scope_) {
     if (framework::global_transfer_scope_key().find(sub_scope_) !=
         framework::global_transfer_scope_key().end()) {
@@ -2131,6 +2420,14 @@ std::unique_ptr<PaddlePredictor> AnalysisPredictor::Clone(void *stream) {
         "function has received a stream parameter."));
   }
   x->predictor_stream_ = stream;
+  if (numa_node_ >= 0) {
+    // the clones of a pinned predictor stay on its node, otherwise they are
+    // spread across the NUMA nodes
+    x->numa_node_ =
+        config_.numa_node() >= 0
+            ? numa_node_
+            : (numa_node_ + ++num_numa_clones_) % platform::GetNumaNodeCount();
+  }
   x->Init(scope_, inference_program_);
   x->executor_->ResetTrtOps(++AnalysisPredictor::clone_num_);
   return std::unique_ptr<PaddlePredictor>(x);
@@ -2142,12 +2439,18 @@ std::string AnalysisPredictor::GetSerializedProgram() const {
 
 // Add SaveOptimModel
 void AnalysisPredictor::SaveOptimModel(const std::string &dir) {
+  SaveOptimModel(dir + "/model", dir + "/params");
+}
+
+void AnalysisPredictor::SaveOptimModel(const std::string &model_file,
+                                       const std::string &params_file) {
   // save model
-  std::string model_name = dir + "/model";
-  std::ofstream outfile;
-  outfile.open(model_name, std::ios::out | std::ios::binary);
-  std::string inference_prog_desc = GetSerializedProgram();
-  outfile << inference_prog_desc;
+  {
+    std::ofstream outfile;
+    outfile.open(model_file, std::ios::out | std::ios::binary);
+    std::string inference_prog_desc = GetSerializedProgram();
+    outfile << inference_prog_desc;
+  }
   // save params
   framework::ProgramDesc save_program;
   auto *save_block = save_program.MutableBlock(0);
@@ -2171,7 +2474,7 @@ void AnalysisPredictor::SaveOptimModel(const std::string &dir) {
   auto *op = save_block->AppendOp();
   op->SetType("save_combine");
   op->SetInput("X", save_var_list);
-  op->SetAttr("file_path", dir + "/params");
+  op->SetAttr("file_path", params_file);
   op->CheckAttrs();
 
   platform::CPUPlace place;
@@ -2446,6 +2749,10 @@ std::string UpdateDllFlag(const char *name, const char *value) {
   return paddle::UpdateDllFlag(name, value);
 }
 
+std::string ExportMetrics() {
+  return paddle::platform::MetricRegistry::Instance().ExportPrometheus();
+}
+
 void ConvertToMixedPrecision(const std::string &model_file,
                              const std::string &params_file,
                              const std::string &mixed_model_file,
@@ -32,6 +32,7 @@
 #include "paddle/fluid/inference/api/resource_manager.h"
 #include "paddle/fluid/platform/device/gpu/gpu_types.h"
 #include "paddle/fluid/platform/float16.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/string/printf.h"
 #ifdef PADDLE_WITH_TESTING
 #include <gtest/gtest.h>
@@ -264,6 +265,18 @@ class AnalysisPredictor : public PaddlePredictor {
   /// \return the inference program
   ///
   framework::ProgramDesc &program() { return *inference_program_; }
+  ///
+  /// \brief Get the NUMA node the predictor is bound to
+  ///
+  /// \return the NUMA node, -1 if the NUMA binding is disabled
+  ///
+  int numa_node() const { return numa_node_; }
+  ///
+  /// \brief Get whether the program is loaded from the optimized model cache
+  ///
+  /// \return Whether the optimized model cache is hit
+  ///
+  bool optimized_model_cache_hit() const { return optimized_model_cache_hit_; }
 
   ///
   /// \brief Get the serialized program
@@ -324,6 +337,11 @@ class AnalysisPredictor : public PaddlePredictor {
   /// \return Whether the function executed successfully
   ///
   bool PrepareExecutor();
+  ///
+  /// \brief Register the persistable weights of fc, mul and matmul_v2 to be
+  /// packed for the GEMM of the cpu math library.
+  ///
+  void RegisterPackedWeights();
 
   ///
   /// \brief Load model program.
@@ -337,6 +355,41 @@ class AnalysisPredictor : public PaddlePredictor {
   /// \return Whether the function executed successfully
   ///
   bool LoadParameters();
+  ///
+  /// \brief Whether the executor places the intermediate tensors in a
+  /// memory arena, which replaces the memory_optimize_pass.
+  ///
+  /// \return Whether the memory arena is used
+  ///
+  bool UseMemoryArena() const;
+  ///
+  /// \brief Get the directory of the optimized model cache for the current
+  /// model and config, it should be called before the IR passes.
+  ///
+  /// \return The directory, or "" if the cache is not usable
+  ///
+  std::string GetOptimizedModelCacheDir();
+  ///
+  /// \brief Load the optimized program and the transformed persistables
+  /// from the optimized model cache, instead of running the IR passes.
+  ///
+  /// \param[in] cache_dir the directory of the optimized model cache
+  ///
+  /// \return Whether the cache is hit
+  ///
+  bool LoadOptimizedModelCache(const std::string &cache_dir);
+  ///
+  /// \brief Save the optimized program and the transformed persistables to
+  /// the optimized model cache.
+  ///
+  /// \param[in] cache_dir the directory of the optimized model cache
+  ///
+  void SaveOptimizedModelCache(const std::string &cache_dir);
+  ///
+  /// \brief Save the program to model_file and the parameters to params_file.
+  ///
+  void SaveOptimModel(const std::string &model_file,
+                      const std::string &params_file);
 
   ///
   /// \brief Prepare input data, only used in Run()
@@ -416,6 +469,7 @@ class AnalysisPredictor : public PaddlePredictor {
   FRIEND_TEST(AnalysisPredictor, analysis_off);
   FRIEND_TEST(AnalysisPredictor, analysis_on);
   FRIEND_TEST(AnalysisPredictor, with_gpu);
+  FRIEND_TEST(AnalysisPredictor, optimized_model_cache);
 #endif
 
  protected:
@@ -531,6 +585,17 @@ class AnalysisPredictor : public PaddlePredictor {
 
   bool private_context_{false};
   void *predictor_stream_{nullptr};
+  // The NUMA node the predictor is bound to, -1 if NUMA binding is disabled.
+  int numa_node_{-1};
+  // The number of the clones placed by Clone() in round-robin.
+  int num_numa_clones_{0};
+  // The directory of the optimized model cache, "" if it is not used.
+  std::string optimized_model_cache_dir_;
+  bool optimized_model_cache_hit_{false};
+  // The weights registered in phi::funcs::PackedWeightCache.
+  std::vector<const void *> packed_weights_;
+  // The latency of ZeroCopyRun, see FLAGS_enable_latency_histogram.
+  platform::LatencyHistogram *run_latency_{nullptr};
   std::map<phi::Place, std::shared_future<std::unique_ptr<phi::DeviceContext>>>
       device_contexts_;
 
@@ -19,17 +19,24 @@
 #endif
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
+#include <cstdio>
 #include <thread>  // NOLINT
 
 #include "paddle/fluid/framework/ir/pass.h"
 #include "paddle/fluid/framework/tensor.h"
+#include "paddle/fluid/inference/analysis/helper.h"
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/api/paddle_api.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/tests/api/tester_helper.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/platform/cpu_info.h"
+#include "paddle/fluid/platform/numa_info.h"
+#include "paddle/phi/kernels/funcs/packed_gemm.h"
 
 DEFINE_string(dirname, "", "dirname to tests.");
 
@@ -264,6 +271,221 @@ TEST(AnalysisPredictor, Clone) {
   }
 }
 
+#if defined(__linux__)
+static std::vector<int> GetThreadCpus() {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  sched_getaffinity(0, sizeof(mask), &mask);
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &mask)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+#endif
+
+TEST(AnalysisPredictor, numa_binding) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.SwitchUseFeedFetchOps(true);
+  config.SetCpuMathLibraryNumThreads(2);
+  config.EnableNumaBinding(0);
+  ASSERT_TRUE(config.numa_binding_enabled());
+  ASSERT_EQ(config.numa_node(), 0);
+
+  // a pinned predictor and its clones stay on the node
+  auto predictor = CreatePaddlePredictor(config);
+  auto cloned = predictor->Clone();
+  auto cloned2 = predictor->Clone();
+  ASSERT_EQ(static_cast<AnalysisPredictor *>(predictor.get())->numa_node(), 0);
+  ASSERT_EQ(static_cast<AnalysisPredictor *>(cloned.get())->numa_node(), 0);
+  ASSERT_EQ(static_cast<AnalysisPredictor *>(cloned2.get())->numa_node(), 0);
+
+  int64_t data[4] = {1, 2, 3, 4};
+  PaddleTensor tensor;
+  tensor.shape = std::vector<int>({4, 1});
+  tensor.data.Reset(data, sizeof(data));
+  tensor.dtype = PaddleDType::INT64;
+  std::vector<PaddleTensor> inputs(4, tensor);
+
+#if defined(__linux__)
+  std::vector<int> cpus = GetThreadCpus();
+#endif
+  std::vector<PaddleTensor> outputs, cloned_outputs;
+  ASSERT_TRUE(predictor->Run(inputs, &outputs));
+  ASSERT_TRUE(cloned->Run(inputs, &cloned_outputs));
+  ASSERT_EQ(outputs.size(), cloned_outputs.size());
+  // the binding of the calling thread and the OpenMP threads is restored
+  // after Run
+  ASSERT_EQ(platform::GetCurrentThreadNumaNode(), -1);
+#if defined(__linux__)
+  ASSERT_EQ(GetThreadCpus(), cpus);
+#endif
+#ifdef PADDLE_WITH_MKLML
+  int bound_threads = 0;
+#pragma omp parallel num_threads(2) reduction(+ : bound_threads)
+  { bound_threads += platform::GetCurrentThreadNumaNode() != -1; }
+  ASSERT_EQ(bound_threads, 0);
+#endif
+
+  // the clones of a round-robin predictor are spread across the nodes,
+  // counted per predictor
+  AnalysisConfig rr_config;
+  rr_config.SetModel(FLAGS_dirname);
+  rr_config.SwitchUseFeedFetchOps(true);
+  rr_config.EnableNumaBinding();
+  auto rr_predictor = CreatePaddlePredictor(rr_config);
+  auto *rr = static_cast<AnalysisPredictor *>(rr_predictor.get());
+  int node_count = platform::GetNumaNodeCount();
+  ASSERT_GE(rr->numa_node(), 0);
+  ASSERT_LT(rr->numa_node(), node_count);
+  // the clones of other predictors do not shift the round robin
+  auto other_cloned = predictor->Clone();
+  for (int i = 1; i <= 3; ++i) {
+    auto rr_cloned = rr_predictor->Clone();
+    ASSERT_EQ(static_cast<AnalysisPredictor *>(rr_cloned.get())->numa_node(),
+              (rr->numa_node() + i) % node_count);
+  }
+}
+
+TEST(AnalysisPredictor, gemm_weight_packing) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.SwitchUseFeedFetchOps(true);
+  auto predictor = CreatePaddlePredictor(config);
+
+  AnalysisConfig packed_config(config);
+  packed_config.EnableGemmWeightPacking();
+  ASSERT_TRUE(packed_config.gemm_weight_packing_enabled());
+  auto packed = CreatePaddlePredictor(packed_config);
+  auto cloned = packed->Clone();
+
+  int64_t data[4] = {1, 2, 3, 4};
+  PaddleTensor tensor;
+  tensor.shape = std::vector<int>({4, 1});
+  tensor.data.Reset(data, sizeof(data));
+  tensor.dtype = PaddleDType::INT64;
+  std::vector<PaddleTensor> inputs(4, tensor);
+
+  std::vector<PaddleTensor> outputs, packed_outputs, cloned_outputs;
+  ASSERT_TRUE(predictor->Run(inputs, &outputs));
+  ASSERT_TRUE(packed->Run(inputs, &packed_outputs));
+  ASSERT_TRUE(cloned->Run(inputs, &cloned_outputs));
+#ifdef PADDLE_WITH_MKLML
+  // the clone uses the weights packed by the first run
+  size_t num_packed = phi::funcs::PackedWeightCache::Instance().Size();
+  ASSERT_GT(num_packed, 0UL);
+  ASSERT_TRUE(cloned->Run(inputs, &cloned_outputs));
+  ASSERT_EQ(phi::funcs::PackedWeightCache::Instance().Size(), num_packed);
+#endif
+  ASSERT_EQ(outputs.size(), packed_outputs.size());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    auto *out = static_cast<float *>(outputs[i].data.data());
+    auto *packed_out = static_cast<float *>(packed_outputs[i].data.data());
+    auto *cloned_out = static_cast<float *>(cloned_outputs[i].data.data());
+    size_t num = outputs[i].data.length() / sizeof(float);
+    for (size_t j = 0; j < num; ++j) {
+      EXPECT_NEAR(out[j], packed_out[j], 1e-5);
+      EXPECT_NEAR(out[j], cloned_out[j], 1e-5);
+    }
+  }
+
+  // the packed weights are released with the predictors
+  cloned.reset();
+  packed.reset();
+  ASSERT_EQ(phi::funcs::PackedWeightCache::Instance().Size(), 0UL);
+}
+
+TEST(AnalysisPredictor, optimized_model_cache) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.SwitchUseFeedFetchOps(true);
+  config.SetOptimCacheDir(FLAGS_dirname + "/_optimized_model_cache");
+  config.EnableOptimizedModelCache();
+  ASSERT_TRUE(config.optimized_model_cache_enabled());
+
+  // The first predictor optimizes the model and fills the cache, the second
+  // one loads the optimized model from the cache.
+  AnalysisConfig cached_config(config);
+  auto predictor = CreatePaddlePredictor(config);
+  auto *analysis_predictor = static_cast<AnalysisPredictor *>(predictor.get());
+  const std::string &cache_dir = analysis_predictor->optimized_model_cache_dir_;
+  ASSERT_FALSE(cache_dir.empty());
+  ASSERT_FALSE(analysis_predictor->optimized_model_cache_hit());
+  ASSERT_TRUE(inference::analysis::FileExists(cache_dir + "/model"));
+  ASSERT_TRUE(inference::analysis::FileExists(cache_dir + "/params"));
+
+  auto cached = CreatePaddlePredictor(cached_config);
+  auto *cached_predictor = static_cast<AnalysisPredictor *>(cached.get());
+  ASSERT_EQ(cached_predictor->optimized_model_cache_dir_, cache_dir);
+  ASSERT_TRUE(cached_predictor->optimized_model_cache_hit());
+  ASSERT_EQ(analysis_predictor->GetSerializedProgram(),
+            cached_predictor->GetSerializedProgram());
+
+  int64_t data[4] = {1, 2, 3, 4};
+  PaddleTensor tensor;
+  tensor.shape = std::vector<int>({4, 1});
+  tensor.data.Reset(data, sizeof(data));
+  tensor.dtype = PaddleDType::INT64;
+  std::vector<PaddleTensor> inputs(4, tensor);
+
+  std::vector<PaddleTensor> outputs, cached_outputs;
+  ASSERT_TRUE(predictor->Run(inputs, &outputs));
+  ASSERT_TRUE(cached->Run(inputs, &cached_outputs));
+  ASSERT_EQ(outputs.size(), cached_outputs.size());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    auto *out = static_cast<float *>(outputs[i].data.data());
+    auto *cached_out = static_cast<float *>(cached_outputs[i].data.data());
+    size_t num = outputs[i].data.length() / sizeof(float);
+    for (size_t j = 0; j < num; ++j) {
+      EXPECT_NEAR(out[j], cached_out[j], 1e-5);
+    }
+  }
+
+  std::remove((cache_dir + "/model").c_str());
+  std::remove((cache_dir + "/params").c_str());
+  std::remove(cache_dir.c_str());
+  std::remove((FLAGS_dirname + "/_optimized_model_cache").c_str());
+}
+
+TEST(AnalysisPredictor, memory_arena) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.SwitchUseFeedFetchOps(true);
+  AnalysisConfig arena_config(config);
+  arena_config.EnableMemoryArena();
+  ASSERT_TRUE(arena_config.memory_arena_enabled());
+
+  auto predictor = CreatePaddlePredictor(config);
+  auto arena = CreatePaddlePredictor(arena_config);
+
+  int64_t data[4] = {1, 2, 3, 4};
+  // Run the shapes twice, the second time with the planned arena
+  for (int batch : {4, 2, 4, 2}) {
+    PaddleTensor tensor;
+    tensor.shape = std::vector<int>({batch, 1});
+    tensor.data.Reset(data, batch * sizeof(int64_t));
+    tensor.dtype = PaddleDType::INT64;
+    std::vector<PaddleTensor> inputs(4, tensor);
+
+    std::vector<PaddleTensor> outputs, arena_outputs;
+    ASSERT_TRUE(predictor->Run(inputs, &outputs));
+    ASSERT_TRUE(arena->Run(inputs, &arena_outputs));
+    ASSERT_EQ(outputs.size(), arena_outputs.size());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      auto *out = static_cast<float *>(outputs[i].data.data());
+      auto *arena_out = static_cast<float *>(arena_outputs[i].data.data());
+      size_t num = outputs[i].data.length() / sizeof(float);
+      ASSERT_EQ(num, arena_outputs[i].data.length() / sizeof(float));
+      for (size_t j = 0; j < num; ++j) {
+        EXPECT_NEAR(out[j], arena_out[j], 1e-5);
+      }
+    }
+  }
+}
+
 // This function is not released yet, will fail on some machine.
 // TODO(Superjomn) Turn on it latter.
 /*
@@ -208,6 +208,23 @@ struct PD_INFER_DECL AnalysisConfig {
     opt_cache_dir_ = opt_cache_dir;
   }
   ///
+  /// \brief Cache the optimized program and the persistables transformed by
+  /// the IR passes, such as the fused and padded weights, in the
+  /// optimization cache directory. A predictor created later with the same
+  /// model and config loads them and skips the IR passes. It takes effect
+  /// only on CPU without subgraph engines, and the cache is written to
+  /// model_dir/_opt_cache if SetOptimCacheDir is not called.
+  ///
+  void EnableOptimizedModelCache();
+  ///
+  /// \brief A boolean state telling whether the optimized model is cached.
+  ///
+  /// \return bool Whether the optimized model is cached.
+  ///
+  bool optimized_model_cache_enabled() const {
+    return use_optimized_model_cache_;
+  }
+  ///
   /// \brief Get the model directory path.
   ///
   /// \return const std::string& The model directory path.
@@ -779,6 +796,45 @@ struct PD_INFER_DECL AnalysisConfig {
     return cpu_math_library_num_threads_;
   }
 
+  ///
+  /// \brief Bind the predictor to a NUMA node. The thread running the
+  /// predictor and the cpu math library threads are bound to the CPUs of the
+  /// node, and the memory they touch is preferred to be allocated from the
+  /// node. The cloned predictors are spread across the nodes.
+  ///
+  /// \param numa_node The NUMA node, -1 means assigning the nodes to the
+  /// predictors in round-robin.
+  ///
+  void EnableNumaBinding(int numa_node = -1);
+  ///
+  /// \brief A boolean state telling whether the NUMA binding is enabled.
+  ///
+  /// \return bool Whether the NUMA binding is enabled.
+  ///
+  bool numa_binding_enabled() const { return use_numa_binding_; }
+  ///
+  /// \brief Get the NUMA node set by EnableNumaBinding.
+  ///
+  /// \return int The NUMA node, -1 means round-robin.
+  ///
+  int numa_node() const { return numa_node_; }
+
+  ///
+  /// \brief Pack the persistable weights of fc, mul and matmul_v2 for the
+  /// GEMM of the cpu math library once, instead of packing them in every
+  /// run. The packed weights are shared by the cloned predictors. It takes
+  /// effect only when Paddle is built with MKLML.
+  ///
+  void EnableGemmWeightPacking();
+  ///
+  /// \brief A boolean state telling whether the weights are packed.
+  ///
+  /// \return bool Whether the weights are packed.
+  ///
+  bool gemm_weight_packing_enabled() const {
+    return use_gemm_weight_packing_;
+  }
+
   ///
   /// \brief Transform the AnalysisConfig to NativeConfig.
   ///
@@ -905,6 +961,24 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool enable_memory_optim() const;
 
+  ///
+  /// \brief Place the intermediate tensors in one preallocated arena instead
+  /// of renaming them for reuse. The executor plans the offsets from the
+  /// lifetimes and sizes seen at the first run of each input shape, then
+  /// binds the operator outputs into the arena, so later runs with those
+  /// shapes do not call the allocator. It takes effect only on CPU without
+  /// MKLDNN, and replaces the memory optimization there.
+  ///
+  /// \param x Whether to enable the memory arena.
+  ///
+  void EnableMemoryArena(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the memory arena is enabled.
+  ///
+  /// \return bool Whether the memory arena is enabled.
+  ///
+  bool memory_arena_enabled() const { return enable_memory_arena_; }
+
   ///
   /// \brief Turn on profiling report.
   /// If not turned on, no profiling report will be generated.
@@ -1077,6 +1151,7 @@ struct PD_INFER_DECL AnalysisConfig {
 
   // memory reuse related.
   bool enable_memory_optim_{false};
+  bool enable_memory_arena_{false};
   bool trt_engine_memory_sharing_{false};
 
   bool use_mkldnn_{false};
@@ -1092,6 +1167,11 @@ struct PD_INFER_DECL AnalysisConfig {
 
   int cpu_math_library_num_threads_{1};
 
+  bool use_numa_binding_{false};
+  int numa_node_{-1};
+  bool use_gemm_weight_packing_{false};
+  bool use_optimized_model_cache_{false};
+
   bool with_profile_{false};
 
   bool with_glog_info_{true};
@@ -201,6 +201,13 @@ PD_INFER_DECL std::tuple<int, int, int> GetTrtCompileVersion();
 PD_INFER_DECL std::tuple<int, int, int> GetTrtRuntimeVersion();
 PD_INFER_DECL std::string UpdateDllFlag(const char* name, const char* value);
 
+///
+/// \brief The latency histograms (see FLAGS_enable_latency_histogram), the
+/// memory and work queue gauges and the StatRegistry values, in the
+/// Prometheus text exposition format. A service serves it to be scraped.
+///
+PD_INFER_DECL std::string ExportMetrics();
+
 PD_INFER_DECL void ConvertToMixedPrecision(
     const std::string& model_file,
     const std::string& params_file,
@@ -18,6 +18,7 @@
 
 #include "paddle/fluid/framework/var_desc.h"
 #include "paddle/fluid/framework/variable.h"
+#include "paddle/fluid/memory/allocation/mmap_allocator.h"
 #include "paddle/fluid/platform/device_context.h"
 
 #include "paddle/fluid/jit/engine/executor_engine.h"
@@ -29,6 +30,7 @@
 #include "paddle/fluid/jit/serializer_utils.h"
 
 DECLARE_string(jit_engine_type);
+DECLARE_bool(load_combine_with_mmap);
 
 namespace paddle {
 namespace jit {
@@ -102,9 +104,24 @@ void Deserializer::ReadTensorData(const std::string& file_name,
                                   const phi::Place& place,
                                   VariableMap* params_dict) const {
   VLOG(3) << "ReadTensorData from: " << file_name;
-  std::ifstream fin(file_name, std::ios::binary);
   platform::DeviceContextPool& pool = platform::DeviceContextPool::Instance();
   auto& dev_ctx = *pool.Get(place);
+#ifndef _WIN32
+  if (FLAGS_load_combine_with_mmap && platform::is_cpu_place(place)) {
+    auto file = memory::allocation::AllocateMemoryMapFileAllocation(file_name);
+    size_t offset = 0;
+    for (auto it = var_name.begin(); it != var_name.end(); it++) {
+      VLOG(3) << "map Tensor: " << *it;
+      Variable v;
+      DenseTensor* dense_tesnor = v.GetMutable<DenseTensor>();
+      framework::DeserializeFromMappedFile(
+          file, &offset, dense_tesnor, dev_ctx);
+      (*params_dict)[*it] = std::make_shared<Variable>(v);
+    }
+    return;
+  }
+#endif
+  std::ifstream fin(file_name, std::ios::binary);
   for (auto it = var_name.begin(); it != var_name.end(); it++) {
     VLOG(3) << "load Tensor: " << *it;
     Variable v;
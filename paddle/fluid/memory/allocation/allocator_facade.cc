@@ -23,6 +23,7 @@
 #include "paddle/fluid/memory/allocation/naive_best_fit_allocator.h"
 #include "paddle/fluid/memory/allocation/retry_allocator.h"
 #include "paddle/fluid/memory/allocation/stat_allocator.h"
+#include "paddle/fluid/memory/allocation/thread_cached_allocator.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/place.h"
 
@@ -99,6 +100,19 @@ PADDLE_DEFINE_EXPORTED_bool(use_cuda_managed_memory,
                             "managed memory, only available for auto_growth "
                             "strategy");
 
+PADDLE_DEFINE_EXPORTED_bool(
+    use_auto_growth_cpu_allocator,
+    false,
+    "Whether to use AutoGrowthBestFitAllocator with per-thread caches to "
+    "allocate CPU memory, only available for auto_growth and thread_local "
+    "strategy. If false, NaiveBestFitAllocator is used.");
+
+PADDLE_DEFINE_EXPORTED_int64(
+    cpu_allocator_thread_cache_size_in_kb,
+    4096,
+    "The max size (KB) of CPU memory cached by each thread when "
+    "FLAGS_use_auto_growth_cpu_allocator is true.");
+
 DECLARE_string(allocator_strategy);
 
 namespace paddle {
@@ -222,7 +236,11 @@ class AllocatorFacadePrivate {
       }
 
       case AllocatorStrategy::kAutoGrowth: {
-        InitNaiveBestFitCPUAllocator();
+        if (FLAGS_use_auto_growth_cpu_allocator) {
+          InitAutoGrowthCPUAllocator(allow_free_idle_chunk);
+        } else {
+          InitNaiveBestFitCPUAllocator();
+        }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
         allow_free_idle_chunk_ = allow_free_idle_chunk;
         for (int dev_id = 0; dev_id < platform::GetGPUDeviceCount(); ++dev_id) {
@@ -288,7 +306,11 @@ class AllocatorFacadePrivate {
       }
 
       case AllocatorStrategy::kThreadLocal: {
-        InitNaiveBestFitCPUAllocator();
+        if (FLAGS_use_auto_growth_cpu_allocator) {
+          InitAutoGrowthCPUAllocator(/*allow_free_idle_chunk=*/true);
+        } else {
+          InitNaiveBestFitCPUAllocator();
+        }
 #ifdef PADDLE_WITH_XPU
         for (int dev_id = 0; dev_id < platform::GetXPUDeviceCount(); ++dev_id) {
           InitNaiveBestFitXPUAllocator(platform::XPUPlace(dev_id));
@@ -497,6 +519,24 @@ class AllocatorFacadePrivate {
         std::make_shared<NaiveBestFitAllocator>(platform::CPUPlace());
   }
 
+  // Size-class per-thread caches in front of a shared auto-growth arena.
+  // Blocks larger than kMaxCachedSize skip the caches, and the idle chunks of
+  // the arena are freed by Release(CPUPlace).
+  void InitAutoGrowthCPUAllocator(bool allow_free_idle_chunk) {
+    constexpr size_t kAlignment = 64;
+    constexpr size_t kChunkSize = 8 << 20;
+    constexpr size_t kMaxCachedSize = 1 << 20;
+    auto arena = std::make_shared<AutoGrowthBestFitAllocator>(
+        std::make_shared<CPUAllocator>(/*update_reserved_stat=*/true),
+        kAlignment,
+        kChunkSize,
+        allow_free_idle_chunk);
+    allocators_[platform::CPUPlace()] = std::make_shared<ThreadCachedAllocator>(
+        arena,
+        kMaxCachedSize,
+        static_cast<size_t>(FLAGS_cpu_allocator_thread_cache_size_in_kb) << 10);
+  }
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   void InitNaiveBestFitCUDAPinnedAllocator() {
     allocators_[platform::CUDAPinnedPlace()] =
@@ -16,6 +16,7 @@
 
 #include <stdlib.h>
 
+#include "paddle/fluid/memory/stats.h"
 #include "paddle/fluid/platform/enforce.h"
 
 namespace paddle {
@@ -31,6 +32,9 @@ void CPUAllocator::FreeImpl(phi::Allocation *allocation) {
 #else
   free(p);
 #endif
+  if (update_reserved_stat_) {
+    HOST_MEMORY_STAT_UPDATE(Reserved, 0, -allocation->size());
+  }
   delete allocation;
 }
 
@@ -46,6 +50,9 @@ phi::Allocation *CPUAllocator::AllocateImpl(size_t size) {
       platform::errors::ResourceExhausted(
           "Fail to alloc memory of %ld size, error code is %d.", size, error));
 #endif
+  if (update_reserved_stat_) {
+    HOST_MEMORY_STAT_UPDATE(Reserved, 0, size);
+  }
   return new Allocation(p, size, platform::CPUPlace());
 }
 }  // namespace allocation
@@ -34,11 +34,20 @@ namespace allocation {
 class CPUAllocator : public Allocator {
  public:
   constexpr static size_t kAlignment = 4096UL;
+
+  // If update_reserved_stat is true, the allocated bytes are recorded in the
+  // host Reserved stat, e.g., when the allocator backs an arena.
+  explicit CPUAllocator(bool update_reserved_stat = false)
+      : update_reserved_stat_(update_reserved_stat) {}
+
   bool IsAllocThreadSafe() const override;
 
  protected:
   void FreeImpl(phi::Allocation* allocation) override;
   phi::Allocation* AllocateImpl(size_t size) override;
+
+ private:
+  bool update_reserved_stat_;
 };
 }  // namespace allocation
 }  // namespace memory
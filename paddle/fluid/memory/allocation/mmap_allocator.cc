@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <random>
 #include <string>
@@ -268,6 +270,47 @@ std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
   return std::make_shared<MemoryMapReaderAllocation>(ptr, size, ipc_name);
 }
 
+MemoryMapFileAllocation::~MemoryMapFileAllocation() {
+  if (this->size() == 0) {
+    return;
+  }
+  PADDLE_ENFORCE_NE(
+      munmap(this->ptr(), this->size()),
+      -1,
+      platform::errors::Unavailable("could not unmap the file %s",
+                                    this->file_name()));
+  VLOG(3) << "~MemoryMapFileAllocation: " << this->file_name();
+}
+
+std::shared_ptr<MemoryMapFileAllocation> AllocateMemoryMapFileAllocation(
+    const std::string &file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  PADDLE_ENFORCE_NE(
+      fd,
+      -1,
+      platform::errors::Unavailable("File %s open failed", file_name.c_str()));
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    close(fd);
+    PADDLE_THROW(platform::errors::Unavailable("Cannot get the size of file %s",
+                                               file_name.c_str()));
+  }
+  size_t size = static_cast<size_t>(file_stat.st_size);
+  // mmap rejects an empty length
+  void *ptr = nullptr;
+  if (size > 0) {
+    // PROT_WRITE is allowed on a read only file by MAP_PRIVATE
+    ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  PADDLE_ENFORCE_NE(ptr,
+                    MAP_FAILED,
+                    platform::errors::Unavailable(
+                        "Memory map failed when map file %s.", file_name));
+  VLOG(3) << "Map file " << file_name << " of " << size << " bytes";
+  return std::make_shared<MemoryMapFileAllocation>(ptr, size, file_name);
+}
+
 MemoryMapFdSet &MemoryMapFdSet::Instance() {  // NOLINT
   static MemoryMapFdSet set;
   return set;
@@ -134,6 +134,29 @@ std::shared_ptr<MemoryMapWriterAllocation> AllocateMemoryMapWriterAllocation(
 std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
     const std::string &ipc_name, size_t size);
 
+// A private mapping of a whole file. Its pages are shared with the page cache,
+// and so with every other process mapping the same file, until they are
+// written: a write copies just the written page (copy-on-write) and never
+// reaches the file.
+class MemoryMapFileAllocation : public Allocation {
+ public:
+  explicit MemoryMapFileAllocation(void *ptr,
+                                   size_t size,
+                                   std::string file_name)
+      : Allocation(ptr, size, platform::CPUPlace()),
+        file_name_(std::move(file_name)) {}
+
+  inline const std::string &file_name() const { return file_name_; }
+
+  ~MemoryMapFileAllocation() override;
+
+ private:
+  std::string file_name_;
+};
+
+std::shared_ptr<MemoryMapFileAllocation> AllocateMemoryMapFileAllocation(
+    const std::string &file_name);
+
 class MemoryMapFdSet {
  public:
   static MemoryMapFdSet &Instance();  // NOLINT
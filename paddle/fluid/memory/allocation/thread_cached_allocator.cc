@@ -0,0 +1,333 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/thread_cached_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// The size of size class i is (kMinBlockSize << i)
+static constexpr size_t kMinBlockSize = 64;
+static constexpr size_t kNumSizeClasses = 20;
+
+static size_t SizeClassOf(size_t size) {
+  size_t size_class = 0;
+  while ((kMinBlockSize << size_class) < size) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+class ThreadCachedAllocation : public Allocation {
+ public:
+  ThreadCachedAllocation(DecoratedAllocationPtr underlying_allocation,
+                         size_t size,
+                         size_t size_class)
+      : Allocation(underlying_allocation->ptr(),
+                   underlying_allocation->base_ptr(),
+                   size,
+                   underlying_allocation->place()),
+        underlying_allocation_(std::move(underlying_allocation)),
+        size_class_(size_class) {}
+
+  DecoratedAllocationPtr TakeUnderlyingAllocation() {
+    return std::move(underlying_allocation_);
+  }
+
+  // kNumSizeClasses if the allocation is not cacheable
+  size_t SizeClass() const { return size_class_; }
+
+ private:
+  DecoratedAllocationPtr underlying_allocation_;
+  size_t size_class_;
+};
+
+class ThreadCachedAllocator::ThreadCache {
+ public:
+  ThreadCache(const std::shared_ptr<Allocator>& underlying_allocator,
+              size_t capacity)
+      : underlying_allocator_(underlying_allocator), capacity_(capacity) {}
+
+  ~ThreadCache() { Flush(); }
+
+  DecoratedAllocationPtr Pop(size_t size_class) {
+    std::lock_guard<SpinLock> guard(spinlock_);
+    auto& free_list = free_lists_[size_class];
+    if (free_list.empty()) {
+      return nullptr;
+    }
+    DecoratedAllocationPtr allocation = std::move(free_list.back());
+    free_list.pop_back();
+    cached_size_ -= allocation->size();
+    return allocation;
+  }
+
+  // Return false if the cache is full, and the allocation is left untouched.
+  bool Push(size_t size_class, DecoratedAllocationPtr* allocation) {
+    std::lock_guard<SpinLock> guard(spinlock_);
+    if (cached_size_ + (*allocation)->size() > capacity_) {
+      return false;
+    }
+    cached_size_ += (*allocation)->size();
+    free_lists_[size_class].emplace_back(std::move(*allocation));
+    return true;
+  }
+
+  // Return all the cached blocks to the underlying allocator.
+  void Flush() {
+    FreeLists free_lists;
+    {
+      std::lock_guard<SpinLock> guard(spinlock_);
+      free_lists.swap(free_lists_);
+      cached_size_ = 0;
+    }
+    // free_lists is destructed here, out of the spinlock
+  }
+
+  // Flush the cache and drop the underlying allocator. Called when the
+  // allocator is destroyed, since the cache may be held by the thread-local
+  // caches of a living thread.
+  void Reset() {
+    std::shared_ptr<Allocator> underlying_allocator;
+    FreeLists free_lists;
+    {
+      std::lock_guard<SpinLock> guard(spinlock_);
+      free_lists.swap(free_lists_);
+      underlying_allocator.swap(underlying_allocator_);
+      cached_size_ = 0;
+    }
+  }
+
+  size_t CachedSize() {
+    std::lock_guard<SpinLock> guard(spinlock_);
+    return cached_size_;
+  }
+
+ private:
+  using FreeLists =
+      std::array<std::vector<DecoratedAllocationPtr>, kNumSizeClasses>;
+
+  // NOTE: declared before free_lists_ to outlive the cached blocks
+  std::shared_ptr<Allocator> underlying_allocator_;
+  size_t capacity_;
+  size_t cached_size_{0};
+  FreeLists free_lists_;
+  SpinLock spinlock_;
+};
+
+namespace {
+
+// The ids of the living allocators. The generation is bumped when an
+// allocator is destroyed, so that the threads drop its caches lazily.
+std::mutex g_live_allocators_mtx;
+std::unordered_set<uint64_t> g_live_allocator_ids;
+std::atomic<uint64_t> g_allocators_generation{0};
+
+// The caches of the current thread, keyed by the id of the allocator. The
+// cached blocks are returned to the underlying allocators when the thread
+// exits.
+struct ThreadCacheHolder {
+  ~ThreadCacheHolder() {
+    for (auto& item : caches) {
+      item.second->Flush();
+    }
+  }
+
+  std::unordered_map<uint64_t,
+                     std::shared_ptr<ThreadCachedAllocator::ThreadCache>>
+      caches;
+  // fast path for the most recently used allocator
+  uint64_t last_id{0};
+  ThreadCachedAllocator::ThreadCache* last_cache{nullptr};
+  // g_allocators_generation when the caches were last checked
+  uint64_t generation{0};
+
+  // Drop the caches of the destroyed allocators.
+  void DropDestroyedCaches() {
+    uint64_t current = g_allocators_generation.load(std::memory_order_acquire);
+    if (generation == current) {
+      return;
+    }
+    std::lock_guard<std::mutex> guard(g_live_allocators_mtx);
+    for (auto iter = caches.begin(); iter != caches.end();) {
+      if (g_live_allocator_ids.count(iter->first) == 0) {
+        if (last_id == iter->first) {
+          last_id = 0;
+          last_cache = nullptr;
+        }
+        iter = caches.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+    generation = current;
+  }
+};
+
+ThreadCacheHolder& GetThreadCacheHolder() {
+  static thread_local ThreadCacheHolder holder;
+  return holder;
+}
+
+std::atomic<uint64_t> g_next_allocator_id{1};
+
+}  // namespace
+
+ThreadCachedAllocator::ThreadCachedAllocator(
+    const std::shared_ptr<Allocator>& underlying_allocator,
+    size_t max_cached_size,
+    size_t thread_cache_size)
+    : underlying_allocator_(underlying_allocator),
+      max_cached_size_(max_cached_size),
+      thread_cache_size_(thread_cache_size),
+      id_(g_next_allocator_id.fetch_add(1)) {
+  PADDLE_ENFORCE_NOT_NULL(
+      underlying_allocator_,
+      platform::errors::InvalidArgument(
+          "The underlying allocator of ThreadCachedAllocator is nullptr."));
+  PADDLE_ENFORCE_EQ(
+      underlying_allocator_->IsAllocThreadSafe(),
+      true,
+      platform::errors::InvalidArgument(
+          "The underlying allocator of ThreadCachedAllocator should be "
+          "thread-safe."));
+  PADDLE_ENFORCE_LE(
+      max_cached_size_,
+      kMinBlockSize << (kNumSizeClasses - 1),
+      platform::errors::InvalidArgument(
+          "The max cached size of ThreadCachedAllocator should not be "
+          "larger than %d, but got %d.",
+          kMinBlockSize << (kNumSizeClasses - 1),
+          max_cached_size_));
+  std::lock_guard<std::mutex> guard(g_live_allocators_mtx);
+  g_live_allocator_ids.insert(id_);
+}
+
+ThreadCachedAllocator::~ThreadCachedAllocator() {
+  {
+    std::lock_guard<std::mutex> guard(g_live_allocators_mtx);
+    g_live_allocator_ids.erase(id_);
+    g_allocators_generation.fetch_add(1, std::memory_order_release);
+  }
+  std::lock_guard<std::mutex> guard(mtx_);
+  // the caches still held by the living threads are dropped by them lazily,
+  // release the cached blocks and the underlying allocator now
+  for (auto& cache : thread_caches_) {
+    cache->Reset();
+  }
+}
+
+ThreadCachedAllocator::ThreadCache* ThreadCachedAllocator::GetThreadCache() {
+  auto& holder = GetThreadCacheHolder();
+  if (holder.last_id == id_) {
+    return holder.last_cache;
+  }
+
+  holder.DropDestroyedCaches();
+  auto iter = holder.caches.find(id_);
+  if (iter == holder.caches.end()) {
+    auto cache = std::make_shared<ThreadCache>(underlying_allocator_,
+                                               thread_cache_size_);
+    {
+      std::lock_guard<std::mutex> guard(mtx_);
+      thread_caches_.emplace_back(cache);
+    }
+    iter = holder.caches.emplace(id_, std::move(cache)).first;
+  }
+  holder.last_id = id_;
+  holder.last_cache = iter->second.get();
+  return holder.last_cache;
+}
+
+phi::Allocation* ThreadCachedAllocator::AllocateImpl(size_t size) {
+  platform::RecordEvent record("ThreadCachedAllocator::Allocate",
+                               platform::TracerEventType::UserDefined,
+                               9 /*level*/);
+  if (size > max_cached_size_) {
+    auto underlying_allocation = static_unique_ptr_cast<Allocation>(
+        underlying_allocator_->Allocate(size));
+    return new ThreadCachedAllocation(
+        std::move(underlying_allocation), size, kNumSizeClasses);
+  }
+
+  size_t size_class = SizeClassOf(size);
+  DecoratedAllocationPtr underlying_allocation =
+      GetThreadCache()->Pop(size_class);
+  if (underlying_allocation == nullptr) {
+    underlying_allocation = static_unique_ptr_cast<Allocation>(
+        underlying_allocator_->Allocate(kMinBlockSize << size_class));
+  }
+  return new ThreadCachedAllocation(
+      std::move(underlying_allocation), size, size_class);
+}
+
+void ThreadCachedAllocator::FreeImpl(phi::Allocation* allocation) {
+  auto* cached_allocation = static_cast<ThreadCachedAllocation*>(allocation);
+  size_t size_class = cached_allocation->SizeClass();
+  DecoratedAllocationPtr underlying_allocation =
+      cached_allocation->TakeUnderlyingAllocation();
+  delete cached_allocation;
+
+  if (size_class < kNumSizeClasses) {
+    // underlying_allocation is freed here if the cache is full
+    GetThreadCache()->Push(size_class, &underlying_allocation);
+  }
+}
+
+uint64_t ThreadCachedAllocator::ReleaseImpl(const platform::Place& place) {
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches;
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    // the caches only referenced here belong to the exited threads, and they
+    // have been flushed when the threads exit
+    thread_caches_.erase(
+        std::remove_if(thread_caches_.begin(),
+                       thread_caches_.end(),
+                       [](const std::shared_ptr<ThreadCache>& cache) {
+                         return cache.use_count() == 1;
+                       }),
+        thread_caches_.end());
+    thread_caches = thread_caches_;
+  }
+  for (auto& cache : thread_caches) {
+    cache->Flush();
+  }
+  uint64_t released_size = underlying_allocator_->Release(place);
+  VLOG(10) << "Release " << released_size << " bytes from "
+           << thread_caches.size() << " thread caches";
+  return released_size;
+}
+
+size_t ThreadCachedAllocator::CachedSize() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  size_t cached_size = 0;
+  for (auto& cache : thread_caches_) {
+    cached_size += cache->CachedSize();
+  }
+  return cached_size;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,78 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/spin_lock.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// ThreadCachedAllocator puts size-class free lists, one set per thread, in
+// front of a shared (thread-safe) underlying allocator, e.g., an
+// AutoGrowthBestFitAllocator. Small allocations are rounded up to a power of
+// two and served from the free list of the calling thread without touching
+// the lock of the underlying allocator. Allocations larger than
+// max_cached_size go to the underlying allocator directly.
+//
+// A freed block is cached by the thread which frees it, as long as the bytes
+// cached by that thread do not exceed thread_cache_size. Release() flushes
+// the caches of all threads back to the underlying allocator and then
+// releases the underlying allocator.
+class ThreadCachedAllocator : public Allocator {
+ public:
+  ThreadCachedAllocator(const std::shared_ptr<Allocator>& underlying_allocator,
+                        size_t max_cached_size,
+                        size_t thread_cache_size);
+
+  ~ThreadCachedAllocator();
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // Bytes cached by all threads, only used for unittests.
+  size_t CachedSize();
+
+  class ThreadCache;
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+
+  void FreeImpl(phi::Allocation* allocation) override;
+
+  uint64_t ReleaseImpl(const platform::Place& place) override;
+
+ private:
+  ThreadCache* GetThreadCache();
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  size_t max_cached_size_;
+  size_t thread_cache_size_;
+  // unique id of this allocator, used as the key of the thread-local caches,
+  // since the address may be reused by another allocator
+  uint64_t id_;
+
+  std::mutex mtx_;
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
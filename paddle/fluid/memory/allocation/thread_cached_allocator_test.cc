@@ -0,0 +1,156 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/thread_cached_allocator.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+#include "paddle/fluid/memory/stats.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class RecordedAllocator : public Allocator {
+ public:
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t AllocatedSize() const { return allocated_size_; }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    allocated_size_ += size;
+    return new Allocation(malloc(size), size, platform::CPUPlace());
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    allocated_size_ -= allocation->size();
+    free(allocation->ptr());
+    delete allocation;
+  }
+
+ private:
+  std::atomic<size_t> allocated_size_{0};
+};
+
+TEST(ThreadCachedAllocator, reuse_and_release) {
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  auto allocator = std::make_shared<ThreadCachedAllocator>(
+      recorded_allocator, /*max_cached_size=*/4096, /*thread_cache_size=*/8192);
+
+  void *ptr = nullptr;
+  {
+    auto allocation = allocator->Allocate(1000);
+    ASSERT_EQ(allocation->size(), 1000UL);
+    // rounded up to the size class
+    ASSERT_EQ(recorded_allocator->AllocatedSize(), 1024UL);
+    ptr = allocation->ptr();
+  }
+  ASSERT_EQ(allocator->CachedSize(), 1024UL);
+
+  // served from the thread cache
+  {
+    auto allocation = allocator->Allocate(600);
+    ASSERT_EQ(allocation->ptr(), ptr);
+    ASSERT_EQ(recorded_allocator->AllocatedSize(), 1024UL);
+  }
+
+  // larger than max_cached_size, never cached
+  {
+    auto allocation = allocator->Allocate(5000);
+    ASSERT_EQ(recorded_allocator->AllocatedSize(), 1024UL + 5000UL);
+  }
+  ASSERT_EQ(recorded_allocator->AllocatedSize(), 1024UL);
+
+  allocator->Release(platform::CPUPlace());
+  ASSERT_EQ(allocator->CachedSize(), 0UL);
+  ASSERT_EQ(recorded_allocator->AllocatedSize(), 0UL);
+}
+
+TEST(ThreadCachedAllocator, thread_cache_size_limit) {
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  auto allocator = std::make_shared<ThreadCachedAllocator>(
+      recorded_allocator, /*max_cached_size=*/4096, /*thread_cache_size=*/8192);
+
+  std::vector<AllocationPtr> allocations;
+  for (size_t i = 0; i < 4; ++i) {
+    allocations.emplace_back(allocator->Allocate(4096));
+  }
+  allocations.clear();
+  // only 2 blocks fit in the thread cache
+  ASSERT_EQ(allocator->CachedSize(), 8192UL);
+  ASSERT_EQ(recorded_allocator->AllocatedSize(), 8192UL);
+}
+
+TEST(ThreadCachedAllocator, destroyed_allocator) {
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  std::weak_ptr<RecordedAllocator> weak_allocator = recorded_allocator;
+  auto allocator = std::make_shared<ThreadCachedAllocator>(
+      recorded_allocator, /*max_cached_size=*/4096, /*thread_cache_size=*/8192);
+  recorded_allocator.reset();
+
+  allocator->Allocate(1000);
+  ASSERT_EQ(allocator->CachedSize(), 1024UL);
+  // the cache of this thread does not keep the underlying allocator alive
+  allocator.reset();
+  ASSERT_TRUE(weak_allocator.expired());
+
+  // the stale cache of this thread is dropped when the next allocator
+  // looks up its cache
+  auto other = std::make_shared<ThreadCachedAllocator>(
+      std::make_shared<RecordedAllocator>(), 4096, 8192);
+  other->Allocate(1000);
+  ASSERT_EQ(other->CachedSize(), 1024UL);
+}
+
+TEST(ThreadCachedAllocator, multi_thread) {
+  auto arena = std::make_shared<AutoGrowthBestFitAllocator>(
+      std::make_shared<CPUAllocator>(/*update_reserved_stat=*/true),
+      64,
+      1 << 20);
+  auto allocator = std::make_shared<ThreadCachedAllocator>(
+      arena, /*max_cached_size=*/1 << 16, /*thread_cache_size=*/1 << 20);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 8; ++i) {
+    threads.emplace_back([&allocator, i] {
+      for (size_t j = 0; j < 1000; ++j) {
+        size_t size = (i * 1000 + j) % (1 << 17) + 1;
+        auto allocation = allocator->Allocate(size);
+        ASSERT_EQ(allocation->size(), size);
+        memset(allocation->ptr(), 0, size);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // the caches of the exited threads are flushed back to the arena
+  ASSERT_EQ(allocator->CachedSize(), 0UL);
+  int64_t reserved = HOST_MEMORY_STAT_CURRENT_VALUE(Reserved, 0);
+  ASSERT_GT(allocator->Release(platform::CPUPlace()), 0UL);
+  ASSERT_LT(HOST_MEMORY_STAT_CURRENT_VALUE(Reserved, 0), reserved);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
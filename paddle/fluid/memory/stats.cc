@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/fluid/memory/stats.h"
 
 #include "paddle/fluid/memory/allocation/spin_lock.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/phi/core/macros.h"
 
 namespace paddle {
@@ -130,12 +131,39 @@ void HostMemoryStatUpdate(const std::string& stat_type,
   StatRegistry::GetInstance()->Register( \
       "Host" #item, 0, Stat<HostMemoryStat##item##0>::GetInstance());
 
+// The samples of a memory gauge of platform::MetricRegistry, the devices
+// that never allocated are left out.
+void CollectMemoryStats(const std::string& stat_type,
+                        platform::MetricRegistry::GaugeSamples* samples) {
+  samples->emplace_back(platform::PrometheusLabel("place", "cpu"),
+                        HostMemoryStatCurrentValue(stat_type, 0));
+  for (int dev_id = 0; dev_id < 16; ++dev_id) {
+    if (DeviceMemoryStatPeakValue(stat_type, dev_id) == 0) continue;
+    samples->emplace_back(
+        platform::PrometheusLabel("place", "device:" + std::to_string(dev_id)),
+        DeviceMemoryStatCurrentValue(stat_type, dev_id));
+  }
+}
+
 int RegisterAllStats() {
   DEVICE_MEMORY_STAT_REGISTER(Allocated);
   DEVICE_MEMORY_STAT_REGISTER(Reserved);
 
   HOST_MEMORY_STAT_REGISTER(Allocated);
   HOST_MEMORY_STAT_REGISTER(Reserved);
+
+  platform::MetricRegistry::Instance().RegisterGauge(
+      "paddle_memory_allocated_bytes",
+      "The bytes allocated by the allocators.",
+      [](platform::MetricRegistry::GaugeSamples* samples) {
+        CollectMemoryStats("Allocated", samples);
+      });
+  platform::MetricRegistry::Instance().RegisterGauge(
+      "paddle_memory_reserved_bytes",
+      "The bytes reserved by the allocators from the system.",
+      [](platform::MetricRegistry::GaugeSamples* samples) {
+        CollectMemoryStats("Reserved", samples);
+      });
   return 0;
 }
 
@@ -24,8 +24,11 @@ limitations under the License. */
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/string_array.h"
 #include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/memory/allocation/mmap_allocator.h"
 #include "paddle/fluid/platform/device_context.h"
 
+DECLARE_bool(load_combine_with_mmap);
+
 namespace paddle {
 namespace operators {
 template <typename DeviceContext, typename T>
@@ -45,6 +48,13 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
                           "it to be greater than 0.",
                           out_var_names.size()));
     if (!model_from_memory) {
+#ifndef _WIN32
+      if (FLAGS_load_combine_with_mmap && platform::is_cpu_place(place) &&
+          !load_as_fp16 && !HasVocab(ctx)) {
+        LoadParamsFromMappedFile(ctx, place, filename, out_var_names);
+        return;
+      }
+#endif
       std::ifstream fin(filename, std::ios::binary);
       PADDLE_ENFORCE_EQ(
           static_cast<bool>(fin),
@@ -67,6 +77,45 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
     }
   }
 
+  bool HasVocab(const framework::ExecutionContext &context) const {
+    for (auto *var : context.MultiOutputVar("Out")) {
+      if (var && var->IsType<framework::Vocab>()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+#ifndef _WIN32
+  void LoadParamsFromMappedFile(
+      const framework::ExecutionContext &context,
+      const platform::Place &place,
+      const std::string &filename,
+      const std::vector<std::string> &out_var_names) const {
+    platform::DeviceContextPool &pool = platform::DeviceContextPool::Instance();
+    auto &dev_ctx = *pool.Get(place);
+    auto out_vars = context.MultiOutputVar("Out");
+    auto file = memory::allocation::AllocateMemoryMapFileAllocation(filename);
+    size_t offset = 0;
+
+    for (size_t i = 0; i < out_var_names.size(); i++) {
+      VLOG(4) << "mapping tensor: " << out_var_names[i];
+      PADDLE_ENFORCE_NOT_NULL(
+          out_vars[i],
+          platform::errors::InvalidArgument(
+              "The variable %s to be loaded cannot be found.",
+              out_var_names[i]));
+      auto *tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
+      framework::DeserializeFromMappedFile(file, &offset, tensor, dev_ctx);
+    }
+    PADDLE_ENFORCE_EQ(offset,
+                      file->size(),
+                      platform::errors::Unavailable(
+                          "Not allowed to load partial data via "
+                          "load_combine_op, please use load_op instead."));
+  }
+#endif
+
   void LoadParamsFromBuffer(
       const framework::ExecutionContext &context,
       const platform::Place &place,
@@ -31,6 +31,8 @@ limitations under the License. */
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/phi/backends/dynload/port.h"
 
+DECLARE_int32(save_combine_data_alignment);
+
 namespace paddle {
 namespace operators {
 template <typename DeviceContext, typename T>
@@ -66,6 +68,14 @@ class SaveCombineOpKernel : public framework::OpKernel<T> {
     // get device context from pool
     platform::DeviceContextPool &pool = platform::DeviceContextPool::Instance();
     auto &dev_ctx = *pool.Get(place);
+    PADDLE_ENFORCE_GE(FLAGS_save_combine_data_alignment,
+                      0,
+                      platform::errors::InvalidArgument(
+                          "FLAGS_save_combine_data_alignment should be >= 0, "
+                          "but received %d.",
+                          FLAGS_save_combine_data_alignment));
+    size_t data_alignment =
+        static_cast<size_t>(FLAGS_save_combine_data_alignment);
 
     for (size_t i = 0; i < inp_var_names.size(); i++) {
       PADDLE_ENFORCE_NOT_NULL(
@@ -102,9 +112,9 @@ class SaveCombineOpKernel : public framework::OpKernel<T> {
           out.set_lod(tensor.lod());
           framework::TransDataType(
               in_kernel_type, out_kernel_type, tensor, &out);
-          framework::SerializeToStream(ss, out, dev_ctx);
+          framework::SerializeToStream(ss, out, dev_ctx, data_alignment);
         } else {
-          framework::SerializeToStream(ss, tensor, dev_ctx);
+          framework::SerializeToStream(ss, tensor, dev_ctx, data_alignment);
         }
       } else {
         auto &tensor = inp_vars[i]->Get<framework::Vocab>();
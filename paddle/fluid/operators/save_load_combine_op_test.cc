@@ -24,6 +24,9 @@ limitations under the License. */
 USE_CPU_ONLY_OP(save_combine);
 USE_CPU_ONLY_OP(load_combine);
 
+DECLARE_int32(save_combine_data_alignment);
+DECLARE_bool(load_combine_with_mmap);
+
 template <typename T, typename U>
 T* CreateForSaveCombineOp(int x,
                           int y,
@@ -370,3 +373,55 @@ TEST(SaveLoadTestWithCombineOp, CPU) {
     }
   }
 }
+
+#ifndef _WIN32
+// Load the params file through a mapping, with and without aligned data
+TEST(SaveLoadCombineOp, MappedFile) {
+  paddle::framework::Scope scope;
+  paddle::platform::CPUPlace place;
+
+  paddle::framework::LoD expect_lod1, expect_lod2;
+  float* expect1 = CreateForSaveCombineOp<float, float>(
+      10, 10, {0, 1, 2, 3, 10}, "test_var1", place, &scope, &expect_lod1);
+  double* expect2 = CreateForSaveCombineOp<double, double>(
+      3, 7, {0, 2, 3}, "test_var2", place, &scope, &expect_lod2);
+
+  for (int alignment : {0, 64}) {
+    FLAGS_save_combine_data_alignment = alignment;
+    std::string filename = "check_mapped_tensor.ls";
+    paddle::framework::AttributeMap attrs;
+    attrs.insert({"file_path", std::string(filename)});
+    auto save_combine_op = paddle::framework::OpRegistry::CreateOp(
+        "save_combine", {{"X", {"test_var1", "test_var2"}}}, {}, attrs);
+    save_combine_op->Run(scope, place);
+    FLAGS_save_combine_data_alignment = 0;
+
+    FLAGS_load_combine_with_mmap = true;
+    auto target1 = GeneratePlaceholderBeforeLoad("out_var1", &scope);
+    auto target2 = GeneratePlaceholderBeforeLoad("out_var2", &scope);
+    auto load_combine_op = paddle::framework::OpRegistry::CreateOp(
+        "load_combine", {}, {{"Out", {"out_var1", "out_var2"}}}, attrs);
+    load_combine_op->Run(scope, place);
+    FLAGS_load_combine_with_mmap = false;
+
+    paddle::framework::LoD actual_lod1, actual_lod2;
+    float* actual1 =
+        GetValuesAfterLoadCombineOp<float>(target1, scope, &actual_lod1);
+    double* actual2 =
+        GetValuesAfterLoadCombineOp<double>(target2, scope, &actual_lod2);
+    CheckValues<float, float>(expect1, actual1, expect_lod1, actual_lod1, 100);
+    CheckValues<double, double>(expect2, actual2, expect_lod2, actual_lod2, 21);
+    if (alignment > 0) {
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(actual1) % alignment, 0UL);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(actual2) % alignment, 0UL);
+    }
+
+    // The mapping is private, a write must not reach the file
+    actual1[0] = -1.0f;
+    auto reload_op = paddle::framework::OpRegistry::CreateOp(
+        "load_combine", {}, {{"Out", {"out_var1", "out_var2"}}}, attrs);
+    reload_op->Run(scope, place);
+    EXPECT_EQ(target1->data<float>()[0], expect1[0]);
+  }
+}
+#endif
@@ -14,6 +14,10 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/cpu_helper.h"
 
+#include <memory>
+
+#include "paddle/fluid/platform/numa_info.h"
+
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 
@@ -52,5 +56,37 @@ void SetNumThreads(int num_threads) {
 #endif
 }
 
+#ifdef PADDLE_WITH_MKLML
+// The binding of every OpenMP thread, see MathLibraryNumaBindingGuard.
+static thread_local std::unique_ptr<NumaBindingGuard> math_library_numa_guard;
+#endif
+
+MathLibraryNumaBindingGuard::MathLibraryNumaBindingGuard(int num_threads,
+                                                         int numa_node)
+    : num_threads_(num_threads > 1 ? num_threads : 1), numa_node_(numa_node) {
+  if (numa_node_ < 0) {
+    return;
+  }
+#ifdef PADDLE_WITH_MKLML
+  // The OpenMP threads are reused by the following parallel regions of the
+  // calling thread, so they keep the binding until the guard is destroyed.
+#pragma omp parallel num_threads(num_threads_)
+  {
+    math_library_numa_guard.reset();
+    math_library_numa_guard.reset(new NumaBindingGuard(numa_node_));
+  }
+#endif
+}
+
+MathLibraryNumaBindingGuard::~MathLibraryNumaBindingGuard() {
+  if (numa_node_ < 0) {
+    return;
+  }
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel num_threads(num_threads_)
+  { math_library_numa_guard.reset(); }
+#endif
+}
+
 }  // namespace platform
 }  // namespace paddle
@@ -16,11 +16,28 @@ limitations under the License. */
 
 #include <stddef.h>
 
+#include "paddle/fluid/platform/macros.h"
+
 namespace paddle {
 namespace platform {
 
 //! Set the number of threads in use.
 void SetNumThreads(int num_threads);
 
+//! Bind the threads of cpu math library (i.e., the OpenMP threads used by
+//! MKL and oneDNN) to a NUMA node in the scope, and restore their CPU
+//! affinity and memory policy on destruction. Only takes effect with MKLML.
+class MathLibraryNumaBindingGuard {
+ public:
+  MathLibraryNumaBindingGuard(int num_threads, int numa_node);
+  ~MathLibraryNumaBindingGuard();
+
+ private:
+  int num_threads_;
+  int numa_node_;
+
+  DISABLE_COPY_AND_ASSIGN(MathLibraryNumaBindingGuard);
+};
+
 }  // namespace platform
 }  // namespace paddle
@@ -376,8 +376,41 @@ PADDLE_DEFINE_EXPORTED_bool(
 PADDLE_DEFINE_EXPORTED_int32(communicator_send_queue_size,
                              20,
                              "queue size to recv gradient before send");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_gloo_comm_threads
+ * Since Version: 2.4.0
+ * Value Range: int32, default=2
+ * Example:
+ * Note: The number of communication threads of ProcessGroupGloo. Each
+ *       thread owns a gloo context and runs the collectives assigned to it
+ *       in order, so that the collectives issued with sync_op=false,
+ *       such as the gradient all-reduce of the DataParallel reducer on
+ *       CPU, run in the background and overlap with each other and with
+ *       the computation. It should be the same on all ranks.
+ */
+PADDLE_DEFINE_EXPORTED_int32(gloo_comm_threads,
+                             2,
+                             "number of communication threads of "
+                             "ProcessGroupGloo");
 #endif
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_tcp_store_server_threads
+ * Since Version: 2.4.0
+ * Value Range: int32, default=4
+ * Example:
+ * Note: The number of worker threads of the TCPStore master. The client
+ *       connections are spread over the workers and the keys over the
+ *       shards of the store, so that the bootstrap of a large job is not
+ *       served by a single thread.
+ */
+PADDLE_DEFINE_EXPORTED_int32(tcp_store_server_threads,
+                             4,
+                             "number of worker threads of the TCPStore "
+                             "master");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_dist_threadpool_size
@@ -953,6 +986,22 @@ DEFINE_bool(enable_slotrecord_reset_shrink,
 DEFINE_bool(enable_ins_parser_file,
             false,
             "enable parser ins file, default false");
+DEFINE_bool(enable_lock_free_channel,
+            false,
+            "use lock-free ring buffer channels as the queues of the private "
+            "queue data feeds, default false");
+DEFINE_int32(native_file_reader_thread_num,
+             0,
+             "the number of threads reading one local file in process instead "
+             "of through the pipe command in the in-memory data feeds, 0 "
+             "disables the native reader, default 0");
+DEFINE_bool(enable_slotrecord_columnar_feed,
+            false,
+            "build the slot values of SlotRecordDataset into per-slot columns "
+            "when training is prepared, and feed the minibatches as slices "
+            "of the columns instead of copying the records, the columns "
+            "take as much memory as the slot values of the records, default "
+            "false");
 PADDLE_DEFINE_EXPORTED_bool(
     gpugraph_enable_hbm_table_collision_stat,
     false,
@@ -992,6 +1041,20 @@ PADDLE_DEFINE_EXPORTED_bool(gpugraph_load_node_list_into_hbm,
 PADDLE_DEFINE_EXPORTED_bool(nccl_blocking_wait, false, "nccl blocking wait");
 #endif
 
+/**
+ * CPU related FLAG
+ * Name: FLAGS_intra_op_num_threads
+ * Since Version: 2.4.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_intra_op_num_threads=8 allows a CPU kernel to run on 8
+ * threads of the intra-op thread pool.
+ * Note: The inference predictors use the cpu_math_library_num_threads of
+ * their configs instead.
+ */
+PADDLE_DEFINE_EXPORTED_int32(intra_op_num_threads,
+                             1,
+                             "The number of threads a CPU kernel runs on.");
+
 /**
  * Autotune related FLAG
  * Name: FLAGS_use_autotune
@@ -1001,6 +1064,20 @@ PADDLE_DEFINE_EXPORTED_bool(nccl_blocking_wait, false, "nccl blocking wait");
  */
 PADDLE_DEFINE_EXPORTED_bool(use_autotune, false, "Whether enable autotune.");
 
+/**
+ * Autotune related FLAG
+ * Name: FLAGS_autotune_cache_file
+ * Since Version: 2.4.0
+ * Value Range: string, default=""
+ * Example: FLAGS_autotune_cache_file=/path/to/autotune_cache saves the tuned
+ * algorithms to the file when the autotune range is over, and loads them
+ * when autotune is enabled or a predictor is created.
+ * Note: The file can only be loaded by the same build of Paddle.
+ */
+PADDLE_DEFINE_EXPORTED_string(autotune_cache_file,
+                              "",
+                              "The file to save and load the autotune cache.");
+
 /**
  * Conv Search cache max number related FLAG
  * Name: FLAGS_search_cache_max_number
@@ -1043,6 +1120,59 @@ PADDLE_DEFINE_EXPORTED_string(jit_engine_type,
                               "Predictor",
                               "Choose default funciton type in JitLayer.");
 
+/**
+ * Model saving related FLAG
+ * Name: FLAGS_save_combine_data_alignment
+ * Since Version: 2.5.0
+ * Value Range: int32, [0, 128], default=0
+ * Example:
+ * Note: If not 0, save_combine pads the header of every tensor so that its
+ * data starts at a multiple of this many bytes in the params file. Such data
+ * can be used in place by FLAGS_load_combine_with_mmap. Older versions of
+ * Paddle still load the padded files.
+ */
+PADDLE_DEFINE_EXPORTED_int32(
+    save_combine_data_alignment,
+    0,
+    "Align the data of the tensors saved by save_combine to this many bytes, "
+    "0 means unaligned.");
+
+/**
+ * Model loading related FLAG
+ * Name: FLAGS_load_combine_with_mmap
+ * Since Version: 2.5.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, load_combine on CPU and jit::Load map the params file
+ * instead of reading it. The tensors whose data are aligned in the file,
+ * see FLAGS_save_combine_data_alignment, use the mapped pages in place: the
+ * processes loading the same model share them through the page cache, and
+ * only the pages touched are read from disk. The mapping is copy-on-write,
+ * so writing such a tensor never changes the file, which must not be
+ * truncated while it is mapped. Not supported on Windows.
+ */
+PADDLE_DEFINE_EXPORTED_bool(load_combine_with_mmap,
+                            false,
+                            "Map the params file in load_combine on CPU.");
+
+/**
+ * Monitor related FLAG
+ * Name: FLAGS_enable_latency_histogram
+ * Since Version: 2.5.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, the new executor records the latency of every operator to
+ * paddle_op_latency_seconds{op_type=...}, and AnalysisPredictor::ZeroCopyRun
+ * records its latency to paddle_predictor_run_latency_seconds{model=...}.
+ * The operator latency is the host time, which only covers the device time
+ * with FLAGS_benchmark. See platform::MetricRegistry::ExportPrometheus for
+ * the export.
+ */
+PADDLE_DEFINE_EXPORTED_bool(enable_latency_histogram,
+                            false,
+                            "Record the latency histograms of the operators "
+                            "and the predictor runs.");
+
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
 /**
  * CUDNNv8 related FLAG
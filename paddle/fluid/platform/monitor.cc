@@ -14,8 +14,263 @@
 
 #include "paddle/fluid/platform/monitor.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
 namespace paddle {
-namespace platform {}  // namespace platform
+namespace platform {
+
+namespace {
+
+// The power of two buckets exported to Prometheus, in ns
+constexpr int kMinExportedExponent = 10;
+constexpr int kMaxExportedExponent = 36;
+
+int FloorLog2(uint64_t x) {
+#if !defined(_WIN32)
+  return 63 - __builtin_clzll(x);
+#else
+  int e = 0;
+  while (x >>= 1) ++e;
+  return e;
+#endif
+}
+
+uint64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string FormatDouble(double value) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.10g", value);
+  return buf;
+}
+
+// name{labels,extra}
+std::string Series(const std::string& name,
+                   const std::string& labels,
+                   const std::string& extra = "") {
+  if (labels.empty() && extra.empty()) return name;
+  std::string series = name + "{" + labels;
+  if (!labels.empty() && !extra.empty()) series += ",";
+  return series + extra + "}";
+}
+
+void AppendHeader(const std::string& name,
+                  const std::string& help,
+                  const std::string& type,
+                  std::string* out) {
+  *out += "# HELP " + name + " " + help + "\n";
+  *out += "# TYPE " + name + " " + type + "\n";
+}
+
+template <typename T>
+void AppendStats(std::string* out) {
+  for (const auto& stat : StatRegistry<T>::Instance().publish()) {
+    std::string name = "paddle_" + stat.key;
+    AppendHeader(name, "The StatRegistry value " + stat.key, "gauge", out);
+    *out += name + " " + FormatDouble(static_cast<double>(stat.value)) + "\n";
+  }
+}
+
+}  // namespace
+
+LatencyHistogram::Shard::Shard() {
+  for (auto& count : counts) count.store(0, std::memory_order_relaxed);
+  sum_ns.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::LatencyHistogram() {
+  for (auto& shard : shards_) shard.store(nullptr, std::memory_order_relaxed);
+}
+
+LatencyHistogram::~LatencyHistogram() {
+  for (auto& shard : shards_) delete shard.load();
+}
+
+int LatencyHistogram::BucketIndex(uint64_t ns) {
+  if (ns < kSubBuckets) return static_cast<int>(ns);
+  int exponent = FloorLog2(ns);
+  if (exponent >= kMaxExponent) return kNumBuckets - 1;
+  int sub_bucket = (ns >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+  return (exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(int index) {
+  if (index < kSubBuckets) return index;
+  int exponent = index / kSubBuckets + kSubBucketBits - 1;
+  uint64_t sub_bucket = index % kSubBuckets;
+  return (kSubBuckets + sub_bucket) << (exponent - kSubBucketBits);
+}
+
+void LatencyHistogram::Record(uint64_t ns) {
+  static std::atomic<int> next_slot{0};
+  static thread_local int slot =
+      next_slot.fetch_add(1, std::memory_order_relaxed) % kMaxShards;
+  Shard* shard = shards_[slot].load(std::memory_order_acquire);
+  if (shard == nullptr) {
+    Shard* created = new Shard();
+    if (shards_[slot].compare_exchange_strong(shard, created)) {
+      shard = created;
+    } else {
+      // Another thread of the slot won, shard is its one now
+      delete created;
+    }
+  }
+  shard->counts[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+  shard->sum_ns.fetch_add(ns, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.counts.assign(kNumBuckets, 0);
+  for (const auto& slot : shards_) {
+    const Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard == nullptr) continue;
+    for (int i = 0; i < kNumBuckets; ++i) {
+      uint64_t count = shard->counts[i].load(std::memory_order_relaxed);
+      snapshot.counts[i] += count;
+      snapshot.count += count;
+    }
+    snapshot.sum_ns += shard->sum_ns.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+double LatencyHistogram::Snapshot::Quantile(double q) const {
+  if (count == 0) return 0;
+  uint64_t rank = static_cast<uint64_t>(
+      std::ceil(std::min(std::max(q, 0.0), 1.0) * count));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return (BucketLowerBound(i) + BucketLowerBound(i + 1)) / 2.0;
+    }
+  }
+  return static_cast<double>(BucketLowerBound(kNumBuckets));
+}
+
+ScopedLatencyRecorder::ScopedLatencyRecorder(LatencyHistogram* histogram)
+    : histogram_(histogram) {
+  if (histogram_ != nullptr) start_ns_ = SteadyNowNs();
+}
+
+ScopedLatencyRecorder::~ScopedLatencyRecorder() {
+  if (histogram_ != nullptr) histogram_->Record(SteadyNowNs() - start_ns_);
+}
+
+std::string PrometheusLabel(const std::string& key, const std::string& value) {
+  std::string label = key + "=\"";
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      label += '\\';
+      label += c;
+    } else if (c == '\n') {
+      label += "\\n";
+    } else {
+      label += c;
+    }
+  }
+  return label + "\"";
+}
+
+MetricRegistry& MetricRegistry::Instance() {
+  static MetricRegistry registry;
+  return registry;
+}
+
+LatencyHistogram* MetricRegistry::GetHistogram(const std::string& name,
+                                               const std::string& help,
+                                               const std::string& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& family = histograms_[name];
+  if (family.help.empty()) family.help = help;
+  auto& histogram = family.series[labels];
+  if (histogram == nullptr) histogram.reset(new LatencyHistogram());
+  return histogram.get();
+}
+
+void MetricRegistry::RegisterGauge(const std::string& name,
+                                   const std::string& help,
+                                   GaugeCollector collector) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& family = gauges_[name];
+  if (family.help.empty()) family.help = help;
+  family.collectors.emplace_back(std::move(collector));
+}
+
+std::string MetricRegistry::ExportPrometheus() {
+  struct HistogramSeries {
+    std::string name;
+    std::string help;
+    std::string labels;
+    const LatencyHistogram* histogram;
+  };
+  std::vector<HistogramSeries> histograms;
+  std::map<std::string, GaugeFamily> gauges;
+  {
+    // The collectors may take their own locks, so call them unlocked
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& family : histograms_) {
+      for (const auto& item : family.second.series) {
+        histograms.push_back({family.first,
+                              family.second.help,
+                              item.first,
+                              item.second.get()});
+      }
+    }
+    gauges = gauges_;
+  }
+
+  std::string out;
+  for (size_t i = 0; i < histograms.size(); ++i) {
+    const auto& series = histograms[i];
+    const std::string& name = series.name;
+    if (i == 0 || histograms[i - 1].name != name) {
+      AppendHeader(name, series.help, "histogram", &out);
+    }
+    auto snapshot = series.histogram->GetSnapshot();
+    uint64_t cumulative = 0;
+    int bucket = 0;
+    for (int e = kMinExportedExponent; e <= kMaxExportedExponent; ++e) {
+      int end = LatencyHistogram::BucketIndex(uint64_t(1) << e);
+      for (; bucket < end; ++bucket) cumulative += snapshot.counts[bucket];
+      out += Series(name + "_bucket",
+                    series.labels,
+                    PrometheusLabel("le", FormatDouble(std::ldexp(1e-9, e))));
+      out += " " + std::to_string(cumulative) + "\n";
+    }
+    out +=
+        Series(name + "_bucket", series.labels, PrometheusLabel("le", "+Inf"));
+    out += " " + std::to_string(snapshot.count) + "\n";
+    out += Series(name + "_sum", series.labels) + " " +
+           FormatDouble(snapshot.sum_ns * 1e-9) + "\n";
+    out += Series(name + "_count", series.labels) + " " +
+           std::to_string(snapshot.count) + "\n";
+  }
+
+  GaugeSamples samples;
+  for (const auto& kv : gauges) {
+    samples.clear();
+    for (const auto& collector : kv.second.collectors) collector(&samples);
+    AppendHeader(kv.first, kv.second.help, "gauge", &out);
+    for (const auto& sample : samples) {
+      out += Series(kv.first, sample.first) + " " +
+             FormatDouble(sample.second) + "\n";
+    }
+  }
+
+  AppendStats<int64_t>(&out);
+  AppendStats<float>(&out);
+  return out;
+}
+
+}  // namespace platform
 }  // namespace paddle
 
 DEFINE_INT_STATUS(STAT_total_feasign_num_in_mem)
@@ -17,6 +17,8 @@
 #include <stdio.h>
 
 #include <atomic>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
@@ -127,6 +129,120 @@ class StatRegistry {
   std::unordered_map<std::string, StatValue<T>*> stats_;
 };
 
+/*
+ * A latency histogram with HDR-style log-linear buckets: every power of two
+ * of nanoseconds is split into kSubBuckets equal buckets, so a latency is
+ * kept within 12.5% from 1 ns up to 2^kMaxExponent ns (about 18 minutes,
+ * longer ones go to the last bucket).
+ *
+ * Record is lock-free and cheap enough for every operator: each thread adds
+ * to its own shard with relaxed atomics, and only a reader sums the shards
+ * up. Threads beyond kMaxShards share the shards, which stays correct.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kMaxExponent = 40;
+  static constexpr int kNumBuckets =
+      (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+  static constexpr int kMaxShards = 32;
+
+  struct Snapshot {
+    std::vector<uint64_t> counts;  // of every bucket
+    uint64_t count{0};
+    uint64_t sum_ns{0};
+
+    // The latency in ns that a fraction q of the samples do not exceed,
+    // estimated by the middle of its bucket. 0 if there is no sample.
+    double Quantile(double q) const;
+  };
+
+  LatencyHistogram();
+  ~LatencyHistogram();
+
+  void Record(uint64_t ns);
+
+  Snapshot GetSnapshot() const;
+
+  static int BucketIndex(uint64_t ns);
+  // The bucket index covers [BucketLowerBound(index),
+  // BucketLowerBound(index + 1)) ns.
+  static uint64_t BucketLowerBound(int index);
+
+ private:
+  struct Shard {
+    Shard();
+    std::atomic<uint64_t> counts[kNumBuckets];
+    std::atomic<uint64_t> sum_ns;
+  };
+
+  std::atomic<Shard*> shards_[kMaxShards];
+
+  DISABLE_COPY_AND_ASSIGN(LatencyHistogram);
+};
+
+// Records the lifetime of the recorder to the histogram, if it is not null
+class ScopedLatencyRecorder {
+ public:
+  explicit ScopedLatencyRecorder(LatencyHistogram* histogram);
+  ~ScopedLatencyRecorder();
+
+ private:
+  LatencyHistogram* histogram_;
+  uint64_t start_ns_{0};
+};
+
+// key="value", escaped as the Prometheus text format requires
+std::string PrometheusLabel(const std::string& key, const std::string& value);
+
+/*
+ * The metrics to be scraped by a monitoring system: latency histograms,
+ * gauges that are evaluated on every export, and the values of
+ * StatRegistry<int64_t> and StatRegistry<float>.
+ */
+class MetricRegistry {
+ public:
+  // The label string, such as PrometheusLabel("device", "0"), and the value
+  using GaugeSamples = std::vector<std::pair<std::string, double>>;
+  using GaugeCollector = std::function<void(GaugeSamples*)>;
+
+  static MetricRegistry& Instance();
+
+  // The histogram of the series name{labels}, created on the first call.
+  // It lives as long as the process, so callers may keep the pointer.
+  LatencyHistogram* GetHistogram(const std::string& name,
+                                 const std::string& help,
+                                 const std::string& labels = "");
+
+  // collector adds the current samples of the gauge name on every export.
+  // It must not call back into the MetricRegistry.
+  void RegisterGauge(const std::string& name,
+                     const std::string& help,
+                     GaugeCollector collector);
+
+  // Everything in the Prometheus text exposition format. Histograms are in
+  // seconds, with a bucket for every power of two from 2^10 to 2^36 ns.
+  std::string ExportPrometheus();
+
+ private:
+  MetricRegistry() = default;
+  DISABLE_COPY_AND_ASSIGN(MetricRegistry);
+
+  struct HistogramFamily {
+    std::string help;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> series;
+  };
+  struct GaugeFamily {
+    std::string help;
+    std::vector<GaugeCollector> collectors;
+  };
+
+  std::mutex mutex_;
+  std::map<std::string, HistogramFamily> histograms_;
+  std::map<std::string, GaugeFamily> gauges_;
+};
+
 }  // namespace platform
 }  // namespace paddle
 
@@ -0,0 +1,98 @@
+//   Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/monitor.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace platform {
+
+TEST(LatencyHistogram, Buckets) {
+  for (int i = 0; i + 1 < LatencyHistogram::kNumBuckets; ++i) {
+    uint64_t lower = LatencyHistogram::BucketLowerBound(i);
+    uint64_t upper = LatencyHistogram::BucketLowerBound(i + 1);
+    ASSERT_LT(lower, upper);
+    ASSERT_EQ(LatencyHistogram::BucketIndex(lower), i);
+    ASSERT_EQ(LatencyHistogram::BucketIndex(upper - 1), i);
+    // Within 12.5%
+    ASSERT_LE((upper - lower) * 8, std::max<uint64_t>(lower, 8));
+  }
+  EXPECT_EQ(LatencyHistogram::BucketIndex(~uint64_t(0)),
+            LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogram, RecordFromThreads) {
+  auto* histogram = MetricRegistry::Instance().GetHistogram(
+      "paddle_test_latency_seconds",
+      "The test latency",
+      PrometheusLabel("op_type", "test\"op"));
+  EXPECT_EQ(histogram,
+            MetricRegistry::Instance().GetHistogram(
+                "paddle_test_latency_seconds",
+                "The test latency",
+                PrometheusLabel("op_type", "test\"op")));
+
+  // More threads than shards
+  std::vector<std::thread> threads;
+  for (int t = 0; t < LatencyHistogram::kMaxShards + 8; ++t) {
+    threads.emplace_back([histogram] {
+      for (uint64_t i = 1; i <= 1000; ++i) histogram->Record(i * 1000);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  auto snapshot = histogram->GetSnapshot();
+  uint64_t count = (LatencyHistogram::kMaxShards + 8) * 1000;
+  EXPECT_EQ(snapshot.count, count);
+  EXPECT_EQ(snapshot.sum_ns, count / 1000 * 500500000);
+  EXPECT_NEAR(snapshot.Quantile(0.5), 500000, 500000 * 0.125);
+  EXPECT_NEAR(snapshot.Quantile(0.99), 990000, 990000 * 0.125);
+  EXPECT_EQ(LatencyHistogram::Snapshot().Quantile(0.5), 0);
+}
+
+TEST(MetricRegistry, ExportPrometheus) {
+  auto* histogram = MetricRegistry::Instance().GetHistogram(
+      "paddle_test_export_seconds", "The test latency");
+  histogram->Record(1500);
+  histogram->Record(3000000000);
+  MetricRegistry::Instance().RegisterGauge(
+      "paddle_test_gauge",
+      "The test gauge",
+      [](MetricRegistry::GaugeSamples* samples) {
+        samples->emplace_back(PrometheusLabel("device", "0"), 42);
+      });
+
+  std::string text = MetricRegistry::Instance().ExportPrometheus();
+  EXPECT_NE(text.find("# TYPE paddle_test_export_seconds histogram\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_test_export_seconds_bucket{le=\"1.024e-06\"} 0"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_test_export_seconds_bucket{le=\"2.048e-06\"} 1"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_test_export_seconds_bucket{le=\"+Inf\"} 2"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_test_export_seconds_count 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_test_gauge{device=\"0\"} 42\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("paddle_test_latency_seconds_count{op_type=\"test\\\"op"),
+            std::string::npos);
+}
+
+}  // namespace platform
+}  // namespace paddle
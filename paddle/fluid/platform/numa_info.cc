@@ -0,0 +1,205 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/platform/numa_info.h"
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "glog/logging.h"
+
+namespace paddle {
+namespace platform {
+
+namespace {
+
+#if defined(__linux__)
+// Defined in <numaif.h>, which is shipped with libnuma. The syscalls are
+// called directly to avoid the dependency.
+constexpr int kMpolDefault = 0;
+constexpr int kMpolPreferred = 1;
+constexpr int kMaxNumaNodes = 1024;
+constexpr int kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT
+constexpr int kNodeMaskWords = kMaxNumaNodes / kBitsPerWord;
+
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+std::vector<int> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> cpus;
+  std::stringstream ss(cpu_list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto pos = range.find('-');
+    int first = std::stoi(range.substr(0, pos));
+    int last =
+        pos == std::string::npos ? first : std::stoi(range.substr(pos + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<std::vector<int>> LoadNumaTopology() {
+  std::vector<std::vector<int>> topology;
+  for (int node = 0; node < kMaxNumaNodes; ++node) {
+    std::ifstream fin("/sys/devices/system/node/node" + std::to_string(node) +
+                      "/cpulist");
+    if (!fin) {
+      break;
+    }
+    std::string cpu_list;
+    std::getline(fin, cpu_list);
+    topology.emplace_back(ParseCpuList(cpu_list));
+  }
+  VLOG(3) << "Found " << topology.size() << " NUMA nodes";
+  return topology;
+}
+
+const std::vector<std::vector<int>>& GetNumaTopology() {
+  static std::vector<std::vector<int>> topology = LoadNumaTopology();
+  return topology;
+}
+#endif
+
+thread_local int g_current_numa_node = -1;
+
+}  // namespace
+
+int GetNumaNodeCount() {
+#if defined(__linux__)
+  int count = static_cast<int>(GetNumaTopology().size());
+  return count > 0 ? count : 1;
+#else
+  return 1;
+#endif
+}
+
+std::vector<int> GetNumaNodeCpus(int numa_node) {
+#if defined(__linux__)
+  const auto& topology = GetNumaTopology();
+  if (numa_node >= 0 && numa_node < static_cast<int>(topology.size())) {
+    return topology[numa_node];
+  }
+#endif
+  return {};
+}
+
+bool BindCurrentThreadToNumaNode(int numa_node) {
+#if defined(__linux__)
+  if (g_current_numa_node == numa_node) {
+    return true;
+  }
+  auto cpus = GetNumaNodeCpus(numa_node);
+  if (cpus.empty()) {
+    VLOG(1) << "NUMA node " << numa_node << " is not found, skip binding";
+    return false;
+  }
+
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &mask);
+  }
+  if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+    LOG(WARNING) << "Failed to bind thread to the CPUs of NUMA node "
+                 << numa_node;
+    return false;
+  }
+
+  unsigned long node_mask[kNodeMaskWords] = {0};  // NOLINT
+  node_mask[numa_node / kBitsPerWord] |= 1UL << (numa_node % kBitsPerWord);
+  // NOTE: the kernel takes maxnode - 1 bits of the mask
+  if (syscall(SYS_set_mempolicy,
+              kMpolPreferred,
+              node_mask,
+              kMaxNumaNodes + 1) != 0) {
+    VLOG(1) << "Failed to set the preferred memory node to " << numa_node;
+  }
+  g_current_numa_node = numa_node;
+  VLOG(4) << "Bind thread to NUMA node " << numa_node;
+  return true;
+#else
+  return false;
+#endif
+}
+
+int GetCurrentThreadNumaNode() { return g_current_numa_node; }
+
+int GetNextNumaNode() {
+  static std::atomic<int> next_node{0};
+  return next_node.fetch_add(1) % GetNumaNodeCount();
+}
+
+struct NumaBindingGuard::SavedState {
+  int numa_node{-1};
+#if defined(__linux__)
+  cpu_set_t cpu_mask;
+  int mem_policy{kMpolDefault};
+  unsigned long node_mask[kNodeMaskWords] = {0};  // NOLINT
+#endif
+};
+
+NumaBindingGuard::NumaBindingGuard(int numa_node) {
+#if defined(__linux__)
+  if (numa_node < 0 || numa_node == g_current_numa_node) {
+    return;
+  }
+  std::unique_ptr<SavedState> saved(new SavedState());
+  saved->numa_node = g_current_numa_node;
+  CPU_ZERO(&saved->cpu_mask);
+  if (sched_getaffinity(0, sizeof(saved->cpu_mask), &saved->cpu_mask) != 0 ||
+      syscall(SYS_get_mempolicy,
+              &saved->mem_policy,
+              saved->node_mask,
+              kMaxNumaNodes,
+              nullptr,
+              0) != 0) {
+    VLOG(1) << "Failed to get the CPU affinity or memory policy of thread, "
+               "skip binding";
+    return;
+  }
+  if (BindCurrentThreadToNumaNode(numa_node)) {
+    saved_ = std::move(saved);
+  }
+#endif
+}
+
+NumaBindingGuard::~NumaBindingGuard() {
+#if defined(__linux__)
+  if (saved_ == nullptr) {
+    return;
+  }
+  sched_setaffinity(0, sizeof(saved_->cpu_mask), &saved_->cpu_mask);
+  bool is_default = saved_->mem_policy == kMpolDefault;
+  syscall(SYS_set_mempolicy,
+          saved_->mem_policy,
+          is_default ? nullptr : saved_->node_mask,
+          is_default ? 0 : kMaxNumaNodes + 1);
+  g_current_numa_node = saved_->numa_node;
+#endif
+}
+
+}  // namespace platform
+}  // namespace paddle
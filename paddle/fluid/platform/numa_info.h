@@ -0,0 +1,57 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "paddle/fluid/platform/macros.h"
+
+namespace paddle {
+namespace platform {
+
+//! Get the number of NUMA nodes, 1 if the topology is unknown.
+int GetNumaNodeCount();
+
+//! Get the CPUs of a NUMA node, empty if the topology is unknown.
+std::vector<int> GetNumaNodeCpus(int numa_node);
+
+//! Bind the current thread to the CPUs of numa_node, and make the memory
+//! touched by the thread preferred to be allocated from numa_node.
+//! Return false if the binding is not supported or fails.
+bool BindCurrentThreadToNumaNode(int numa_node);
+
+//! Get the NUMA node bound by BindCurrentThreadToNumaNode, or -1.
+int GetCurrentThreadNumaNode();
+
+//! Get a NUMA node in round-robin, used to spread predictors across nodes.
+int GetNextNumaNode();
+
+//! Bind the current thread to numa_node in the scope, and restore the CPU
+//! affinity and memory policy of the thread on destruction.
+class NumaBindingGuard {
+ public:
+  explicit NumaBindingGuard(int numa_node);
+  ~NumaBindingGuard();
+
+ private:
+  struct SavedState;
+  std::unique_ptr<SavedState> saved_;
+
+  DISABLE_COPY_AND_ASSIGN(NumaBindingGuard);
+};
+
+}  // namespace platform
+}  // namespace paddle
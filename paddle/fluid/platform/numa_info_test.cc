@@ -0,0 +1,39 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/platform/numa_info.h"
+
+#include "gtest/gtest.h"
+
+TEST(NumaInfo, Topology) {
+  int count = paddle::platform::GetNumaNodeCount();
+  EXPECT_GE(count, 1);
+  for (int i = 0; i < count * 2; ++i) {
+    int node = paddle::platform::GetNextNumaNode();
+    EXPECT_GE(node, 0);
+    EXPECT_LT(node, count);
+  }
+  EXPECT_TRUE(paddle::platform::GetNumaNodeCpus(count).empty());
+  EXPECT_FALSE(paddle::platform::BindCurrentThreadToNumaNode(count));
+}
+
+TEST(NumaInfo, BindingGuard) {
+  EXPECT_EQ(paddle::platform::GetCurrentThreadNumaNode(), -1);
+  {
+    paddle::platform::NumaBindingGuard guard(0);
+    int node = paddle::platform::GetCurrentThreadNumaNode();
+    EXPECT_TRUE(node == 0 || node == -1);
+  }
+  EXPECT_EQ(paddle::platform::GetCurrentThreadNumaNode(), -1);
+}
@@ -23,6 +23,7 @@ limitations under the License. */
 #include "paddle/fluid/platform/device_tracer.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/profiler/common_event.h"
+#include "paddle/fluid/platform/profiler/flight_recorder.h"
 #include "paddle/fluid/platform/profiler/host_event_recorder.h"
 #include "paddle/fluid/platform/profiler/host_tracer.h"
 #include "paddle/fluid/platform/profiler/profiler.h"
@@ -91,6 +92,12 @@ RecordEvent::RecordEvent(const char *name,
   }
 #endif
 #endif
+  if (UNLIKELY(FlightRecorder::NeedRecord(level))) {
+    is_flight_ = true;
+    shallow_copy_name_ = name;
+    type_ = type;
+    start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -125,6 +132,12 @@ RecordEvent::RecordEvent(const std::string &name,
   }
 #endif
 #endif
+  if (UNLIKELY(FlightRecorder::NeedRecord(level))) {
+    is_flight_ = true;
+    flight_name_ = new std::string(name);
+    type_ = type;
+    start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -159,6 +172,12 @@ RecordEvent::RecordEvent(const std::string &name,
 #endif
 #endif
 
+  if (UNLIKELY(FlightRecorder::NeedRecord(level))) {
+    is_flight_ = true;
+    flight_name_ = new std::string(name);
+    type_ = type;
+    start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -206,6 +225,17 @@ void RecordEvent::End() {
   }
 #endif
 #endif
+  if (UNLIKELY(is_flight_)) {
+    FlightRecorder::GetInstance().Record(
+        flight_name_ != nullptr ? flight_name_->c_str() : shallow_copy_name_,
+        start_ns_,
+        PosixInNsec(),
+        type_);
+    delete flight_name_;
+    flight_name_ = nullptr;
+    // use this flag to avoid double End();
+    is_flight_ = false;
+  }
   if (LIKELY(FLAGS_enable_host_event_recorder_hook && is_enabled_)) {
     uint64_t end_ns = PosixInNsec();
     if (LIKELY(shallow_copy_name_ != nullptr)) {
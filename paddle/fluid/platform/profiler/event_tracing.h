@@ -109,6 +109,10 @@ class RecordEvent {
   TracerEventType type_{TracerEventType::UserDefined};
   std::string* attr_{nullptr};
   bool finished_{false};
+  // Set if the event goes to the FlightRecorder as well. The name is
+  // shallow_copy_name_, or flight_name_ if it is a std::string.
+  bool is_flight_{false};
+  std::string* flight_name_{nullptr};
 };
 
 }  // namespace platform
@@ -0,0 +1,319 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/profiler/flight_recorder.h"
+
+#ifndef _WIN32
+#include <signal.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/flags.h"
+#include "paddle/fluid/platform/os_info.h"
+#include "paddle/fluid/platform/profiler/extra_info.h"
+#include "paddle/fluid/platform/profiler/profiler.h"
+#include "paddle/fluid/platform/profiler/trace_event_collector.h"
+#include "paddle/fluid/platform/profiler/utils.h"
+
+// Works like host_trace_level, but for the flight recorder, and it does not
+// need a running Profiler. -1 disables the flight recorder.
+PADDLE_DEFINE_EXPORTED_int64(
+    flight_recorder_trace_level,
+    -1,
+    "RecordEvent is kept by the flight recorder if "
+    "flight_recorder_trace_level >= level, -1 to disable it.");
+PADDLE_DEFINE_EXPORTED_int64(
+    flight_recorder_events_per_thread,
+    8192,
+    "The number of latest events the flight recorder keeps for each thread.");
+PADDLE_DEFINE_EXPORTED_string(
+    flight_recorder_dump_dir,
+    ".",
+    "The directory of the flight recorder dumps made by signal or SLO.");
+PADDLE_DEFINE_EXPORTED_double(
+    flight_recorder_dump_seconds,
+    10.0,
+    "A flight recorder dump made by signal or SLO covers the events that "
+    "ended in the last flight_recorder_dump_seconds seconds.");
+PADDLE_DEFINE_EXPORTED_string(
+    flight_recorder_dump_format,
+    "json",
+    "The format of the flight recorder dumps made by signal or SLO, json "
+    "for chrome tracing or pb for nodetree.proto.");
+PADDLE_DEFINE_EXPORTED_int32(
+    flight_recorder_dump_signal,
+    0,
+    "The flight recorder dumps when the process receives this signal, e.g. "
+    "12 for SIGUSR2. 0 disables it.");
+PADDLE_DEFINE_EXPORTED_double(
+    flight_recorder_slo_ms,
+    0.0,
+    "The flight recorder dumps when an event named flight_recorder_slo_event "
+    "takes more than flight_recorder_slo_ms milliseconds. 0 disables it.");
+PADDLE_DEFINE_EXPORTED_string(
+    flight_recorder_slo_event,
+    "AnalysisPredictor::ZeroCopyRun",
+    "The name of the event whose latency is checked against "
+    "flight_recorder_slo_ms.");
+
+namespace paddle {
+namespace platform {
+
+namespace {
+
+constexpr size_t kMaxEventNameLength = 64;
+
+// Requested by the signal handler, see FlightRecorder::RequestDump
+std::atomic<bool>* g_signal_dump_requested = nullptr;
+
+#ifndef _WIN32
+void HandleDumpSignal(int signum) {
+  if (g_signal_dump_requested != nullptr) {
+    g_signal_dump_requested->store(true);
+  }
+}
+#endif
+
+}  // namespace
+
+struct FlightEvent {
+  char name[kMaxEventNameLength];
+  uint64_t start_ns;
+  uint64_t end_ns;
+  TracerEventType type;
+};
+
+// The events of one thread. The owner thread writes, a dump reads, so the
+// mutex is almost never contended.
+struct FlightRing {
+  std::mutex mutex;
+  std::vector<FlightEvent> events;
+  // The number of events ever recorded, events[next % size] is the oldest
+  uint64_t next{0};
+  uint64_t thread_id{0};
+  std::string thread_name;
+};
+
+FlightRecorder& FlightRecorder::GetInstance() {
+  static FlightRecorder instance;
+  return instance;
+}
+
+FlightRecorder::FlightRecorder() {
+#ifndef _WIN32
+  if (FLAGS_flight_recorder_dump_signal > 0) {
+    StartDumpThread();
+    g_signal_dump_requested = &dump_requested_;
+    struct sigaction sig_action;
+    memset(&sig_action, 0, sizeof(sig_action));
+    sigemptyset(&sig_action.sa_mask);
+    sig_action.sa_handler = HandleDumpSignal;
+    sig_action.sa_flags = SA_RESTART;
+    sigaction(FLAGS_flight_recorder_dump_signal, &sig_action, NULL);
+    VLOG(1) << "The flight recorder dumps on signal "
+            << FLAGS_flight_recorder_dump_signal;
+  }
+#endif
+}
+
+FlightRecorder::~FlightRecorder() {
+  g_signal_dump_requested = nullptr;
+  stop_.store(true);
+  dump_cv_.notify_all();
+  if (dump_thread_.joinable()) {
+    dump_thread_.join();
+  }
+}
+
+FlightRing* FlightRecorder::CurrentRing() {
+  // Both the thread and rings_ own the ring, so that the events of an exited
+  // thread can still be dumped.
+  static thread_local std::shared_ptr<FlightRing> ring;
+  if (UNLIKELY(ring == nullptr)) {
+    ring = std::make_shared<FlightRing>();
+    ring->events.resize(static_cast<size_t>(
+        std::max<int64_t>(FLAGS_flight_recorder_events_per_thread, 1)));
+    ring->thread_id = GetCurrentThreadSysId();
+    ring->thread_name = GetCurrentThreadName();
+    std::lock_guard<std::mutex> guard(rings_mutex_);
+    // Forget the exited threads, or thread pools that come and go would make
+    // rings_ grow without bound.
+    rings_.erase(std::remove_if(rings_.begin(),
+                                rings_.end(),
+                                [](const std::shared_ptr<FlightRing>& r) {
+                                  return r.use_count() == 1;
+                                }),
+                 rings_.end());
+    rings_.push_back(ring);
+  }
+  return ring.get();
+}
+
+void FlightRecorder::Record(const char* name,
+                            uint64_t start_ns,
+                            uint64_t end_ns,
+                            TracerEventType type) {
+  FlightRing* ring = CurrentRing();
+  {
+    std::lock_guard<std::mutex> guard(ring->mutex);
+    auto& event = ring->events[ring->next % ring->events.size()];
+    strncpy(event.name, name, kMaxEventNameLength - 1);
+    event.name[kMaxEventNameLength - 1] = '\0';
+    event.start_ns = start_ns;
+    event.end_ns = end_ns;
+    event.type = type;
+    ++ring->next;
+  }
+
+  if (UNLIKELY(FLAGS_flight_recorder_slo_ms > 0 &&
+               end_ns - start_ns > FLAGS_flight_recorder_slo_ms * 1e6 &&
+               FLAGS_flight_recorder_slo_event == name)) {
+    // At most one dump per window, so that the dumps do not overlap
+    uint64_t last = last_slo_dump_ns_.load();
+    uint64_t window_ns =
+        static_cast<uint64_t>(FLAGS_flight_recorder_dump_seconds * 1e9);
+    if (end_ns >= last + window_ns &&
+        last_slo_dump_ns_.compare_exchange_strong(last, end_ns)) {
+      LOG(WARNING) << name << " took " << (end_ns - start_ns) / 1e6
+                   << " ms, more than FLAGS_flight_recorder_slo_ms="
+                   << FLAGS_flight_recorder_slo_ms
+                   << ", dump the flight recorder.";
+      RequestDump();
+    }
+  }
+}
+
+std::unique_ptr<ProfilerResult> FlightRecorder::Collect(double seconds) {
+  uint64_t since = 0;
+  if (seconds > 0) {
+    uint64_t now = PosixInNsec();
+    since = now - std::min(now, static_cast<uint64_t>(seconds * 1e9));
+  }
+  std::vector<std::shared_ptr<FlightRing>> rings;
+  {
+    std::lock_guard<std::mutex> guard(rings_mutex_);
+    rings = rings_;
+  }
+
+  TraceEventCollector collector;
+  uint64_t process_id = GetProcessId();
+  std::vector<FlightEvent> events;
+  for (auto& ring : rings) {
+    events.clear();
+    {
+      std::lock_guard<std::mutex> guard(ring->mutex);
+      uint64_t size = ring->events.size();
+      uint64_t begin = ring->next > size ? ring->next - size : 0;
+      for (uint64_t i = begin; i < ring->next; ++i) {
+        const auto& event = ring->events[i % size];
+        if (event.end_ns >= since) {
+          events.push_back(event);
+        }
+      }
+    }
+    if (ring->thread_name != kDefaultThreadName) {
+      collector.AddThreadName(ring->thread_id, ring->thread_name);
+    }
+    for (const auto& event : events) {
+      collector.AddHostEvent(HostTraceEvent(event.name,
+                                            event.type,
+                                            event.start_ns,
+                                            event.end_ns,
+                                            process_id,
+                                            ring->thread_id));
+    }
+  }
+
+  std::unique_ptr<NodeTrees> tree(
+      new NodeTrees(collector.HostEvents(),
+                    collector.RuntimeEvents(),
+                    collector.DeviceEvents(),
+                    collector.MemEvents(),
+                    collector.OperatorSupplementEvents()));
+  ExtraInfo extrainfo;
+  for (const auto& kv : collector.ThreadNames()) {
+    extrainfo.AddExtraInfo(string_format(std::string("%llu"), kv.first),
+                           std::string("%s"),
+                           kv.second.c_str());
+  }
+  std::unique_ptr<ProfilerResult> result(
+      new ProfilerResult(std::move(tree), extrainfo));
+  result->SetVersion(std::string(Profiler::version));
+  result->SetSpanIndx(0);
+  return result;
+}
+
+void FlightRecorder::Dump(const std::string& file_name,
+                          double seconds,
+                          const std::string& format) {
+  PADDLE_ENFORCE_EQ(
+      format == "json" || format == "pb",
+      true,
+      platform::errors::InvalidArgument(
+          "The flight recorder dumps as json or pb, but received %s.",
+          format));
+  Collect(seconds)->Save(file_name, format);
+  VLOG(1) << "Dump the flight recorder to " << file_name;
+}
+
+void FlightRecorder::RequestDump() {
+  StartDumpThread();
+  dump_requested_.store(true);
+  dump_cv_.notify_one();
+}
+
+void FlightRecorder::StartDumpThread() {
+  std::call_once(dump_thread_once_, [this] {
+    dump_thread_ = std::thread([this] { DumpLoop(); });
+  });
+}
+
+void FlightRecorder::DumpLoop() {
+  SetCurrentThreadName("FlightRecorderDump");
+  while (!stop_.load()) {
+    {
+      // A signal handler cannot notify, so poll as well
+      std::unique_lock<std::mutex> lock(dump_mutex_);
+      dump_cv_.wait_for(lock, std::chrono::milliseconds(100), [this] {
+        return stop_.load() || dump_requested_.load();
+      });
+    }
+    if (stop_.load() || !dump_requested_.exchange(false)) {
+      continue;
+    }
+    std::string file_name =
+        string_format(std::string("%s/flight_%u_%llu.%s"),
+                      FLAGS_flight_recorder_dump_dir.c_str(),
+                      GetProcessId(),
+                      static_cast<unsigned long long>(PosixInNsec()),  // NOLINT
+                      FLAGS_flight_recorder_dump_format.c_str());
+    try {
+      Dump(file_name,
+           FLAGS_flight_recorder_dump_seconds,
+           FLAGS_flight_recorder_dump_format);
+      LOG(INFO) << "The flight recorder is dumped to " << file_name;
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to dump the flight recorder to " << file_name
+                   << ": " << e.what();
+    }
+  }
+}
+
+}  // namespace platform
+}  // namespace paddle
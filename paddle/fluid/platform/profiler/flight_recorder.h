@@ -0,0 +1,105 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "paddle/fluid/platform/macros.h"
+#include "paddle/fluid/platform/profiler/event_python.h"
+#include "paddle/fluid/platform/profiler/trace_event.h"
+
+DECLARE_int64(flight_recorder_trace_level);
+
+namespace paddle {
+namespace platform {
+
+struct FlightRing;
+
+/*
+ * Keeps the latest host events of every thread in a fixed-size ring, so that
+ * a profile of the last seconds is at hand when something goes wrong, without
+ * starting a profiler beforehand.
+ *
+ * RecordEvent of level <= FLAGS_flight_recorder_trace_level goes here, with
+ * or without a running Profiler. Each thread overwrites its own ring of
+ * FLAGS_flight_recorder_events_per_thread events, so the memory and the cost
+ * per event stay bounded however long the process runs.
+ *
+ * The rings are dumped as a chrome trace (json) or as nodetree.proto (pb) by
+ * Dump, by FLAGS_flight_recorder_dump_signal, or when an event named
+ * FLAGS_flight_recorder_slo_event takes longer than
+ * FLAGS_flight_recorder_slo_ms. The last two dump in a background thread to
+ * FLAGS_flight_recorder_dump_dir.
+ */
+class FlightRecorder {
+ public:
+  static FlightRecorder& GetInstance();
+
+  // Checked by every RecordEvent, so keep it cheap
+  static bool NeedRecord(uint32_t level) {
+    return FLAGS_flight_recorder_trace_level >= static_cast<int64_t>(level);
+  }
+
+  // thread-safe, the name is copied
+  void Record(const char* name,
+              uint64_t start_ns,
+              uint64_t end_ns,
+              TracerEventType type);
+
+  // The kept events that ended in the last seconds, all of them if seconds
+  // is not positive. The rings are left as they are.
+  std::unique_ptr<ProfilerResult> Collect(double seconds);
+
+  // Collect and save to file_name, format is "json" or "pb"
+  void Dump(const std::string& file_name,
+            double seconds,
+            const std::string& format = std::string("json"));
+
+  // Ask the background thread for a dump. Async-signal-safe once the
+  // background thread is started, see StartDumpThread.
+  void RequestDump();
+
+  ~FlightRecorder();
+
+ private:
+  FlightRecorder();
+  DISABLE_COPY_AND_ASSIGN(FlightRecorder);
+
+  FlightRing* CurrentRing();
+  void StartDumpThread();
+  void DumpLoop();
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<FlightRing>> rings_;
+
+  std::once_flag dump_thread_once_;
+  std::thread dump_thread_;
+  std::mutex dump_mutex_;
+  std::condition_variable dump_cv_;
+  std::atomic<bool> dump_requested_{false};
+  std::atomic<bool> stop_{false};
+  std::atomic<uint64_t> last_slo_dump_ns_{0};
+};
+
+}  // namespace platform
+}  // namespace paddle
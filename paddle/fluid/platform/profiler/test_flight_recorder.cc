@@ -0,0 +1,68 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/profiler/flight_recorder.h"
+
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/platform/profiler/utils.h"
+
+DECLARE_int64(flight_recorder_events_per_thread);
+
+TEST(FlightRecorderTest, KeepLatestEvents) {
+  using paddle::platform::FlightRecorder;
+  using paddle::platform::PosixInNsec;
+  using paddle::platform::TracerEventType;
+  FLAGS_flight_recorder_events_per_thread = 4;
+  // A new thread gets a ring of the new size
+  std::thread worker([] {
+    for (int i = 0; i < 10; ++i) {
+      uint64_t start_ns = PosixInNsec();
+      FlightRecorder::GetInstance().Record(
+          ("TestFlightRecorder_" + std::to_string(i)).c_str(),
+          start_ns,
+          start_ns + 1000,
+          TracerEventType::UserDefined);
+    }
+  });
+  worker.join();
+
+  // The ring of an exited thread can still be collected
+  auto result = FlightRecorder::GetInstance().Collect(60);
+  std::set<std::string> host_events;
+  for (const auto& pair : result->GetNodeTrees()->Traverse(true)) {
+    for (const auto evt : pair.second) {
+      if (evt->Name().find("TestFlightRecorder_") == 0) {
+        host_events.insert(evt->Name());
+      }
+    }
+  }
+  EXPECT_EQ(host_events.size(), 4u);
+  EXPECT_EQ(host_events.count("TestFlightRecorder_5"), 0u);
+  EXPECT_EQ(host_events.count("TestFlightRecorder_6"), 1u);
+  EXPECT_EQ(host_events.count("TestFlightRecorder_9"), 1u);
+
+  FlightRecorder::GetInstance().Dump("test_flight_recorder.json", 60);
+  std::ifstream dumped("test_flight_recorder.json");
+  std::string content((std::istreambuf_iterator<char>(dumped)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_NE(content.find("TestFlightRecorder_9"), std::string::npos);
+  EXPECT_ANY_THROW(FlightRecorder::GetInstance().Dump(
+      "test_flight_recorder.txt", 60, "txt"));
+}
@@ -709,6 +709,10 @@ void BindAnalysisConfig(py::module *m) {
       .def("enable_memory_optim",
            &AnalysisConfig::EnableMemoryOptim,
            py::arg("x") = true)
+      .def("enable_memory_arena",
+           &AnalysisConfig::EnableMemoryArena,
+           py::arg("x") = true)
+      .def("memory_arena_enabled", &AnalysisConfig::memory_arena_enabled)
       .def("enable_profile", &AnalysisConfig::EnableProfile)
       .def("disable_glog_info", &AnalysisConfig::DisableGlogInfo)
       .def("glog_info_disabled", &AnalysisConfig::glog_info_disabled)
@@ -793,6 +797,19 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::SetCpuMathLibraryNumThreads)
       .def("cpu_math_library_num_threads",
            &AnalysisConfig::cpu_math_library_num_threads)
+      .def("enable_numa_binding",
+           &AnalysisConfig::EnableNumaBinding,
+           py::arg("numa_node") = -1)
+      .def("numa_binding_enabled", &AnalysisConfig::numa_binding_enabled)
+      .def("numa_node", &AnalysisConfig::numa_node)
+      .def("enable_gemm_weight_packing",
+           &AnalysisConfig::EnableGemmWeightPacking)
+      .def("gemm_weight_packing_enabled",
+           &AnalysisConfig::gemm_weight_packing_enabled)
+      .def("enable_optimized_model_cache",
+           &AnalysisConfig::EnableOptimizedModelCache)
+      .def("optimized_model_cache_enabled",
+           &AnalysisConfig::optimized_model_cache_enabled)
       .def("to_native_config", &AnalysisConfig::ToNativeConfig)
       .def("enable_quantizer", &AnalysisConfig::EnableMkldnnQuantizer)
       .def("enable_mkldnn_bfloat16", &AnalysisConfig::EnableMkldnnBfloat16)
@@ -85,6 +85,7 @@ limitations under the License. */
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/fluid/platform/profiler/event_python.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
+#include "paddle/fluid/platform/profiler/flight_recorder.h"
 #include "paddle/fluid/platform/profiler/profiler.h"
 #include "paddle/fluid/pybind/cuda_streams_py.h"
 #include "paddle/fluid/pybind/distributed_py.h"
@@ -1674,8 +1675,12 @@ All parameter, weight, gradient are variables in Paddle.
       .def(py::init<>())
       .def("total_time",
            [](interpreter::CostInfo &self) { return self.total_time; })
-      .def("device_memory_bytes", [](interpreter::CostInfo &self) {
-        return self.device_memory_bytes;
+      .def("device_memory_bytes",
+           [](interpreter::CostInfo &self) {
+             return self.device_memory_bytes;
+           })
+      .def("instruction_time", [](interpreter::CostInfo &self) {
+        return self.instruction_time;
       });
 
   py::class_<framework::StandaloneExecutor>(m, "StandaloneExecutor")
@@ -1774,6 +1779,9 @@ All parameter, weight, gradient are variables in Paddle.
     }
     return stats_map;
   });
+  m.def("export_metrics", []() {
+    return paddle::platform::MetricRegistry::Instance().ExportPrometheus();
+  });
   m.def("device_memory_stat_current_value",
         memory::DeviceMemoryStatCurrentValue);
   m.def("device_memory_stat_peak_value", memory::DeviceMemoryStatPeakValue);
@@ -2324,6 +2332,17 @@ All parameter, weight, gradient are variables in Paddle.
         &paddle::platform::EnableInputShapeRecorder);
   m.def("disable_input_shape_recorder",
         &paddle::platform::DisableInputShapeRecorder);
+  m.def(
+      "dump_flight_recorder",
+      [](const std::string &file_name,
+         double seconds,
+         const std::string &format) {
+        paddle::platform::FlightRecorder::GetInstance().Dump(
+            file_name, seconds, format);
+      },
+      py::arg("file_name"),
+      py::arg("seconds") = 0.0,
+      py::arg("format") = "json");
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   m.def("set_cublas_switch", platform::SetAllowTF32Cublas);
@@ -12,8 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#ifndef EIGEN_USE_THREADS
+#define EIGEN_USE_THREADS
+#endif
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 
@@ -22,8 +33,51 @@
 #include "paddle/phi/core/device_context.h"
 #include "unsupported/Eigen/CXX11/Tensor"
 
+DECLARE_int32(intra_op_num_threads);
+
 namespace phi {
 
+// The intra-op thread pool shared by all the CPUContexts, and the Eigen
+// devices on it for every parallelism. The pool is created on first use with
+// max(hardware concurrency, FLAGS_intra_op_num_threads) threads, and the
+// parallelism is limited to the pool size.
+class IntraOpThreadPool {
+ public:
+  static IntraOpThreadPool& Instance() {
+    static IntraOpThreadPool pool;
+    return pool;
+  }
+
+  int MaxThreads() const { return pool_.NumThreads(); }
+
+  // whether the calling thread is one of the pool
+  bool InPool() const { return pool_.CurrentThreadId() != -1; }
+
+  void Schedule(std::function<void()> fn) { pool_.Schedule(std::move(fn)); }
+
+  Eigen::ThreadPoolDevice* GetDevice(int num_threads) {
+    num_threads = std::min(num_threads, MaxThreads());
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& device = devices_[num_threads];
+    if (device == nullptr) {
+      device.reset(new Eigen::ThreadPoolDevice(&pool_, num_threads));
+    }
+    return device.get();
+  }
+
+ private:
+  IntraOpThreadPool()
+      : pool_(std::max(static_cast<int>(std::thread::hardware_concurrency()),
+                       FLAGS_intra_op_num_threads)) {}
+
+  Eigen::ThreadPool pool_;
+  std::mutex mutex_;
+  std::map<int, std::unique_ptr<Eigen::ThreadPoolDevice>> devices_;
+};
+
+// 0 means FLAGS_intra_op_num_threads
+static thread_local int intra_op_num_threads = 0;
+
 struct CPUContext::Impl {
   Impl() : place_(CPUPlace()) {}
 
@@ -79,4 +133,78 @@ void CPUContext::SetEigenDevice(Eigen::DefaultDevice* device) {
   impl_->eigen_device_ = device;
 }
 
+Eigen::ThreadPoolDevice* CPUContext::eigen_pool_device() const {
+  int num_threads = GetIntraOpNumThreads();
+  if (num_threads <= 1) {
+    return nullptr;
+  }
+  // the devices live as long as the pool, so they can be cached
+  thread_local int cached_num_threads = 0;
+  thread_local Eigen::ThreadPoolDevice* cached_device = nullptr;
+  if (cached_num_threads != num_threads) {
+    cached_device = IntraOpThreadPool::Instance().GetDevice(num_threads);
+    cached_num_threads = num_threads;
+  }
+  return cached_device;
+}
+
+void CPUContext::ParallelFor(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& fn) const {
+  if (begin >= end) {
+    return;
+  }
+  int64_t size = end - begin;
+  grain_size = std::max<int64_t>(grain_size, 1);
+  int64_t num_blocks = std::min<int64_t>(GetIntraOpNumThreads(),
+                                         (size + grain_size - 1) / grain_size);
+  if (num_blocks <= 1 || IntraOpThreadPool::Instance().InPool()) {
+    fn(begin, end);
+    return;
+  }
+  int64_t block_size = (size + num_blocks - 1) / num_blocks;
+  num_blocks = (size + block_size - 1) / block_size;
+
+  // the first block runs on the calling thread
+  std::vector<std::exception_ptr> errors(num_blocks);
+  Eigen::Barrier barrier(static_cast<unsigned int>(num_blocks - 1));
+  for (int64_t i = 1; i < num_blocks; ++i) {
+    int64_t block_begin = begin + i * block_size;
+    int64_t block_end = std::min(end, block_begin + block_size);
+    IntraOpThreadPool::Instance().Schedule(
+        [&fn, &errors, &barrier, i, block_begin, block_end] {
+          try {
+            fn(block_begin, block_end);
+          } catch (...) {
+            errors[i] = std::current_exception();
+          }
+          barrier.Notify();
+        });
+  }
+  try {
+    fn(begin, begin + block_size);
+  } catch (...) {
+    errors[0] = std::current_exception();
+  }
+  barrier.Wait();
+  for (auto& error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+void CPUContext::SetIntraOpNumThreads(int num_threads) {
+  intra_op_num_threads = std::max(num_threads, 1);
+}
+
+int CPUContext::GetIntraOpNumThreads() {
+  return intra_op_num_threads > 0 ? intra_op_num_threads
+                                  : std::max(FLAGS_intra_op_num_threads, 1);
+}
+
+bool CPUContext::UseIntraOpThreadPool() { return GetIntraOpNumThreads() > 1; }
+
 }  // namespace phi
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "paddle/phi/backends/cpu/forwards.h"
@@ -35,6 +36,30 @@ class PADDLE_API CPUContext : public DeviceContext,
   Eigen::DefaultDevice* eigen_device() const;
   const Place& GetPlace() const override;
 
+  // The Eigen device evaluating expressions by the intra-op thread pool, or
+  // nullptr if the intra-op parallelism of the calling thread is 1.
+  Eigen::ThreadPoolDevice* eigen_pool_device() const;
+
+  // Split [begin, end) into blocks of at least grain_size elements, and run
+  // fn(block_begin, block_end) on the blocks by the intra-op thread pool.
+  // fn runs on the calling thread only if the intra-op parallelism is 1, the
+  // range is not larger than grain_size, or ParallelFor is nested.
+  void ParallelFor(int64_t begin,
+                   int64_t end,
+                   int64_t grain_size,
+                   const std::function<void(int64_t, int64_t)>& fn) const;
+
+  // The intra-op parallelism of the calling thread, which is
+  // FLAGS_intra_op_num_threads by default. The thread pool is shared by all
+  // the CPUContexts, so that the predictors running on different threads
+  // can use different parallelism.
+  static void SetIntraOpNumThreads(int num_threads);
+  static int GetIntraOpNumThreads();
+  // Whether the intra-op parallelism of the calling thread is larger than 1.
+  // If not, the kernels which were parallelized by OpenMP keep using it
+  // instead of the serial ParallelFor.
+  static bool UseIntraOpThreadPool();
+
   static const char* name() { return "CPUContext"; }
 
  protected:
@@ -25,7 +25,8 @@ namespace phi {
 
 void SerializeToStream(std::ostream &os,
                        const DenseTensor &tensor,
-                       const DeviceContext &dev_ctx) {
+                       const DeviceContext &dev_ctx,
+                       size_t data_alignment) {
   {  // the 1st field, uint32_t version for DenseTensor
     os.write(
         reinterpret_cast<const char *>(&paddle::framework::kCurTensorVersion),
@@ -50,7 +51,7 @@ void SerializeToStream(std::ostream &os,
   }
   // the 3st field, Tensor
   paddle::framework::TensorToStream(
-      os, static_cast<DenseTensor>(tensor), dev_ctx);
+      os, static_cast<DenseTensor>(tensor), dev_ctx, data_alignment);
 }
 
 void DeserializeFromStream(std::istream &is,
@@ -27,7 +27,8 @@ namespace phi {
  */
 void SerializeToStream(std::ostream& os,
                        const DenseTensor& tensor,
-                       const DeviceContext& dev_ctx);
+                       const DeviceContext& dev_ctx,
+                       size_t data_alignment = 0);
 void DeserializeFromStream(std::istream& is,
                            DenseTensor* tensor,
                            const DeviceContext& dev_ctx);
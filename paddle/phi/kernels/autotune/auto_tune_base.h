@@ -14,14 +14,50 @@
 
 #pragma once
 
+#include <atomic>
 #include <type_traits>
 #include "glog/logging.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/autotune/cpu_timer.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 #include "paddle/phi/kernels/autotune/gpu_timer.h"
+#endif
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
 
 namespace phi {
 namespace autotune {
 
+// KernelTimer times the kernels launched on the stream of ctx with
+// GpuTimer, and the kernels of CPUContext with the host clock.
+template <typename Context>
+class KernelTimer {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+ public:
+  explicit KernelTimer(const Context& ctx) : stream_(ctx.stream()) {}
+
+  void Start() { timer_.Start(stream_); }
+  void Stop() { timer_.Stop(stream_); }
+  float ElapsedTime() { return timer_.ElapsedTime(); }
+
+ private:
+  gpuStream_t stream_;
+  phi::GpuTimer timer_;
+#endif
+};
+
+template <>
+class KernelTimer<phi::CPUContext> {
+ public:
+  explicit KernelTimer(const phi::CPUContext& ctx) {}
+
+  void Start() { timer_.Start(); }
+  void Stop() { timer_.Stop(); }
+  float ElapsedTime() { return timer_.ElapsedTime(); }
+
+ private:
+  phi::CpuTimer timer_;
+};
+
 template <typename T, typename ReturnType, typename... Args>
 class KernelCallback {
  public:
@@ -54,6 +90,8 @@ class AutoTuneBase {
     kernels_.push_back(/*default=*/kernel);
   }
 
+  // Not thread-safe with Run, so add the callbacks once before the first
+  // Run, e.g. in a std::call_once.
   template <typename ReturnType, typename... Args>
   void AddCallBack(ReturnType (*func)(Args...)) {
     if (!is_init_) {
@@ -70,16 +108,27 @@ class AutoTuneBase {
     PADDLE_ENFORCE_GT(
         kernels_.size(),
         0,
-        paddle::platform::errors::InvalidArgument(
+        phi::errors::InvalidArgument(
             "kernel num must be greater than 0, now is %d", kernels_.size()));
     is_init_ = true;
 
     auto& cache = AutoTuneCache::Instance().Get(algo);
+    bool use_autotune = AutoTuneStatus::Instance().UseAutoTune();
+    // Find locks the cache, keep it off the path of the untuned kernels
+    if (!use_autotune && cache.IsEmpty()) {
+      kernels_[0].Run(args...);
+      return;
+    }
     if (cache.Find(key)) {
       auto best_idx = cache.Get(key);
+      // The cache may be loaded from a file of another build
+      if (best_idx < 0 || static_cast<size_t>(best_idx) >= kernels_.size()) {
+        VLOG(3) << "The cached kernel " << best_idx << " is out of range ["
+                << 0 << ", " << kernels_.size() << "), run the default one.";
+        best_idx = 0;
+      }
       kernels_[best_idx].Run(args...);
     } else {
-      bool use_autotune = AutoTuneStatus::Instance().UseAutoTune();
       if (use_autotune) {
         // All avaliable kernels have ran while picking the best kernel,
         // so there may be no need for another kernel run.
@@ -92,7 +141,7 @@ class AutoTuneBase {
   }
 
  private:
-  bool is_init_{false};
+  std::atomic<bool> is_init_{false};
   std::vector<KernelType> kernels_;
   mutable std::mutex mutex_;
 
@@ -102,7 +151,7 @@ class AutoTuneBase {
     PADDLE_ENFORCE_GT(
         kernels_.size(),
         0,
-        paddle::platform::errors::InvalidArgument(
+        phi::errors::InvalidArgument(
             "kernel num must be greater than 0, now is %d", kernels_.size()));
     size_t best_idx = 0;
     float min_time = std::numeric_limits<float>::max();
@@ -124,15 +173,14 @@ class AutoTuneBase {
     // Regard 1st run as warmup, judge the compare result by the time cost
     // of rest cycles.
     constexpr int repeats = 4;
-    phi::GpuTimer timer;
+    KernelTimer<Context> timer(ctx);
     float time_cost = 0;
-    const auto& stream = ctx.stream();
 
     ctx.Wait();
     for (int i = 0; i < repeats; ++i) {
-      timer.Start(stream);
+      timer.Start();
       kernels_[idx].Run(args...);
-      timer.Stop(stream);
+      timer.Stop();
       auto time = timer.ElapsedTime();
       if (i > 0) {
         time_cost += time;
@@ -174,5 +222,29 @@ MakeTransposeTuner(ReturnType (*func)(Args...)) {
   return TransposeAutoTuner<T, ReturnType, Args...>::Instance(func);
 }
 
+template <typename T, typename ReturnType, typename... Args>
+class TopkAutoTuner
+    : public AutoTuneBase<T, KernelCallback<T, ReturnType, Args...>> {
+ public:
+  static AutoTuneBase<T, KernelCallback<T, ReturnType, Args...>>* Instance(
+      ReturnType (*func)(Args...)) {
+    static std::once_flag topk_init_flag_;
+    static std::unique_ptr<
+        AutoTuneBase<T, KernelCallback<T, ReturnType, Args...>>>
+        instance_;
+    std::call_once(topk_init_flag_, [&] {
+      auto obj = MakeCallback<T>(func);
+      instance_.reset(new AutoTuneBase<T, decltype(obj)>(obj));
+    });
+    return instance_.get();
+  }
+};
+
+template <typename T, typename ReturnType, typename... Args>
+static AutoTuneBase<T, KernelCallback<T, ReturnType, Args...>>* MakeTopkTuner(
+    ReturnType (*func)(Args...)) {
+  return TopkAutoTuner<T, ReturnType, Args...>::Instance(func);
+}
+
 }  // namespace autotune
 }  // namespace phi
@@ -14,7 +14,11 @@
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
+#include <random>
+#include <tuple>
 
 #include "glog/logging.h"
 
@@ -28,6 +32,20 @@ size_t TransposeKey(const std::vector<int64_t>& x_dims,
   return GetKey(x_dims, perm, rank, static_cast<int64_t>(dtype));
 }
 
+size_t TopkKey(int64_t input_height,
+               int64_t input_width,
+               int k,
+               bool largest,
+               bool sorted,
+               phi::DataType dtype) {
+  return GetKey(input_height,
+                input_width,
+                k,
+                largest,
+                sorted,
+                static_cast<int64_t>(dtype));
+}
+
 std::string AlgorithmTypeString(int64_t algo_type) {
   if (algo_type == static_cast<int64_t>(AlgorithmType::kConvForward)) {
     return "conv_forward";
@@ -37,6 +55,12 @@ std::string AlgorithmTypeString(int64_t algo_type) {
   } else if (algo_type ==
              static_cast<int64_t>(AlgorithmType::kConvBackwardFilter)) {
     return "conv_backward_filter";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kTranspose)) {
+    return "transpose";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kTransposeCPU)) {
+    return "transpose_cpu";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kTopkCPU)) {
+    return "topk_cpu";
   }
   return std::to_string(algo_type);
 }
@@ -76,5 +100,65 @@ void AutoTuneCache::UpdateStatus() {
   total_cache_misses_ = cache_misses;
 }
 
+// Every line of the file is "algo_type key algo".
+void AutoTuneCache::Save(const std::string& path) {
+  // Write to a temporary file and rename it, so that a process reading the
+  // cache never sees a partially written one.
+  std::string tmp_path = path + ".tmp" + std::to_string(std::random_device()());
+  std::ofstream fout(tmp_path);
+  PADDLE_ENFORCE_EQ(
+      fout.is_open(),
+      true,
+      phi::errors::Unavailable(
+          "Failed to open file %s to save the autotune cache.", tmp_path));
+  int64_t size = 0;
+  for (auto& v : auto_tune_map_) {
+    for (auto& item : v.second.GetAll()) {
+      fout << v.first << " " << item.first << " " << item.second << "\n";
+      ++size;
+    }
+  }
+  fout.close();
+  if (fout.fail() || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to save the autotune cache to " << path;
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  VLOG(3) << "Save " << size << " autotune results to " << path;
+}
+
+bool AutoTuneCache::Load(const std::string& path) {
+  std::ifstream fin(path);
+  if (!fin.is_open()) {
+    VLOG(3) << "The autotune cache file " << path << " does not exist.";
+    return false;
+  }
+  // Check the whole file before using any of it
+  std::vector<std::tuple<int64_t, size_t, int64_t>> results;
+  int64_t algo_type;
+  size_t key;
+  int64_t algo;
+  while (fin >> algo_type >> key >> algo) {
+    if (auto_tune_map_.find(algo_type) == auto_tune_map_.end() || algo < 0) {
+      LOG(WARNING) << "The autotune cache file " << path
+                   << " has an invalid algorithm " << algo_type << " " << algo
+                   << ", it is ignored.";
+      return false;
+    }
+    results.emplace_back(algo_type, key, algo);
+  }
+  if (!fin.eof()) {
+    LOG(WARNING) << "The autotune cache file " << path
+                 << " is broken, it is ignored.";
+    return false;
+  }
+  for (const auto& result : results) {
+    auto_tune_map_[std::get<0>(result)].Set(std::get<1>(result),
+                                            std::get<2>(result));
+  }
+  VLOG(3) << "Load " << results.size() << " autotune results from " << path;
+  return true;
+}
+
 }  // namespace autotune
 }  // namespace phi
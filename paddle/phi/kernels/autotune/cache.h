@@ -15,8 +15,11 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <numeric>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -206,10 +209,20 @@ size_t TransposeKey(const std::vector<int64_t>& x_dims,
                     const std::vector<int32_t>& perm,
                     phi::DataType dtype);
 
+size_t TopkKey(int64_t input_height,
+               int64_t input_width,
+               int k,
+               bool largest,
+               bool sorted,
+               phi::DataType dtype);
+
 template <typename AlgorithmT>
 class AlgorithmsCache {
  public:
-  AlgorithmsCache() : cache_mutex_(new std::mutex()) { hash_.clear(); }
+  AlgorithmsCache()
+      : cache_mutex_(new std::mutex()), size_(new std::atomic<int64_t>(0)) {
+    hash_.clear();
+  }
 
   AlgorithmT Get(const size_t& key) {
     std::lock_guard<std::mutex> lock(*cache_mutex_);
@@ -235,6 +248,7 @@ class AlgorithmsCache {
   void Clean() {
     std::lock_guard<std::mutex> lock(*cache_mutex_);
     hash_.clear();
+    size_->store(0, std::memory_order_relaxed);
     cache_hits_ = 0;
     cache_misses_ = 0;
   }
@@ -242,8 +256,12 @@ class AlgorithmsCache {
   void Set(const size_t& key, AlgorithmT algo) {
     std::lock_guard<std::mutex> lock(*cache_mutex_);
     hash_[key] = algo;
+    size_->store(hash_.size(), std::memory_order_relaxed);
   }
 
+  // Lock free, for the kernels to skip the cache when nothing is tuned
+  bool IsEmpty() const { return size_->load(std::memory_order_relaxed) == 0; }
+
   int64_t CacheMisses() const { return cache_misses_; }
 
   int64_t CacheHits() const { return cache_hits_; }
@@ -260,9 +278,15 @@ class AlgorithmsCache {
 
   int64_t Size() const { return hash_.size(); }
 
+  std::unordered_map<size_t, AlgorithmT> GetAll() {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    return hash_;
+  }
+
  private:
   std::unordered_map<size_t, AlgorithmT> hash_;
   std::shared_ptr<std::mutex> cache_mutex_;
+  std::shared_ptr<std::atomic<int64_t>> size_;
 
   int64_t cache_hits_{0};
   int64_t cache_misses_{0};
@@ -273,7 +297,9 @@ enum class AlgorithmType {
   kConvBackwardData = 2,
   kConvBackwardFilter = 3,
   kTranspose = 4,
-  kAlgorithmCount = 5
+  kTransposeCPU = 5,
+  kTopkCPU = 6,
+  kAlgorithmCount = 7
 };
 
 // AlgorithmsConfigKey -> AlgorithmsID
@@ -313,6 +339,14 @@ class AutoTuneCache {
 
   void UpdateStatus();
 
+  // Save the cached algorithms to a file, and load them back in another
+  // process, so that the process starts with the tuned algorithms. The
+  // cuDNN conv algorithms are not saved, and the keys are only valid for
+  // the same build of Paddle. Load returns false, and keeps the cache as it
+  // is, if the file does not exist or is malformed.
+  void Save(const std::string& path);
+  bool Load(const std::string& path);
+
   // The number of total config cached
   int64_t Size() const { return total_size_; }
 
@@ -18,6 +18,7 @@
 #include "glog/logging.h"
 
 DECLARE_bool(use_autotune);
+DECLARE_string(autotune_cache_file);
 
 namespace phi {
 namespace autotune {
@@ -25,6 +26,10 @@ namespace autotune {
 void AutoTuneStatus::EnableAutoTune() {
   FLAGS_use_autotune = true;
   Init();
+  // The shapes tuned before are not tuned again.
+  if (!FLAGS_autotune_cache_file.empty()) {
+    AutoTuneCache::Instance().Load(FLAGS_autotune_cache_file);
+  }
 }
 
 void AutoTuneStatus::DisableAutoTune() {
@@ -55,6 +60,10 @@ void AutoTuneStatus::Update() {
             << static_cast<int>(StepHitRate() * 100) << "%";
   } else {
     use_autotune_ = false;
+    if (current_steps_id_ + 1 == stop_step_id_ &&
+        !FLAGS_autotune_cache_file.empty()) {
+      AutoTuneCache::Instance().Save(FLAGS_autotune_cache_file);
+    }
     // Set a small tolerance to avoid performance degradation
     // due to large cache size under dynamic shape.
     // TODO(limingshu): Currently works for conv op only, this
@@ -14,6 +14,8 @@
 
 #include "paddle/phi/kernels/embedding_grad_kernel.h"
 
+#include <algorithm>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/kernel_registry.h"
@@ -40,56 +42,68 @@ struct EmbeddingGradCPUFunctor {
   void apply() {
     DDim table_dim = weight_.dims();
 
-    auto ids = CopyIdsToVector<IdT, int64_t>(input_);
-    auto ids_num = static_cast<int64_t>(ids.size());
-
-    // Since paddings are not trainable and fixed in forward, the gradient of
-    // paddings makes no sense and we don't deal with it in backward.
-    {
-      auto* d_output = &out_grad_;
-      auto* ids_data = ids.data();
-
-      int64_t N = table_dim[0];
-      int64_t D = table_dim[1];
+    const auto* ids_data = input_.data<IdT>();
+    auto ids_num = input_.numel();
+
+    int64_t N = table_dim[0];
+    int64_t D = table_dim[1];
+
+    auto invalid = FindInvalidId(ids_data, ids_num, N, padding_idx_);
+    if (invalid < ids_num) {
+      PADDLE_THROW(phi::errors::InvalidArgument(
+          "Variable value (input) of "
+          "OP(paddle.nn.functional.embedding) "
+          "expected >= 0 and < %ld, but got %ld. Please check input "
+          "value.",
+          N,
+          static_cast<int64_t>(ids_data[invalid])));
+    }
 
-      auto* d_output_data = d_output->template data<T>();
+    auto* d_output_data = out_grad_.template data<T>();
 
-      dev_ctx_.template Alloc<T>(weight_grad_);
-      auto* d_table_data = weight_grad_->data<T>();
+    dev_ctx_.template Alloc<T>(weight_grad_);
+    auto* d_table_data = weight_grad_->data<T>();
 
-      memset(d_table_data, 0, weight_grad_->numel() * sizeof(T));
+    memset(d_table_data, 0, weight_grad_->numel() * sizeof(T));
 
+    // Since paddings are not trainable and fixed in forward, the gradient of
+    // paddings makes no sense and we don't deal with it in backward.
+    if (!CPUContext::UseIntraOpThreadPool()) {
       for (int64_t i = 0; i < ids_num; ++i) {
         if (padding_idx_ != kNoPadding && ids_data[i] == padding_idx_) {
-          // the gradient of padding_idx should be 0, already done by memset, so
-          // do nothing.
-        } else {
-          PADDLE_ENFORCE_LT(
-              ids_data[i],
-              N,
-              phi::errors::InvalidArgument(
-                  "Variable value (input) of "
-                  "OP(paddle.nn.functional.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  N,
-                  ids_data[i]));
-          PADDLE_ENFORCE_GE(
-              ids_data[i],
-              0,
-              phi::errors::InvalidArgument(
-                  "Variable value (input) of "
-                  "OP(paddle.nn.functional.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  N,
-                  ids_data[i]));
-          for (int j = 0; j < D; ++j) {
-            d_table_data[ids_data[i] * D + j] += d_output_data[i * D + j];
-          }
+          // the gradient of padding_idx should be 0, already done by memset
+          continue;
+        }
+        for (int64_t j = 0; j < D; ++j) {
+          d_table_data[ids_data[i] * D + j] += d_output_data[i * D + j];
         }
       }
+      return;
     }
+
+    // With the intra-op thread pool, the paddings are dropped by the sort.
+    // The gradients of the same id are accumulated to its row by one thread,
+    // in the order of the positions of the id, and the rows of different ids
+    // are accumulated in parallel.
+    std::vector<int64_t> unique_starts;
+    auto sorted_ids =
+        SortIdsWithPositions(ids_data, ids_num, padding_idx_, &unique_starts);
+    int64_t unique_num = static_cast<int64_t>(unique_starts.size()) - 1;
+
+    int64_t grain_size =
+        std::max<int64_t>(1, (1 << 14) / std::max<int64_t>(D, 1));
+    dev_ctx_.ParallelFor(
+        0, unique_num, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            T* dst = d_table_data + sorted_ids[unique_starts[i]].first * D;
+            for (int64_t k = unique_starts[i]; k < unique_starts[i + 1]; ++k) {
+              const T* src = d_output_data + sorted_ids[k].second * D;
+              for (int64_t j = 0; j < D; ++j) {
+                dst[j] += src[j];
+              }
+            }
+          }
+        });
   }
 
  private:
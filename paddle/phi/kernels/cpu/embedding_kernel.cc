@@ -14,6 +14,8 @@
 
 #include "paddle/phi/kernels/embedding_kernel.h"
 
+#include <algorithm>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/kernel_registry.h"
@@ -37,47 +39,49 @@ struct EmbeddingCPUFunctor {
 
   template <typename IdT>
   void apply() {
-    auto ids = CopyIdsToVector<IdT, int64_t>(input_);
-    auto ids_numel = static_cast<int64_t>(ids.size());
+    const auto* ids = input_.data<IdT>();
+    auto ids_numel = input_.numel();
 
     int64_t row_number = weight_.dims()[0];
     int64_t row_width = weight_.dims()[1];
 
+    // check the ids before the lookup, instead of checking every id in the
+    // loop of lookup
+    auto invalid = FindInvalidId(ids, ids_numel, row_number, padding_idx_);
+    if (invalid < ids_numel) {
+      PADDLE_THROW(phi::errors::InvalidArgument(
+          "Variable value (input) of OP(fluid.layers.embedding) "
+          "expected >= 0 and < %ld, but got %ld. Please check input "
+          "value.",
+          row_number,
+          static_cast<int64_t>(ids[invalid])));
+    }
+
     auto* table = weight_.data<T>();
 
     dev_ctx_.template Alloc<T>(out_);
     auto* output = out_->data<T>();
 
+    int64_t grain_size =
+        std::max<int64_t>(1, (1 << 14) / std::max<int64_t>(row_width, 1));
+    if (CPUContext::UseIntraOpThreadPool()) {
+      dev_ctx_.ParallelFor(
+          0, ids_numel, grain_size, [&](int64_t begin, int64_t end) {
+            EmbeddingLookup(
+                table, row_width, ids, begin, end, padding_idx_, output);
+          });
+      return;
+    }
+    // the blocks of grain_size ids are looked up by OpenMP as before the
+    // intra-op thread pool
+    int64_t num_blocks = (ids_numel + grain_size - 1) / grain_size;
 #if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
 #pragma omp parallel for
 #endif
-
-    for (int64_t i = 0; i < ids_numel; ++i) {
-      if (padding_idx_ != kNoPadding && ids[i] == padding_idx_) {
-        memset(output + i * row_width, 0, row_width * sizeof(T));
-      } else {
-        PADDLE_ENFORCE_LT(
-            ids[i],
-            row_number,
-            phi::errors::InvalidArgument(
-                "Variable value (input) of OP(fluid.layers.embedding) "
-                "expected >= 0 and < %ld, but got %ld. Please check input "
-                "value.",
-                row_number,
-                ids[i]));
-        PADDLE_ENFORCE_GE(
-            ids[i],
-            0,
-            phi::errors::InvalidArgument(
-                "Variable value (input) of OP(fluid.layers.embedding) "
-                "expected >= 0 and < %ld, but got %ld. Please check input "
-                "value.",
-                row_number,
-                ids[i]));
-        memcpy(output + i * row_width,
-               table + ids[i] * row_width,
-               row_width * sizeof(T));
-      }
+    for (int64_t block = 0; block < num_blocks; ++block) {
+      int64_t begin = block * grain_size;
+      int64_t end = std::min(ids_numel, begin + grain_size);
+      EmbeddingLookup(table, row_width, ids, begin, end, padding_idx_, output);
     }
   }
 
@@ -42,10 +42,7 @@ void FlipKernel(const Context& dev_ctx,
   auto numel = x.numel();
   const T* x_data = x.data<T>();
   T* out_data = dev_ctx.template Alloc<T>(out);
-#ifdef PADDLE_WITH_MKLML
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < numel; ++i) {
+  auto flip = [&](int64_t i) {
     int64_t cur_indices = i;
     int64_t rem = 0;
     int64_t dst_offset = 0;
@@ -59,6 +56,21 @@ void FlipKernel(const Context& dev_ctx,
       cur_indices = rem;
     }
     out_data[i] = x_data[dst_offset];
+  };
+
+  if (CPUContext::UseIntraOpThreadPool()) {
+    dev_ctx.ParallelFor(0, numel, 1 << 14, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        flip(i);
+      }
+    });
+    return;
+  }
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < numel; ++i) {
+    flip(i);
   }
 }
 
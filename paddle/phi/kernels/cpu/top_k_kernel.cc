@@ -16,6 +16,7 @@
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/autotune/auto_tune_base.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
@@ -30,10 +31,8 @@ static void FullTopK(Type input_height,
                      Type* t_indices,
                      const int& k,
                      const bool& largest,
-                     const bool& sorted) {
-  // when the k is small, will the partial sort
-  bool partial_sort_flag = (k * 64) < input_width;
-
+                     const bool& sorted,
+                     bool partial_sort_flag) {
 #ifdef PADDLE_WITH_MKLML
 #pragma omp parallel for
 #endif
@@ -120,6 +119,115 @@ static void FullTopK(Type input_height,
   }
 }
 
+template <typename T, typename Type>
+static void DefaultTopK(Type input_height,
+                        Type input_width,
+                        int input_dim,
+                        const DenseTensor* input,
+                        T* t_out,
+                        Type* t_indices,
+                        const int& k,
+                        const bool& largest,
+                        const bool& sorted) {
+  // when the k is small, will the partial sort
+  bool partial_sort_flag = (k * 64) < input_width;
+  FullTopK<T, Type>(input_height,
+                    input_width,
+                    input_dim,
+                    input,
+                    t_out,
+                    t_indices,
+                    k,
+                    largest,
+                    sorted,
+                    partial_sort_flag);
+}
+
+template <typename T, typename Type>
+static void PartialSortTopK(Type input_height,
+                            Type input_width,
+                            int input_dim,
+                            const DenseTensor* input,
+                            T* t_out,
+                            Type* t_indices,
+                            const int& k,
+                            const bool& largest,
+                            const bool& sorted) {
+  FullTopK<T, Type>(input_height,
+                    input_width,
+                    input_dim,
+                    input,
+                    t_out,
+                    t_indices,
+                    k,
+                    largest,
+                    sorted,
+                    true);
+}
+
+template <typename T, typename Type>
+static void NthElementTopK(Type input_height,
+                           Type input_width,
+                           int input_dim,
+                           const DenseTensor* input,
+                           T* t_out,
+                           Type* t_indices,
+                           const int& k,
+                           const bool& largest,
+                           const bool& sorted) {
+  FullTopK<T, Type>(input_height,
+                    input_width,
+                    input_dim,
+                    input,
+                    t_out,
+                    t_indices,
+                    k,
+                    largest,
+                    sorted,
+                    false);
+}
+
+// The partial sort is used when k is small by default, the faster one of
+// the partial sort and the nth element is picked for the shape if autotune
+// is enabled.
+template <typename T, typename Context>
+static void TopKWithAutoTune(const Context& dev_ctx,
+                             int64_t input_height,
+                             int64_t input_width,
+                             int input_dim,
+                             const DenseTensor* input,
+                             T* t_out,
+                             int64_t* t_indices,
+                             int k,
+                             bool largest,
+                             bool sorted) {
+  auto* tuner = phi::autotune::MakeTopkTuner<T>(DefaultTopK<T, int64_t>);
+  static std::once_flag add_callbacks;
+  std::call_once(add_callbacks, [tuner] {
+    tuner->AddCallBack(PartialSortTopK<T, int64_t>);
+    tuner->AddCallBack(NthElementTopK<T, int64_t>);
+  });
+  size_t key = phi::autotune::TopkKey(
+      input_height,
+      input_width,
+      k,
+      largest,
+      sorted,
+      paddle::experimental::CppTypeToDataType<T>::Type());
+  tuner->Run(dev_ctx,
+             phi::autotune::AlgorithmType::kTopkCPU,
+             key,
+             input_height,
+             input_width,
+             input_dim,
+             input,
+             t_out,
+             t_indices,
+             k,
+             largest,
+             sorted);
+}
+
 template <typename T, typename Context>
 void TopkKernel(const Context& dev_ctx,
                 const DenseTensor& x,
@@ -154,15 +262,16 @@ void TopkKernel(const Context& dev_ctx,
     const int64_t& input_height =
         phi::product(phi::slice_ddim(in_dims, 0, in_dims.size() - 1));
     const int64_t& input_width = in_dims[in_dims.size() - 1];
-    FullTopK<T, int64_t>(input_height,
-                         input_width,
-                         in_dims.size(),
-                         input,
-                         out_data,
-                         indices_data,
-                         k,
-                         largest,
-                         sorted);
+    TopKWithAutoTune<T, Context>(dev_ctx,
+                                 input_height,
+                                 input_width,
+                                 in_dims.size(),
+                                 input,
+                                 out_data,
+                                 indices_data,
+                                 k,
+                                 largest,
+                                 sorted);
   } else {
     // if the topk dims is not last dim, will tranpose and do topk
     std::vector<int> trans;
@@ -207,15 +316,16 @@ void TopkKernel(const Context& dev_ctx,
     auto* t_ind = dev_ctx.template Alloc<int64_t>(&tmp_indices);
 
     // get the TopK value
-    FullTopK<T, int64_t>(input_height,
-                         input_width,
-                         in_dims.size(),
-                         &trans_inp,
-                         t_out,
-                         t_ind,
-                         k,
-                         largest,
-                         sorted);
+    TopKWithAutoTune<T, Context>(dev_ctx,
+                                 input_height,
+                                 input_width,
+                                 in_dims.size(),
+                                 &trans_inp,
+                                 t_out,
+                                 t_ind,
+                                 k,
+                                 largest,
+                                 sorted);
     // transpose back
     funcs::TransCompute<phi::CPUContext, int64_t>(
         ndims, dev_ctx, tmp_indices, indices, trans);
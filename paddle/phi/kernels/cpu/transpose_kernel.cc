@@ -14,30 +14,26 @@
 
 #include "paddle/phi/kernels/transpose_kernel.h"
 
+#include <mutex>
 #include <vector>
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/autotune/auto_tune_base.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/impl/transpose_grad_kernel_impl.h"
 
 namespace phi {
 
+// Transpose with the Eigen shuffle, which runs on one thread.
 template <typename T, typename Context>
-void TransposeKernel(const Context& ctx,
-                     const DenseTensor& x,
-                     const std::vector<int>& axis,
-                     DenseTensor* out) {
-  ctx.template Alloc<T>(out);
-  if (out->numel() == 0) {
-    return;
-  }
+static void TransposeEigen(const Context& ctx,
+                           const DenseTensor& x,
+                           const std::vector<int>& axis,
+                           DenseTensor* out) {
   int rank = axis.size();
   switch (rank) {
-    case 0:
-      phi::Copy<Context>(ctx, x, ctx.GetPlace(), false, out);
-      break;
     case 1:
       funcs::Transpose<Context, T, 1> trans1;
       trans1(ctx, x, out, axis);
@@ -63,9 +59,57 @@ void TransposeKernel(const Context& ctx,
       trans6(ctx, x, out, axis);
       break;
     default:
-      // for rank >= 7 situation
-      funcs::TransposeNormal<Context, T> trans_normal;
-      trans_normal(ctx, x, out, axis);
+      PADDLE_THROW(phi::errors::InvalidArgument(
+          "The rank of the Eigen transpose must be in [1, 6], but got %d.",
+          rank));
+  }
+}
+
+// Transpose with the index computed for every element, which runs on the
+// intra-op threads.
+template <typename T, typename Context>
+static void TransposeIndex(const Context& ctx,
+                           const DenseTensor& x,
+                           const std::vector<int>& axis,
+                           DenseTensor* out) {
+  funcs::TransposeNormal<Context, T> trans_normal;
+  trans_normal(ctx, x, out, axis);
+}
+
+template <typename T, typename Context>
+void TransposeKernel(const Context& ctx,
+                     const DenseTensor& x,
+                     const std::vector<int>& axis,
+                     DenseTensor* out) {
+  ctx.template Alloc<T>(out);
+  if (out->numel() == 0) {
+    return;
+  }
+  int rank = axis.size();
+  if (rank == 0) {
+    phi::Copy<Context>(ctx, x, ctx.GetPlace(), false, out);
+  } else if (rank > 6) {
+    TransposeIndex<T, Context>(ctx, x, axis, out);
+  } else {
+    // The Eigen transpose is the default, the faster one is picked for the
+    // shape if autotune is enabled.
+    auto* tuner =
+        phi::autotune::MakeTransposeTuner<T>(TransposeEigen<T, Context>);
+    static std::once_flag add_callbacks;
+    std::call_once(add_callbacks, [tuner] {
+      tuner->AddCallBack(TransposeIndex<T, Context>);
+    });
+    size_t key = phi::autotune::TransposeKey(
+        phi::vectorize(x.dims()),
+        axis,
+        paddle::experimental::CppTypeToDataType<T>::Type());
+    tuner->Run(ctx,
+               phi::autotune::AlgorithmType::kTransposeCPU,
+               key,
+               ctx,
+               x,
+               axis,
+               out);
   }
 }
 }  // namespace phi
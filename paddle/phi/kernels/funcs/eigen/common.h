@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <stdint.h>
 
+#include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "unsupported/Eigen/CXX11/Tensor"
 
@@ -167,4 +168,22 @@ To32BitIndex(EigenTensor in) {
   return RetType(in.data(), To32BitDims(in.dimensions()));
 }
 
+// Call fn with the Eigen device of the context to evaluate expressions on.
+// For CPUContext, it is the device of the intra-op thread pool if the
+// intra-op parallelism of the calling thread is larger than 1.
+template <typename Context, typename Fn>
+void VisitEigenDevice(const Context& dev_ctx, Fn&& fn) {
+  fn(*dev_ctx.eigen_device());
+}
+
+template <typename Fn>
+void VisitEigenDevice(const CPUContext& dev_ctx, Fn&& fn) {
+  auto* pool_device = dev_ctx.eigen_pool_device();
+  if (pool_device != nullptr) {
+    fn(*pool_device);
+  } else {
+    fn(*dev_ctx.eigen_device());
+  }
+}
+
 }  // namespace phi
@@ -14,6 +14,9 @@ limitations under the License. */
 
 #pragma once
 
+#include <algorithm>
+#include <vector>
+
 #include "paddle/fluid/platform/transform.h"
 #include "paddle/phi/backends/all_context.h"
 #include "paddle/phi/core/dense_tensor.h"
@@ -272,6 +275,120 @@ class TransformFunctor {
   bool is_xsize_larger_;
 };
 
+// BroadcastCPU computes out = func(x, y) for every element of out, where x
+// and y are broadcast to out_dims by the strides, and a stride is 0 in the
+// broadcast dims. The dims of size 1 are dropped and the dims contiguous in
+// x, y and out are collapsed, then every row of the innermost dim is
+// computed by a loop which the compiler can vectorize, with fast paths for
+// an x or y broadcast along the row. The rows are split across the intra-op
+// threads of the context.
+template <typename Functor, typename T, typename OutType = T>
+void BroadcastCPU(const CPUContext &ctx,
+                  const T *x,
+                  const T *y,
+                  OutType *out,
+                  const std::vector<int64_t> &out_dims,
+                  const std::vector<int64_t> &x_strides,
+                  const std::vector<int64_t> &y_strides,
+                  Functor func) {
+  std::vector<int64_t> dims, xs, ys;
+  for (size_t i = 0; i < out_dims.size(); ++i) {
+    if (out_dims[i] == 0) {
+      return;
+    }
+    if (out_dims[i] == 1) {
+      continue;
+    }
+    if (!dims.empty() && xs.back() == x_strides[i] * out_dims[i] &&
+        ys.back() == y_strides[i] * out_dims[i]) {
+      dims.back() *= out_dims[i];
+      xs.back() = x_strides[i];
+      ys.back() = y_strides[i];
+    } else {
+      dims.push_back(out_dims[i]);
+      xs.push_back(x_strides[i]);
+      ys.push_back(y_strides[i]);
+    }
+  }
+  if (dims.empty()) {
+    out[0] = func(x[0], y[0]);
+    return;
+  }
+
+  const int rank = dims.size();
+  const int64_t cols = dims.back();
+  const int64_t x_col_stride = xs.back();
+  const int64_t y_col_stride = ys.back();
+  int64_t rows = 1;
+  for (int i = 0; i < rank - 1; ++i) {
+    rows *= dims[i];
+  }
+
+  auto run_row = [&](const T *x_row, const T *y_row, OutType *out_row) {
+    if (x_col_stride == 1 && y_col_stride == 1) {
+      for (int64_t j = 0; j < cols; ++j) {
+        out_row[j] = func(x_row[j], y_row[j]);
+      }
+    } else if (x_col_stride == 1 && y_col_stride == 0) {
+      const T y_value = y_row[0];
+      for (int64_t j = 0; j < cols; ++j) {
+        out_row[j] = func(x_row[j], y_value);
+      }
+    } else if (x_col_stride == 0 && y_col_stride == 1) {
+      const T x_value = x_row[0];
+      for (int64_t j = 0; j < cols; ++j) {
+        out_row[j] = func(x_value, y_row[j]);
+      }
+    } else {
+      for (int64_t j = 0; j < cols; ++j) {
+        out_row[j] = func(x_row[j * x_col_stride], y_row[j * y_col_stride]);
+      }
+    }
+  };
+
+  // about 32K elements are computed by a thread at least
+  const int64_t grain_size = std::max<int64_t>(1, (1 << 15) / cols);
+  ctx.ParallelFor(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+    // the index of the first row in the outer dims
+    std::vector<int64_t> index(std::max(rank - 1, 1), 0);
+    int64_t x_offset = 0, y_offset = 0, rest = begin;
+    for (int i = rank - 2; i >= 0; --i) {
+      index[i] = rest % dims[i];
+      rest /= dims[i];
+      x_offset += index[i] * xs[i];
+      y_offset += index[i] * ys[i];
+    }
+    for (int64_t row = begin; row < end; ++row) {
+      run_row(x + x_offset, y + y_offset, out + row * cols);
+      for (int i = rank - 2; i >= 0; --i) {
+        x_offset += xs[i];
+        y_offset += ys[i];
+        if (++index[i] < dims[i]) {
+          break;
+        }
+        x_offset -= xs[i] * dims[i];
+        y_offset -= ys[i] * dims[i];
+        index[i] = 0;
+      }
+    }
+  });
+}
+
+// The strides of a row-major tensor broadcast from dims_array to
+// out_dims_array, which are 0 in the broadcast dims.
+inline std::vector<int64_t> GetBroadcastStrides(
+    const int *dims_array, const int *out_dims_array, int max_dim) {
+  std::vector<int64_t> strides(max_dim, 0);
+  int64_t stride = 1;
+  for (int i = max_dim - 1; i >= 0; --i) {
+    if (dims_array[i] != 1 || out_dims_array[i] == 1) {
+      strides[i] = stride;
+    }
+    stride *= dims_array[i];
+  }
+  return strides;
+}
+
 template <typename Functor, typename T, typename OutType = T>
 void CommonForwardBroadcastCPU(const DenseTensor &x,
                                const DenseTensor &y,
@@ -283,7 +400,6 @@ void CommonForwardBroadcastCPU(const DenseTensor &x,
                                const CPUContext &ctx,
                                Functor func,
                                const bool is_xsize_larger = true) {
-  std::vector<int> index_array(max_dim, 0);
   const T *x_data = x.data<T>();
   const T *y_data = y.data<T>();
   PADDLE_ENFORCE_NOT_NULL(
@@ -292,19 +408,15 @@ void CommonForwardBroadcastCPU(const DenseTensor &x,
       y_data, errors::InvalidArgument("The input Y should not be empty."));
   OutType *out_data = ctx.Alloc<OutType>(z);
 
-  const int out_size = std::accumulate(
-      out_dims_array, out_dims_array + max_dim, 1, std::multiplies<int>());
-  int x_index, y_index;
-  for (int out_index = 0; out_index < out_size; ++out_index) {
-    x_index = GetElementwiseIndex(x_dims_array, max_dim, index_array.data());
-    y_index = GetElementwiseIndex(y_dims_array, max_dim, index_array.data());
-    if (is_xsize_larger) {
-      out_data[out_index] = func(x_data[x_index], y_data[y_index]);
-    } else {
-      out_data[out_index] = func(y_data[y_index], x_data[x_index]);
-    }
-
-    UpdateElementwiseIndexArray(out_dims_array, max_dim, index_array.data());
+  std::vector<int64_t> out_dims(out_dims_array, out_dims_array + max_dim);
+  auto x_strides = GetBroadcastStrides(x_dims_array, out_dims_array, max_dim);
+  auto y_strides = GetBroadcastStrides(y_dims_array, out_dims_array, max_dim);
+  if (is_xsize_larger) {
+    BroadcastCPU<Functor, T, OutType>(
+        ctx, x_data, y_data, out_data, out_dims, x_strides, y_strides, func);
+  } else {
+    BroadcastCPU<Functor, T, OutType>(
+        ctx, y_data, x_data, out_data, out_dims, y_strides, x_strides, func);
   }
 }
 
@@ -380,10 +492,12 @@ void ElementwiseCompute(const CPUContext &dev_ctx,
     is_xsize_larger = false;
     max_dim = y_dims.size();
   }
-  TransformFunctor<Functor, T, CPUContext, OutType> functor(
-      x, y, z, dev_ctx, func, is_xsize_larger);
+  const T *x_data = x.data<T>();
+  const T *y_data = y.data<T>();
+  OutType *z_data = z->data<OutType>();
   if (x_dims == y_dims) {
-    functor.Run();
+    BroadcastCPU<Functor, T, OutType>(
+        dev_ctx, x_data, y_data, z_data, {x.numel()}, {1}, {1}, func);
     return;
   }
 
@@ -432,13 +546,18 @@ void ElementwiseCompute(const CPUContext &dev_ctx,
     return;
   }
 
-  if (post == 1) {
-    functor.RunRowWise(n, pre);
-    return;
-  } else {
-    functor.RunMidWise(n, pre, post);
-    return;
+  // the smaller one is broadcast to [pre, n, post]
+  if (!is_xsize_larger) {
+    std::swap(x_data, y_data);
   }
+  BroadcastCPU<Functor, T, OutType>(dev_ctx,
+                                    x_data,
+                                    y_data,
+                                    z_data,
+                                    {pre, n, post},
+                                    {static_cast<int64_t>(n) * post, post, 1},
+                                    {0, post, 1},
+                                    func);
 }
 
 // for broadcast backwards
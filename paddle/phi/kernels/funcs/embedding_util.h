@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
 #include "paddle/phi/core/dense_tensor.h"
 
 namespace phi {
@@ -34,4 +39,147 @@ static std::vector<OutT> CopyIdsToVector(const DenseTensor &ids) {
   return ret;
 }
 
+// Return the index of the first id which is out of [0, row_number) and is not
+// padding_idx, or numel if all the ids are valid. The ids are checked without
+// branches first, so that the check is vectorized and is not paid by the loop
+// of lookup.
+template <typename IdT>
+int64_t FindInvalidId(const IdT *ids,
+                      int64_t numel,
+                      int64_t row_number,
+                      int64_t padding_idx) {
+  auto is_invalid = [&](int64_t id) {
+    return static_cast<uint64_t>(id) >= static_cast<uint64_t>(row_number) &&
+           (padding_idx == kNoPadding || id != padding_idx);
+  };
+  int invalid = 0;
+  for (int64_t i = 0; i < numel; ++i) {
+    invalid |= static_cast<int>(is_invalid(ids[i]));
+  }
+  if (invalid) {
+    for (int64_t i = 0; i < numel; ++i) {
+      if (is_invalid(ids[i])) {
+        return i;
+      }
+    }
+  }
+  return numel;
+}
+
+// The lookup prefetches the row of the id kEmbeddingPrefetchDistance ids
+// ahead, and at most kEmbeddingPrefetchBytes bytes of the row, after which
+// the hardware prefetcher follows the row.
+constexpr int64_t kEmbeddingPrefetchDistance = 8;
+constexpr int64_t kEmbeddingPrefetchBytes = 256;
+
+inline void PrefetchEmbeddingRow(const void *row, int64_t bytes) {
+#if defined(__GNUC__) || defined(__clang__)
+  const char *ptr = static_cast<const char *>(row);
+  bytes = std::min(bytes, kEmbeddingPrefetchBytes);
+  for (int64_t offset = 0; offset < bytes; offset += 64) {
+    __builtin_prefetch(ptr + offset);
+  }
+#endif
+}
+
+// Copy the rows of ids in [begin, end) from table to out. The width of rows
+// is a compile-time constant kWidth for the common widths, so that the copy
+// of a row is unrolled into vector instructions instead of calling memcpy,
+// and kWidth is 0 for the other widths.
+template <typename T, typename IdT, int kWidth>
+void EmbeddingLookupRows(const T *table,
+                         int64_t width,
+                         const IdT *ids,
+                         int64_t begin,
+                         int64_t end,
+                         int64_t padding_idx,
+                         T *out) {
+  const int64_t row_width = kWidth > 0 ? kWidth : width;
+  for (int64_t i = begin; i < end; ++i) {
+    if (i + kEmbeddingPrefetchDistance < end) {
+      PrefetchEmbeddingRow(
+          table + ids[i + kEmbeddingPrefetchDistance] * row_width,
+          row_width * sizeof(T));
+    }
+    T *dst = out + i * row_width;
+    if (padding_idx != kNoPadding && ids[i] == padding_idx) {
+      std::memset(dst, 0, row_width * sizeof(T));
+      continue;
+    }
+    const T *src = table + ids[i] * row_width;
+    if (kWidth > 0) {
+      for (int j = 0; j < kWidth; ++j) {
+        dst[j] = src[j];
+      }
+    } else {
+      std::memcpy(dst, src, row_width * sizeof(T));
+    }
+  }
+}
+
+template <typename T, typename IdT>
+void EmbeddingLookup(const T *table,
+                     int64_t row_width,
+                     const IdT *ids,
+                     int64_t begin,
+                     int64_t end,
+                     int64_t padding_idx,
+                     T *out) {
+  switch (row_width) {
+    case 8:
+      EmbeddingLookupRows<T, IdT, 8>(
+          table, row_width, ids, begin, end, padding_idx, out);
+      break;
+    case 16:
+      EmbeddingLookupRows<T, IdT, 16>(
+          table, row_width, ids, begin, end, padding_idx, out);
+      break;
+    case 32:
+      EmbeddingLookupRows<T, IdT, 32>(
+          table, row_width, ids, begin, end, padding_idx, out);
+      break;
+    case 64:
+      EmbeddingLookupRows<T, IdT, 64>(
+          table, row_width, ids, begin, end, padding_idx, out);
+      break;
+    case 128:
+      EmbeddingLookupRows<T, IdT, 128>(
+          table, row_width, ids, begin, end, padding_idx, out);
+      break;
+    default:
+      EmbeddingLookupRows<T, IdT, 0>(
+          table, row_width, ids, begin, end, padding_idx, out);
+      break;
+  }
+}
+
+// Return the (id, position) pairs of the ids except padding_idx sorted by id,
+// where the positions of the same id are in order. The unique ids are
+// returned in unique_starts by the index of their first pair, followed by the
+// number of the pairs.
+template <typename IdT>
+std::vector<std::pair<int64_t, int64_t>> SortIdsWithPositions(
+    const IdT *ids,
+    int64_t numel,
+    int64_t padding_idx,
+    std::vector<int64_t> *unique_starts) {
+  std::vector<std::pair<int64_t, int64_t>> sorted_ids;
+  sorted_ids.reserve(numel);
+  for (int64_t i = 0; i < numel; ++i) {
+    if (padding_idx == kNoPadding || ids[i] != padding_idx) {
+      sorted_ids.emplace_back(ids[i], i);
+    }
+  }
+  std::sort(sorted_ids.begin(), sorted_ids.end());
+
+  unique_starts->clear();
+  for (size_t i = 0; i < sorted_ids.size(); ++i) {
+    if (i == 0 || sorted_ids[i].first != sorted_ids[i - 1].first) {
+      unique_starts->push_back(i);
+    }
+  }
+  unique_starts->push_back(sorted_ids.size());
+  return sorted_ids;
+}
+
 }  // namespace phi
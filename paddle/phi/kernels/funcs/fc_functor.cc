@@ -17,6 +17,7 @@ limitations under the License. */
 #include "paddle/fluid/operators/jit/kernels.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/packed_gemm.h"
 
 namespace phi {
 namespace funcs {
@@ -60,7 +61,7 @@ void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
               static_cast<T>(0.0),
               Y1_data,
               NN);
-  } else {
+  } else if (!PackedMatMul(context, M, N, K, X, W, false, Y)) {
     blas.MatMul(M, N, K, X, W, Y);
   }
   if (B == NULL) {
@@ -130,7 +130,8 @@ void TransposeNormal<DeviceContext, T>::operator()(
       out_ptr[out_idx] = in_ptr[in_idx];
     }
   };
-  transpose_helper(0, out->numel());
+  // every element is a few index computations and a copy
+  context.ParallelFor(0, out->numel(), 1 << 14, transpose_helper);
 }
 
 // define transpose normal
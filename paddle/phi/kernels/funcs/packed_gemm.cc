@@ -0,0 +1,192 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/packed_gemm.h"
+
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+namespace phi {
+namespace funcs {
+
+PackedWeightCache& PackedWeightCache::Instance() {
+  static PackedWeightCache* cache = new PackedWeightCache();
+  return *cache;
+}
+
+void PackedWeightCache::Register(const void* weight) {
+  AutoWRLock guard(&lock_);
+  auto& w = weights_[weight];
+  if (w.ref_count++ == 0) {
+    num_weights_.fetch_add(1);
+  }
+}
+
+void PackedWeightCache::Unregister(const void* weight) {
+  AutoWRLock guard(&lock_);
+  auto it = weights_.find(weight);
+  PADDLE_ENFORCE_NE(it,
+                    weights_.end(),
+                    errors::NotFound("The weight to unregister is not found "
+                                     "in PackedWeightCache."));
+  if (--it->second.ref_count == 0) {
+    weights_.erase(it);
+    num_weights_.fetch_sub(1);
+  }
+}
+
+bool PackedWeightCache::IsRegistered(const void* weight) {
+  if (num_weights_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  AutoRDLock guard(&lock_);
+  return weights_.count(weight) > 0;
+}
+
+size_t PackedWeightCache::Size() {
+  AutoRDLock guard(&lock_);
+  size_t size = 0;
+  for (auto& w : weights_) {
+    size += w.second.packed.size();
+  }
+  return size;
+}
+
+template <typename T>
+const T* PackedWeightCache::GetPackedWeight(const CPUContext& ctx,
+                                            const T* weight,
+                                            int M,
+                                            int N,
+                                            int K,
+                                            bool trans_w) {
+#ifdef PADDLE_WITH_MKLML
+  if (num_weights_.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+  Shape shape(M, N, K, trans_w);
+  {
+    AutoRDLock guard(&lock_);
+    auto it = weights_.find(weight);
+    if (it == weights_.end()) {
+      return nullptr;
+    }
+    auto packed = it->second.packed.find(shape);
+    if (packed != it->second.packed.end()) {
+      return reinterpret_cast<const T*>(packed->second.get());
+    }
+  }
+
+  AutoWRLock guard(&lock_);
+  auto it = weights_.find(weight);
+  if (it == weights_.end()) {
+    return nullptr;
+  }
+  auto& packed = it->second.packed;
+  auto packed_it = packed.find(shape);
+  if (packed_it != packed.end()) {
+    return reinterpret_cast<const T*>(packed_it->second.get());
+  }
+  if (packed.size() >= static_cast<size_t>(kMaxShapes)) {
+    return nullptr;
+  }
+  auto blas = GetBlas<CPUContext, T>(ctx);
+  T* dst = blas.GEMM_ALLOC(CblasBMatrix, M, N, K);
+  if (dst == nullptr) {
+    return nullptr;
+  }
+  blas.GEMM_PACK(CblasBMatrix,
+                 trans_w ? CblasTrans : CblasNoTrans,
+                 M,
+                 N,
+                 K,
+                 static_cast<T>(1),
+                 weight,
+                 trans_w ? K : N,
+                 dst);
+  VLOG(4) << "Pack the weight " << weight << " for GEMM of M " << M << ", N "
+          << N << ", K " << K;
+  packed[shape] = std::shared_ptr<void>(dst, [](void* data) {
+    CBlas<T>::GEMM_FREE(reinterpret_cast<T*>(data));
+  });
+  return dst;
+#else
+  return nullptr;
+#endif
+}
+
+template <typename T>
+static bool PackedMatMulImpl(const CPUContext& ctx,
+                             int M,
+                             int N,
+                             int K,
+                             const T* x,
+                             const T* w,
+                             bool trans_w,
+                             T* out) {
+#ifdef PADDLE_WITH_MKLML
+  if (M <= 0 || N <= 0 || K <= 0) {
+    return false;
+  }
+  const T* packed = PackedWeightCache::Instance().GetPackedWeight<T>(
+      ctx, w, M, N, K, trans_w);
+  if (packed == nullptr) {
+    return false;
+  }
+  auto blas = GetBlas<CPUContext, T>(ctx);
+  blas.GEMM_COMPUTE(CblasNoTrans,
+                    CblasPacked,
+                    M,
+                    N,
+                    K,
+                    x,
+                    K,
+                    packed,
+                    trans_w ? K : N,
+                    static_cast<T>(0),
+                    out,
+                    N);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool PackedMatMul(const CPUContext& ctx,
+                  int M,
+                  int N,
+                  int K,
+                  const float* x,
+                  const float* w,
+                  bool trans_w,
+                  float* out) {
+  return PackedMatMulImpl<float>(ctx, M, N, K, x, w, trans_w, out);
+}
+
+bool PackedMatMul(const CPUContext& ctx,
+                  int M,
+                  int N,
+                  int K,
+                  const double* x,
+                  const double* w,
+                  bool trans_w,
+                  double* out) {
+  return PackedMatMulImpl<double>(ctx, M, N, K, x, w, trans_w, out);
+}
+
+template const float* PackedWeightCache::GetPackedWeight<float>(
+    const CPUContext&, const float*, int, int, int, bool);
+template const double* PackedWeightCache::GetPackedWeight<double>(
+    const CPUContext&, const double*, int, int, int, bool);
+
+}  // namespace funcs
+}  // namespace phi
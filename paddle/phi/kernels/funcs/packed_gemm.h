@@ -0,0 +1,114 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/utils/rw_lock.h"
+
+namespace phi {
+namespace funcs {
+
+// PackedWeightCache keeps the weights of fc, mul and matmul_v2 packed by
+// Blas::GEMM_PACK for inference, so that the packing is not paid again by
+// every GEMM with the weight. Only the registered weights are packed, whose
+// memory and values must not change while they are registered. A weight is
+// packed when it is first used, and the packed buffer is shared by all the
+// predictors which registered the weight, such as the clones of a predictor.
+class PackedWeightCache {
+ public:
+  // The packed buffer depends on the number of rows of the input, so a
+  // weight is packed for at most kMaxShapes different inputs.
+  static constexpr int kMaxShapes = 8;
+
+  static PackedWeightCache& Instance();
+
+  // The weight is released when it is unregistered as many times as it is
+  // registered.
+  void Register(const void* weight);
+  void Unregister(const void* weight);
+
+  bool IsRegistered(const void* weight);
+
+  // The number of packed buffers.
+  size_t Size();
+
+  // Return the weight of out[M, N] = x[M, K] * weight packed as the B matrix
+  // of GEMM_COMPUTE, where weight is [K, N], or [N, K] if trans_w is true.
+  // nullptr is returned if the weight is not registered, or can not be packed.
+  template <typename T>
+  const T* GetPackedWeight(const CPUContext& ctx,
+                           const T* weight,
+                           int M,
+                           int N,
+                           int K,
+                           bool trans_w);
+
+ private:
+  PackedWeightCache() = default;
+
+  // (M, N, K, trans_w)
+  typedef std::tuple<int, int, int, bool> Shape;
+
+  struct Weight {
+    int ref_count{0};
+    std::map<Shape, std::shared_ptr<void>> packed;
+  };
+
+  RWLock lock_;
+  std::atomic<size_t> num_weights_{0};
+  std::unordered_map<const void*, Weight> weights_;
+};
+
+// Compute out[M, N] = x[M, K] * w with the packed weight if w is registered
+// in PackedWeightCache, and return false if the weight is not packed, then
+// the caller computes it in the usual way.
+template <typename Context, typename T>
+inline bool PackedMatMul(const Context& ctx,
+                         int M,
+                         int N,
+                         int K,
+                         const T* x,
+                         const T* w,
+                         bool trans_w,
+                         T* out) {
+  return false;
+}
+
+bool PackedMatMul(const CPUContext& ctx,
+                  int M,
+                  int N,
+                  int K,
+                  const float* x,
+                  const float* w,
+                  bool trans_w,
+                  float* out);
+
+bool PackedMatMul(const CPUContext& ctx,
+                  int M,
+                  int N,
+                  int K,
+                  const double* x,
+                  const double* w,
+                  bool trans_w,
+                  double* out);
+
+}  // namespace funcs
+}  // namespace phi
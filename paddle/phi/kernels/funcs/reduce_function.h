@@ -1235,16 +1235,17 @@ void ReduceFunctor(const DeviceContext& context,
                       dims_vector.end());
     out_dims = phi::make_ddim(dims_vector);
   }
-  auto& place = *context.eigen_device();
   Functor functor;
 
-  if (D == 1) {
-    auto out = EigenScalar<T>::From(*output);
-    functor(place, &x, &out, reduce_dim);
-  } else {
-    auto out = EigenTensor<T, (D - R_D)>::From(*output, out_dims);
-    functor(place, &x, &out, reduce_dim);
-  }
+  VisitEigenDevice(context, [&](const auto& place) {
+    if (D == 1) {
+      auto out = EigenScalar<T>::From(*output);
+      functor(place, &x, &out, reduce_dim);
+    } else {
+      auto out = EigenTensor<T, (D - R_D)>::From(*output, out_dims);
+      functor(place, &x, &out, reduce_dim);
+    }
+  });
 }
 
 #define HANDLE_REDUCE_DIM(NDIM, RDIM)                        \
@@ -1338,11 +1339,12 @@ void ReduceKernelImpl(const DeviceContext& dev_ctx,
     // Flatten and reduce 1-D tensor
     auto x = EigenVector<OutT>::Flatten(input);
     auto out = EigenScalar<OutT>::From(*output);
-    auto& dev = *dev_ctx.eigen_device();
     auto reduce_dim = Eigen::array<int, 1>({{0}});
 
     Functor functor;
-    functor(dev, &x, &out, reduce_dim);
+    VisitEigenDevice(dev_ctx, [&](const auto& dev) {
+      functor(dev, &x, &out, reduce_dim);
+    });
   } else {
     int ndim = input.dims().size();
     int rdim = dims.size();
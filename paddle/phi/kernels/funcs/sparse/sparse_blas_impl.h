@@ -0,0 +1,387 @@
+//   Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/ddim.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/sparse_coo_tensor.h"
+#include "paddle/phi/core/sparse_csr_tensor.h"
+#include "paddle/phi/core/visit_type.h"
+
+namespace phi {
+namespace funcs {
+namespace sparse {
+
+// The work of a task of ParallelFor is about 32K multiply-adds at least.
+constexpr int64_t kSparseGrainWork = 1 << 15;
+
+/************* SPARSE MATRIX ROWS (COO/CSR) ************/
+
+// SparseRows is the nonzeros of a batched sparse matrix in the row major
+// order. The nonzeros of row r of batch b are [offsets[b * rows + r],
+// offsets[b * rows + r + 1]), and the i-th nonzero in the order is
+// nnz_index[i] in the values of the tensor, or i if nnz_index is empty.
+struct SparseRows {
+  int64_t batch_size{1};
+  int64_t rows{0};
+  int64_t cols{0};
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> col_index;
+  std::vector<int64_t> nnz_index;
+
+  inline int64_t NnzIndex(int64_t i) const {
+    return nnz_index.empty() ? i : nnz_index[i];
+  }
+};
+
+inline void GetMatrixDims(const DDim& dims, SparseRows* rows) {
+  std::vector<int64_t> dim_vec = phi::vectorize(dims);
+  int ndims = dim_vec.size();
+  PADDLE_ENFORCE_GE(
+      ndims,
+      2,
+      phi::errors::InvalidArgument("the dim size of sparse tensor must be "
+                                   "greater than or eaqual to 2."));
+  rows->batch_size = 1;
+  for (int i = 0; i < ndims - 2; ++i) {
+    rows->batch_size *= dim_vec[i];
+  }
+  rows->rows = dim_vec[ndims - 2];
+  rows->cols = dim_vec[ndims - 1];
+}
+
+template <typename IntT>
+void GetCsrRows(const SparseCsrTensor& x, SparseRows* rows) {
+  GetMatrixDims(x.dims(), rows);
+  PADDLE_ENFORCE_EQ(x.crows().numel(),
+                    rows->batch_size * (rows->rows + 1),
+                    phi::errors::PreconditionNotMet(
+                        "the length of SparseCsrTensor crows is not right."));
+  const IntT* crows = x.crows().data<IntT>();
+  const IntT* cols = x.cols().data<IntT>();
+  // the crows of every batch start from 0
+  rows->offsets.resize(rows->batch_size * rows->rows + 1);
+  int64_t batch_offset = 0;
+  for (int64_t b = 0; b < rows->batch_size; ++b) {
+    const IntT* batch_crows = crows + b * (rows->rows + 1);
+    for (int64_t r = 0; r < rows->rows; ++r) {
+      rows->offsets[b * rows->rows + r] = batch_offset + batch_crows[r];
+    }
+    batch_offset += batch_crows[rows->rows];
+  }
+  rows->offsets.back() = batch_offset;
+  PADDLE_ENFORCE_EQ(batch_offset,
+                    x.cols().numel(),
+                    phi::errors::PreconditionNotMet(
+                        "the crows and cols of SparseCsrTensor do not match."));
+  rows->col_index.assign(cols, cols + batch_offset);
+}
+
+// The nonzeros of COO are not required to be sorted, they are sorted by rows
+// with a counting sort.
+template <typename IntT>
+void GetCooRows(const SparseCooTensor& x, SparseRows* rows) {
+  GetMatrixDims(x.dims(), rows);
+  const int64_t nnz = x.nnz();
+  const int sparse_dim = x.sparse_dim();
+  PADDLE_ENFORCE_EQ(sparse_dim,
+                    x.dims().size(),
+                    phi::errors::InvalidArgument(
+                        "the sparse dim of SparseCooTensor must be equal to "
+                        "its rank in sparse matmul."));
+  const IntT* indices = x.indices().data<IntT>();
+  const IntT* row_indices = indices + (sparse_dim - 2) * nnz;
+  const IntT* col_indices = indices + (sparse_dim - 1) * nnz;
+
+  // the index of the row of every nonzero in all batches
+  std::vector<int64_t> global_rows(nnz);
+  for (int64_t i = 0; i < nnz; ++i) {
+    int64_t batch = 0;
+    for (int d = 0; d < sparse_dim - 2; ++d) {
+      batch = batch * x.dims()[d] + indices[d * nnz + i];
+    }
+    global_rows[i] = batch * rows->rows + row_indices[i];
+  }
+
+  const int64_t total_rows = rows->batch_size * rows->rows;
+  rows->offsets.assign(total_rows + 1, 0);
+  for (int64_t i = 0; i < nnz; ++i) {
+    ++rows->offsets[global_rows[i] + 1];
+  }
+  for (int64_t r = 0; r < total_rows; ++r) {
+    rows->offsets[r + 1] += rows->offsets[r];
+  }
+  std::vector<int64_t> next(rows->offsets.begin(), rows->offsets.end() - 1);
+  rows->col_index.resize(nnz);
+  rows->nnz_index.resize(nnz);
+  for (int64_t i = 0; i < nnz; ++i) {
+    int64_t pos = next[global_rows[i]]++;
+    rows->col_index[pos] = col_indices[i];
+    rows->nnz_index[pos] = i;
+  }
+}
+
+inline SparseRows GetSparseRows(const SparseCsrTensor& x) {
+  SparseRows rows;
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      x.crows().dtype(), "GetCsrRows", ([&] { GetCsrRows<data_t>(x, &rows); }));
+  return rows;
+}
+
+inline SparseRows GetSparseRows(const SparseCooTensor& x) {
+  SparseRows rows;
+  PD_VISIT_BASE_INTEGRAL_TYPES(x.indices().dtype(), "GetCooRows", ([&] {
+                                 GetCooRows<data_t>(x, &rows);
+                               }));
+  return rows;
+}
+
+/************* DENSE MATRIX HELPERS ************/
+
+// Transpose every matrix of the batched [batch_size, rows, cols] to
+// [batch_size, cols, rows].
+template <typename T>
+std::vector<T> BatchTranspose(const phi::CPUContext& dev_ctx,
+                              const T* x,
+                              int64_t batch_size,
+                              int64_t rows,
+                              int64_t cols) {
+  std::vector<T> out(batch_size * rows * cols);
+  int64_t grain =
+      std::max<int64_t>(1, kSparseGrainWork / std::max<int64_t>(rows, 1));
+  dev_ctx.ParallelFor(
+      0, batch_size * cols, grain, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const T* src = x + (i / cols) * rows * cols + i % cols;
+          T* dst = out.data() + i * rows;
+          for (int64_t r = 0; r < rows; ++r) {
+            dst[r] = src[r * cols];
+          }
+        }
+      });
+  return out;
+}
+
+// The batch size and the dims of the last two axes of a dense tensor.
+inline void GetDenseMatrixDims(const DenseTensor& x,
+                               int64_t* batch_size,
+                               int64_t* rows,
+                               int64_t* cols) {
+  const auto& dims = x.dims();
+  int ndims = dims.size();
+  PADDLE_ENFORCE_GE(
+      ndims,
+      2,
+      phi::errors::InvalidArgument("the dim size of dense tensor must be "
+                                   "greater than or eaqual to 2."));
+  *batch_size = 1;
+  for (int i = 0; i < ndims - 2; ++i) {
+    *batch_size *= dims[i];
+  }
+  *rows = dims[ndims - 2];
+  *cols = dims[ndims - 1];
+}
+
+template <typename T>
+void ScaleOut(T beta, int64_t n, T* out) {
+  if (beta == static_cast<T>(0)) {
+    std::fill(out, out + n, static_cast<T>(0));
+  } else if (beta != static_cast<T>(1)) {
+    for (int64_t i = 0; i < n; ++i) {
+      out[i] *= beta;
+    }
+  }
+}
+
+/************* SPARSE*DENSE->DENSE MATMUL ************/
+
+template <>
+template <typename T, typename TensorType>
+void SparseBlas<phi::CPUContext>::SPMM(bool transa,
+                                       bool transb,
+                                       T alpha,
+                                       const TensorType& mat_a,
+                                       const phi::DenseTensor& mat_b,
+                                       T beta,
+                                       phi::DenseTensor* mat_out) const {
+  SparseRows a = GetSparseRows(mat_a);
+  const T* a_values = mat_a.values().template data<T>();
+
+  int64_t b_batch, b_rows, b_cols;
+  GetDenseMatrixDims(mat_b, &b_batch, &b_rows, &b_cols);
+  const int64_t K = transa ? a.rows : a.cols;
+  const int64_t N = transb ? b_rows : b_cols;
+  PADDLE_ENFORCE_EQ(transb ? b_cols : b_rows,
+                    K,
+                    phi::errors::InvalidArgument(
+                        "the shapes of the sparse and dense matrix do not "
+                        "match in SPMM."));
+  PADDLE_ENFORCE_EQ(
+      b_batch == a.batch_size || b_batch == 1,
+      true,
+      phi::errors::InvalidArgument("the batch size of the dense matrix must "
+                                   "be 1 or the batch size of sparse matrix."));
+  PADDLE_ENFORCE_EQ(
+      mat_out->numel(),
+      a.batch_size * (transa ? a.cols : a.rows) * N,
+      phi::errors::InvalidArgument(
+          "the shape of the output does not match the result of SPMM."));
+
+  // the dense matrix is [K, N] in row major order
+  std::vector<T> b_trans;
+  const T* b = mat_b.data<T>();
+  if (transb) {
+    b_trans = BatchTranspose<T>(dev_ctx_, b, b_batch, b_rows, b_cols);
+    b = b_trans.data();
+  }
+  const int64_t b_stride = b_batch == 1 ? 0 : K * N;
+  T* out = mat_out->data<T>();
+  const int64_t nnz = a.col_index.size();
+
+  if (!transa) {
+    // out[M, N] = A[M, K] * B[K, N], every row of out is computed by a task
+    const int64_t M = a.rows;
+    int64_t row_nnz = nnz / std::max<int64_t>(1, a.batch_size * M);
+    int64_t work_per_row = std::max<int64_t>(1, N * row_nnz);
+    int64_t grain = std::max<int64_t>(1, kSparseGrainWork / work_per_row);
+    dev_ctx_.ParallelFor(
+        0, a.batch_size * M, grain, [&](int64_t begin, int64_t end) {
+          for (int64_t r = begin; r < end; ++r) {
+            const T* batch_b = b + (r / M) * b_stride;
+            T* out_row = out + r * N;
+            ScaleOut(beta, N, out_row);
+            for (int64_t i = a.offsets[r]; i < a.offsets[r + 1]; ++i) {
+              const T value = alpha * a_values[a.NnzIndex(i)];
+              const T* b_row = batch_b + a.col_index[i] * N;
+              for (int64_t j = 0; j < N; ++j) {
+                out_row[j] += value * b_row[j];
+              }
+            }
+          }
+        });
+  } else {
+    // out[K', N] = A'[K', M'] * B[M', N], the nonzeros are scattered to the
+    // rows of out, so the tasks are split by the columns of out instead.
+    const int64_t out_rows = a.cols;
+    const int64_t M = a.rows;
+    int64_t num_chunks = std::max<int64_t>(
+        1,
+        std::min<int64_t>(N, phi::CPUContext::GetIntraOpNumThreads() * 4));
+    int64_t chunk = (N + num_chunks - 1) / num_chunks;
+    num_chunks = (N + chunk - 1) / chunk;
+    dev_ctx_.ParallelFor(
+        0, a.batch_size * num_chunks, 1, [&](int64_t begin, int64_t end) {
+          for (int64_t t = begin; t < end; ++t) {
+            const int64_t batch = t / num_chunks;
+            const int64_t n0 = (t % num_chunks) * chunk;
+            const int64_t n1 = std::min(N, n0 + chunk);
+            const T* batch_b = b + batch * b_stride;
+            T* batch_out = out + batch * out_rows * N;
+            for (int64_t r = 0; r < out_rows; ++r) {
+              ScaleOut(beta, n1 - n0, batch_out + r * N + n0);
+            }
+            for (int64_t r = batch * M; r < (batch + 1) * M; ++r) {
+              const T* b_row = batch_b + (r - batch * M) * N;
+              for (int64_t i = a.offsets[r]; i < a.offsets[r + 1]; ++i) {
+                const T value = alpha * a_values[a.NnzIndex(i)];
+                T* out_row = batch_out + a.col_index[i] * N;
+                for (int64_t j = n0; j < n1; ++j) {
+                  out_row[j] += value * b_row[j];
+                }
+              }
+            }
+          }
+        });
+  }
+}
+
+/************* DENSE*DENSE->SPARSE MATMUL ************/
+
+template <>
+template <typename T, typename TensorType>
+void SparseBlas<phi::CPUContext>::SDDMM(bool transa,
+                                        bool transb,
+                                        T alpha,
+                                        const phi::DenseTensor& mat_a,
+                                        const phi::DenseTensor& mat_b,
+                                        T beta,
+                                        TensorType* mat_out) const {
+  SparseRows c = GetSparseRows(*mat_out);
+  T* out_values = mat_out->mutable_values()->template data<T>();
+
+  int64_t a_batch, a_rows, a_cols, b_batch, b_rows, b_cols;
+  GetDenseMatrixDims(mat_a, &a_batch, &a_rows, &a_cols);
+  GetDenseMatrixDims(mat_b, &b_batch, &b_rows, &b_cols);
+  const int64_t M = c.rows;
+  const int64_t N = c.cols;
+  const int64_t K = transa ? a_rows : a_cols;
+  PADDLE_ENFORCE_EQ(
+      (transa ? a_cols : a_rows) == M && (transb ? b_rows : b_cols) == N &&
+          (transb ? b_cols : b_rows) == K,
+      true,
+      phi::errors::InvalidArgument(
+          "the shapes of the dense matrices and the sparse mask do not match "
+          "in SDDMM."));
+  PADDLE_ENFORCE_EQ(a_batch == c.batch_size && b_batch == c.batch_size,
+                    true,
+                    phi::errors::InvalidArgument(
+                        "the batch sizes of the dense matrices and the sparse "
+                        "mask must be equal in SDDMM."));
+
+  // A is [M, K] and B' is [N, K] in row major order, so that every nonzero
+  // is a dot product of two contiguous rows.
+  std::vector<T> a_trans, b_trans;
+  const T* a = mat_a.data<T>();
+  const T* b = mat_b.data<T>();
+  if (transa) {
+    a_trans = BatchTranspose<T>(dev_ctx_, a, a_batch, a_rows, a_cols);
+    a = a_trans.data();
+  }
+  if (!transb) {
+    b_trans = BatchTranspose<T>(dev_ctx_, b, b_batch, b_rows, b_cols);
+    b = b_trans.data();
+  }
+
+  const int64_t nnz = c.col_index.size();
+  int64_t row_nnz = nnz / std::max<int64_t>(1, c.batch_size * M);
+  int64_t work_per_row = std::max<int64_t>(1, K * row_nnz);
+  int64_t grain = std::max<int64_t>(1, kSparseGrainWork / work_per_row);
+  dev_ctx_.ParallelFor(
+      0, c.batch_size * M, grain, [&](int64_t begin, int64_t end) {
+        for (int64_t r = begin; r < end; ++r) {
+          const T* a_row = a + r * K;
+          const T* batch_b = b + (r / M) * N * K;
+          for (int64_t i = c.offsets[r]; i < c.offsets[r + 1]; ++i) {
+            const T* b_row = batch_b + c.col_index[i] * K;
+            T sum = static_cast<T>(0);
+            for (int64_t k = 0; k < K; ++k) {
+              sum += a_row[k] * b_row[k];
+            }
+            T& value = out_values[c.NnzIndex(i)];
+            value = beta == static_cast<T>(0) ? alpha * sum
+                                              : alpha * sum + beta * value;
+          }
+        }
+      });
+}
+
+}  // namespace sparse
+}  // namespace funcs
+}  // namespace phi
@@ -17,6 +17,7 @@ limitations under the License. */
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
 #include "paddle/phi/kernels/funcs/complex_functors.h"
+#include "paddle/phi/kernels/funcs/packed_gemm.h"
 
 namespace phi {
 
@@ -355,7 +356,17 @@ void MatMulFunction(const Context& dev_ctx,
                       1LL,
                       std::multiplies<std::int64_t>());
   if (out_batch_size == 0) return;
-  if (x_batch_size == 1 && y_batch_size == 1) {
+  if (y_batch_size == 1 && !trans_x && !flag &&
+      funcs::PackedMatMul(dev_ctx,
+                          x_batch_size * M,
+                          N,
+                          K,
+                          x_data,
+                          y_data,
+                          trans_y,
+                          dev_ctx.template Alloc<T>(Out))) {
+    VLOG(3) << "MatMul's case 11 with packed Y";
+  } else if (x_batch_size == 1 && y_batch_size == 1) {
     VLOG(3) << "MatMul's case 8";
     blas.GEMM(trans_x ? CblasTrans : CblasNoTrans,
               trans_y ? CblasTrans : CblasNoTrans,
@@ -527,9 +538,17 @@ void MatmulWithFlattenKernel(const Context& dev_ctx,
     out->Resize({x_matrix.dims()[0], y_matrix.dims()[1]});
   }
 
-  auto blas = phi::funcs::GetBlas<Context, T>(dev_ctx);
-
-  blas.MatMul(x_matrix, y_matrix, out);
+  if (!funcs::PackedMatMul(dev_ctx,
+                           x_matrix.dims()[0],
+                           y_matrix.dims()[1],
+                           x_matrix.dims()[1],
+                           x_matrix.data<T>(),
+                           y_matrix.data<T>(),
+                           false,
+                           out->data<T>())) {
+    auto blas = phi::funcs::GetBlas<Context, T>(dev_ctx);
+    blas.MatMul(x_matrix, y_matrix, out);
+  }
   if (z_dim.size() != 2) {
     out->Resize(z_dim);
   }
@@ -14,12 +14,88 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/addmm_kernel.h"
 
+#include <vector>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/ddim.h"
+#include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/sparse/sparse_blas.h"
+
 namespace phi {
 namespace sparse {
 
-/* DENSE + COO @ DENSE -> DENSE */
+template <typename T, typename Context, typename TensorType>
+void AddmmKernelImpl(const Context& dev_ctx,
+                     const DenseTensor& input,
+                     const TensorType& x,
+                     const DenseTensor& y,
+                     float beta,
+                     float alpha,
+                     DenseTensor* out) {
+  std::vector<int64_t> input_dim = phi::vectorize(input.dims());
+  std::vector<int64_t> x_dim = phi::vectorize(x.dims());
+  std::vector<int64_t> y_dim = phi::vectorize(y.dims());
+  auto rank = input_dim.size();
+
+  PADDLE_ENFORCE_GE(
+      rank,
+      2,
+      phi::errors::InvalidArgument(
+          "the dims size of input must be greater than or eaqual to 2."));
+
+  PADDLE_ENFORCE_EQ(
+      x_dim.size(),
+      rank,
+      phi::errors::PreconditionNotMet(
+          "The dims size of Input(input) and Input(x) must be eaqual."));
+
+  PADDLE_ENFORCE_EQ(
+      y_dim.size(),
+      rank,
+      phi::errors::InvalidArgument(
+          "the dims size of Input(input) and Input(y) must be eaqual."));
+
+  for (size_t i = 0; i < rank - 2; ++i) {
+    PADDLE_ENFORCE_EQ(input_dim[i],
+                      x_dim[i],
+                      phi::errors::InvalidArgument(
+                          "input.dim[%d] and x.dim[%d] must be eaqul.", i, i));
+    PADDLE_ENFORCE_EQ(input_dim[i],
+                      y_dim[i],
+                      phi::errors::InvalidArgument(
+                          "input.dim[%d] and y.dim[%d] must be eaqul.", i, i));
+  }
+
+  PADDLE_ENFORCE_EQ(
+      input_dim[rank - 2],
+      x_dim[rank - 2],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(input) and Input(x) is not suitable for matmul "
+          "opetation, input_dim[-2] must be eaqual to x_dim[-2]."));
+
+  PADDLE_ENFORCE_EQ(
+      input_dim[rank - 1],
+      y_dim[rank - 1],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(input) and Input(y) is not suitable for matmul "
+          "opetation, input_dim[-1] must be eaqual to y_dim[-1]."));
+
+  PADDLE_ENFORCE_EQ(
+      x_dim[rank - 1],
+      y_dim[rank - 2],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(x) and Input(y) is not suitable for matmul "
+          "opetation, x_dim[-1] must be eaqual to y_dim[-2]."));
+
+  phi::Copy(dev_ctx, input, dev_ctx.GetPlace(), false, out);
+
+  auto sparse_blas = phi::funcs::sparse::GetSparseBlas<Context, T>(dev_ctx);
+  sparse_blas.SPMM(
+      false, false, static_cast<T>(alpha), x, y, static_cast<T>(beta), out);
+}
+
 template <typename T, typename Context>
 void AddmmCooDenseKernel(const Context& dev_ctx,
                          const DenseTensor& input,
@@ -28,11 +104,9 @@ void AddmmCooDenseKernel(const Context& dev_ctx,
                          float beta,
                          float alpha,
                          DenseTensor* out) {
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "Not support CPU kernel of 'sparse.addmm' now."));
+  AddmmKernelImpl<T>(dev_ctx, input, x, y, beta, alpha, out);
 }
 
-/* DENSE + CSR @ DENSE -> DENSE */
 template <typename T, typename Context>
 void AddmmCsrDenseKernel(const Context& dev_ctx,
                          const DenseTensor& input,
@@ -41,8 +115,7 @@ void AddmmCsrDenseKernel(const Context& dev_ctx,
                          float beta,
                          float alpha,
                          DenseTensor* out) {
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "Not support CPU kernel of 'sparse.addmm' now."));
+  AddmmKernelImpl<T>(dev_ctx, input, x, y, beta, alpha, out);
 }
 
 }  // namespace sparse
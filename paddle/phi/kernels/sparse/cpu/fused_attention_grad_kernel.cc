@@ -14,12 +14,45 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/fused_attention_grad_kernel.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/sparse/sparse_blas.h"
+#include "paddle/phi/kernels/sparse/empty_kernel.h"
+#include "paddle/phi/kernels/sparse/matmul_grad_kernel.h"
 
 namespace phi {
 namespace sparse {
 
+template <typename T>
+void AttnSoftmaxCpuGradKernel(const CPUContext& dev_ctx,
+                              const phi::funcs::sparse::SparseRows& out_rows,
+                              const T* out_values,
+                              const T* dout_values,
+                              T* dx_values,
+                              T scale) {
+  // dx = (dout - sum(dout * out)) * out
+  const int64_t total_row_num = out_rows.batch_size * out_rows.rows;
+  int64_t avg_row_nnz = std::max<int64_t>(
+      1, out_rows.offsets.back() / std::max<int64_t>(1, total_row_num));
+  int64_t grain = std::max<int64_t>(1, (1 << 15) / avg_row_nnz);
+  dev_ctx.ParallelFor(0, total_row_num, grain, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      int64_t row_first = out_rows.offsets[row];
+      int64_t row_last = out_rows.offsets[row + 1];
+      T mul_sum = 0;
+      for (int64_t idx = row_first; idx < row_last; ++idx) {
+        mul_sum += out_values[idx] * dout_values[idx];
+      }
+      for (int64_t idx = row_first; idx < row_last; ++idx) {
+        dx_values[idx] = (dout_values[idx] - mul_sum) * out_values[idx] / scale;
+      }
+    }
+  });
+}
+
 template <typename T, typename Context>
 void FusedAttentionCsrGradKernel(const Context& dev_ctx,
                                  const DenseTensor& query,
@@ -30,9 +63,56 @@ void FusedAttentionCsrGradKernel(const Context& dev_ctx,
                                  DenseTensor* dquery,
                                  DenseTensor* dkey,
                                  DenseTensor* dvalue) {
-  PD_THROW(
-      "Not support CPU kernel of 'sparse.nn.functional.fused_attention' now");
+  /* Step1: Forward: softmax{CSR} * value{Dense} -> out{Dense}, reuse */
+  SparseCsrTensor dsoftmax;
+  MatmulCsrDenseGradKernel<T, Context>(
+      dev_ctx, softmax, value, dout, &dsoftmax, dvalue);
+
+  /* Step2: Calculate grad of sdd_result, manualy not reuse */
+  SparseCsrTensor d_sdd_result;
+  EmptyLikeCsrKernel<T, Context>(dev_ctx, dsoftmax, &d_sdd_result);
+  auto q_dim = query.dims();
+  int64_t N = q_dim[q_dim.size() - 1];
+  AttnSoftmaxCpuGradKernel<T>(dev_ctx,
+                              phi::funcs::sparse::GetSparseRows(softmax),
+                              softmax.values().data<T>(),
+                              dsoftmax.values().data<T>(),
+                              d_sdd_result.mutable_values()->data<T>(),
+                              static_cast<T>(std::sqrt(N)));
+
+  /* Step3: Forward: query{Dense} * key'{Dense} -> sdd_result{SparseCsr} */
+  auto sparse_blas = phi::funcs::sparse::GetSparseBlas<Context, T>(dev_ctx);
+  // dquery{Dense} = d_sdd_result{SparseCsr} * key{Dense} //
+  dquery->Resize(query.dims());
+  dev_ctx.template Alloc<T>(dquery);
+  sparse_blas.SPMM(false,
+                   false,
+                   static_cast<T>(1.f),
+                   d_sdd_result,
+                   key,
+                   static_cast<T>(0.f),
+                   dquery);
+
+  // dkey{Dense} = d_sdd_result'{SparseCsr} * query{Dense} //
+  dkey->Resize(key.dims());
+  dev_ctx.template Alloc<T>(dkey);
+  sparse_blas.SPMM(true,
+                   false,
+                   static_cast<T>(1.f),
+                   d_sdd_result,
+                   query,
+                   static_cast<T>(0.f),
+                   dkey);
 }
 
 }  // namespace sparse
 }  // namespace phi
+
+PD_REGISTER_KERNEL(fused_attention_csr_grad,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::sparse::FusedAttentionCsrGradKernel,
+                   float,
+                   double) {
+  kernel->InputAt(0).SetDataLayout(phi::DataLayout::SPARSE_CSR);
+}
@@ -14,12 +14,74 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/fused_attention_kernel.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/sparse/sparse_blas.h"
+#include "paddle/phi/kernels/sparse/empty_kernel.h"
+#include "paddle/phi/kernels/sparse/matmul_kernel.h"
 
 namespace phi {
 namespace sparse {
 
+template <typename T>
+void AttnSoftmaxCpuKernel(const CPUContext& dev_ctx,
+                          const phi::funcs::sparse::SparseRows& x_rows,
+                          const T* x_values,
+                          const T* kp_mask,
+                          const T* attn_mask,
+                          T* out_values,
+                          int64_t num_heads) {
+  // out = exp(x-x_max) / sum(exp(x-x_max))
+  const int64_t M = x_rows.rows;
+  const int64_t total_row_num = x_rows.batch_size * M;
+  int64_t avg_row_nnz = std::max<int64_t>(
+      1, x_rows.offsets.back() / std::max<int64_t>(1, total_row_num));
+  int64_t grain = std::max<int64_t>(1, (1 << 15) / avg_row_nnz);
+  dev_ctx.ParallelFor(0, total_row_num, grain, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      int64_t cur_batch = row / M;
+      int64_t cur_row = row % M;
+      int64_t row_first = x_rows.offsets[row];
+      int64_t row_last = x_rows.offsets[row + 1];
+
+      T max_val = -std::numeric_limits<T>::infinity();
+      for (int64_t idx = row_first; idx < row_last; ++idx) {
+        int64_t col_idx = x_rows.col_index[idx];
+        bool mask = (kp_mask != nullptr &&
+                     kp_mask[(cur_batch / num_heads) * M + col_idx] == 0) ||
+                    (attn_mask != nullptr &&
+                     attn_mask[cur_row * M + col_idx] == 0);
+        if (!mask) {
+          max_val = std::max(max_val, x_values[idx]);
+          out_values[idx] = x_values[idx];
+        } else {
+          out_values[idx] = -std::numeric_limits<T>::infinity();
+        }
+      }
+      // all the elements of the row are masked
+      if (max_val == -std::numeric_limits<T>::infinity()) {
+        std::fill(
+            out_values + row_first, out_values + row_last, static_cast<T>(0));
+        continue;
+      }
+
+      T exp_sum = 0;
+      for (int64_t idx = row_first; idx < row_last; ++idx) {
+        T exp = std::exp(out_values[idx] - max_val);
+        exp_sum += exp;
+        out_values[idx] = exp;
+      }
+      for (int64_t idx = row_first; idx < row_last; ++idx) {
+        out_values[idx] /= exp_sum;
+      }
+    }
+  });
+}
+
 template <typename T, typename Context>
 void FusedAttentionCsrKernel(
     const Context& dev_ctx,
@@ -31,9 +93,113 @@ void FusedAttentionCsrKernel(
     const paddle::optional<DenseTensor>& attn_mask,
     DenseTensor* out,
     SparseCsrTensor* softmax) {
-  PD_THROW(
-      "Not support CPU kernel of 'sparse.nn.functional.fused_attention' now");
+  /* Check Shape */
+  PADDLE_ENFORCE_EQ(query.dims().size(),
+                    4,
+                    phi::errors::InvalidArgument(" 'query' must be 4D Tensor"));
+  PADDLE_ENFORCE_EQ(key.dims().size(),
+                    4,
+                    phi::errors::InvalidArgument(" 'key' must be 4D Tensor"));
+  PADDLE_ENFORCE_EQ(value.dims().size(),
+                    4,
+                    phi::errors::InvalidArgument(" 'value' must be 4D Tensor"));
+
+  auto q_dim = query.dims();
+  int64_t batch_num = q_dim[0] * q_dim[1];
+  int64_t M = q_dim[2];
+  int64_t N = q_dim[3];
+
+  PADDLE_ENFORCE_EQ(
+      sparse_mask.dims().size(),
+      3,
+      phi::errors::InvalidArgument("dense shape of 'sparse_mask' must be "
+                                   "[batch_size*num_heads, seq_len, seq_len]"));
+  PADDLE_ENFORCE_EQ(
+      sparse_mask.dims()[0],
+      batch_num,
+      phi::errors::InvalidArgument("dense shape of 'sparse_mask' must be "
+                                   "[batch_size*num_heads, seq_len, seq_len]"));
+  PADDLE_ENFORCE_EQ(
+      sparse_mask.dims()[1],
+      M,
+      phi::errors::InvalidArgument("dense shape of 'sparse_mask' must be "
+                                   "[batch_size*num_heads, seq_len, seq_len]"));
+  PADDLE_ENFORCE_EQ(
+      sparse_mask.dims()[2],
+      M,
+      phi::errors::InvalidArgument("dense shape of 'sparse_mask' must be "
+                                   "[batch_size*num_heads, seq_len, seq_len]"));
+
+  const auto kp_mask_ptr = key_padding_mask.get_ptr();
+  if (kp_mask_ptr) {
+    PADDLE_ENFORCE_EQ(
+        kp_mask_ptr->dims().size(),
+        2,
+        phi::errors::InvalidArgument(
+            "shape of 'key_padding_mask' must be [batch_size, seq_len]"));
+    PADDLE_ENFORCE_EQ(
+        kp_mask_ptr->dims()[0],
+        q_dim[0],
+        phi::errors::InvalidArgument(
+            "shape of 'key_padding_mask' must be [batch_size, seq_len]"));
+    PADDLE_ENFORCE_EQ(
+        kp_mask_ptr->dims()[1],
+        M,
+        phi::errors::InvalidArgument(
+            "shape of 'key_padding_mask' must be [batch_size, seq_len]"));
+  }
+
+  const auto attn_mask_ptr = attn_mask.get_ptr();
+  if (attn_mask_ptr) {
+    PADDLE_ENFORCE_EQ(attn_mask_ptr->dims().size(),
+                      2,
+                      phi::errors::InvalidArgument(
+                          "shape of 'attn_mask' must be [seq_len, seq_len]"));
+    PADDLE_ENFORCE_EQ(attn_mask_ptr->dims()[0],
+                      M,
+                      phi::errors::InvalidArgument(
+                          "shape of 'attn_mask' must be [seq_len, seq_len]"));
+    PADDLE_ENFORCE_EQ(attn_mask_ptr->dims()[1],
+                      M,
+                      phi::errors::InvalidArgument(
+                          "shape of 'attn_mask' must be [seq_len, seq_len]"));
+  }
+
+  /* Step1: SDD Matmul, reuse matmul */
+  SparseCsrTensor sdd_result;
+  EmptyLikeCsrKernel<T, Context>(dev_ctx, sparse_mask, &sdd_result);
+  auto sparse_blas = phi::funcs::sparse::GetSparseBlas<Context, T>(dev_ctx);
+  sparse_blas.SDDMM(false,
+                    true,
+                    static_cast<T>(1 / std::sqrt(N)),
+                    query,
+                    key,
+                    static_cast<T>(0),
+                    &sdd_result);
+
+  /* Step2: Softmax with the masks */
+  EmptyLikeCsrKernel<T, Context>(dev_ctx, sdd_result, softmax);
+  AttnSoftmaxCpuKernel<T>(dev_ctx,
+                          phi::funcs::sparse::GetSparseRows(sdd_result),
+                          sdd_result.values().data<T>(),
+                          kp_mask_ptr ? kp_mask_ptr->data<T>() : nullptr,
+                          attn_mask_ptr ? attn_mask_ptr->data<T>() : nullptr,
+                          softmax->mutable_values()->data<T>(),
+                          q_dim[1]);
+
+  /* Step3: DSD Matmul, reuse matmul */
+  softmax->set_dims(phi::make_ddim({q_dim[0], q_dim[1], q_dim[2], q_dim[2]}));
+  MatmulCsrDenseKernel<T, Context>(dev_ctx, *softmax, value, out);
 }
 
 }  // namespace sparse
 }  // namespace phi
+
+PD_REGISTER_KERNEL(fused_attention_csr,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::sparse::FusedAttentionCsrKernel,
+                   float,
+                   double) {
+  kernel->InputAt(0).SetDataLayout(phi::DataLayout::SPARSE_CSR);
+}
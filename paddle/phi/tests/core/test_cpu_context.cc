@@ -0,0 +1,97 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/enforce.h"
+#include "unsupported/Eigen/CXX11/Tensor"
+
+namespace phi {
+namespace tests {
+
+TEST(CPUContext, ParallelFor) {
+  CPUContext ctx;
+  for (int num_threads : {1, 4}) {
+    CPUContext::SetIntraOpNumThreads(num_threads);
+    ASSERT_EQ(CPUContext::GetIntraOpNumThreads(), num_threads);
+    ASSERT_EQ(CPUContext::UseIntraOpThreadPool(), num_threads > 1);
+    ASSERT_EQ(ctx.eigen_pool_device() != nullptr, num_threads > 1);
+
+    // every element is visited once, and the blocks are not smaller than
+    // the grain size except the last one
+    std::vector<int> visited(1000, 0);
+    std::atomic<int> blocks(0);
+    ctx.ParallelFor(0, 1000, 100, [&](int64_t begin, int64_t end) {
+      ASSERT_TRUE(end - begin >= 100 || end == 1000);
+      for (int64_t i = begin; i < end; ++i) {
+        ++visited[i];
+      }
+      ++blocks;
+    });
+    ASSERT_EQ(blocks.load(), num_threads);
+    for (int v : visited) {
+      ASSERT_EQ(v, 1);
+    }
+
+    // nested ParallelFor runs on the calling thread
+    std::atomic<int64_t> sum(0);
+    ctx.ParallelFor(0, 8, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        ctx.ParallelFor(
+            0, 100, 1, [&](int64_t inner_begin, int64_t inner_end) {
+              sum += inner_end - inner_begin;
+            });
+      }
+    });
+    ASSERT_EQ(sum.load(), 800);
+  }
+  CPUContext::SetIntraOpNumThreads(1);
+}
+
+TEST(CPUContext, ParallelForException) {
+  CPUContext ctx;
+  CPUContext::SetIntraOpNumThreads(4);
+  bool caught = false;
+  try {
+    ctx.ParallelFor(0, 100, 1, [](int64_t begin, int64_t end) {
+      if (end == 100) {
+        PADDLE_THROW(phi::errors::InvalidArgument("the last block"));
+      }
+    });
+  } catch (const std::exception&) {
+    caught = true;
+  }
+  ASSERT_TRUE(caught);
+  CPUContext::SetIntraOpNumThreads(1);
+}
+
+TEST(CPUContext, EigenPoolDevice) {
+  CPUContext ctx;
+  CPUContext::SetIntraOpNumThreads(4);
+  Eigen::Tensor<float, 2> x(64, 1024);
+  x.setConstant(1.0f);
+  Eigen::Tensor<float, 1> y(64);
+  y.device(*ctx.eigen_pool_device()) = x.sum(Eigen::array<int, 1>({{1}}));
+  for (int i = 0; i < 64; ++i) {
+    ASSERT_EQ(y(i), 1024.0f);
+  }
+  CPUContext::SetIntraOpNumThreads(1);
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -15,6 +15,8 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <functional>
 
 #include "paddle/phi/kernels/autotune/cache.h"
@@ -66,3 +68,50 @@ TEST(AlgosCache, AlgosCache) {
   EXPECT_EQ(autotune_cache.CacheMisses(), 2);
   EXPECT_LT(std::abs(cache_hit_rate - autotune_cache.CacheHitRate()), 1e-5);
 }
+
+TEST(AlgosCache, SaveAndLoad) {
+  auto& autotune_cache = phi::autotune::AutoTuneCache::Instance();
+  auto& cache = autotune_cache.Get(phi::autotune::AlgorithmType::kTopkCPU);
+  phi::DataType dtype = paddle::experimental::CppTypeToDataType<float>::Type();
+  size_t key1 = phi::autotune::TopkKey(32, 1000, 5, true, true, dtype);
+  size_t key2 = phi::autotune::TopkKey(32, 1000, 500, true, true, dtype);
+  cache.Set(key1, 1);
+  cache.Set(key2, 2);
+
+  const std::string path = "./test_autotune_cache.txt";
+  autotune_cache.Save(path);
+  autotune_cache.Clean();
+  EXPECT_EQ(cache.Find(key1), false);
+
+  EXPECT_EQ(autotune_cache.Load(path), true);
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_EQ(cache.Get(key1), 1);
+  EXPECT_EQ(cache.Get(key2), 2);
+  EXPECT_EQ(autotune_cache.Load("./not_exist_autotune_cache.txt"), false);
+  std::remove(path.c_str());
+}
+
+TEST(AlgosCache, LoadMalformedFile) {
+  auto& autotune_cache = phi::autotune::AutoTuneCache::Instance();
+  autotune_cache.Clean();
+  auto& cache = autotune_cache.Get(phi::autotune::AlgorithmType::kTopkCPU);
+
+  // The first line is valid, but the file is ignored as a whole.
+  const std::string path = "./test_malformed_autotune_cache.txt";
+  {
+    std::ofstream fout(path);
+    fout << static_cast<int64_t>(phi::autotune::AlgorithmType::kTopkCPU)
+         << " 1 1\n";
+    fout << "12345 2 1\n";
+  }
+  EXPECT_EQ(autotune_cache.Load(path), false);
+  EXPECT_EQ(cache.IsEmpty(), true);
+
+  {
+    std::ofstream fout(path);
+    fout << "not a cache file\n";
+  }
+  EXPECT_EQ(autotune_cache.Load(path), false);
+  EXPECT_EQ(cache.IsEmpty(), true);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/autotune/auto_tune_base.h"
+
+namespace tune = phi::autotune;
+
+void SlowKernel(int* out) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  *out = 0;
+}
+
+void FastKernel(int* out) { *out = 1; }
+
+TEST(AutoTune, CPUKernel) {
+  phi::CPUContext ctx;
+  auto callback = tune::MakeCallback<float>(SlowKernel);
+  tune::AutoTuneBase<float, decltype(callback)> tuner(callback);
+  tuner.AddCallBack(FastKernel);
+
+  auto& status = tune::AutoTuneStatus::Instance();
+  auto& cache =
+      tune::AutoTuneCache::Instance().Get(tune::AlgorithmType::kTopkCPU);
+  size_t key = tune::GetKey(int64_t(1), int64_t(2));
+
+  // The default kernel runs if autotune is disabled.
+  int out = -1;
+  tuner.Run(ctx, tune::AlgorithmType::kTopkCPU, key, &out);
+  EXPECT_EQ(out, 0);
+  EXPECT_EQ(cache.Find(key), false);
+
+  // The first step is in the default tuning range [1, 10).
+  status.EnableAutoTune();
+  status.Update();
+  EXPECT_EQ(status.UseAutoTune(), true);
+  tuner.Run(ctx, tune::AlgorithmType::kTopkCPU, key, &out);
+  EXPECT_EQ(cache.Find(key), true);
+  EXPECT_EQ(cache.Get(key), 1);
+
+  // The tuned kernel runs after the tuning range.
+  status.SetAutoTuneRange(1, 2);
+  status.Update();
+  EXPECT_EQ(status.UseAutoTune(), false);
+  out = -1;
+  tuner.Run(ctx, tune::AlgorithmType::kTopkCPU, key, &out);
+  EXPECT_EQ(out, 1);
+  status.DisableAutoTune();
+}
+
+TEST(AutoTune, CachedKernelOutOfRange) {
+  phi::CPUContext ctx;
+  auto callback = tune::MakeCallback<float>(SlowKernel);
+  tune::AutoTuneBase<float, decltype(callback)> tuner(callback);
+  tuner.AddCallBack(FastKernel);
+
+  // A cache loaded from a file of another build may name a kernel that
+  // this tuner does not have.
+  auto& cache =
+      tune::AutoTuneCache::Instance().Get(tune::AlgorithmType::kTopkCPU);
+  size_t key = tune::GetKey(int64_t(3), int64_t(4));
+  cache.Set(key, 99);
+
+  int out = -1;
+  tuner.Run(ctx, tune::AlgorithmType::kTopkCPU, key, &out);
+  EXPECT_EQ(out, 0);
+  cache.Clean();
+}
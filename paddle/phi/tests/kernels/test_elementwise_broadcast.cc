@@ -0,0 +1,138 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <sys/time.h>
+
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/elementwise_base.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time;
+  gettimeofday(&time, NULL);
+  return 1e+6 * time.tv_sec + time.tv_usec;
+}
+constexpr int repeat = 10;
+
+struct SubFunctor {
+  float operator()(float a, float b) const { return a - b; }
+};
+
+// the previous implementation, which computes the index of x and y for
+// every element of out
+void RefBroadcast(const float* x,
+                  const float* y,
+                  float* out,
+                  const std::vector<int>& x_dims,
+                  const std::vector<int>& y_dims,
+                  const std::vector<int>& out_dims) {
+  int max_dim = out_dims.size();
+  int64_t numel = 1;
+  for (int dim : out_dims) {
+    numel *= dim;
+  }
+  std::vector<int> index_array(max_dim, 0);
+  for (int64_t out_index = 0; out_index < numel; ++out_index) {
+    int x_index = phi::funcs::GetElementwiseIndex(
+        x_dims.data(), max_dim, index_array.data());
+    int y_index = phi::funcs::GetElementwiseIndex(
+        y_dims.data(), max_dim, index_array.data());
+    out[out_index] = SubFunctor()(x[x_index], y[y_index]);
+    phi::funcs::UpdateElementwiseIndexArray(
+        out_dims.data(), max_dim, index_array.data());
+  }
+}
+
+void TestAndBench(const std::vector<int>& x_dims,
+                  const std::vector<int>& y_dims,
+                  int num_threads) {
+  std::vector<int> out_dims(x_dims.size());
+  int64_t x_numel = 1, y_numel = 1, out_numel = 1;
+  for (size_t i = 0; i < x_dims.size(); ++i) {
+    out_dims[i] = x_dims[i] == 1 ? y_dims[i] : x_dims[i];
+    x_numel *= x_dims[i];
+    y_numel *= y_dims[i];
+    out_numel *= out_dims[i];
+  }
+  std::vector<float> x(x_numel), y(y_numel);
+  std::vector<float> out(out_numel), out_ref(out_numel);
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (auto& v : x) v = dist(engine);
+  for (auto& v : y) v = dist(engine);
+
+  auto x_strides = phi::funcs::GetBroadcastStrides(
+      x_dims.data(), out_dims.data(), out_dims.size());
+  auto y_strides = phi::funcs::GetBroadcastStrides(
+      y_dims.data(), out_dims.data(), out_dims.size());
+  std::vector<int64_t> dims(out_dims.begin(), out_dims.end());
+
+  phi::CPUContext::SetIntraOpNumThreads(num_threads);
+  phi::CPUContext ctx;
+  auto st = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    phi::funcs::BroadcastCPU<SubFunctor, float>(ctx,
+                                                x.data(),
+                                                y.data(),
+                                                out.data(),
+                                                dims,
+                                                x_strides,
+                                                y_strides,
+                                                SubFunctor());
+  }
+  auto mt = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    RefBroadcast(
+        x.data(), y.data(), out_ref.data(), x_dims, y_dims, out_dims);
+  }
+  auto et = GetCurrentUS();
+  phi::CPUContext::SetIntraOpNumThreads(0);
+  VLOG(3) << "Broadcast " << out_numel << " elements with " << num_threads
+          << " threads: refer takes: " << (et - mt) / repeat
+          << " us, tgt takes: " << (mt - st) / repeat << " us";
+  for (int64_t i = 0; i < out_numel; ++i) {
+    ASSERT_EQ(out[i], out_ref[i]);
+  }
+}
+
+TEST(ElementwiseBroadcast, CPU) {
+  for (int num_threads : {1, 4}) {
+    // same shape and scalar
+    TestAndBench({4, 5, 6}, {4, 5, 6}, num_threads);
+    TestAndBench({1, 1, 1}, {1, 1, 1}, num_threads);
+    TestAndBench({8, 33, 65}, {1, 1, 1}, num_threads);
+    TestAndBench({1, 1, 1}, {8, 33, 65}, num_threads);
+    // bias add of [batch, seq_len, hidden] and [hidden]
+    TestAndBench({16, 128, 768}, {1, 1, 768}, num_threads);
+    // [batch, dim] and [batch, 1] in CTR models
+    TestAndBench({512, 1000}, {512, 1}, num_threads);
+    // attention mask of [batch, 1, seq_len, seq_len]
+    TestAndBench({8, 12, 128, 128}, {8, 1, 128, 128}, num_threads);
+    // both of x and y are broadcast
+    TestAndBench({7, 1, 9, 1}, {1, 5, 1, 3}, num_threads);
+    TestAndBench({1, 300}, {200, 1}, num_threads);
+    // empty output
+    TestAndBench({0, 3}, {1, 3}, num_threads);
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
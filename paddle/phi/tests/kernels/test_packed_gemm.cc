@@ -0,0 +1,91 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/packed_gemm.h"
+
+namespace phi {
+namespace tests {
+
+template <typename T>
+void RefMatMul(int M,
+               int N,
+               int K,
+               const T* x,
+               const T* w,
+               bool trans_w,
+               T* out) {
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      T sum = 0;
+      for (int k = 0; k < K; ++k) {
+        sum += x[i * K + k] * (trans_w ? w[j * K + k] : w[k * N + j]);
+      }
+      out[i * N + j] = sum;
+    }
+  }
+}
+
+template <typename T>
+void TestPackedMatMul(int M, int N, int K, bool trans_w) {
+  std::vector<T> x(M * K), w(K * N), out(M * N), out_ref(M * N);
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<T> dist(-1, 1);
+  for (auto& v : x) v = dist(engine);
+  for (auto& v : w) v = dist(engine);
+
+  phi::CPUContext ctx;
+  auto& cache = phi::funcs::PackedWeightCache::Instance();
+  // the weight is not packed before it is registered
+  ASSERT_FALSE(phi::funcs::PackedMatMul(
+      ctx, M, N, K, x.data(), w.data(), trans_w, out.data()));
+
+  cache.Register(w.data());
+  cache.Register(w.data());
+  ASSERT_TRUE(cache.IsRegistered(w.data()));
+  RefMatMul(M, N, K, x.data(), w.data(), trans_w, out_ref.data());
+  for (int i = 0; i < 2; ++i) {
+    bool packed = phi::funcs::PackedMatMul(
+        ctx, M, N, K, x.data(), w.data(), trans_w, out.data());
+#ifdef PADDLE_WITH_MKLML
+    ASSERT_TRUE(packed);
+    // the weight is packed once
+    ASSERT_EQ(cache.Size(), 1UL);
+    for (int j = 0; j < M * N; ++j) {
+      EXPECT_NEAR(out[j], out_ref[j], 1e-4);
+    }
+#else
+    ASSERT_FALSE(packed);
+    ASSERT_EQ(cache.Size(), 0UL);
+#endif
+  }
+
+  cache.Unregister(w.data());
+  ASSERT_TRUE(cache.IsRegistered(w.data()));
+  cache.Unregister(w.data());
+  ASSERT_FALSE(cache.IsRegistered(w.data()));
+  ASSERT_EQ(cache.Size(), 0UL);
+}
+
+TEST(PackedGemm, MatMul) {
+  TestPackedMatMul<float>(1, 64, 128, false);
+  TestPackedMatMul<float>(16, 33, 17, true);
+  TestPackedMatMul<double>(7, 20, 30, false);
+}
+
+}  // namespace tests
+}  // namespace phi
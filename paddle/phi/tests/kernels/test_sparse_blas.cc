@@ -0,0 +1,312 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <sys/time.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/sparse/sparse_blas.h"
+#include "paddle/phi/tests/core/allocator.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time;
+  gettimeofday(&time, NULL);
+  return 1e+6 * time.tv_sec + time.tv_usec;
+}
+constexpr int repeat = 10;
+
+template <typename T>
+DenseTensor MakeTensor(Allocator* alloc,
+                       DataType dtype,
+                       const std::vector<int64_t>& dims,
+                       const std::vector<T>& data) {
+  DenseTensorMeta meta(dtype, phi::make_ddim(dims), DataLayout::NCHW);
+  DenseTensor tensor(alloc, meta);
+  std::copy(data.begin(), data.end(), tensor.mutable_data<T>(CPUPlace()));
+  return tensor;
+}
+
+// A random [batch, rows, cols] matrix, of which about 'density' of the
+// elements are nonzeros.
+std::vector<float> RandomMatrix(
+    int64_t batch, int64_t rows, int64_t cols, float density, int seed) {
+  std::vector<float> x(batch * rows * cols);
+  std::default_random_engine engine(seed);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::uniform_real_distribution<float> prob(0.f, 1.f);
+  for (auto& v : x) {
+    v = prob(engine) < density ? dist(engine) : 0.f;
+  }
+  return x;
+}
+
+SparseCsrTensor DenseToCsr(Allocator* alloc,
+                           const std::vector<float>& x,
+                           int64_t batch,
+                           int64_t rows,
+                           int64_t cols) {
+  std::vector<int64_t> crows, col_index;
+  std::vector<float> values;
+  for (int64_t b = 0; b < batch; ++b) {
+    crows.push_back(0);
+    int64_t batch_nnz = 0;
+    for (int64_t r = 0; r < rows; ++r) {
+      for (int64_t c = 0; c < cols; ++c) {
+        float v = x[(b * rows + r) * cols + c];
+        if (v != 0.f) {
+          col_index.push_back(c);
+          values.push_back(v);
+          ++batch_nnz;
+        }
+      }
+      crows.push_back(batch_nnz);
+    }
+  }
+  int64_t nnz = values.size();
+  std::vector<int64_t> dims = {rows, cols};
+  if (batch > 1) {
+    dims.insert(dims.begin(), batch);
+  }
+  return SparseCsrTensor(
+      MakeTensor(alloc, DataType::INT64, {batch * (rows + 1)}, crows),
+      MakeTensor(alloc, DataType::INT64, {nnz}, col_index),
+      MakeTensor(alloc, DataType::FLOAT32, {nnz}, values),
+      phi::make_ddim(dims));
+}
+
+// The nonzeros of the COO tensor are shuffled, which are not required to be
+// sorted by SparseBlas.
+SparseCooTensor DenseToCoo(Allocator* alloc,
+                           const std::vector<float>& x,
+                           int64_t batch,
+                           int64_t rows,
+                           int64_t cols) {
+  std::vector<int64_t> order;
+  for (int64_t i = 0; i < static_cast<int64_t>(x.size()); ++i) {
+    if (x[i] != 0.f) {
+      order.push_back(i);
+    }
+  }
+  std::shuffle(order.begin(), order.end(), std::default_random_engine(0));
+  int64_t nnz = order.size();
+  int sparse_dim = batch > 1 ? 3 : 2;
+  std::vector<int64_t> indices(sparse_dim * nnz);
+  std::vector<float> values(nnz);
+  for (int64_t i = 0; i < nnz; ++i) {
+    int64_t index = order[i];
+    indices[(sparse_dim - 1) * nnz + i] = index % cols;
+    indices[(sparse_dim - 2) * nnz + i] = index / cols % rows;
+    if (batch > 1) {
+      indices[i] = index / (rows * cols);
+    }
+    values[i] = x[index];
+  }
+  std::vector<int64_t> dims = {rows, cols};
+  if (batch > 1) {
+    dims.insert(dims.begin(), batch);
+  }
+  return SparseCooTensor(
+      MakeTensor(alloc, DataType::INT64, {sparse_dim, nnz}, indices),
+      MakeTensor(alloc, DataType::FLOAT32, {nnz}, values),
+      phi::make_ddim(dims));
+}
+
+// out[M, N] = x[M, K] * y[K, N] for every batch
+void RefMatMul(const std::vector<float>& x,
+               const std::vector<float>& y,
+               int64_t batch,
+               int64_t M,
+               int64_t N,
+               int64_t K,
+               std::vector<float>* out) {
+  out->assign(batch * M * N, 0.f);
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t i = 0; i < M; ++i) {
+      for (int64_t k = 0; k < K; ++k) {
+        float v = x[(b * M + i) * K + k];
+        for (int64_t j = 0; j < N; ++j) {
+          (*out)[(b * M + i) * N + j] += v * y[(b * K + k) * N + j];
+        }
+      }
+    }
+  }
+}
+
+template <typename TensorType>
+void TestSpMM(const TensorType& x,
+              const std::vector<float>& dense_x,
+              int64_t batch,
+              int64_t M,
+              int64_t N,
+              int64_t K,
+              float density) {
+  auto alloc = std::unique_ptr<Allocator>(new FancyAllocator);
+  phi::CPUContext ctx;
+  auto sparse_blas = phi::funcs::sparse::GetSparseBlas<CPUContext, float>(ctx);
+  auto blas = phi::funcs::GetBlas<CPUContext, float>(ctx);
+
+  std::vector<float> y_data = RandomMatrix(batch, K, N, 1.f, 1);
+  DenseTensor y =
+      MakeTensor(alloc.get(), DataType::FLOAT32, {batch, K, N}, y_data);
+  DenseTensor out = MakeTensor(alloc.get(),
+                               DataType::FLOAT32,
+                               {batch, M, N},
+                               std::vector<float>(batch * M * N, 1.f));
+  std::vector<float> out_ref;
+  RefMatMul(dense_x, y_data, batch, M, N, K, &out_ref);
+
+  // out = 2 * x * y + 1 * out
+  sparse_blas.SPMM(false, false, 2.f, x, y, 1.f, &out);
+  for (int64_t i = 0; i < batch * M * N; ++i) {
+    ASSERT_NEAR(out.data<float>()[i], 2.f * out_ref[i] + 1.f, 1e-4);
+  }
+
+  // x' * dout, which is the gradient of y
+  std::vector<float> x_trans(batch * K * M), dout_data(batch * M * N, 1.f);
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t i = 0; i < M; ++i) {
+      for (int64_t k = 0; k < K; ++k) {
+        x_trans[(b * K + k) * M + i] = dense_x[(b * M + i) * K + k];
+      }
+    }
+  }
+  DenseTensor dout =
+      MakeTensor(alloc.get(), DataType::FLOAT32, {batch, M, N}, dout_data);
+  DenseTensor dy = MakeTensor(alloc.get(),
+                              DataType::FLOAT32,
+                              {batch, K, N},
+                              std::vector<float>(batch * K * N));
+  RefMatMul(x_trans, dout_data, batch, K, N, M, &out_ref);
+  sparse_blas.SPMM(true, false, 1.f, x, dout, 0.f, &dy);
+  for (int64_t i = 0; i < batch * K * N; ++i) {
+    ASSERT_NEAR(dy.data<float>()[i], out_ref[i], 1e-4);
+  }
+
+  // benchmark against the dense matmul
+  DenseTensor x_dense =
+      MakeTensor(alloc.get(), DataType::FLOAT32, {batch, M, K}, dense_x);
+  auto st = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    sparse_blas.SPMM(false, false, 1.f, x, y, 0.f, &out);
+  }
+  auto mt = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    blas.BatchedGEMM(CblasNoTrans,
+                     CblasNoTrans,
+                     M,
+                     N,
+                     K,
+                     1.f,
+                     x_dense.data<float>(),
+                     y.data<float>(),
+                     0.f,
+                     out.data<float>(),
+                     batch,
+                     M * K,
+                     K * N);
+  }
+  auto et = GetCurrentUS();
+  VLOG(3) << "SPMM of [" << batch << ", " << M << ", " << K << "] x [" << K
+          << ", " << N << "] with density " << density
+          << ": dense matmul takes: " << (et - mt) / repeat
+          << " us, sparse matmul takes: " << (mt - st) / repeat << " us";
+}
+
+TEST(SparseBlas, SPMM) {
+  auto alloc = std::unique_ptr<Allocator>(new FancyAllocator);
+  for (int num_threads : {1, 4}) {
+    phi::CPUContext::SetIntraOpNumThreads(num_threads);
+    for (float density : {0.01f, 0.05f, 0.2f, 0.5f}) {
+      for (int64_t batch : {1, 4}) {
+        const int64_t M = 128, N = 64, K = 256;
+        auto x = RandomMatrix(batch, M, K, density, 0);
+        TestSpMM(DenseToCsr(alloc.get(), x, batch, M, K),
+                 x,
+                 batch,
+                 M,
+                 N,
+                 K,
+                 density);
+        TestSpMM(DenseToCoo(alloc.get(), x, batch, M, K),
+                 x,
+                 batch,
+                 M,
+                 N,
+                 K,
+                 density);
+      }
+    }
+  }
+  phi::CPUContext::SetIntraOpNumThreads(0);
+}
+
+TEST(SparseBlas, SDDMM) {
+  auto alloc = std::unique_ptr<Allocator>(new FancyAllocator);
+  phi::CPUContext ctx;
+  auto sparse_blas = phi::funcs::sparse::GetSparseBlas<CPUContext, float>(ctx);
+  const int64_t batch = 3, M = 17, N = 23, K = 9;
+  std::vector<float> x_data = RandomMatrix(batch, M, K, 1.f, 0);
+  std::vector<float> y_data = RandomMatrix(batch, K, N, 1.f, 1);
+  std::vector<float> mask_data = RandomMatrix(batch, M, N, 0.3f, 2);
+  std::vector<float> out_ref;
+  RefMatMul(x_data, y_data, batch, M, N, K, &out_ref);
+  DenseTensor x =
+      MakeTensor(alloc.get(), DataType::FLOAT32, {batch, M, K}, x_data);
+  DenseTensor y =
+      MakeTensor(alloc.get(), DataType::FLOAT32, {batch, K, N}, y_data);
+
+  // out = x * y masked by the pattern of mask
+  auto csr = DenseToCsr(alloc.get(), mask_data, batch, M, N);
+  sparse_blas.SDDMM(false, false, 1.f, x, y, 0.f, &csr);
+  const int64_t* crows = csr.crows().data<int64_t>();
+  const int64_t* cols = csr.cols().data<int64_t>();
+  int64_t batch_offset = 0;
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t r = 0; r < M; ++r) {
+      const int64_t* batch_crows = crows + b * (M + 1);
+      for (int64_t i = batch_crows[r]; i < batch_crows[r + 1]; ++i) {
+        int64_t c = cols[batch_offset + i];
+        ASSERT_NEAR(csr.values().data<float>()[batch_offset + i],
+                    out_ref[(b * M + r) * N + c],
+                    1e-4);
+      }
+    }
+    batch_offset += crows[b * (M + 1) + M];
+  }
+
+  // the same for COO, whose nonzeros are not sorted
+  auto coo = DenseToCoo(alloc.get(), mask_data, batch, M, N);
+  sparse_blas.SDDMM(false, false, 1.f, x, y, 0.f, &coo);
+  const int64_t* indices = coo.indices().data<int64_t>();
+  for (int64_t i = 0; i < coo.nnz(); ++i) {
+    int64_t b = indices[i];
+    int64_t r = indices[coo.nnz() + i];
+    int64_t c = indices[2 * coo.nnz() + i];
+    ASSERT_NEAR(
+        coo.values().data<float>()[i], out_ref[(b * M + r) * N + c], 1e-4);
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -87,6 +87,30 @@ class TestProcessGroupFp32(unittest.TestCase):
 
             print("test allreduce max api ok")
 
+            # test async allreduce
+            xs = [
+                np.random.random(self.shape).astype(self.dtype)
+                for _ in range(4)
+            ]
+            ys = [
+                np.random.random(self.shape).astype(self.dtype)
+                for _ in range(4)
+            ]
+            tensors = [
+                paddle.to_tensor(x if rank == 0 else y)
+                for x, y in zip(xs, ys)
+            ]
+            tasks = [
+                pg.all_reduce(t, core.ReduceOp.SUM, sync_op=False)
+                for t in tensors
+            ]
+            for x, y, t, task in zip(xs, ys, tensors, tasks):
+                task.wait()
+                assert task.is_completed()
+                np.testing.assert_allclose(t.numpy(), x + y, rtol=1e-6)
+
+            print("test async allreduce api ok")
+
             # test broadcast
             # rank 0
             x = np.random.random(self.shape).astype(self.dtype)
@@ -62,6 +62,16 @@ class TestLookupTableOp(OpTest):
         self.check_grad(['W'], 'Out', no_grad_set=set('Ids'), check_eager=True)
 
 
+class TestLookupTableOpWithDuplicatedIds(TestLookupTableOp):
+    def setUp(self):
+        self.op_type = "lookup_table_v2"
+        self.python_api = paddle.nn.functional.embedding
+        table = np.random.random((20, 16)).astype("float64")
+        ids = np.random.randint(0, 5, 200).astype(self.id_dtype())
+        self.inputs = {'W': table, 'Ids': ids}
+        self.outputs = {'Out': table[ids]}
+
+
 class TestLookupTableOpInt16(OpTest):
     def id_dtype(self):
         return "int16"
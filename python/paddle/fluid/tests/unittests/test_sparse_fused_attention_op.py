@@ -175,5 +175,29 @@ class TestSparseAttentionAPI5(TestSparseAttentionAPI1):
         self.use_mask = True
 
 
+class TestSparseAttentionCPU(unittest.TestCase):
+    def setUp(self):
+        self.origin_device = paddle.device.get_device()
+        paddle.device.set_device('cpu')
+        self.batch_size = 2
+        self.num_heads = 4
+        self.seq_len = 128
+        self.head_dim = 16
+        self.dtype = 'float64'
+        self.use_mask = True
+
+    def tearDown(self):
+        paddle.device.set_device(self.origin_device)
+
+    # the CPU kernels do not depend on the CUDA version
+    test_dygraph = TestSparseAttentionAPI1.test_dygraph
+
+
+class TestSparseAttentionCPUNoMask(TestSparseAttentionCPU):
+    def setUp(self):
+        super().setUp()
+        self.use_mask = False
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -62,7 +62,7 @@ class TestMatmul(unittest.TestCase):
         np.testing.assert_allclose(
             sp_out.numpy(), dense_out.numpy(), rtol=1e-05
         )
-        if get_cuda_version() >= 11030:
+        if paddle.device.get_device() == 'cpu' or get_cuda_version() >= 11030:
             dense_out.backward()
             sp_out.backward()
             np.testing.assert_allclose(
@@ -98,6 +98,16 @@ class TestMaskedMatmul(unittest.TestCase):
         "only support on cuda>=11.3",
     )
     def test_masked_matmul_2d(self):
+        self.check_masked_matmul_2d()
+
+    @unittest.skipIf(
+        not paddle.is_compiled_with_cuda() or get_cuda_version() < 11080,
+        "only support on cuda>=11.8",
+    )
+    def test_masked_matmul_3d(self):
+        self.check_masked_matmul_3d()
+
+    def check_masked_matmul_2d(self):
         np_mask = np.random.rand(10, 6) < 0.2
 
         np_x = np.random.rand(10, 12)
@@ -130,11 +140,7 @@ class TestMaskedMatmul(unittest.TestCase):
         np.testing.assert_allclose(np_x_grad, x.grad.numpy(), rtol=1e-05)
         np.testing.assert_allclose(np_y_grad, y.grad.numpy(), rtol=1e-05)
 
-    @unittest.skipIf(
-        not paddle.is_compiled_with_cuda() or get_cuda_version() < 11080,
-        "only support on cuda>=11.8",
-    )
-    def test_masked_matmul_3d(self):
+    def check_masked_matmul_3d(self):
         paddle.set_default_dtype('float32')
         origin_x = paddle.rand([16, 16, 12])
         mask = paddle.randint(0, 2, [16, 12])
@@ -168,5 +174,37 @@ class TestMaskedMatmul(unittest.TestCase):
         )
 
 
+class TestMatmulCPU(TestMatmul):
+    def setUp(self):
+        self.origin_device = paddle.device.get_device()
+        paddle.device.set_device('cpu')
+
+    def tearDown(self):
+        paddle.device.set_device(self.origin_device)
+
+    def test_matmul_2d(self):
+        self.check_result([16, 12], [12, 10], 'coo')
+        self.check_result([16, 12], [12, 10], 'csr')
+
+    def test_matmul_3d(self):
+        self.check_result([8, 16, 12], [8, 12, 10], 'coo')
+        self.check_result([8, 16, 12], [8, 12, 10], 'csr')
+
+
+class TestMaskedMatmulCPU(TestMaskedMatmul):
+    def setUp(self):
+        self.origin_device = paddle.device.get_device()
+        paddle.device.set_device('cpu')
+
+    def tearDown(self):
+        paddle.device.set_device(self.origin_device)
+
+    def test_masked_matmul_2d(self):
+        self.check_masked_matmul_2d()
+
+    def test_masked_matmul_3d(self):
+        self.check_masked_matmul_3d()
+
+
 if __name__ == "__main__":
     unittest.main()